@@ -0,0 +1,242 @@
+#include "Core.AsyncReadback.h"
+
+
+namespace Mi::Core
+{
+    AsyncReadback::~AsyncReadback()
+    {
+        (void)Stop();
+    }
+
+    AsyncReadback::AsyncReadback(_In_ const winrt::com_ptr<ID3D11Device>& Device)
+        : mDevice(Device)
+    {
+        mDevice->GetImmediateContext(mContext.put());
+    }
+
+    winrt::hresult AsyncReadback::Start(_In_ const Callback& Handler, _In_opt_ uint32_t Slots)
+    {
+        std::lock_guard Lock(mEnqueueMutex);
+
+        if (mActive) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        mCallback  = Handler;
+        mSlotCount = std::clamp<uint32_t>(Slots, 2, MAXIMUM_READBACK_SLOTS);
+        mSlots     = std::make_unique<Slot[]>(mSlotCount);
+        mNextSlot  = 0;
+        mStopping  = false;
+
+        mCompleted = 0;
+        mDropped   = 0;
+        mFailed    = 0;
+
+        try {
+            mWorker = std::thread(&AsyncReadback::Run, this);
+        }
+        catch (const std::system_error& Exception) {
+            mSlots    = nullptr;
+            mCallback = nullptr;
+            return HRESULT_FROM_WIN32(Exception.code().value());
+        }
+
+        mActive = true;
+        return S_OK;
+    }
+
+    winrt::hresult AsyncReadback::Stop()
+    {
+        {
+            std::lock_guard Lock(mEnqueueMutex);
+            if (!mActive) {
+                return S_FALSE;
+            }
+            mActive = false;
+        }
+
+        mStopping = true;
+        mWake.notify_all();
+
+        if (mWorker.joinable()) {
+            mWorker.join();
+        }
+        mSlots    = nullptr;
+        mCallback = nullptr;
+
+        return S_OK;
+    }
+
+    bool AsyncReadback::IsActive()
+    {
+        std::lock_guard Lock(mEnqueueMutex);
+        return mActive;
+    }
+
+    bool AsyncReadback::Enqueue(_In_ ID3D11Texture2D* Surface, _In_ uint64_t Sequence,
+        _In_opt_ const std::vector<RECT>* DirtyRects, _In_opt_ const D3D11_BOX* Region)
+    {
+        const std::unique_lock Lock(mEnqueueMutex, std::try_to_lock);
+        if (!Lock.owns_lock() || !mActive) {
+            return false;
+        }
+
+        auto& Item = mSlots[mNextSlot % mSlotCount];
+        if (Item.State.load(std::memory_order_acquire) != SlotState::Free) {
+            ++mDropped;
+            return false;
+        }
+
+        D3D11_TEXTURE2D_DESC SurfaceDesc{};
+        Surface->GetDesc(&SurfaceDesc);
+
+        if (Region) {
+            if (Region->left >= Region->right || Region->right > SurfaceDesc.Width ||
+                Region->top >= Region->bottom || Region->bottom > SurfaceDesc.Height) {
+                ++mFailed;
+                return false;
+            }
+            SurfaceDesc.Width  = Region->right  - Region->left;
+            SurfaceDesc.Height = Region->bottom - Region->top;
+        }
+
+        if (Item.Staging) {
+            D3D11_TEXTURE2D_DESC StagingDesc{};
+            Item.Staging->GetDesc(&StagingDesc);
+
+            if (StagingDesc.Width  != SurfaceDesc.Width  ||
+                StagingDesc.Height != SurfaceDesc.Height ||
+                StagingDesc.Format != SurfaceDesc.Format) {
+                Item.Staging = nullptr;
+            }
+        }
+
+        if (Item.Staging == nullptr) {
+            D3D11_TEXTURE2D_DESC StagingDesc{};
+            StagingDesc.Width            = SurfaceDesc.Width;
+            StagingDesc.Height           = SurfaceDesc.Height;
+            StagingDesc.MipLevels        = 1;
+            StagingDesc.ArraySize        = 1;
+            StagingDesc.Format           = SurfaceDesc.Format;
+            StagingDesc.SampleDesc.Count = 1;
+            StagingDesc.Usage            = D3D11_USAGE_STAGING;
+            StagingDesc.CPUAccessFlags   = D3D11_CPU_ACCESS_READ;
+
+            const winrt::hresult Result = mDevice->CreateTexture2D(&StagingDesc, nullptr, Item.Staging.put());
+            if (FAILED(Result)) {
+                LOG(ERROR, "AsyncReadback::Enqueue(), ID3D11Device::CreateTexture2D(%ux%u, %d) failed, Result=0x%0*X",
+                    StagingDesc.Width, StagingDesc.Height, StagingDesc.Format, 8, Result.value);
+                ++mFailed;
+                return false;
+            }
+        }
+
+        D3D11_BOX SourceBox{};
+        if (Region) {
+            SourceBox       = *Region;
+            SourceBox.front = 0;
+            SourceBox.back  = 1;
+        }
+        mContext->CopySubresourceRegion(Item.Staging.get(), 0, 0, 0, 0, Surface, 0, Region ? &SourceBox : nullptr);
+
+        Item.Sequence = Sequence;
+        Item.Time     = std::chrono::steady_clock::now();
+
+        Item.DirtyRects.clear();
+        if (DirtyRects) {
+            Item.DirtyRects.assign(DirtyRects->begin(), DirtyRects->end());
+        }
+
+        // The worker owns the slot from here on, the copy is flushed by the next Present()
+        Item.State.store(SlotState::Copied, std::memory_order_release);
+        ++mNextSlot;
+
+        mWake.notify_one();
+        return true;
+    }
+
+    AsyncReadbackStatistics AsyncReadback::GetStatistics() const
+    {
+        AsyncReadbackStatistics Statistics{};
+        Statistics.Completed = mCompleted;
+        Statistics.Dropped   = mDropped;
+        Statistics.Failed    = mFailed;
+        return Statistics;
+    }
+
+    void AsyncReadback::Run()
+    {
+        LOG(INFO, "AsyncReadback::Run() startup.");
+
+        uint64_t Next = 0;
+        while (true) {
+            auto& Item = mSlots[Next % mSlotCount];
+
+            if (Item.State.load(std::memory_order_acquire) != SlotState::Copied) {
+                if (mStopping) {
+                    break;
+                }
+
+                // Enqueue() does not take the mutex, the timeout covers a notification that came too early
+                std::unique_lock Lock(mWakeMutex);
+                mWake.wait_for(Lock, std::chrono::milliseconds(10), [&]
+                {
+                    return mStopping || Item.State.load(std::memory_order_acquire) == SlotState::Copied;
+                });
+                continue;
+            }
+
+            if (!MapSlot(Item)) {
+                // Nothing presents any more after a stop, the last copies have to be submitted here
+                if (mStopping) {
+                    mContext->Flush();
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+
+            Item.State.store(SlotState::Free, std::memory_order_release);
+            ++Next;
+        }
+
+        LOG(INFO, "AsyncReadback::Run() quit.");
+    }
+
+    bool AsyncReadback::MapSlot(_In_ Slot& Item)
+    {
+        // Never waits for the GPU, the immediate context is shared with the render thread
+        D3D11_MAPPED_SUBRESOURCE Mapped{};
+        const winrt::hresult Result = mContext->Map(Item.Staging.get(), 0, D3D11_MAP_READ,
+            D3D11_MAP_FLAG_DO_NOT_WAIT, &Mapped);
+        if (Result == DXGI_ERROR_WAS_STILL_DRAWING) {
+            return false;
+        }
+
+        if (FAILED(Result)) {
+            LOG(ERROR, "AsyncReadback::MapSlot(), ID3D11DeviceContext::Map failed, Result=0x%0*X", 8, Result.value);
+            ++mFailed;
+            return true;
+        }
+
+        D3D11_TEXTURE2D_DESC StagingDesc{};
+        Item.Staging->GetDesc(&StagingDesc);
+
+        ReadbackFrame Frame{};
+        Frame.Data       = static_cast<const uint8_t*>(Mapped.pData);
+        Frame.RowPitch   = Mapped.RowPitch;
+        Frame.Width      = StagingDesc.Width;
+        Frame.Height     = StagingDesc.Height;
+        Frame.Format     = StagingDesc.Format;
+        Frame.Sequence   = Item.Sequence;
+        Frame.Time       = Item.Time;
+        Frame.DirtyRects = &Item.DirtyRects;
+
+        if (mCallback) {
+            mCallback(Frame);
+        }
+        mContext->Unmap(Item.Staging.get(), 0);
+
+        ++mCompleted;
+        return true;
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <condition_variable>
+
+
+namespace Mi::Core
+{
+    constexpr uint32_t DEFAULT_READBACK_SLOTS = 4;
+    constexpr uint32_t MAXIMUM_READBACK_SLOTS = 16;
+
+    // A surface copied back to the CPU. Data points into the mapped staging texture and is only valid
+    // during the callback, consumers that keep the pixels have to copy them.
+    struct ReadbackFrame
+    {
+        const uint8_t* Data     = nullptr;
+        uint32_t       RowPitch = 0;
+        uint32_t       Width    = 0;
+        uint32_t       Height   = 0;
+        DXGI_FORMAT    Format   = DXGI_FORMAT_UNKNOWN;
+        uint64_t       Sequence = 0;
+        std::chrono::steady_clock::time_point Time{};   // when the copy was queued
+        const std::vector<RECT>* DirtyRects = nullptr;  // empty if the whole surface changed
+    };
+
+    struct AsyncReadbackStatistics
+    {
+        uint64_t Completed = 0;     // frames handed to the callback
+        uint64_t Dropped   = 0;     // frames not copied because every staging slot was still busy
+        uint64_t Failed    = 0;     // frames lost to a failed copy or map
+    };
+
+    // Reads surfaces back without stalling the render thread.
+    //
+    // Enqueue() copies the surface into the next staging texture of a ring and returns. A worker thread maps
+    // the staging textures in order with D3D11_MAP_FLAG_DO_NOT_WAIT a few frames later, once the GPU is done
+    // with them, and hands them to the callback. When the callback falls behind, all slots stay busy and
+    // Enqueue() drops the frame instead of waiting.
+    class AsyncReadback
+    {
+    public:
+        using Callback = std::function<void(_In_ const ReadbackFrame& Frame)>;
+
+    private:
+        enum class SlotState : uint32_t
+        {
+            Free,       // owned by the render thread
+            Copied,     // copy queued, owned by the worker thread
+        };
+
+        struct Slot
+        {
+            std::atomic<SlotState>          State = SlotState::Free;
+            winrt::com_ptr<ID3D11Texture2D> Staging{ nullptr };
+            uint64_t                        Sequence = 0;
+            std::chrono::steady_clock::time_point Time{};
+            std::vector<RECT>               DirtyRects;
+        };
+
+        winrt::com_ptr<ID3D11Device>        mDevice { nullptr };
+        winrt::com_ptr<ID3D11DeviceContext> mContext{ nullptr };
+
+        // Held by Start() and Stop(), Enqueue() only tries it and drops the frame if it is taken
+        std::mutex                  mEnqueueMutex;
+        bool                        mActive = false;
+        std::unique_ptr<Slot[]>     mSlots;
+        uint32_t                    mSlotCount = 0;
+        uint64_t                    mNextSlot  = 0;     // render thread
+        Callback                    mCallback;
+
+        std::thread                 mWorker;
+        std::atomic_bool            mStopping = false;
+        std::mutex                  mWakeMutex;
+        std::condition_variable     mWake;
+
+        std::atomic_uint64_t        mCompleted = 0;
+        std::atomic_uint64_t        mDropped   = 0;
+        std::atomic_uint64_t        mFailed    = 0;
+
+    public:
+        ~AsyncReadback();
+
+        explicit AsyncReadback(_In_ const winrt::com_ptr<ID3D11Device>& Device);
+        AsyncReadback(      AsyncReadback&&) = delete;
+        AsyncReadback(const AsyncReadback& ) = delete;
+        AsyncReadback& operator=(      AsyncReadback&&) = delete;
+        AsyncReadback& operator=(const AsyncReadback& ) = delete;
+
+        // Slots is the number of frames that can be on their way back. The callback runs on the worker thread.
+        winrt::hresult Start(_In_ const Callback& Handler, _In_opt_ uint32_t Slots = DEFAULT_READBACK_SLOTS);
+
+        // Hands the frames already copied to the callback, then joins the worker thread.
+        winrt::hresult Stop();
+
+        [[nodiscard]] bool IsActive();
+
+        // Render thread. Returns false if the frame was dropped. DirtyRects may be nullptr when the whole frame changed.
+        // Region limits the copy to part of the surface, the frame handed to the callback is then the size of Region.
+        bool Enqueue(_In_ ID3D11Texture2D* Surface, _In_ uint64_t Sequence, _In_opt_ const std::vector<RECT>* DirtyRects = nullptr,
+            _In_opt_ const D3D11_BOX* Region = nullptr);
+
+        [[nodiscard]] AsyncReadbackStatistics GetStatistics() const;
+
+    private:
+        void Run();
+
+        bool MapSlot(_In_ Slot& Item);
+    };
+}
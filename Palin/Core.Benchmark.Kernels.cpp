@@ -0,0 +1,432 @@
+#include "Core.Benchmark.h"
+#include "Core.FrameTiming.h"
+#include "Core.FrameBarcode.h"
+#include "Core.FrameChecksum.h"
+#include "Core.TestPattern.h"
+#include "Core.SharedFrameRing.h"
+#include "Core.Logger.h"
+#include "Core.Trace.h"
+#include "Core.WindowRegistry.h"
+#include "Core.TrigramIndex.h"
+
+
+namespace Mi::Core
+{
+    static constexpr uint32_t BENCHMARK_WIDTH  = 1920;
+    static constexpr uint32_t BENCHMARK_HEIGHT = 1080;
+    static constexpr uint32_t BENCHMARK_PITCH  = BENCHMARK_WIDTH * 4;
+    static constexpr uint64_t BENCHMARK_FRAME_BYTES = static_cast<uint64_t>(BENCHMARK_PITCH) * BENCHMARK_HEIGHT;
+
+    static void AddTestPatternBenchmarks(_Inout_ BenchmarkSuite& Suite)
+    {
+        const auto Frame = std::make_shared<std::vector<uint8_t>>(BENCHMARK_FRAME_BYTES);
+
+        for (const auto Pattern : { TestPattern::Gradient, TestPattern::Checkerboard, TestPattern::ScrollingText, TestPattern::Noise }) {
+            Suite.Add(std::string("pattern.") + GetTestPatternName(Pattern) + ".1080p", [Frame, Pattern](uint64_t Iterations)
+            {
+                for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                    DrawTestPattern(Pattern, Index, Frame->data(), BENCHMARK_PITCH, BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+                }
+                KeepValue((*Frame)[Iterations % Frame->size()]);
+                return true;
+            }, BENCHMARK_FRAME_BYTES);
+        }
+
+        // Only the strip is touched, the rest of the frame does not matter
+        const uint32_t StripHeight = GetFrameBarcodeHeight(BENCHMARK_WIDTH);
+        const auto Strip = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(BENCHMARK_PITCH) * StripHeight);
+
+        Suite.Add("barcode.write.1080p", [Strip, StripHeight](uint64_t Iterations)
+        {
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                (void)WriteFrameBarcode({ Index, Index * 16'666'667 }, Strip->data(), BENCHMARK_PITCH, BENCHMARK_WIDTH, StripHeight);
+            }
+            KeepValue((*Strip)[0]);
+            return true;
+        });
+
+        Suite.Add("barcode.read.1080p", [Strip, StripHeight](uint64_t Iterations)
+        {
+            (void)WriteFrameBarcode({ 1, 2 }, Strip->data(), BENCHMARK_PITCH, BENCHMARK_WIDTH, StripHeight);
+
+            uint64_t Decoded = 0;
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                const auto Barcode = ReadFrameBarcode(Strip->data(), BENCHMARK_PITCH, BENCHMARK_WIDTH, StripHeight);
+                Decoded += Barcode ? Barcode->Sequence : 0;
+            }
+            KeepValue(Decoded);
+            return Decoded == Iterations;
+        });
+    }
+
+    // The CPU reference of Shader.FrameChecksum.hlsl, over a frame that is not all zeros
+    static void AddChecksumBenchmarks(_Inout_ BenchmarkSuite& Suite)
+    {
+        const auto Frame = std::make_shared<std::vector<uint8_t>>(BENCHMARK_FRAME_BYTES);
+        DrawTestPattern(TestPattern::Noise, 0, Frame->data(), BENCHMARK_PITCH, BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+
+        const auto Checksums = std::make_shared<std::vector<uint32_t>>(
+            static_cast<size_t>(GetChecksumTilesX(BENCHMARK_WIDTH)) * GetChecksumTilesY(BENCHMARK_HEIGHT));
+
+        Suite.Add("frame_checksum.cpu.1080p", [Frame, Checksums](uint64_t Iterations)
+        {
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                ComputeTileChecksums(Frame->data(), BENCHMARK_WIDTH, BENCHMARK_HEIGHT, BENCHMARK_PITCH, Checksums->data());
+            }
+            KeepValue((*Checksums)[Iterations % Checksums->size()]);
+            return true;
+        }, BENCHMARK_FRAME_BYTES);
+    }
+
+    static void AddQueueBenchmarks(_Inout_ BenchmarkSuite& Suite)
+    {
+        // Single threaded, the cost of the operations without contention
+        Suite.Add("spsc_ring.push_pop", [](uint64_t Iterations)
+        {
+            const auto Ring = std::make_unique<SpscRing<FrameTimingSample, 1024>>();
+
+            FrameTimingSample Sample{};
+            uint64_t Popped = 0;
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                Sample.FrameNumber = Index;
+                (void)Ring->Push(Sample);
+                if (Ring->Pop(Sample)) {
+                    ++Popped;
+                }
+            }
+            KeepValue(Popped);
+            return true;
+        });
+
+        // Producer and consumer on their own threads, the ring bouncing between two cores
+        Suite.Add("spsc_ring.two_threads", [](uint64_t Iterations)
+        {
+            const auto Ring = std::make_unique<SpscRing<uint64_t, 1024>>();
+
+            std::thread Consumer([&]
+            {
+                uint64_t Item = 0, Received = 0, Sum = 0;
+                while (Received < Iterations) {
+                    if (Ring->Pop(Item)) {
+                        Sum += Item;
+                        ++Received;
+                    }
+                }
+                KeepValue(Sum);
+            });
+
+            for (uint64_t Index = 0; Index < Iterations; ) {
+                if (Ring->Push(Index)) {
+                    ++Index;
+                }
+            }
+            Consumer.join();
+            return true;
+        });
+
+        Suite.Add("latency_histogram.record", [](uint64_t Iterations)
+        {
+            const auto Histogram = std::make_unique<LatencyHistogram>();
+
+            // Spread over the buckets a frame time falls into
+            uint64_t Value = 1'000'000;
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                Histogram->Record(Value);
+                Value = (Value * 6364136223846793005ull + 1442695040888963407ull) % 50'000'000;
+            }
+            KeepValue(Histogram->GetPercentile(99.0));
+            return true;
+        });
+
+        const size_t RingSize = GetSharedFrameRingSize(3, static_cast<uint32_t>(BENCHMARK_FRAME_BYTES));
+        const auto   Memory   = std::make_shared<std::vector<uint8_t>>(RingSize + SHARED_FRAME_RING_ALIGNMENT);
+        const auto   Pixels   = std::make_shared<std::vector<uint8_t>>(BENCHMARK_FRAME_BYTES);
+        DrawTestPattern(TestPattern::Noise, 0, Pixels->data(), BENCHMARK_PITCH, BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+
+        const auto AlignedRing = [Memory]()
+        {
+            const auto Address = reinterpret_cast<uintptr_t>(Memory->data());
+            return reinterpret_cast<void*>((Address + SHARED_FRAME_RING_ALIGNMENT - 1) & ~static_cast<uintptr_t>(SHARED_FRAME_RING_ALIGNMENT - 1));
+        };
+
+        Suite.Add("shared_frame_ring.write.1080p", [AlignedRing, RingSize, Pixels](uint64_t Iterations)
+        {
+            void* Ring = AlignedRing();
+            if (!SharedFrameRingWriter::Initialize(Ring, RingSize, 3, static_cast<uint32_t>(BENCHMARK_FRAME_BYTES))) {
+                return false;
+            }
+
+            SharedFrameRingWriter Writer(Ring, RingSize);
+            uint64_t Sequence = 0;
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                Sequence = Writer.Write(Pixels->data(), BENCHMARK_WIDTH, BENCHMARK_HEIGHT, BENCHMARK_PITCH, SharedFrameFormat::B8G8R8A8);
+            }
+            KeepValue(Sequence);
+            return Sequence != 0;
+        }, BENCHMARK_FRAME_BYTES);
+
+        Suite.Add("shared_frame_ring.read.1080p", [AlignedRing, RingSize, Pixels](uint64_t Iterations)
+        {
+            void* Ring = AlignedRing();
+            if (!SharedFrameRingWriter::Initialize(Ring, RingSize, 3, static_cast<uint32_t>(BENCHMARK_FRAME_BYTES))) {
+                return false;
+            }
+
+            SharedFrameRingWriter Writer(Ring, RingSize);
+            (void)Writer.Write(Pixels->data(), BENCHMARK_WIDTH, BENCHMARK_HEIGHT, BENCHMARK_PITCH, SharedFrameFormat::B8G8R8A8);
+
+            const SharedFrameRingReader Reader(Ring, RingSize);
+            std::vector<uint8_t> Destination(BENCHMARK_FRAME_BYTES);
+
+            uint64_t Read = 0;
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                const auto Info = Reader.Peek();
+                if (Info && Reader.Read(*Info, Destination.data(), BENCHMARK_PITCH)) {
+                    ++Read;
+                }
+            }
+            KeepValue(Read + Destination[Iterations % Destination.size()]);
+            return Read == Iterations;
+        }, BENCHMARK_FRAME_BYTES);
+    }
+
+    static void AddJsonBenchmarks(_Inout_ BenchmarkSuite& Suite)
+    {
+        // About the size of one stage block of the headless summary
+        Suite.Add("json_writer.stage_block", [](uint64_t Iterations)
+        {
+            JsonWriter Json(true);
+            size_t Written = 0;
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                Json.Clear();
+                Json.BeginObject()
+                    .Member("count", Index)
+                    .Member("mean_ms", 16.6667)
+                    .Member("p50_ms", 16.5)
+                    .Member("p95_ms", 17.25)
+                    .Member("p99_ms", 18.125)
+                    .Member("max_ms", 33.3333)
+                    .EndObject();
+                Written += Json.GetString().size();
+            }
+            KeepValue(Written);
+            return true;
+        });
+    }
+
+    static void AddLoggerBenchmarks(_Inout_ BenchmarkSuite& Suite)
+    {
+        // A typical render thread line, copied into a record without the ring and the clock
+        Suite.Add("logger.record", [](uint64_t Iterations)
+        {
+            LogRecord Record;
+            uint64_t Written = 0;
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                Record.Size = 0;
+                LogDetail::AppendArgument(Record, Index);
+                LogDetail::AppendArgument(Record, 0x887A0005);
+                LogDetail::AppendArgument(Record, "GraphicsRender::EndFrame");
+                Written += Record.Size;
+            }
+            KeepValue(Written);
+            return true;
+        });
+
+        // The whole path per record: the call, then the formatting on the logger thread. Bursts stay below the
+        // ring size so nothing is dropped, the console is off so the terminal does not count
+        Suite.Add("logger.write", [](uint64_t Iterations)
+        {
+            static constexpr uint64_t BURST = 64;
+
+            // Lines logged before still go out
+            Logger::Flush();
+            const bool Console = Logger::IsConsoleEnabled();
+            Logger::SetConsole(false);
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                LOG(INFO, "Benchmark, Frame=%llu, Result=0x%0*X, Source=%s", Index, 8, 0x887A0005, "logger.write");
+                if (Index % BURST == BURST - 1) {
+                    Logger::Flush();
+                }
+            }
+            Logger::Flush();
+            Logger::SetConsole(Console);
+            return true;
+        });
+    }
+
+    static void AddTraceBenchmarks(_Inout_ BenchmarkSuite& Suite)
+    {
+        // What every span in the pipeline costs while tracing is off, and while it is on
+        for (const bool Enabled : { false, true }) {
+            Suite.Add(Enabled ? "trace.span.enabled" : "trace.span.disabled", [Enabled](uint64_t Iterations)
+            {
+                const bool Previous = Trace::IsEnabled();
+                Trace::SetEnabled(Enabled);
+                for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                    const TraceSpan Span("Benchmark::Span");
+                }
+                Trace::SetEnabled(Previous);
+                return true;
+            });
+        }
+    }
+
+    // A desktop of synthetic windows, every fourth one is hidden like the tool and message windows of a real one
+    class BenchmarkWindowProvider final : public IWindowProvider
+    {
+    public:
+        std::vector<WindowId> Windows;
+        uint64_t              Described = 0;
+
+        explicit BenchmarkWindowProvider(_In_ uint32_t Count)
+        {
+            for (uint32_t Index = 0; Index < Count; ++Index) {
+                Windows.push_back(0x10000 + Index * 16);
+            }
+        }
+
+        void EnumerateWindows(_Inout_ std::vector<WindowId>& Result) override
+        {
+            Result.insert(Result.end(), Windows.begin(), Windows.end());
+        }
+
+        bool DescribeWindow(_In_ WindowId Window, _Out_ std::wstring& Title, _Out_ std::wstring& ClassName,
+            _Out_ std::wstring& ProcessName) override
+        {
+            ++Described;
+            Title       = L"Window " + std::to_wstring(Window) + L" - Untitled Document";
+            ClassName   = L"BenchmarkWindowClass";
+            ProcessName = L"Benchmark.exe";
+            return Window % 64 != 0;
+        }
+    };
+
+    static void AddWindowRegistryBenchmarks(_Inout_ BenchmarkSuite& Suite)
+    {
+        static constexpr uint32_t WINDOW_COUNT = 1000;
+
+        // The resync of a dropdown: listed windows keep their names, only the hidden ones are asked again
+        Suite.Add("window_registry.rebuild.1000", [](uint64_t Iterations)
+        {
+            BenchmarkWindowProvider Provider(WINDOW_COUNT);
+            WindowRegistry Registry(Provider);
+            Registry.Rebuild();
+
+            const uint64_t Described = Provider.Described;
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                Registry.Rebuild();
+            }
+            return Provider.Described - Described == Iterations * (WINDOW_COUNT / 4)
+                && Registry.GetEntries().size() == WINDOW_COUNT - WINDOW_COUNT / 4;
+        });
+
+        // One window comes and goes on a busy desktop, the cost of a hook event
+        Suite.Add("window_registry.event.1000", [](uint64_t Iterations)
+        {
+            BenchmarkWindowProvider Provider(WINDOW_COUNT);
+            WindowRegistry Registry(Provider);
+            Registry.Rebuild();
+
+            uint64_t Changes = 0;
+            Registry.SetObserver([&Changes](WindowRegistryAction /*Action*/, uint32_t /*Index*/)
+            {
+                ++Changes;
+            });
+
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                const WindowId Window = Provider.Windows[(Index / 2 * 4 + 1) % WINDOW_COUNT];
+                Registry.OnEvent(Index % 2 == 0 ? WindowEvent::Hidden : WindowEvent::Shown, Window);
+            }
+            // Every hidden window is one that shows again, each event is a change
+            return Changes == Iterations;
+        });
+    }
+
+    // Titles of an operator machine: documents, browser tabs and tools of a few processes, the same words again
+    // and again, which is what makes the postings long
+    static std::shared_ptr<TrigramIndex> CreateBenchmarkTrigramIndex(_In_ uint32_t Count)
+    {
+        static constexpr const wchar_t* WORDS[] = {
+            L"Render", L"Capture", L"Shared", L"Texture", L"Frame", L"Latency", L"Report", L"Budget", L"Shader",
+            L"Profile", L"Session", L"Playback", L"Monitor", L"Display", L"Timeline", L"Export", L"Settings",
+            L"Pipeline", L"Camera", L"Preview", L"Studio", L"Console", L"Output", L"Stream", L"Overlay",
+        };
+        static constexpr std::pair<const wchar_t*, const wchar_t*> PROCESSES[] = {
+            { L"devenv.exe",   L"HwndWrapper[DefaultDomain;;]" },
+            { L"chrome.exe",   L"Chrome_WidgetWin_1"           },
+            { L"Code.exe",     L"Chrome_WidgetWin_1"           },
+            { L"explorer.exe", L"CabinetWClass"                },
+            { L"obs64.exe",    L"Qt5152QWindowIcon"            },
+            { L"notepad.exe",  L"Notepad"                      },
+            { L"Game.exe",     L"UnrealWindow"                 },
+        };
+
+        auto Index = std::make_shared<TrigramIndex>();
+
+        uint64_t State = 0x9E3779B97F4A7C15;
+        const auto Next = [&State](size_t Range)
+        {
+            State = State * 6364136223846793005 + 1442695040888963407;
+            return static_cast<size_t>((State >> 33) % Range);
+        };
+
+        for (uint32_t Item = 0; Item < Count; ++Item) {
+            const auto& [Process, Class] = PROCESSES[Next(std::size(PROCESSES))];
+
+            std::wstring Title = WORDS[Next(std::size(WORDS))];
+            for (size_t Word = Next(4); Word > 0; --Word) {
+                Title += L' ';
+                Title += WORDS[Next(std::size(WORDS))];
+            }
+            Title += L" " + std::to_wstring(Item) + L" - " + std::wstring(Process, wcslen(Process) - 4);
+
+            Index->Insert(0x10000 + Item * 16, Title, Class, Process);
+        }
+
+        return Index;
+    }
+
+    static void AddTrigramIndexBenchmarks(_Inout_ BenchmarkSuite& Suite)
+    {
+        static constexpr uint32_t DOCUMENT_COUNT = 10'000;
+
+        // What the user types, one key at a time, with a typo at the end
+        static constexpr const wchar_t* QUERIES[] = {
+            L"l", L"la", L"lat", L"late", L"laten", L"latency", L"latency rep", L"latency report", L"latnecy report",
+        };
+
+        Suite.Add("trigram_index.search.10k", [Index = CreateBenchmarkTrigramIndex(DOCUMENT_COUNT)](uint64_t Iterations)
+        {
+            std::vector<TrigramMatch> Matches;
+            uint64_t Found = 0;
+            for (uint64_t Item = 0; Item < Iterations; ++Item) {
+                Index->Search(QUERIES[Item % std::size(QUERIES)], 16, Matches);
+                Found += Matches.size();
+            }
+            KeepValue(Found);
+            return Iterations == 0 || Found > 0;
+        });
+
+        // A window renamed, its trigrams leave the postings and the new ones go in
+        Suite.Add("trigram_index.update.10k", [Index = CreateBenchmarkTrigramIndex(DOCUMENT_COUNT)](uint64_t Iterations)
+        {
+            for (uint64_t Item = 0; Item < Iterations; ++Item) {
+                const uint64_t Id = 0x10000 + (Item % DOCUMENT_COUNT) * 16;
+                Index->Insert(Id, L"Capture Preview - Untitled " + std::to_wstring(Item), L"Notepad", L"notepad.exe");
+            }
+            return Index->GetSize() == DOCUMENT_COUNT;
+        });
+    }
+
+    void AddKernelBenchmarks(_Inout_ BenchmarkSuite& Suite)
+    {
+        AddTestPatternBenchmarks(Suite);
+        AddChecksumBenchmarks(Suite);
+        AddQueueBenchmarks(Suite);
+        AddJsonBenchmarks(Suite);
+        AddLoggerBenchmarks(Suite);
+        AddTraceBenchmarks(Suite);
+        AddWindowRegistryBenchmarks(Suite);
+        AddTrigramIndexBenchmarks(Suite);
+    }
+}
@@ -0,0 +1,130 @@
+#include "Core.Benchmark.h"
+
+
+namespace Mi::Core
+{
+    static std::atomic_uint64_t BenchmarkSink = 0;
+
+    void KeepValue(_In_ uint64_t Value) noexcept
+    {
+        BenchmarkSink.fetch_xor(Value, std::memory_order_relaxed);
+    }
+
+    void BenchmarkSuite::Add(_In_ std::string_view Name, _In_ const Body& Run, _In_opt_ uint64_t BytesPerIteration)
+    {
+        mEntries.push_back({ std::string(Name), Run, BytesPerIteration });
+    }
+
+    std::vector<BenchmarkResult> BenchmarkSuite::Run(_In_ const BenchmarkOptions& Options) const
+    {
+        std::vector<BenchmarkResult> Results;
+
+        for (const auto& Item : mEntries) {
+            if (!Options.Filter.empty() && Item.Name.find(Options.Filter) == std::string::npos) {
+                continue;
+            }
+
+            Results.push_back(RunEntry(Item, Options));
+
+            const auto& Result = Results.back();
+            if (Result.Skipped) {
+                LOG(INFO, "BenchmarkSuite::Run(), %s skipped.", Result.Name.c_str());
+            }
+            else {
+                LOG(INFO, "BenchmarkSuite::Run(), %s: median %.1f ns, min %.1f ns, max %.1f ns (%llu x %u)",
+                    Result.Name.c_str(), Result.Median, Result.Minimum, Result.Maximum, Result.Iterations, Result.Samples);
+            }
+        }
+
+        return Results;
+    }
+
+    BenchmarkResult BenchmarkSuite::RunEntry(_In_ const Entry& Item, _In_ const BenchmarkOptions& Options)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        BenchmarkResult Result{};
+        Result.Name  = Item.Name;
+        Result.Bytes = Item.Bytes;
+
+        const auto Time = [&](uint64_t Iterations, std::chrono::nanoseconds& Elapsed)
+        {
+            const auto Start = Clock::now();
+            const bool Ran   = Item.Run(Iterations);
+            Elapsed = Clock::now() - Start;
+            return Ran;
+        };
+
+        // Doubles the count until a run is long enough to scale from, the first call also warms up caches
+        const std::chrono::nanoseconds Target = Options.SampleTime;
+        uint64_t Iterations = 1;
+        std::chrono::nanoseconds Elapsed{ 0 };
+        while (true) {
+            if (!Time(Iterations, Elapsed)) {
+                Result.Skipped = true;
+                return Result;
+            }
+            if (Elapsed >= Target / 8 || Iterations >= (UINT64_MAX >> 2)) {
+                break;
+            }
+            Iterations *= 2;
+        }
+
+        const double PerIteration = static_cast<double>(std::max<int64_t>(Elapsed.count(), 1)) / static_cast<double>(Iterations);
+        Iterations = std::max<uint64_t>(static_cast<uint64_t>(static_cast<double>(Target.count()) / PerIteration), 1);
+
+        std::vector<double> Samples;
+        Samples.reserve(std::max<uint32_t>(Options.Samples, 1));
+        for (uint32_t Sample = 0; Sample < std::max<uint32_t>(Options.Samples, 1); ++Sample) {
+            if (!Time(Iterations, Elapsed)) {
+                Result.Skipped = true;
+                return Result;
+            }
+            Samples.push_back(static_cast<double>(Elapsed.count()) / static_cast<double>(Iterations));
+        }
+
+        std::sort(Samples.begin(), Samples.end());
+
+        double Sum = 0.0;
+        for (const double Value : Samples) {
+            Sum += Value;
+        }
+
+        const size_t Middle = Samples.size() / 2;
+        Result.Iterations = Iterations;
+        Result.Samples    = static_cast<uint32_t>(Samples.size());
+        Result.Minimum    = Samples.front();
+        Result.Maximum    = Samples.back();
+        Result.Mean       = Sum / static_cast<double>(Samples.size());
+        Result.Median     = (Samples.size() % 2) ? Samples[Middle] : (Samples[Middle - 1] + Samples[Middle]) / 2.0;
+        return Result;
+    }
+
+    void BenchmarkSuite::WriteResults(_Inout_ JsonWriter& Json, _In_ const std::vector<BenchmarkResult>& Results)
+    {
+        Json.BeginArray();
+        for (const auto& Result : Results) {
+            Json.BeginObject();
+            Json.Member("name", Result.Name);
+            Json.Member("skipped", Result.Skipped);
+
+            if (!Result.Skipped) {
+                Json.Member("iterations", Result.Iterations);
+                Json.Member("samples", Result.Samples);
+                Json.Member("median_ns", Result.Median);
+                Json.Member("min_ns", Result.Minimum);
+                Json.Member("mean_ns", Result.Mean);
+                Json.Member("max_ns", Result.Maximum);
+
+                if (Result.Bytes && Result.Median > 0.0) {
+                    Json.Member("bytes", Result.Bytes);
+                    // Bytes per nanosecond are gigabytes per second
+                    Json.Member("gb_per_s", static_cast<double>(Result.Bytes) / Result.Median);
+                }
+            }
+
+            Json.EndObject();
+        }
+        Json.EndArray();
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Core.JsonWriter.h"
+
+#include <string>
+
+
+namespace Mi::Core
+{
+    struct BenchmarkOptions
+    {
+        std::chrono::milliseconds SampleTime{ 50 };     // iterations per sample are calibrated to take about this long
+        uint32_t                  Samples = 15;
+        std::string               Filter;               // only benchmarks whose name contains it, all if empty
+    };
+
+    struct BenchmarkResult
+    {
+        std::string Name;
+        bool        Skipped    = false;    // the body could not run here, e.g. a missing GPU feature
+        uint64_t    Iterations = 0;        // per sample
+        uint32_t    Samples    = 0;
+        uint64_t    Bytes      = 0;        // processed per iteration, 0 if throughput does not apply
+
+        // Nanoseconds per iteration over the samples
+        double Minimum = 0.0;
+        double Median  = 0.0;
+        double Mean    = 0.0;
+        double Maximum = 0.0;
+    };
+
+    // Keeps a value alive so the compiler can not drop the work that produced it.
+    void KeepValue(_In_ uint64_t Value) noexcept;
+
+    // A list of named benchmarks and the loop that times them.
+    //
+    // Every body runs its operation Iterations times per call. The suite calibrates the count so a sample takes
+    // about BenchmarkOptions::SampleTime, then reports per-iteration times over the samples. The median is the
+    // figure to compare, the minimum shows the best case and the maximum how noisy the machine was.
+    class BenchmarkSuite
+    {
+    public:
+        // Returns false if the benchmark can not run, it is then reported as skipped.
+        using Body = std::function<bool(_In_ uint64_t Iterations)>;
+
+    private:
+        struct Entry
+        {
+            std::string Name;
+            Body        Run;
+            uint64_t    Bytes = 0;
+        };
+
+        std::vector<Entry> mEntries;
+
+    public:
+        void Add(_In_ std::string_view Name, _In_ const Body& Run, _In_opt_ uint64_t BytesPerIteration = 0);
+
+        [[nodiscard]] std::vector<BenchmarkResult> Run(_In_ const BenchmarkOptions& Options) const;
+
+        // Writes the results as an array of objects, the format the comparison script reads.
+        static void WriteResults(_Inout_ JsonWriter& Json, _In_ const std::vector<BenchmarkResult>& Results);
+
+    private:
+        [[nodiscard]] static BenchmarkResult RunEntry(_In_ const Entry& Item, _In_ const BenchmarkOptions& Options);
+    };
+
+    // The portable micro-benchmarks: test pattern, barcode and tile checksum kernels, the frame queues, the timing
+    // histogram, the logger, the trace spans, the window registry and the window search index.
+    void AddKernelBenchmarks(_Inout_ BenchmarkSuite& Suite);
+}
@@ -93,4 +93,44 @@ namespace Mi::Core
         SetConsoleScreenBufferSize(GetStdHandle(STD_OUTPUT_HANDLE), coninfo.dwSize);
     }
 
+    bool AttachParentConsole()
+    {
+        if (_fileno(stdout) >= 0 && _get_osfhandle(_fileno(stdout)) >= 0) {
+            return true;
+        }
+
+        if (!AttachConsole(ATTACH_PARENT_PROCESS)) {
+            return false;
+        }
+
+        FILE* fp = nullptr;
+
+        freopen_s(&fp, "CONOUT$", "w", stdout);
+        freopen_s(&fp, "CONOUT$", "w", stderr);
+
+        setvbuf(stdout, nullptr, _IONBF, 0);
+        setvbuf(stderr, nullptr, _IONBF, 0);
+
+        return true;
+    }
+
+    FILE* SeparateDataOutput()
+    {
+        const int Descriptor = _dup(_fileno(stdout));
+        if (Descriptor < 0) {
+            return stdout;
+        }
+
+        // Lines logged so far still belong on the original stdout
+        Logger::Flush();
+        (void)fflush(stdout);
+        if (_dup2(_fileno(stderr), _fileno(stdout)) != 0) {
+            (void)_close(Descriptor);
+            return stdout;
+        }
+
+        FILE* Output = _fdopen(Descriptor, "w");
+        return Output ? Output : stdout;
+    }
+
 }
@@ -5,4 +5,12 @@ namespace Mi::Core
     void SetConsoleCodePage (_In_opt_ uint32_t CodePage, _In_opt_ const char* FontName);
     void RedirectIOToConsole(_In_opt_ short MaxConsoleLines);
 
+    // Keeps output that is redirected to a file or a pipe, otherwise writes to the console of the parent process.
+    // Returns false if there is neither.
+    bool AttachParentConsole();
+
+    // Points stdout at stderr, so the log can not mix with machine-readable output, and returns a stream on the
+    // original stdout for that output. Returns stdout itself if the descriptors can not be duplicated.
+    [[nodiscard]] FILE* SeparateDataOutput();
+
 }
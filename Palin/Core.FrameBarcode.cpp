@@ -0,0 +1,133 @@
+#include "Core.FrameBarcode.h"
+
+#include <cstring>
+
+
+namespace Mi::Core
+{
+    static constexpr uint8_t FRAME_BARCODE_SYNC = 0b10110010;
+
+    static uint16_t ComputeCrc16(_In_ const FrameBarcode& Barcode) noexcept
+    {
+        uint8_t Bytes[16];
+        for (int Index = 0; Index < 8; ++Index) {
+            Bytes[Index]     = static_cast<uint8_t>(Barcode.Sequence  >> (56 - Index * 8));
+            Bytes[Index + 8] = static_cast<uint8_t>(Barcode.Timestamp >> (56 - Index * 8));
+        }
+
+        uint16_t Crc = 0xFFFF;
+        for (const uint8_t Byte : Bytes) {
+            Crc ^= static_cast<uint16_t>(Byte << 8);
+            for (int Bit = 0; Bit < 8; ++Bit) {
+                Crc = (Crc & 0x8000) ? static_cast<uint16_t>((Crc << 1) ^ 0x1021) : static_cast<uint16_t>(Crc << 1);
+            }
+        }
+        return Crc;
+    }
+
+    // Cell Index covers [Left, Right) of the width
+    static void GetCellBounds(_In_ uint32_t Index, _In_ uint32_t Width, _Out_ uint32_t& Left, _Out_ uint32_t& Right) noexcept
+    {
+        Left  = static_cast<uint32_t>(static_cast<uint64_t>(Index)     * Width / FRAME_BARCODE_BITS);
+        Right = static_cast<uint32_t>(static_cast<uint64_t>(Index + 1) * Width / FRAME_BARCODE_BITS);
+    }
+
+    uint32_t GetFrameBarcodeHeight(_In_ uint32_t Width) noexcept
+    {
+        if (Width < FRAME_BARCODE_MINIMUM_WIDTH) {
+            return 0;
+        }
+
+        // Square cells, but never so thin that a filtered row loses them
+        return std::max<uint32_t>(Width / FRAME_BARCODE_BITS, 4);
+    }
+
+    bool WriteFrameBarcode(_In_ const FrameBarcode& Barcode,
+        _Out_writes_bytes_(Pitch * Height) uint8_t* Pixels, _In_ uint32_t Pitch, _In_ uint32_t Width, _In_ uint32_t Height) noexcept
+    {
+        const uint32_t StripHeight = GetFrameBarcodeHeight(Width);
+        if (StripHeight == 0 || StripHeight > Height || Pitch < Width * 4) {
+            return false;
+        }
+
+        const uint16_t Crc = ComputeCrc16(Barcode);
+
+        const auto GetBit = [&](uint32_t Index) -> bool
+        {
+            if (Index < 8) {
+                return (FRAME_BARCODE_SYNC >> (7 - Index)) & 1;
+            }
+            Index -= 8;
+            if (Index < 64) {
+                return (Barcode.Sequence >> (63 - Index)) & 1;
+            }
+            Index -= 64;
+            if (Index < 64) {
+                return (Barcode.Timestamp >> (63 - Index)) & 1;
+            }
+            Index -= 64;
+            return (Crc >> (15 - Index)) & 1;
+        };
+
+        // The first row is built once and copied to the others
+        for (uint32_t Index = 0; Index < FRAME_BARCODE_BITS; ++Index) {
+            uint32_t Left, Right;
+            GetCellBounds(Index, Width, Left, Right);
+
+            const uint8_t Value = GetBit(Index) ? 0xFF : 0x00;
+            memset(Pixels + static_cast<size_t>(Left) * 4, Value, static_cast<size_t>(Right - Left) * 4);
+        }
+
+        for (uint32_t Row = 1; Row < StripHeight; ++Row) {
+            memcpy(Pixels + static_cast<size_t>(Row) * Pitch, Pixels, static_cast<size_t>(Width) * 4);
+        }
+
+        return true;
+    }
+
+    std::optional<FrameBarcode> ReadFrameBarcode(
+        _In_reads_bytes_(Pitch * Height) const uint8_t* Pixels, _In_ uint32_t Pitch, _In_ uint32_t Width, _In_ uint32_t Height) noexcept
+    {
+        const uint32_t StripHeight = GetFrameBarcodeHeight(Width);
+        if (StripHeight == 0 || StripHeight > Height || Pitch < Width * 4) {
+            return std::nullopt;
+        }
+
+        // The middle row, away from whatever filtering did to the edges of the strip
+        const uint8_t* Row = Pixels + static_cast<size_t>(StripHeight / 2) * Pitch;
+
+        const auto ReadBit = [&](uint32_t Index) -> uint64_t
+        {
+            uint32_t Left, Right;
+            GetCellBounds(Index, Width, Left, Right);
+
+            const uint8_t* Pixel = Row + static_cast<size_t>((Left + Right) / 2) * 4;
+            const uint32_t Luminance = (static_cast<uint32_t>(Pixel[0]) + Pixel[1] + Pixel[2]) / 3;
+            return Luminance >= 0x80 ? 1 : 0;
+        };
+
+        uint32_t Index = 0;
+        const auto ReadBits = [&](uint32_t Count) -> uint64_t
+        {
+            uint64_t Value = 0;
+            for (uint32_t Bit = 0; Bit < Count; ++Bit) {
+                Value = (Value << 1) | ReadBit(Index++);
+            }
+            return Value;
+        };
+
+        if (ReadBits(8) != FRAME_BARCODE_SYNC) {
+            return std::nullopt;
+        }
+
+        FrameBarcode Barcode{};
+        Barcode.Sequence  = ReadBits(64);
+        Barcode.Timestamp = ReadBits(64);
+
+        if (ReadBits(16) != ComputeCrc16(Barcode)) {
+            return std::nullopt;
+        }
+
+        return Barcode;
+    }
+}
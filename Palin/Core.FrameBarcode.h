@@ -0,0 +1,34 @@
+#pragma once
+
+
+namespace Mi::Core
+{
+    // A strip of black and white cells across the top rows of a 32 bit frame that carries its sequence number
+    // and generation timestamp, so a frame read back after Present() tells which source frame it shows.
+    //
+    // Cells are laid out relative to the width, a strip scaled horizontally still decodes. The strip is gray,
+    // the channel order of the frame does not matter.
+    //
+    // Layout: 8 sync bits, 64 bits sequence, 64 bits timestamp, 16 bits CRC-16/CCITT of both, most significant first.
+
+    constexpr uint32_t FRAME_BARCODE_BITS          = 8 + 64 + 64 + 16;
+    constexpr uint32_t FRAME_BARCODE_MINIMUM_WIDTH = FRAME_BARCODE_BITS * 2;
+
+    struct FrameBarcode
+    {
+        uint64_t Sequence  = 0;
+        uint64_t Timestamp = 0;     // nanoseconds, the clock is up to the producer
+    };
+
+    // Rows taken by the strip for a frame of Width, 0 if the frame is too narrow to carry one.
+    [[nodiscard]] uint32_t GetFrameBarcodeHeight(_In_ uint32_t Width) noexcept;
+
+    // Returns false if the frame is too small.
+    bool WriteFrameBarcode(_In_ const FrameBarcode& Barcode,
+        _Out_writes_bytes_(Pitch * Height) uint8_t* Pixels, _In_ uint32_t Pitch, _In_ uint32_t Width, _In_ uint32_t Height) noexcept;
+
+    // Pixels needs the GetFrameBarcodeHeight(Width) top rows only.
+    // Returns std::nullopt if there is no strip or it does not pass the checksum.
+    [[nodiscard]] std::optional<FrameBarcode> ReadFrameBarcode(
+        _In_reads_bytes_(Pitch * Height) const uint8_t* Pixels, _In_ uint32_t Pitch, _In_ uint32_t Width, _In_ uint32_t Height) noexcept;
+}
@@ -0,0 +1,226 @@
+#include "Core.FrameChangeDetector.h"
+
+// Generated by FxCompile into $(IntDir)
+#include "Shader.FrameChecksum.h"
+
+
+namespace Mi::Core
+{
+    struct CHECKSUM_CONSTANTS
+    {
+        UINT Width;
+        UINT Height;
+        UINT TilesX;
+        UINT Reserved;
+    };
+
+    FrameChangeDetector::FrameChangeDetector(_In_ const winrt::com_ptr<ID3D11Device>& Device)
+        : mDevice(Device)
+    {
+        mDevice->GetImmediateContext(mDeviceContext.put());
+
+        if (mDevice->GetFeatureLevel() < D3D_FEATURE_LEVEL_11_0) {
+            return;
+        }
+
+        winrt::check_hresult(mDevice->CreateComputeShader(FRAME_CHECKSUM_SHADER_BYTECODE,
+            sizeof(FRAME_CHECKSUM_SHADER_BYTECODE), nullptr, mComputeShader.put()));
+
+        D3D11_BUFFER_DESC BufferDesc{};
+        BufferDesc.Usage          = D3D11_USAGE_DYNAMIC;
+        BufferDesc.ByteWidth      = sizeof(CHECKSUM_CONSTANTS);
+        BufferDesc.BindFlags      = D3D11_BIND_CONSTANT_BUFFER;
+        BufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        winrt::check_hresult(mDevice->CreateBuffer(&BufferDesc, nullptr, mConstants.put()));
+    }
+
+    bool FrameChangeDetector::IsSupported() const
+    {
+        return !!mComputeShader;
+    }
+
+    FrameChange FrameChangeDetector::Update(_In_ ID3D11Texture2D* Texture)
+    {
+        if (!IsSupported()) {
+            return FrameChange::Unknown;
+        }
+
+        CollectReadbacks();
+
+        if (FAILED(CreateSourceResources(Texture))) {
+            return FrameChange::Unknown;
+        }
+
+        // Every staging buffer is still in flight, skip this frame rather than wait
+        auto& Target = mReadbacks[mNextReadback];
+        if (Target.InFlight) {
+            return mLastChange;
+        }
+
+        ID3D11ShaderResourceView*  const ShaderResources[] = { mSourceView.get() };
+        ID3D11UnorderedAccessView* const AccessViews[]     = { mChecksumsView.get() };
+        ID3D11Buffer*              const ConstantBuffers[] = { mConstants.get() };
+
+        mDeviceContext->CSSetShader(mComputeShader.get(), nullptr, 0);
+        mDeviceContext->CSSetShaderResources(0, _countof(ShaderResources), ShaderResources);
+        mDeviceContext->CSSetUnorderedAccessViews(0, _countof(AccessViews), AccessViews, nullptr);
+        mDeviceContext->CSSetConstantBuffers(0, _countof(ConstantBuffers), ConstantBuffers);
+
+        mDeviceContext->Dispatch(GetChecksumTilesX(mSourceDesc.Width), GetChecksumTilesY(mSourceDesc.Height), 1);
+
+        // Unbind, the texture may be bound as a pixel shader input by the renderer next
+        ID3D11ShaderResourceView*  const NullResources[]   = { nullptr };
+        ID3D11UnorderedAccessView* const NullAccessViews[] = { nullptr };
+        mDeviceContext->CSSetShaderResources(0, _countof(NullResources), NullResources);
+        mDeviceContext->CSSetUnorderedAccessViews(0, _countof(NullAccessViews), NullAccessViews, nullptr);
+
+        mDeviceContext->CopyResource(Target.Staging.get(), mChecksums.get());
+        Target.InFlight = true;
+        mNextReadback   = (mNextReadback + 1) % READBACK_DEPTH;
+
+        return mLastChange;
+    }
+
+    void FrameChangeDetector::Reset()
+    {
+        mSource        = nullptr;
+        mSourceView    = nullptr;
+        mSourceDesc    = {};
+        mChecksums     = nullptr;
+        mChecksumsView = nullptr;
+        mReadbacks     = {};
+        mNextReadback  = 0;
+        mTileCount     = 0;
+        mLastChange    = FrameChange::Unknown;
+        mLastChecksums.clear();
+    }
+
+    winrt::hresult FrameChangeDetector::CreateSourceResources(_In_ ID3D11Texture2D* Texture)
+    {
+        D3D11_TEXTURE2D_DESC TextureDesc{};
+        Texture->GetDesc(&TextureDesc);
+
+        if (TextureDesc.Format != DXGI_FORMAT_B8G8R8A8_UNORM) {
+            return DXGI_ERROR_UNSUPPORTED;
+        }
+
+        if (mSource.get() == Texture && mSourceView) {
+            return S_OK;
+        }
+
+        const bool SizeChanged = TextureDesc.Width != mSourceDesc.Width || TextureDesc.Height != mSourceDesc.Height;
+        if (SizeChanged) {
+            Reset();
+        }
+
+        // Another texture of the same size, like the two upload surfaces of a source taking turns
+        mSource     = nullptr;
+        mSourceView = nullptr;
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC ShaderDesc{};
+        ShaderDesc.Format                    = TextureDesc.Format;
+        ShaderDesc.ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D;
+        ShaderDesc.Texture2D.MostDetailedMip = 0;
+        ShaderDesc.Texture2D.MipLevels       = 1;
+
+        winrt::hresult Result = mDevice->CreateShaderResourceView(Texture, &ShaderDesc, mSourceView.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        mSource.copy_from(Texture);
+        mSourceDesc = TextureDesc;
+
+        if (!SizeChanged) {
+            return S_OK;
+        }
+
+        const UINT TilesX = GetChecksumTilesX(TextureDesc.Width);
+        mTileCount = static_cast<size_t>(TilesX) * GetChecksumTilesY(TextureDesc.Height);
+
+        D3D11_BUFFER_DESC BufferDesc{};
+        BufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+        BufferDesc.ByteWidth           = static_cast<UINT>(mTileCount * sizeof(uint32_t));
+        BufferDesc.BindFlags           = D3D11_BIND_UNORDERED_ACCESS;
+        BufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        BufferDesc.StructureByteStride = sizeof(uint32_t);
+
+        Result = mDevice->CreateBuffer(&BufferDesc, nullptr, mChecksums.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        Result = mDevice->CreateUnorderedAccessView(mChecksums.get(), nullptr, mChecksumsView.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        BufferDesc.Usage          = D3D11_USAGE_STAGING;
+        BufferDesc.BindFlags      = 0;
+        BufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+        for (auto& Readback : mReadbacks) {
+            Result = mDevice->CreateBuffer(&BufferDesc, nullptr, Readback.Staging.put());
+            if (FAILED(Result)) {
+                return Result;
+            }
+        }
+
+        D3D11_MAPPED_SUBRESOURCE Mapped{};
+        Result = mDeviceContext->Map(mConstants.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &Mapped);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        const CHECKSUM_CONSTANTS Constants{ TextureDesc.Width, TextureDesc.Height, TilesX, 0 };
+        memcpy(Mapped.pData, &Constants, sizeof(Constants));
+        mDeviceContext->Unmap(mConstants.get(), 0);
+
+        return S_OK;
+    }
+
+    void FrameChangeDetector::CollectReadbacks()
+    {
+        // Completed readbacks are consumed oldest first, the ring index points at the oldest one.
+        // A change seen by any of them wins, otherwise it would never be presented.
+        bool AnyChanged = false;
+
+        for (size_t Idx = 0; Idx < READBACK_DEPTH; ++Idx) {
+            auto& Readback = mReadbacks[(mNextReadback + Idx) % READBACK_DEPTH];
+            if (!Readback.InFlight) {
+                continue;
+            }
+
+            D3D11_MAPPED_SUBRESOURCE Mapped{};
+            const auto Result = mDeviceContext->Map(Readback.Staging.get(), 0, D3D11_MAP_READ,
+                D3D11_MAP_FLAG_DO_NOT_WAIT, &Mapped);
+            if (Result == DXGI_ERROR_WAS_STILL_DRAWING) {
+                break;
+            }
+
+            Readback.InFlight = false;
+            if (FAILED(Result)) {
+                mLastChange = FrameChange::Unknown;
+                continue;
+            }
+
+            const auto Checksums = static_cast<const uint32_t*>(Mapped.pData);
+            if (mLastChecksums.size() == mTileCount) {
+                mLastChange = CompareTileChecksums(Checksums, mLastChecksums.data(), mTileCount) != 0
+                    ? FrameChange::Changed : FrameChange::Unchanged;
+            }
+            else {
+                mLastChange = FrameChange::Changed;
+            }
+
+            AnyChanged |= mLastChange == FrameChange::Changed;
+
+            mLastChecksums.assign(Checksums, Checksums + mTileCount);
+            mDeviceContext->Unmap(Readback.Staging.get(), 0);
+        }
+
+        if (AnyChanged) {
+            mLastChange = FrameChange::Changed;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "Core.FrameChecksum.h"
+
+
+namespace Mi::Core
+{
+    enum class FrameChange
+    {
+        Unknown,
+        Changed,
+        Unchanged,
+    };
+
+    // Detects whether a texture changed between frames with a GPU tile checksum.
+    //
+    // The checksums are read back through a ring of staging buffers mapped with D3D11_MAP_FLAG_DO_NOT_WAIT,
+    // so the answer lags the GPU by a few frames but never stalls the pipeline.
+    class FrameChangeDetector
+    {
+        static constexpr size_t READBACK_DEPTH = 3;
+
+        struct Readback
+        {
+            winrt::com_ptr<ID3D11Buffer> Staging{};
+            bool                         InFlight = false;
+        };
+
+        winrt::com_ptr<ID3D11Device>              mDevice{};
+        winrt::com_ptr<ID3D11DeviceContext>       mDeviceContext{};
+        winrt::com_ptr<ID3D11ComputeShader>       mComputeShader{};
+        winrt::com_ptr<ID3D11Buffer>              mConstants{};
+        winrt::com_ptr<ID3D11Buffer>              mChecksums{};
+        winrt::com_ptr<ID3D11UnorderedAccessView> mChecksumsView{};
+
+        winrt::com_ptr<ID3D11Texture2D>           mSource{};
+        winrt::com_ptr<ID3D11ShaderResourceView>  mSourceView{};
+        D3D11_TEXTURE2D_DESC                      mSourceDesc{};
+
+        std::array<Readback, READBACK_DEPTH>      mReadbacks{};
+        size_t                                    mNextReadback = 0;
+        size_t                                    mTileCount    = 0;
+
+        std::vector<uint32_t>                     mLastChecksums{};
+        FrameChange                               mLastChange = FrameChange::Unknown;
+
+    public:
+        ~FrameChangeDetector() = default;
+
+        FrameChangeDetector(      FrameChangeDetector&&) = delete;
+        FrameChangeDetector(const FrameChangeDetector& ) = delete;
+        FrameChangeDetector& operator=(      FrameChangeDetector&&) = delete;
+        FrameChangeDetector& operator=(const FrameChangeDetector& ) = delete;
+
+        explicit FrameChangeDetector(_In_ const winrt::com_ptr<ID3D11Device>& Device);
+
+        // Compute shaders need feature level 11_0, only B8G8R8A8 textures are hashed.
+        [[nodiscard]] bool IsSupported() const;
+
+        // Queues a checksum of Texture and returns the newest completed comparison.
+        // Must be called while the caller owns the texture (e.g. inside the keyed mutex).
+        FrameChange Update(_In_ ID3D11Texture2D* Texture);
+
+        void Reset();
+
+    private:
+        winrt::hresult CreateSourceResources(_In_ ID3D11Texture2D* Texture);
+        void CollectReadbacks();
+    };
+}
@@ -0,0 +1,50 @@
+#include "Core.FrameChecksum.h"
+
+
+namespace Mi::Core
+{
+    void ComputeTileChecksums(
+        _In_reads_bytes_(RowPitch * Height) const uint8_t* Pixels,
+        _In_ const uint32_t Width,
+        _In_ const uint32_t Height,
+        _In_ const uint32_t RowPitch,
+        _Out_writes_(GetChecksumTilesX(Width) * GetChecksumTilesY(Height)) uint32_t* Checksums)
+    {
+        const uint32_t TilesX = GetChecksumTilesX(Width);
+        const uint32_t TilesY = GetChecksumTilesY(Height);
+
+        std::fill_n(Checksums, static_cast<size_t>(TilesX) * TilesY, 0u);
+
+        for (uint32_t Y = 0; Y < Height; ++Y) {
+            const auto Row     = Pixels + static_cast<size_t>(Y) * RowPitch;
+            const auto TileRow = Checksums + static_cast<size_t>(Y / CHECKSUM_TILE_SIZE) * TilesX;
+
+            for (uint32_t TileX = 0; TileX < TilesX; ++TileX) {
+                const uint32_t Begin = TileX * CHECKSUM_TILE_SIZE;
+                const uint32_t End   = std::min(Begin + CHECKSUM_TILE_SIZE, Width);
+
+                // Kept branch-free so the compiler can vectorize it
+                uint32_t Sum = 0;
+                for (uint32_t X = Begin; X < End; ++X) {
+                    uint32_t Pixel;
+                    memcpy(&Pixel, Row + static_cast<size_t>(X) * 4, sizeof(Pixel));
+                    Sum += MixChecksumPixel(Pixel, Y * Width + X);
+                }
+
+                TileRow[TileX] += Sum;
+            }
+        }
+    }
+
+    uint32_t CompareTileChecksums(
+        _In_reads_(Count) const uint32_t* Left,
+        _In_reads_(Count) const uint32_t* Right,
+        _In_ const size_t Count)
+    {
+        uint32_t Differences = 0;
+        for (size_t Idx = 0; Idx < Count; ++Idx) {
+            Differences += Left[Idx] != Right[Idx] ? 1 : 0;
+        }
+        return Differences;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+
+namespace Mi::Core
+{
+    // Tile checksums over a B8G8R8A8 image.
+    //
+    // Every pixel is mixed with its linear index and the results are summed per tile with wrap-around,
+    // so the order of accumulation does not matter. Shader.FrameChecksum.hlsl computes the same values
+    // bit for bit on the GPU; this is the CPU reference for it.
+    constexpr uint32_t CHECKSUM_TILE_SIZE = 32;
+
+    constexpr uint32_t MixChecksumPixel(_In_ uint32_t Pixel, _In_ uint32_t Index) noexcept
+    {
+        uint32_t Hash = Pixel ^ (Index * 0x9E3779B1u);
+        Hash ^= Hash >> 16;
+        Hash *= 0x85EBCA6Bu;
+        Hash ^= Hash >> 13;
+        Hash *= 0xC2B2AE35u;
+        Hash ^= Hash >> 16;
+        return Hash;
+    }
+
+    constexpr uint32_t GetChecksumTilesX(_In_ uint32_t Width) noexcept
+    {
+        return (Width + CHECKSUM_TILE_SIZE - 1) / CHECKSUM_TILE_SIZE;
+    }
+
+    constexpr uint32_t GetChecksumTilesY(_In_ uint32_t Height) noexcept
+    {
+        return (Height + CHECKSUM_TILE_SIZE - 1) / CHECKSUM_TILE_SIZE;
+    }
+
+    // Checksums receives GetChecksumTilesX(Width) * GetChecksumTilesY(Height) values in row-major order.
+    void ComputeTileChecksums(
+        _In_reads_bytes_(RowPitch * Height) const uint8_t* Pixels,
+        _In_ uint32_t Width,
+        _In_ uint32_t Height,
+        _In_ uint32_t RowPitch,
+        _Out_writes_(GetChecksumTilesX(Width) * GetChecksumTilesY(Height)) uint32_t* Checksums);
+
+    // Returns the number of tiles that differ.
+    uint32_t CompareTileChecksums(
+        _In_reads_(Count) const uint32_t* Left,
+        _In_reads_(Count) const uint32_t* Right,
+        _In_ size_t Count);
+}
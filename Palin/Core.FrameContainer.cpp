@@ -0,0 +1,204 @@
+#include "Core.FrameContainer.h"
+#include <cstring>
+
+
+namespace Mi::Core
+{
+    static constexpr uint64_t AlignContainerOffset(_In_ uint64_t Offset) noexcept
+    {
+        return (Offset + FRAME_CONTAINER_ALIGNMENT - 1) & ~static_cast<uint64_t>(FRAME_CONTAINER_ALIGNMENT - 1);
+    }
+
+    // Pixels start on an aligned offset after the dirty rects
+    static constexpr uint64_t GetPixelOffset(_In_ uint32_t DirtyRectCount) noexcept
+    {
+        return AlignContainerOffset(sizeof(FrameRecordHeader) + static_cast<uint64_t>(DirtyRectCount) * sizeof(FrameRect));
+    }
+
+    FrameContainerWriter::~FrameContainerWriter()
+    {
+        (void)Finish();
+    }
+
+    bool FrameContainerWriter::Open(_In_ const std::filesystem::path& Path)
+    {
+        if (mStream.is_open()) {
+            return false;
+        }
+
+        mStream.open(Path, std::ios::binary | std::ios::trunc);
+        if (!mStream) {
+            return false;
+        }
+
+        FrameContainerHeader Header{};
+        Header.Magic   = FRAME_CONTAINER_MAGIC;
+        Header.Version = FRAME_CONTAINER_VERSION;
+
+        mStream.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+        mOffset = sizeof(Header);
+        mIndex.clear();
+
+        return !!mStream;
+    }
+
+    bool FrameContainerWriter::Append(_In_ const FrameRecordHeader& Header,
+        _In_reads_(Header.DirtyRectCount) const FrameRect* DirtyRects, _In_ const uint8_t* Pixels)
+    {
+        if (!mStream.is_open() || !mStream) {
+            return false;
+        }
+
+        static constexpr char Padding[FRAME_CONTAINER_ALIGNMENT]{};
+
+        const uint64_t PixelOffset = GetPixelOffset(Header.DirtyRectCount);
+
+        FrameRecordHeader Record = Header;
+        Record.PayloadSize = static_cast<uint64_t>(Header.Stride) * Header.Height;
+        Record.RecordSize  = AlignContainerOffset(PixelOffset + Record.PayloadSize);
+
+        const uint64_t RectsEnd = sizeof(Record) + static_cast<uint64_t>(Record.DirtyRectCount) * sizeof(FrameRect);
+
+        mStream.write(reinterpret_cast<const char*>(&Record), sizeof(Record));
+        if (Record.DirtyRectCount) {
+            mStream.write(reinterpret_cast<const char*>(DirtyRects),
+                static_cast<std::streamsize>(Record.DirtyRectCount * sizeof(FrameRect)));
+        }
+        mStream.write(Padding, static_cast<std::streamsize>(PixelOffset - RectsEnd));
+        mStream.write(reinterpret_cast<const char*>(Pixels), static_cast<std::streamsize>(Record.PayloadSize));
+        mStream.write(Padding, static_cast<std::streamsize>(Record.RecordSize - PixelOffset - Record.PayloadSize));
+
+        if (!mStream) {
+            return false;
+        }
+
+        mIndex.push_back({ mOffset, Record.Timestamp });
+        mOffset += Record.RecordSize;
+
+        return true;
+    }
+
+    bool FrameContainerWriter::Finish()
+    {
+        if (!mStream.is_open()) {
+            return false;
+        }
+
+        const uint64_t IndexOffset = mOffset;
+        mStream.write(reinterpret_cast<const char*>(mIndex.data()),
+            static_cast<std::streamsize>(mIndex.size() * sizeof(FrameIndexEntry)));
+
+        FrameContainerHeader Header{};
+        Header.Magic       = FRAME_CONTAINER_MAGIC;
+        Header.Version     = FRAME_CONTAINER_VERSION;
+        Header.FrameCount  = mIndex.size();
+        Header.IndexOffset = IndexOffset;
+
+        mStream.seekp(0);
+        mStream.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+        const bool Succeeded = !!mStream;
+        mStream.close();
+        mIndex.clear();
+
+        return Succeeded;
+    }
+
+    bool FrameContainerReader::Open(_In_reads_bytes_(Size) const void* Data, _In_ size_t Size)
+    {
+        mData  = static_cast<const uint8_t*>(Data);
+        mSize  = Size;
+        mIndex = nullptr;
+        mFrameCount = 0;
+        mFinished   = false;
+        mRecoveredIndex.clear();
+
+        if (mData == nullptr || mSize < sizeof(FrameContainerHeader)
+            || reinterpret_cast<uintptr_t>(mData) % alignof(FrameRecordHeader)) {
+            return false;
+        }
+
+        const auto Header = reinterpret_cast<const FrameContainerHeader*>(mData);
+        if (Header->Magic != FRAME_CONTAINER_MAGIC || Header->Version != FRAME_CONTAINER_VERSION) {
+            return false;
+        }
+
+        if (Header->IndexOffset) {
+            const uint64_t IndexSize = Header->FrameCount * sizeof(FrameIndexEntry);
+            if (Header->FrameCount > mSize / sizeof(FrameIndexEntry)
+                || Header->IndexOffset % FRAME_CONTAINER_ALIGNMENT
+                || Header->IndexOffset > mSize || IndexSize > mSize - Header->IndexOffset) {
+                return false;
+            }
+
+            mIndex      = reinterpret_cast<const FrameIndexEntry*>(mData + Header->IndexOffset);
+            mFrameCount = Header->FrameCount;
+            mFinished   = true;
+            return true;
+        }
+
+        // Unfinished, every complete record up to the end of the data is kept
+        uint64_t Offset = sizeof(FrameContainerHeader);
+        while (const auto Record = GetRecord(Offset)) {
+            mRecoveredIndex.push_back({ Offset, Record->Header->Timestamp });
+            Offset += Record->Header->RecordSize;
+        }
+
+        mIndex      = mRecoveredIndex.data();
+        mFrameCount = mRecoveredIndex.size();
+        return true;
+    }
+
+    std::optional<FrameRecordView> FrameContainerReader::GetFrame(_In_ uint64_t Index) const noexcept
+    {
+        if (Index >= mFrameCount) {
+            return std::nullopt;
+        }
+
+        return GetRecord(mIndex[Index].Offset);
+    }
+
+    std::optional<uint64_t> FrameContainerReader::FindFrame(_In_ uint64_t Timestamp) const noexcept
+    {
+        const auto End  = mIndex + mFrameCount;
+        const auto Next = std::upper_bound(mIndex, End, Timestamp,
+            [](uint64_t Value, const FrameIndexEntry& Entry) { return Value < Entry.Timestamp; });
+
+        if (Next == mIndex) {
+            return std::nullopt;
+        }
+
+        return static_cast<uint64_t>(Next - mIndex - 1);
+    }
+
+    std::optional<FrameRecordView> FrameContainerReader::GetRecord(_In_ uint64_t Offset) const noexcept
+    {
+        if (Offset % FRAME_CONTAINER_ALIGNMENT || Offset > mSize || mSize - Offset < sizeof(FrameRecordHeader)) {
+            return std::nullopt;
+        }
+
+        const auto Header = reinterpret_cast<const FrameRecordHeader*>(mData + Offset);
+
+        // The file may be truncated or damaged, nothing in a record is trusted
+        const uint64_t Available = mSize - Offset;
+        if (Header->DirtyRectCount > Available / sizeof(FrameRect) || Header->PayloadSize > Available) {
+            return std::nullopt;
+        }
+
+        const uint64_t PixelOffset = GetPixelOffset(Header->DirtyRectCount);
+        if (Header->PayloadSize != static_cast<uint64_t>(Header->Stride) * Header->Height
+            || Header->RecordSize < PixelOffset + Header->PayloadSize
+            || Header->RecordSize % FRAME_CONTAINER_ALIGNMENT
+            || Header->RecordSize > Available) {
+            return std::nullopt;
+        }
+
+        FrameRecordView View{};
+        View.Header     = Header;
+        View.DirtyRects = Header->DirtyRectCount
+            ? reinterpret_cast<const FrameRect*>(mData + Offset + sizeof(FrameRecordHeader)) : nullptr;
+        View.Pixels     = mData + Offset + PixelOffset;
+
+        return View;
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <fstream>
+
+
+namespace Mi::Core
+{
+    // Raw frame recording.
+    //
+    // Layout, every part aligned to FRAME_CONTAINER_ALIGNMENT so a mapped file can be read in place:
+    //   FrameContainerHeader
+    //   FrameCount x { FrameRecordHeader, DirtyRectCount x FrameRect, pixels }
+    //   FrameCount x FrameIndexEntry
+    //
+    // The header is patched with the index position when the recording is finished. A file without one,
+    // from a recording that did not finish, is read by walking the records instead.
+
+    constexpr uint32_t FRAME_CONTAINER_MAGIC     = 0x43524C50;  // "PLRC"
+    constexpr uint32_t FRAME_CONTAINER_VERSION   = 1;
+    constexpr uint32_t FRAME_CONTAINER_ALIGNMENT = 64;
+
+    struct FrameContainerHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint64_t FrameCount;
+        uint64_t IndexOffset;   // 0 until the recording is finished
+        uint64_t Reserved[5];
+    };
+
+    struct FrameRect
+    {
+        int32_t Left;
+        int32_t Top;
+        int32_t Right;
+        int32_t Bottom;
+    };
+
+    struct FrameRecordHeader
+    {
+        uint64_t Timestamp;         // nanoseconds since the recording started
+        uint64_t Sequence;          // source frame generation, 0 if unknown
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t Stride;
+        uint32_t Format;            // DXGI_FORMAT
+        uint32_t DirtyRectCount;    // 0 if the whole frame changed
+        uint32_t Reserved;
+        uint64_t PayloadSize;       // Stride * Height
+        uint64_t RecordSize;        // up to the next record or the index, including padding
+    };
+
+    struct FrameIndexEntry
+    {
+        uint64_t Offset;
+        uint64_t Timestamp;
+    };
+
+    static_assert(sizeof(FrameContainerHeader) == FRAME_CONTAINER_ALIGNMENT);
+    static_assert(sizeof(FrameRecordHeader) % 8 == 0);
+
+    struct FrameRecordView
+    {
+        const FrameRecordHeader* Header     = nullptr;
+        const FrameRect*         DirtyRects = nullptr;
+        const uint8_t*           Pixels     = nullptr;
+    };
+
+    class FrameContainerWriter
+    {
+        std::ofstream                mStream;
+        uint64_t                     mOffset = 0;
+        std::vector<FrameIndexEntry> mIndex;
+
+    public:
+        FrameContainerWriter() = default;
+        ~FrameContainerWriter();
+
+        FrameContainerWriter(      FrameContainerWriter&&) = delete;
+        FrameContainerWriter(const FrameContainerWriter& ) = delete;
+        FrameContainerWriter& operator=(      FrameContainerWriter&&) = delete;
+        FrameContainerWriter& operator=(const FrameContainerWriter& ) = delete;
+
+        bool Open(_In_ const std::filesystem::path& Path);
+
+        // Pixels holds Height rows of Stride bytes, RecordSize and PayloadSize of Header are filled in.
+        bool Append(_In_ const FrameRecordHeader& Header, _In_reads_(Header.DirtyRectCount) const FrameRect* DirtyRects,
+            _In_ const uint8_t* Pixels);
+
+        // Writes the index and patches the header. Also called by the destructor.
+        bool Finish();
+
+        [[nodiscard]] bool     IsOpen() const noexcept { return mStream.is_open(); }
+        [[nodiscard]] uint64_t GetFrameCount() const noexcept { return mIndex.size(); }
+        [[nodiscard]] uint64_t GetSize() const noexcept { return mOffset; }
+    };
+
+    // Reads a container that is mapped or loaded into memory.
+    class FrameContainerReader
+    {
+        const uint8_t* mData = nullptr;
+        size_t         mSize = 0;
+
+        // Points into the file, or into mRecoveredIndex for a recording that did not finish
+        const FrameIndexEntry*       mIndex = nullptr;
+        uint64_t                     mFrameCount = 0;
+        std::vector<FrameIndexEntry> mRecoveredIndex;
+        bool                         mFinished = false;
+
+    public:
+        FrameContainerReader() = default;
+        FrameContainerReader(      FrameContainerReader&&) = delete;
+        FrameContainerReader(const FrameContainerReader& ) = delete;
+        FrameContainerReader& operator=(      FrameContainerReader&&) = delete;
+        FrameContainerReader& operator=(const FrameContainerReader& ) = delete;
+
+        // Returns false if Data is not a container. Data must stay valid while the reader is used.
+        bool Open(_In_reads_bytes_(Size) const void* Data, _In_ size_t Size);
+
+        [[nodiscard]] uint64_t GetFrameCount() const noexcept { return mFrameCount; }
+        [[nodiscard]] bool     IsFinished() const noexcept { return mFinished; }
+
+        [[nodiscard]] std::optional<FrameRecordView> GetFrame(_In_ uint64_t Index) const noexcept;
+
+        // Index of the last frame with a timestamp at or before Timestamp, std::nullopt if there is none.
+        [[nodiscard]] std::optional<uint64_t> FindFrame(_In_ uint64_t Timestamp) const noexcept;
+
+    private:
+        [[nodiscard]] std::optional<FrameRecordView> GetRecord(_In_ uint64_t Offset) const noexcept;
+    };
+}
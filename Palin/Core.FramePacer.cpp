@@ -0,0 +1,160 @@
+#include "Core.FramePacer.h"
+
+
+namespace Mi::Core
+{
+    static std::chrono::nanoseconds RateToInterval(_In_ const double Rate)
+    {
+        if (Rate <= 0.0) {
+            return std::chrono::nanoseconds(0);
+        }
+
+        return std::chrono::nanoseconds(static_cast<int64_t>(1'000'000'000.0 / Rate));
+    }
+
+    std::chrono::nanoseconds FramePacer::SteadyClock()
+    {
+        return std::chrono::steady_clock::now().time_since_epoch();
+    }
+
+    FramePacer::FramePacer(_In_opt_ Clock Clock)
+        : mClock(Clock ? std::move(Clock) : SteadyClock)
+    {
+    }
+
+    void FramePacer::SetPolicy(_In_ const FramePacingPolicy Policy, _In_opt_ const double TargetRate)
+    {
+        mPolicy         = Policy;
+        mTargetInterval = RateToInterval(TargetRate);
+
+        Reset();
+    }
+
+    void FramePacer::SetRefreshRate(_In_ const double RefreshRate)
+    {
+        mRefreshInterval = RateToInterval(RefreshRate);
+    }
+
+    FramePacingPolicy FramePacer::GetPolicy() const
+    {
+        return mPolicy;
+    }
+
+    std::chrono::nanoseconds FramePacer::GetSourceInterval() const
+    {
+        return mSourceInterval;
+    }
+
+    void FramePacer::OnSourceFrame()
+    {
+        const auto Now = mClock();
+
+        if (mLastSourceFrame) {
+            const auto Interval = Now - *mLastSourceFrame;
+
+            // Exponential moving average, 1/8 weight for the newest sample
+            if (mSourceInterval.count() == 0) {
+                mSourceInterval = Interval;
+            }
+            else {
+                mSourceInterval += (Interval - mSourceInterval) / 8;
+            }
+        }
+
+        mLastSourceFrame = Now;
+        ++mPendingSourceFrames;
+    }
+
+    void FramePacer::OnFrameStart()
+    {
+        mFrameStart = mClock();
+    }
+
+    void FramePacer::OnPresented()
+    {
+        const auto Now = mClock();
+
+        if (mPolicy == FramePacingPolicy::FixedRate && mTargetInterval.count() > 0) {
+            // Keep the cadence, but do not try to catch up after a long stall
+            if (!mNextDeadline || Now - *mNextDeadline > mTargetInterval) {
+                mNextDeadline = Now + mTargetInterval;
+            }
+            else {
+                mNextDeadline = *mNextDeadline + mTargetInterval;
+            }
+        }
+
+        if (mFrameStart) {
+            mLastFrameTime = Now - *mFrameStart;
+            mFrameStart.reset();
+        }
+
+        mPendingSourceFrames = 0;
+    }
+
+    FramePacingDecision FramePacer::Decide()
+    {
+        FramePacingDecision Decision{};
+        const auto Now = mClock();
+
+        switch (mPolicy) {
+            default:
+            case FramePacingPolicy::VSync:
+            {
+                break;
+            }
+            case FramePacingPolicy::FixedRate:
+            {
+                Decision.SyncInterval = 0;
+
+                if (mNextDeadline && *mNextDeadline > Now) {
+                    Decision.Delay = *mNextDeadline - Now;
+                }
+                break;
+            }
+            case FramePacingPolicy::MatchSource:
+            {
+                if (mPendingSourceFrames == 0) {
+                    Decision.Present = false;
+
+                    // Sleep until the next source frame is expected
+                    if (mLastSourceFrame && mSourceInterval.count() > 0) {
+                        const auto Expected = *mLastSourceFrame + mSourceInterval;
+                        if (Expected > Now) {
+                            Decision.Delay = Expected - Now;
+                        }
+                    }
+                }
+                break;
+            }
+            case FramePacingPolicy::Uncapped:
+            {
+                Decision.SyncInterval = 0;
+                Decision.AllowTearing = true;
+                break;
+            }
+            case FramePacingPolicy::AdaptiveVSync:
+            {
+                // Late when the work of the last frame missed the vblank it started for (with 1/8 slack),
+                // a slow source leaves long gaps between presents but every frame is still on time
+                if (mRefreshInterval.count() > 0 && mLastFrameTime > mRefreshInterval + mRefreshInterval / 8) {
+                    Decision.SyncInterval = 0;
+                    Decision.AllowTearing = true;
+                }
+                break;
+            }
+        }
+
+        return Decision;
+    }
+
+    void FramePacer::Reset()
+    {
+        mFrameStart.reset();
+        mLastFrameTime = std::chrono::nanoseconds(0);
+        mNextDeadline.reset();
+        mLastSourceFrame.reset();
+        mSourceInterval      = std::chrono::nanoseconds(0);
+        mPendingSourceFrames = 0;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+
+namespace Mi::Core
+{
+    enum class FramePacingPolicy
+    {
+        VSync,          // present every frame on the next vblank
+        FixedRate,      // cap at a target rate, without tearing
+        MatchSource,    // present once per source frame, at the source cadence
+        Uncapped,       // present as fast as possible, tearing allowed
+        AdaptiveVSync,  // vsync while on time, tear when a frame is late
+    };
+
+    struct FramePacingDecision
+    {
+        bool     Present      = true;
+        uint32_t SyncInterval = 1;
+        bool     AllowTearing = false;
+
+        // Time to wait before drawing, so the frame that is presented is the freshest one
+        std::chrono::nanoseconds Delay{ 0 };
+    };
+
+    // Decides when and how the render thread presents.
+    // The clock is injectable, so the policies do not depend on real time.
+    class FramePacer
+    {
+    public:
+        using Clock = std::function<std::chrono::nanoseconds()>;
+
+        static std::chrono::nanoseconds SteadyClock();
+
+    private:
+        Clock                    mClock;
+        FramePacingPolicy        mPolicy = FramePacingPolicy::VSync;
+        std::chrono::nanoseconds mTargetInterval { 0 };
+        std::chrono::nanoseconds mRefreshInterval{ 0 };
+
+        std::optional<std::chrono::nanoseconds> mFrameStart{};
+        std::chrono::nanoseconds mLastFrameTime{ 0 };      // from OnFrameStart() to OnPresented()
+        std::optional<std::chrono::nanoseconds> mNextDeadline{};
+        std::optional<std::chrono::nanoseconds> mLastSourceFrame{};
+        std::chrono::nanoseconds mSourceInterval{ 0 };
+        uint64_t                 mPendingSourceFrames = 0;
+
+    public:
+        explicit FramePacer(_In_opt_ Clock Clock = SteadyClock);
+
+        // TargetRate is in frames per second and only used by FixedRate.
+        void SetPolicy(_In_ FramePacingPolicy Policy, _In_opt_ double TargetRate = 0.0);
+        void SetRefreshRate(_In_ double RefreshRate);
+
+        [[nodiscard]] FramePacingPolicy GetPolicy() const;
+        [[nodiscard]] std::chrono::nanoseconds GetSourceInterval() const;
+
+        // Once per new source frame, not for redraws of a frame that was presented before.
+        void OnSourceFrame();
+
+        // The render thread starts the work of a frame, acquire and draw. Time spent waiting for the source
+        // before it is not part of the frame, AdaptiveVSync only counts a frame late for its own work.
+        void OnFrameStart();
+        void OnPresented();
+
+        [[nodiscard]] FramePacingDecision Decide();
+
+        void Reset();
+    };
+}
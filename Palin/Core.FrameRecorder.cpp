@@ -0,0 +1,116 @@
+#include "Core.FrameRecorder.h"
+
+
+namespace Mi::Core
+{
+    FrameRecorder::~FrameRecorder()
+    {
+        (void)Stop();
+    }
+
+    FrameRecorder::FrameRecorder(_In_ const winrt::com_ptr<ID3D11Device>& Device)
+        : mReadback(Device)
+    {
+    }
+
+    winrt::hresult FrameRecorder::Start(_In_ const std::filesystem::path& Path, _In_opt_ uint32_t Slots)
+    {
+        if (mReadback.IsActive() || mContainer.IsOpen()) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        if (!mContainer.Open(Path)) {
+            LOG(ERROR, "FrameRecorder::Start(), can not create %ls.", Path.c_str());
+            return HRESULT_FROM_WIN32(ERROR_OPEN_FAILED);
+        }
+
+        mStartTime = std::chrono::steady_clock::now();
+        mRecorded  = 0;
+        mFailed    = 0;
+        mBytes     = 0;
+
+        const winrt::hresult Result = mReadback.Start([this](const ReadbackFrame& Frame) { WriteFrame(Frame); }, Slots);
+        if (FAILED(Result)) {
+            LOG(ERROR, "FrameRecorder::Start(), AsyncReadback::Start failed, Result=0x%0*X", 8, Result.value);
+            (void)mContainer.Finish();
+            return Result;
+        }
+
+        LOG(INFO, "FrameRecorder::Start(), Path=%ls, Slots=%u", Path.c_str(), Slots);
+        return S_OK;
+    }
+
+    winrt::hresult FrameRecorder::Stop()
+    {
+        if (mReadback.Stop() != S_OK) {
+            return S_FALSE;
+        }
+
+        if (!mContainer.Finish()) {
+            LOG(ERROR, "FrameRecorder::Stop(), the index of the recording could not be written.");
+        }
+
+        const auto Statistics = GetStatistics();
+        LOG(INFO, "FrameRecorder::Stop(), statistics:"
+            "\n\t Recorded = %llu"
+            "\n\t Dropped  = %llu"
+            "\n\t Failed   = %llu"
+            "\n\t Bytes    = %llu",
+            Statistics.Recorded, Statistics.Dropped, Statistics.Failed, Statistics.Bytes);
+
+        return S_OK;
+    }
+
+    bool FrameRecorder::IsRecording()
+    {
+        return mReadback.IsActive();
+    }
+
+    void FrameRecorder::Record(_In_ ID3D11Texture2D* Surface, _In_ uint64_t Sequence,
+        _In_opt_ const std::vector<RECT>* DirtyRects)
+    {
+        (void)mReadback.Enqueue(Surface, Sequence, DirtyRects);
+    }
+
+    FrameRecorderStatistics FrameRecorder::GetStatistics() const
+    {
+        const auto Readback = mReadback.GetStatistics();
+
+        FrameRecorderStatistics Statistics{};
+        Statistics.Recorded = mRecorded;
+        Statistics.Dropped  = Readback.Dropped;
+        Statistics.Failed   = Readback.Failed + mFailed;
+        Statistics.Bytes    = mBytes;
+        return Statistics;
+    }
+
+    void FrameRecorder::WriteFrame(_In_ const ReadbackFrame& Frame)
+    {
+        FrameRecordHeader Header{};
+        Header.Timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Frame.Time - mStartTime).count());
+        Header.Sequence  = Frame.Sequence;
+        Header.Width     = Frame.Width;
+        Header.Height    = Frame.Height;
+        Header.Stride    = Frame.RowPitch;
+        Header.Format    = Frame.Format;
+
+        std::vector<FrameRect> DirtyRects;
+        if (Frame.DirtyRects) {
+            DirtyRects.reserve(Frame.DirtyRects->size());
+            for (const auto& Rect : *Frame.DirtyRects) {
+                DirtyRects.push_back({ Rect.left, Rect.top, Rect.right, Rect.bottom });
+            }
+        }
+        Header.DirtyRectCount = static_cast<uint32_t>(DirtyRects.size());
+
+        // Rows are written with the pitch of the mapping, readers use the stride of each record
+        if (mContainer.Append(Header, DirtyRects.data(), Frame.Data)) {
+            ++mRecorded;
+            mBytes += static_cast<uint64_t>(Header.Stride) * Header.Height;
+        }
+        else {
+            ++mFailed;
+        }
+    }
+}
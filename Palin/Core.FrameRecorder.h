@@ -0,0 +1,55 @@
+#pragma once
+#include "Core.FrameContainer.h"
+#include "Core.AsyncReadback.h"
+
+
+namespace Mi::Core
+{
+    struct FrameRecorderStatistics
+    {
+        uint64_t Recorded = 0;  // frames written to the container
+        uint64_t Dropped  = 0;  // frames not recorded because every staging slot was still busy
+        uint64_t Failed   = 0;  // frames lost to a failed map or write
+        uint64_t Bytes    = 0;
+    };
+
+    // Records frames into a FrameContainer without stalling the render thread.
+    //
+    // Frames come back through an AsyncReadback, its worker thread appends them to the container.
+    // When the disk falls behind, the readback slots stay busy and Record() drops the frame instead of waiting.
+    class FrameRecorder
+    {
+        AsyncReadback               mReadback;
+        FrameContainerWriter        mContainer;         // readback worker thread
+        std::chrono::steady_clock::time_point mStartTime{};
+
+        std::atomic_uint64_t        mRecorded = 0;
+        std::atomic_uint64_t        mFailed   = 0;      // write failures, the readback counts its own
+        std::atomic_uint64_t        mBytes    = 0;
+
+    public:
+        ~FrameRecorder();
+
+        explicit FrameRecorder(_In_ const winrt::com_ptr<ID3D11Device>& Device);
+        FrameRecorder(      FrameRecorder&&) = delete;
+        FrameRecorder(const FrameRecorder& ) = delete;
+        FrameRecorder& operator=(      FrameRecorder&&) = delete;
+        FrameRecorder& operator=(const FrameRecorder& ) = delete;
+
+        // Slots is the number of frames that can be on their way to the disk.
+        winrt::hresult Start(_In_ const std::filesystem::path& Path, _In_opt_ uint32_t Slots = DEFAULT_READBACK_SLOTS);
+
+        // Writes the frames already copied, then finishes the container.
+        winrt::hresult Stop();
+
+        [[nodiscard]] bool IsRecording();
+
+        // Render thread. DirtyRects may be nullptr when the whole frame changed.
+        void Record(_In_ ID3D11Texture2D* Surface, _In_ uint64_t Sequence, _In_opt_ const std::vector<RECT>* DirtyRects);
+
+        [[nodiscard]] FrameRecorderStatistics GetStatistics() const;
+
+    private:
+        void WriteFrame(_In_ const ReadbackFrame& Frame);
+    };
+}
@@ -0,0 +1,33 @@
+#include "Core.FrameSignal.h"
+
+
+namespace Mi::Core
+{
+    void FrameSignal::Notify()
+    {
+        {
+            auto Guard = std::unique_lock(mMutex);
+            mSignaled = true;
+        }
+        mCondition.notify_one();
+    }
+
+    void FrameSignal::Reset()
+    {
+        auto Guard = std::unique_lock(mMutex);
+        mSignaled = false;
+    }
+
+    bool FrameSignal::WaitFor(_In_ std::chrono::nanoseconds Timeout)
+    {
+        auto Guard = std::unique_lock(mMutex);
+
+        const auto Signaled = mCondition.wait_for(Guard, Timeout, [this]
+        {
+            return mSignaled;
+        });
+
+        mSignaled = false;
+        return Signaled;
+    }
+}
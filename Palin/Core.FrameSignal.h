@@ -0,0 +1,28 @@
+#pragma once
+#include <condition_variable>
+
+
+namespace Mi::Core
+{
+    // Auto-reset event used to park the render thread until there is work to do.
+    // Capture sources set it when a frame arrives, stop and resize requests set it to wake the thread.
+    class FrameSignal
+    {
+        std::mutex              mMutex;
+        std::condition_variable mCondition;
+        bool                    mSignaled = false;
+
+    public:
+        FrameSignal() = default;
+        FrameSignal(      FrameSignal&&) = delete;
+        FrameSignal(const FrameSignal& ) = delete;
+        FrameSignal& operator=(      FrameSignal&&) = delete;
+        FrameSignal& operator=(const FrameSignal& ) = delete;
+
+        void Notify();
+        void Reset();
+
+        // Returns true if the signal was set before the timeout elapsed, and resets it.
+        bool WaitFor(_In_ std::chrono::nanoseconds Timeout);
+    };
+}
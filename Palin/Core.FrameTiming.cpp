@@ -0,0 +1,150 @@
+#include "Core.FrameTiming.h"
+#include <bit>
+#include <cmath>
+
+
+namespace Mi::Core
+{
+    const char* GetFrameStageName(_In_ const FrameStage Stage) noexcept
+    {
+        switch (Stage) {
+            case FrameStage::Acquire: return "Acquire";
+            case FrameStage::Draw:    return "Draw";
+            case FrameStage::Present: return "Present";
+            case FrameStage::Gpu:     return "Gpu";
+            case FrameStage::Frame:   return "Frame";
+            default:                  return "Unknown";
+        }
+    }
+
+    uint32_t LatencyHistogram::GetBucketIndex(_In_ const uint64_t Value) noexcept
+    {
+        if (Value < SUB_BUCKET_COUNT) {
+            return static_cast<uint32_t>(Value);
+        }
+
+        const uint32_t Major = static_cast<uint32_t>(std::bit_width(Value)) - 1;
+        const uint32_t Minor = static_cast<uint32_t>(Value >> (Major - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+
+        return (Major - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + Minor;
+    }
+
+    uint64_t LatencyHistogram::GetBucketUpperBound(_In_ const uint32_t Index) noexcept
+    {
+        if (Index < SUB_BUCKET_COUNT) {
+            return Index;
+        }
+
+        const uint32_t Major = Index / SUB_BUCKET_COUNT + SUB_BUCKET_BITS - 1;
+        const uint32_t Minor = Index % SUB_BUCKET_COUNT;
+        const uint32_t Shift = Major - SUB_BUCKET_BITS;
+
+        // Lower bound plus the width less one, the end of the top bucket is UINT64_MAX and one past it does not fit
+        const uint64_t Lower = static_cast<uint64_t>(SUB_BUCKET_COUNT + Minor) << Shift;
+        return Lower + ((1ull << Shift) - 1);
+    }
+
+    void LatencyHistogram::Record(_In_ const uint64_t Value) noexcept
+    {
+        ++mBuckets[GetBucketIndex(Value)];
+        ++mCount;
+        mSum += Value;
+        mMin  = std::min(mMin, Value);
+        mMax  = std::max(mMax, Value);
+    }
+
+    void LatencyHistogram::Reset() noexcept
+    {
+        mBuckets.fill(0);
+        mCount = 0;
+        mSum   = 0;
+        mMin   = UINT64_MAX;
+        mMax   = 0;
+    }
+
+    uint64_t LatencyHistogram::GetPercentile(_In_ const double Percentile) const noexcept
+    {
+        if (mCount == 0) {
+            return 0;
+        }
+
+        const double   Clamped = std::clamp(Percentile, 0.0, 100.0);
+        const uint64_t Rank    = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(Clamped / 100.0 * mCount)));
+
+        uint64_t Total = 0;
+        for (uint32_t Index = 0; Index < BUCKET_COUNT; ++Index) {
+            Total += mBuckets[Index];
+            if (Total >= Rank) {
+                return std::clamp(GetBucketUpperBound(Index), GetMin(), mMax);
+            }
+        }
+
+        return mMax;
+    }
+
+    void FrameTimingCollector::Push(_In_ const FrameTimingSample& Sample) noexcept
+    {
+        if (!mRing.Push(Sample)) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Fold samples in when nobody reads the summary for a while, but never wait for a reader
+        if (mRing.Size() >= RING_CAPACITY / 2) {
+            if (std::unique_lock Lock(mMutex, std::try_to_lock); Lock.owns_lock()) {
+                Drain();
+            }
+        }
+    }
+
+    FrameTimingSummary FrameTimingCollector::GetSummary()
+    {
+        std::lock_guard Lock(mMutex);
+        Drain();
+
+        FrameTimingSummary Summary{};
+        Summary.Frames  = mFrames;
+        Summary.Dropped = mDropped.load(std::memory_order_relaxed);
+
+        for (size_t Stage = 0; Stage < FRAME_STAGE_COUNT; ++Stage) {
+            const auto& Histogram = mHistograms[Stage];
+            auto& Result = Summary.Stages[Stage];
+
+            Result.Count = Histogram.GetCount();
+            Result.Mean  = std::chrono::nanoseconds(Histogram.GetMean());
+            Result.P50   = std::chrono::nanoseconds(Histogram.GetPercentile(50.0));
+            Result.P95   = std::chrono::nanoseconds(Histogram.GetPercentile(95.0));
+            Result.P99   = std::chrono::nanoseconds(Histogram.GetPercentile(99.0));
+            Result.Max   = std::chrono::nanoseconds(Histogram.GetMax());
+        }
+
+        return Summary;
+    }
+
+    void FrameTimingCollector::Reset()
+    {
+        std::lock_guard Lock(mMutex);
+        Drain();
+
+        for (auto& Histogram : mHistograms) {
+            Histogram.Reset();
+        }
+        mFrames = 0;
+        mDropped.store(0, std::memory_order_relaxed);
+    }
+
+    void FrameTimingCollector::Drain()
+    {
+        FrameTimingSample Sample;
+        while (mRing.Pop(Sample)) {
+            if (Sample.Nanoseconds[static_cast<size_t>(FrameStage::Frame)] >= 0) {
+                ++mFrames;
+            }
+
+            for (size_t Stage = 0; Stage < FRAME_STAGE_COUNT; ++Stage) {
+                if (Sample.Nanoseconds[Stage] >= 0) {
+                    mHistograms[Stage].Record(static_cast<uint64_t>(Sample.Nanoseconds[Stage]));
+                }
+            }
+        }
+    }
+}
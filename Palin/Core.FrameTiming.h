@@ -0,0 +1,177 @@
+#pragma once
+#include <array>
+
+
+namespace Mi::Core
+{
+    enum class FrameStage : uint32_t
+    {
+        Acquire,    // keyed mutex acquire
+        Draw,       // GraphicsRender::Draw on the CPU
+        Present,    // GraphicsRender::EndFrame
+        Gpu,        // draw on the GPU, from timestamp queries
+        Frame,      // whole frame on the CPU, from the source frame to the present
+        Count,
+    };
+
+    constexpr size_t FRAME_STAGE_COUNT = static_cast<size_t>(FrameStage::Count);
+
+    const char* GetFrameStageName(_In_ FrameStage Stage) noexcept;
+
+    // Durations of one frame, stages that were not measured are negative.
+    struct FrameTimingSample
+    {
+        uint64_t FrameNumber = 0;
+        std::array<int64_t, FRAME_STAGE_COUNT> Nanoseconds{};
+
+        FrameTimingSample()
+        {
+            Nanoseconds.fill(-1);
+        }
+
+        void Set(_In_ FrameStage Stage, _In_ std::chrono::nanoseconds Duration) noexcept
+        {
+            Nanoseconds[static_cast<size_t>(Stage)] = Duration.count();
+        }
+    };
+
+    // Lock-free single producer, single consumer ring. Push fails instead of blocking when it is full.
+    template <typename T, size_t Capacity>
+    class SpscRing
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+        std::array<T, Capacity> mItems{};
+        alignas(64) std::atomic_size_t mHead = 0; // written by the consumer
+        alignas(64) std::atomic_size_t mTail = 0; // written by the producer
+
+    public:
+        bool Push(_In_ const T& Item) noexcept
+        {
+            const size_t Tail = mTail.load(std::memory_order_relaxed);
+            if (Tail - mHead.load(std::memory_order_acquire) == Capacity) {
+                return false;
+            }
+
+            mItems[Tail & (Capacity - 1)] = Item;
+            mTail.store(Tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Push in two steps for items that are too large to build elsewhere and copy: fill the slot that
+        // BeginPush returns, nullptr if the ring is full, then publish it with CommitPush.
+        [[nodiscard]] T* BeginPush() noexcept
+        {
+            const size_t Tail = mTail.load(std::memory_order_relaxed);
+            if (Tail - mHead.load(std::memory_order_acquire) == Capacity) {
+                return nullptr;
+            }
+            return &mItems[Tail & (Capacity - 1)];
+        }
+
+        void CommitPush() noexcept
+        {
+            mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        bool Pop(_Out_ T& Item) noexcept
+        {
+            const size_t Head = mHead.load(std::memory_order_relaxed);
+            if (Head == mTail.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            Item = mItems[Head & (Capacity - 1)];
+            mHead.store(Head + 1, std::memory_order_release);
+            return true;
+        }
+
+        [[nodiscard]] size_t Size() const noexcept
+        {
+            return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+        }
+    };
+
+    // Log-linear histogram of nanosecond durations.
+    // Every power of two is split into 16 buckets, so percentiles are within 1/16 of the recorded value.
+    class LatencyHistogram
+    {
+        static constexpr uint32_t SUB_BUCKET_BITS  = 4;
+        static constexpr uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+        static constexpr uint32_t BUCKET_COUNT     = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+        std::array<uint64_t, BUCKET_COUNT> mBuckets{};
+        uint64_t mCount = 0;
+        uint64_t mSum   = 0;
+        uint64_t mMin   = UINT64_MAX;
+        uint64_t mMax   = 0;
+
+    public:
+        static uint32_t GetBucketIndex(_In_ uint64_t Value) noexcept;
+        static uint64_t GetBucketUpperBound(_In_ uint32_t Index) noexcept;
+
+        void Record(_In_ uint64_t Value) noexcept;
+        void Reset() noexcept;
+
+        [[nodiscard]] uint64_t GetCount() const noexcept { return mCount; }
+        [[nodiscard]] uint64_t GetMin  () const noexcept { return mCount ? mMin : 0; }
+        [[nodiscard]] uint64_t GetMax  () const noexcept { return mMax; }
+        [[nodiscard]] uint64_t GetMean () const noexcept { return mCount ? mSum / mCount : 0; }
+
+        // Percentile in [0, 100], returns 0 for an empty histogram.
+        [[nodiscard]] uint64_t GetPercentile(_In_ double Percentile) const noexcept;
+    };
+
+    struct FrameStageSummary
+    {
+        uint64_t Count = 0;
+        std::chrono::nanoseconds Mean{ 0 };
+        std::chrono::nanoseconds P50 { 0 };
+        std::chrono::nanoseconds P95 { 0 };
+        std::chrono::nanoseconds P99 { 0 };
+        std::chrono::nanoseconds Max { 0 };
+    };
+
+    struct FrameTimingSummary
+    {
+        uint64_t Frames  = 0;
+        uint64_t Dropped = 0;   // samples lost because the ring was full
+        std::array<FrameStageSummary, FRAME_STAGE_COUNT> Stages{};
+
+        [[nodiscard]] const FrameStageSummary& operator[](_In_ FrameStage Stage) const noexcept
+        {
+            return Stages[static_cast<size_t>(Stage)];
+        }
+    };
+
+    // Per-session frame timing.
+    // The render thread pushes samples without locking, readers fold them into the histograms under a mutex.
+    class FrameTimingCollector
+    {
+        static constexpr size_t RING_CAPACITY = 1024;
+
+        SpscRing<FrameTimingSample, RING_CAPACITY> mRing;
+        std::atomic_uint64_t mDropped = 0;
+
+        std::mutex mMutex;
+        std::array<LatencyHistogram, FRAME_STAGE_COUNT> mHistograms{};
+        uint64_t mFrames = 0;
+
+    public:
+        FrameTimingCollector() = default;
+        FrameTimingCollector(      FrameTimingCollector&&) = delete;
+        FrameTimingCollector(const FrameTimingCollector& ) = delete;
+        FrameTimingCollector& operator=(      FrameTimingCollector&&) = delete;
+        FrameTimingCollector& operator=(const FrameTimingCollector& ) = delete;
+
+        // Producer side, called by one thread only. Drains the ring itself when it is half full and no reader holds it.
+        void Push(_In_ const FrameTimingSample& Sample) noexcept;
+
+        // Consumer side.
+        [[nodiscard]] FrameTimingSummary GetSummary();
+        void Reset();
+
+    private:
+        void Drain();
+    };
+}
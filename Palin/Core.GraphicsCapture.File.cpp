@@ -0,0 +1,323 @@
+#include "Core.GraphicsCapture.h"
+
+
+namespace Mi::Core
+{
+    GraphicsCaptureForFile::~GraphicsCaptureForFile()
+    {
+        StopCapture();
+    }
+
+    GraphicsCaptureForFile::GraphicsCaptureForFile(_In_ const winrt::com_ptr<ID3D11Device>& Device)
+        : mDevice(Device)
+        , mUpload(Device)
+    {
+    }
+
+    winrt::hresult GraphicsCaptureForFile::StartCapture(_In_ const std::filesystem::path& Path, _In_opt_ ReplayTiming Timing,
+        _In_opt_ bool Loop)
+    {
+        if (IsValid()) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        mFile = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (mFile == INVALID_HANDLE_VALUE) {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER FileSize{};
+        if (!GetFileSizeEx(mFile, &FileSize)) {
+            const winrt::hresult Result = HRESULT_FROM_WIN32(GetLastError());
+            StopCapture();
+            return Result;
+        }
+
+        if (FileSize.QuadPart < static_cast<LONGLONG>(sizeof(FrameContainerHeader))
+            || static_cast<ULONGLONG>(FileSize.QuadPart) > SIZE_MAX) {
+            StopCapture();
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mMapping == nullptr) {
+            const winrt::hresult Result = HRESULT_FROM_WIN32(GetLastError());
+            StopCapture();
+            return Result;
+        }
+
+        mView = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+        if (mView == nullptr) {
+            const winrt::hresult Result = HRESULT_FROM_WIN32(GetLastError());
+            StopCapture();
+            return Result;
+        }
+
+        if (!mReader.Open(mView, static_cast<size_t>(FileSize.QuadPart)) || mReader.GetFrameCount() == 0) {
+            LOG(ERROR, "GraphicsCaptureForFile::StartCapture(), %ls is not a recording of version %u with frames.",
+                Path.c_str(), FRAME_CONTAINER_VERSION);
+            StopCapture();
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        const uint64_t FrameCount = mReader.GetFrameCount();
+        const uint64_t LastTimestamp = mReader.GetFrame(FrameCount - 1)->Header->Timestamp;
+        mFirstTimestamp = mReader.GetFrame(0)->Header->Timestamp;
+
+        // The last frame stays up for the average frame interval before the replay ends or starts over
+        constexpr uint64_t DEFAULT_INTERVAL = 16'666'667;
+        const uint64_t Span = LastTimestamp - mFirstTimestamp;
+        mDuration = Span + (FrameCount > 1 && Span ? Span / (FrameCount - 1) : DEFAULT_INTERVAL);
+
+        mTiming         = Timing;
+        mLoop           = Loop;
+        mAcquiredFrame  = nullptr;
+        mAcquiredIndex  = 0;
+        mNextIndex      = 0;
+        mStartTime      = std::nullopt;
+        mFinished       = false;
+
+        LOG(INFO, "GraphicsCaptureForFile::StartCapture(), target:"
+            "\n\t Path     = %ls"
+            "\n\t Frames   = %llu"
+            "\n\t Duration = %.3f ms"
+            "\n\t Finished = %d"
+            "\n\t Timing   = %d"
+            "\n\t Loop     = %d",
+            Path.c_str(), FrameCount, static_cast<double>(mDuration) / 1e6, mReader.IsFinished(), mTiming, mLoop);
+
+        return S_OK;
+    }
+
+    winrt::hresult GraphicsCaptureForFile::StopCapture()
+    {
+        mAcquiredFrame = nullptr;
+        mUpload.Reset();
+        (void)mReader.Open(nullptr, 0);
+
+        if (mView) {
+            UnmapViewOfFile(mView);
+            mView = nullptr;
+        }
+        if (mMapping) {
+            CloseHandle(mMapping);
+            mMapping = nullptr;
+        }
+        if (mFile != INVALID_HANDLE_VALUE) {
+            CloseHandle(mFile);
+            mFile = INVALID_HANDLE_VALUE;
+        }
+
+        return S_OK;
+    }
+
+    winrt::hresult GraphicsCaptureForFile::GetDirtyRect(RECT& DirtyRect) const
+    {
+        const auto Frame = mAcquiredFrame;
+        if (Frame == nullptr) {
+            return E_PENDING;
+        }
+
+        if (Frame->DirtyRectsValid) {
+            DirtyRect = {};
+            for (const auto& Rect : Frame->DirtyRects) {
+                (void)UnionRect(&DirtyRect, &DirtyRect, &Rect);
+            }
+            return S_OK;
+        }
+
+        D3D11_TEXTURE2D_DESC TextureDesc{};
+        Frame->Surface->GetDesc(&TextureDesc);
+
+        DirtyRect = { 0, 0, static_cast<LONG>(TextureDesc.Width), static_cast<LONG>(TextureDesc.Height) };
+        return S_OK;
+    }
+
+    HANDLE GraphicsCaptureForFile::GetSurfaceHandle() const
+    {
+        // The surfaces are private to our device
+        return nullptr;
+    }
+
+    winrt::com_ptr<ID3D11Texture2D> GraphicsCaptureForFile::GetSurface() const
+    {
+        const auto Frame = mAcquiredFrame;
+        return Frame ? Frame->Surface : nullptr;
+    }
+
+    GraphicsFrameLease GraphicsCaptureForFile::AcquireFrame() const
+    {
+        if (!IsValid()) {
+            return nullptr;
+        }
+
+        const auto Due = GetDueFrame();
+        if (!Due) {
+            // The last frame stays on screen until the consumer stops the replay
+            if (!mFinished) {
+                mFinished = true;
+
+                LOG(INFO, "GraphicsCaptureForFile::AcquireFrame(), the replay is over.");
+                if (mClosedHandler) {
+                    mClosedHandler(nullptr);
+                }
+            }
+            return mAcquiredFrame;
+        }
+
+        if (mAcquiredFrame == nullptr || *Due != mAcquiredIndex) {
+            (void)UploadFrame(*Due);
+        }
+
+        return mAcquiredFrame;
+    }
+
+    void GraphicsCaptureForFile::OnFrameConsumed(_In_ uint64_t Generation) const
+    {
+        if (mTiming != ReplayTiming::AsFastAsPossible) {
+            return;
+        }
+
+        const auto Frame = mAcquiredFrame;
+        if (Frame && Frame->Generation == Generation) {
+            mNextIndex = mAcquiredIndex + 1;
+        }
+    }
+
+    std::optional<uint64_t> GraphicsCaptureForFile::GetDueFrame() const
+    {
+        const uint64_t FrameCount = mReader.GetFrameCount();
+
+        if (mTiming == ReplayTiming::AsFastAsPossible) {
+            if (!mLoop && mNextIndex >= FrameCount) {
+                return std::nullopt;
+            }
+            return mNextIndex;
+        }
+
+        // The clock starts with the first frame that is asked for, not with StartCapture()
+        const auto Now = std::chrono::steady_clock::now();
+        if (!mStartTime) {
+            mStartTime = Now;
+        }
+
+        const uint64_t Elapsed = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Now - *mStartTime).count());
+
+        const uint64_t Pass = Elapsed / mDuration;
+        if (!mLoop && Pass > 0) {
+            return std::nullopt;
+        }
+
+        const auto Index = mReader.FindFrame(mFirstTimestamp + Elapsed % mDuration);
+        return Pass * FrameCount + Index.value_or(0);
+    }
+
+    bool GraphicsCaptureForFile::UploadFrame(_In_ uint64_t Index) const
+    {
+        const uint64_t FrameCount = mReader.GetFrameCount();
+
+        const auto Record = mReader.GetFrame(Index % FrameCount);
+        if (!Record) {
+            LOG(ERROR, "GraphicsCaptureForFile::UploadFrame(), frame %llu is damaged.", Index % FrameCount);
+            mNextIndex = Index + 1;
+            return false;
+        }
+        const auto& Header = *Record->Header;
+
+        const auto Format = static_cast<DXGI_FORMAT>(Header.Format);
+        if (!UploadSurfaces::IsFormatSupported(Format)) {
+            LOG(ERROR, "GraphicsCaptureForFile::UploadFrame(), frame %llu has the unsupported format %u.",
+                Index % FrameCount, Header.Format);
+            mNextIndex = Index + 1;
+            return false;
+        }
+
+        D3D11_MAPPED_SUBRESOURCE Mapped{};
+        if (FAILED(mUpload.Resize(Header.Width, Header.Height, Format)) || FAILED(mUpload.Map(Mapped))) {
+            mNextIndex = Index + 1;
+            return false;
+        }
+
+        const size_t RowSize = std::min<size_t>(Header.Stride, Mapped.RowPitch);
+        for (uint32_t Row = 0; Row < Header.Height; ++Row) {
+            memcpy(static_cast<uint8_t*>(Mapped.pData) + static_cast<size_t>(Row) * Mapped.RowPitch,
+                Record->Pixels + static_cast<size_t>(Row) * Header.Stride, RowSize);
+        }
+
+        GraphicsFrame Frame{ mUpload.Unmap(true), Index + 1 };
+
+        // Recorded dirty rects are relative to the previous source frame, which is only the previous
+        // recorded frame if the recorder dropped nothing in between
+        if (Header.DirtyRectCount && mAcquiredFrame && Index == mAcquiredIndex + 1 && Index % FrameCount) {
+            const auto Previous = mReader.GetFrame(Index % FrameCount - 1);
+            if (Previous && Header.Sequence && Previous->Header->Sequence + 1 == Header.Sequence) {
+                Frame.DirtyRects.reserve(Header.DirtyRectCount);
+                for (uint32_t Item = 0; Item < Header.DirtyRectCount; ++Item) {
+                    const auto& Rect = Record->DirtyRects[Item];
+                    Frame.DirtyRects.push_back({ Rect.Left, Rect.Top, Rect.Right, Rect.Bottom });
+                }
+                Frame.DirtyRectsValid = true;
+            }
+        }
+
+        const auto PreviousFrame = mAcquiredFrame;
+
+        mAcquiredIndex = Index;
+        mAcquiredFrame = std::make_shared<const GraphicsFrame>(std::move(Frame));
+
+        if (PreviousFrame && !mUpload.Owns(PreviousFrame->Surface.get())) {
+            if (mResizeHandler) {
+                mResizeHandler(nullptr);
+            }
+        }
+
+        return true;
+    }
+
+    bool GraphicsCaptureForFile::IsValid() const
+    {
+        return mView != nullptr;
+    }
+
+    bool GraphicsCaptureForFile::IsCursorCaptureEnabled() const
+    {
+        return false;
+    }
+
+    void GraphicsCaptureForFile::IsCursorCaptureEnabled(_In_ bool Enabled)
+    {
+        UNREFERENCED_PARAMETER(Enabled);
+    }
+
+    bool GraphicsCaptureForFile::IsBorderRequired() const
+    {
+        return false;
+    }
+
+    void GraphicsCaptureForFile::IsBorderRequired(_In_ bool Enabled)
+    {
+        UNREFERENCED_PARAMETER(Enabled);
+    }
+
+    bool GraphicsCaptureForFile::IsUpdateEventSupported() const
+    {
+        // Polled, AcquireFrame() picks the frame that is due
+        return false;
+    }
+
+    void GraphicsCaptureForFile::SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mClosedHandler = Handler;
+    }
+
+    void GraphicsCaptureForFile::SubscribeResizeEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mResizeHandler = Handler;
+    }
+
+    void GraphicsCaptureForFile::SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mUpdateHandler = Handler;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "Core.FrameContainer.h"
+#include "Core.UploadSurfaces.h"
+
+
+namespace Mi::Core
+{
+    enum class ReplayTiming
+    {
+        Original,           // every frame is shown at its recorded time, frames the renderer is too slow for are skipped
+        AsFastAsPossible,   // every frame is shown once, the next one is taken as soon as the previous was drawn
+    };
+
+    // Plays back a recording of FrameRecorder, for benchmarks that need the same input on every run.
+    class GraphicsCaptureForFile final : public IGraphicsCapture
+    {
+        winrt::com_ptr<ID3D11Device> mDevice{ nullptr };
+
+        HANDLE               mFile    = INVALID_HANDLE_VALUE;
+        HANDLE               mMapping = nullptr;
+        const void*          mView    = nullptr;
+        FrameContainerReader mReader;
+
+        ReplayTiming mTiming = ReplayTiming::Original;
+        bool         mLoop   = false;
+        uint64_t     mFirstTimestamp = 0;
+        uint64_t     mDuration       = 0;   // of one pass, including the interval after the last frame
+
+        // Render thread only
+        mutable UploadSurfaces     mUpload;
+        mutable GraphicsFrameLease mAcquiredFrame{ nullptr };
+        mutable uint64_t           mAcquiredIndex = 0;     // frame index over all passes
+        mutable uint64_t           mNextIndex     = 0;     // AsFastAsPossible only
+        mutable std::optional<std::chrono::steady_clock::time_point> mStartTime;
+        mutable bool               mFinished = false;
+
+        std::function<void(HWND)> mClosedHandler;
+        std::function<void(HWND)> mResizeHandler;
+        std::function<void(HWND)> mUpdateHandler;
+
+    public:
+        virtual ~GraphicsCaptureForFile();
+
+        GraphicsCaptureForFile(      GraphicsCaptureForFile&&) = delete;
+        GraphicsCaptureForFile(const GraphicsCaptureForFile& ) = delete;
+        GraphicsCaptureForFile& operator=(      GraphicsCaptureForFile&&) = delete;
+        GraphicsCaptureForFile& operator=(const GraphicsCaptureForFile& ) = delete;
+
+        explicit GraphicsCaptureForFile(
+            _In_ const winrt::com_ptr<ID3D11Device>& Device);
+
+        /* method */
+        // Without Loop the closed event is raised after the last frame.
+        winrt::hresult StartCapture(_In_ const std::filesystem::path& Path, _In_opt_ ReplayTiming Timing = ReplayTiming::Original,
+            _In_opt_ bool Loop = false);
+        winrt::hresult StopCapture ();
+
+        /* interface */
+        HANDLE GetSurfaceHandle() const override;
+        winrt::com_ptr<ID3D11Texture2D> GetSurface() const override;
+        GraphicsFrameLease AcquireFrame() const override;
+        void OnFrameConsumed(_In_ uint64_t Generation) const override;
+        winrt::hresult GetDirtyRect(RECT& DirtyRect) const override;
+
+        bool IsValid() const override;
+
+        bool IsCursorCaptureEnabled() const override;
+        void IsCursorCaptureEnabled(_In_ bool Enabled) override;
+
+        bool IsBorderRequired() const override;
+        void IsBorderRequired(_In_ bool Enabled) override;
+
+        bool IsUpdateEventSupported() const override;
+
+        void SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+        void SubscribeResizeEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+        void SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+
+    private:
+        // Frame index over all passes that is due now, std::nullopt once a replay without Loop is over.
+        std::optional<uint64_t> GetDueFrame() const;
+
+        // Frames that can not be uploaded are skipped, AsFastAsPossible would wait for them forever.
+        bool UploadFrame(_In_ uint64_t Index) const;
+    };
+
+}
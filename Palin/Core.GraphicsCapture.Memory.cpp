@@ -0,0 +1,255 @@
+#include "Core.GraphicsCapture.h"
+
+
+namespace Mi::Core
+{
+    static DXGI_FORMAT GetSharedFrameDxgiFormat(_In_ SharedFrameFormat Format)
+    {
+        switch (Format) {
+            case SharedFrameFormat::B8G8R8A8: return DXGI_FORMAT_B8G8R8A8_UNORM;
+            case SharedFrameFormat::R8G8B8A8: return DXGI_FORMAT_R8G8B8A8_UNORM;
+            default:                          return DXGI_FORMAT_UNKNOWN;
+        }
+    }
+
+    GraphicsCaptureForMemory::~GraphicsCaptureForMemory()
+    {
+        StopCapture();
+    }
+
+    GraphicsCaptureForMemory::GraphicsCaptureForMemory(_In_ const winrt::com_ptr<ID3D11Device>& Device)
+        : mDevice(Device)
+        , mUpload(Device)
+    {
+    }
+
+    winrt::hresult GraphicsCaptureForMemory::StartCapture(_In_opt_ HWND Window, _In_ LPCWSTR MappingName)
+    {
+        if (IsValid()) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        mWindow  = Window;
+        mMapping = OpenFileMappingW(FILE_MAP_READ, FALSE, MappingName);
+        if (mMapping == nullptr) {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        mView = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+        if (mView == nullptr) {
+            const winrt::hresult Result = HRESULT_FROM_WIN32(GetLastError());
+            StopCapture();
+            return Result;
+        }
+
+        MEMORY_BASIC_INFORMATION Information{};
+        if (VirtualQuery(mView, &Information, sizeof(Information)) == 0) {
+            const winrt::hresult Result = HRESULT_FROM_WIN32(GetLastError());
+            StopCapture();
+            return Result;
+        }
+
+        mReader = SharedFrameRingReader(mView, Information.RegionSize);
+        if (!mReader.IsValid()) {
+            LOG(ERROR, "GraphicsCaptureForMemory::StartCapture(), %ls is not a frame ring of version %u.",
+                MappingName, SHARED_FRAME_RING_VERSION);
+            StopCapture();
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        LOG(INFO, "GraphicsCaptureForMemory::StartCapture(), target:"
+            "\n\t Mapping = %ls"
+            "\n\t Size    = %zu",
+            MappingName, Information.RegionSize);
+
+        if (mWindow) {
+            const winrt::hresult Result = WindowMonitor::GetInstance().Register(mWindow,
+                [this](HWND Window, WindowMonitorEvent Event, SIZE /*ClientSize*/)
+                {
+                    // The frame size comes from the ring, only a closed window ends the capture
+                    if (Event == WindowMonitorEvent::Closed) {
+                        OnClosed(Window);
+                    }
+                },
+                mMonitorCookie);
+            if (FAILED(Result)) {
+                StopCapture();
+                return Result;
+            }
+        }
+
+        return S_OK;
+    }
+
+    winrt::hresult GraphicsCaptureForMemory::StopCapture()
+    {
+        if (mMonitorCookie) {
+            WindowMonitor::GetInstance().Unregister(mMonitorCookie);
+            mMonitorCookie = 0;
+        }
+
+        mAcquiredFrame = nullptr;
+        mUpload.Reset();
+        mReader        = {};
+
+        if (mView) {
+            UnmapViewOfFile(mView);
+            mView = nullptr;
+        }
+        if (mMapping) {
+            CloseHandle(mMapping);
+            mMapping = nullptr;
+        }
+
+        return S_OK;
+    }
+
+    winrt::hresult GraphicsCaptureForMemory::GetDirtyRect(RECT& DirtyRect) const
+    {
+        if (mWindow == nullptr) {
+            const auto Frame = mAcquiredFrame;
+            if (Frame == nullptr) {
+                return E_PENDING;
+            }
+
+            D3D11_TEXTURE2D_DESC TextureDesc{};
+            Frame->Surface->GetDesc(&TextureDesc);
+
+            DirtyRect = { 0, 0, static_cast<LONG>(TextureDesc.Width), static_cast<LONG>(TextureDesc.Height) };
+            return S_OK;
+        }
+
+        if (!GetClientRect(mWindow, &DirtyRect)) {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        if (MapWindowPoints(mWindow, HWND_DESKTOP,
+            reinterpret_cast<POINT*>(&DirtyRect), 2) == 0) {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        return S_OK;
+    }
+
+    HANDLE GraphicsCaptureForMemory::GetSurfaceHandle() const
+    {
+        // The surfaces are private to our device
+        return nullptr;
+    }
+
+    winrt::com_ptr<ID3D11Texture2D> GraphicsCaptureForMemory::GetSurface() const
+    {
+        const auto Frame = mAcquiredFrame;
+        return Frame ? Frame->Surface : nullptr;
+    }
+
+    GraphicsFrameLease GraphicsCaptureForMemory::AcquireFrame() const
+    {
+        if (!IsValid()) {
+            return nullptr;
+        }
+
+        const auto Info = mReader.Peek();
+        if (Info && (mAcquiredFrame == nullptr || mAcquiredFrame->Generation != Info->Sequence)) {
+            (void)UploadFrame(*Info);
+        }
+
+        return mAcquiredFrame;
+    }
+
+    bool GraphicsCaptureForMemory::UploadFrame(_In_ const SharedFrameInfo& Info) const
+    {
+        constexpr int MAXIMUM_ATTEMPTS = 3;
+
+        auto Frame = Info;
+        for (int Attempt = 0; Attempt < MAXIMUM_ATTEMPTS; ++Attempt) {
+            D3D11_MAPPED_SUBRESOURCE Mapped{};
+            if (FAILED(mUpload.Resize(Frame.Width, Frame.Height, GetSharedFrameDxgiFormat(Frame.Format)))
+                || FAILED(mUpload.Map(Mapped))) {
+                return false;
+            }
+
+            const bool Complete = mReader.Read(Frame, Mapped.pData, Mapped.RowPitch);
+            const auto Surface  = mUpload.Unmap(Complete);
+
+            if (Complete) {
+                const auto Previous = mAcquiredFrame;
+
+                mAcquiredFrame = std::make_shared<const GraphicsFrame>(GraphicsFrame{ Surface, Frame.Sequence });
+
+                if (Previous && !mUpload.Owns(Previous->Surface.get())) {
+                    if (mResizeHandler) {
+                        mResizeHandler(mWindow);
+                    }
+                }
+                return true;
+            }
+
+            // The producer lapped us, its newest frame is the one worth another try
+            const auto Newer = mReader.Peek();
+            if (!Newer) {
+                return false;
+            }
+            Frame = *Newer;
+        }
+
+        return false;
+    }
+
+    bool GraphicsCaptureForMemory::IsValid() const
+    {
+        return mView != nullptr;
+    }
+
+    bool GraphicsCaptureForMemory::IsCursorCaptureEnabled() const
+    {
+        return false;
+    }
+
+    void GraphicsCaptureForMemory::IsCursorCaptureEnabled(_In_ bool Enabled)
+    {
+        UNREFERENCED_PARAMETER(Enabled);
+    }
+
+    bool GraphicsCaptureForMemory::IsBorderRequired() const
+    {
+        return false;
+    }
+
+    void GraphicsCaptureForMemory::IsBorderRequired(_In_ bool Enabled)
+    {
+        UNREFERENCED_PARAMETER(Enabled);
+    }
+
+    bool GraphicsCaptureForMemory::IsUpdateEventSupported() const
+    {
+        // The ring is polled, AcquireFrame() returns the same frame until the producer published a new one.
+        return false;
+    }
+
+    void GraphicsCaptureForMemory::SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mClosedHandler = Handler;
+    }
+
+    void GraphicsCaptureForMemory::SubscribeResizeEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mResizeHandler = Handler;
+    }
+
+    void GraphicsCaptureForMemory::SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mUpdateHandler = Handler;
+    }
+
+    void GraphicsCaptureForMemory::OnClosed(
+        _In_ HWND Sender)
+    {
+        UNREFERENCED_PARAMETER(Sender);
+
+        // The render thread still reads the mapping, App::StopPlay() unmaps it after joining
+        if (mClosedHandler) {
+            mClosedHandler(mWindow);
+        }
+    }
+}
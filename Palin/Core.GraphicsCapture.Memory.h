@@ -0,0 +1,76 @@
+#pragma once
+#include <winrt/windows.graphics.h>
+
+#include "Core.SharedFrameRing.h"
+#include "Core.UploadSurfaces.h"
+#include "Core.WindowMonitor.h"
+
+
+namespace Mi::Core
+{
+    // Frames rendered on the CPU by producers without a D3D device, read from a named shared frame ring.
+    class GraphicsCaptureForMemory final : public IGraphicsCapture
+    {
+        HWND        mWindow = nullptr;
+
+        winrt::com_ptr<ID3D11Device> mDevice{ nullptr };
+
+        HANDLE                mMapping = nullptr;
+        const void*           mView    = nullptr;
+        SharedFrameRingReader mReader;
+
+        // Render thread only. A copy torn by the producer is not published, so it is never drawn.
+        mutable UploadSurfaces     mUpload;
+        mutable GraphicsFrameLease mAcquiredFrame{ nullptr };
+
+        WindowMonitor::Cookie mMonitorCookie = 0;
+        std::function<void(HWND)> mClosedHandler;
+        std::function<void(HWND)> mResizeHandler;
+        std::function<void(HWND)> mUpdateHandler;
+
+    public:
+        virtual ~GraphicsCaptureForMemory();
+
+        GraphicsCaptureForMemory(      GraphicsCaptureForMemory&&) = delete;
+        GraphicsCaptureForMemory(const GraphicsCaptureForMemory& ) = delete;
+        GraphicsCaptureForMemory& operator=(      GraphicsCaptureForMemory&&) = delete;
+        GraphicsCaptureForMemory& operator=(const GraphicsCaptureForMemory& ) = delete;
+
+        explicit GraphicsCaptureForMemory(
+            _In_ const winrt::com_ptr<ID3D11Device>& Device);
+
+        /* method */
+        // Window is the producer's window for the closed and resize events, it may be nullptr.
+        winrt::hresult StartCapture(_In_opt_ HWND Window, _In_ LPCWSTR MappingName);
+        winrt::hresult StopCapture ();
+
+        /* interface */
+        HANDLE GetSurfaceHandle() const override;
+        winrt::com_ptr<ID3D11Texture2D> GetSurface() const override;
+        GraphicsFrameLease AcquireFrame() const override;
+        winrt::hresult GetDirtyRect(RECT& DirtyRect) const override;
+
+        bool IsValid() const override;
+
+        bool IsCursorCaptureEnabled() const override;
+        void IsCursorCaptureEnabled(_In_ bool Enabled) override;
+
+        bool IsBorderRequired() const override;
+        void IsBorderRequired(_In_ bool Enabled) override;
+
+        bool IsUpdateEventSupported() const override;
+
+        void SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+        void SubscribeResizeEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+        void SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+
+    private:
+        // Uploads the newest frame of the ring, returns false if there is none or every copy was torn.
+        bool UploadFrame(_In_ const SharedFrameInfo& Info) const;
+
+        /* event */
+        void OnClosed(
+            _In_ HWND Sender);
+    };
+
+}
@@ -0,0 +1,199 @@
+#include "Core.GraphicsCapture.h"
+
+
+namespace Mi::Core
+{
+    GraphicsCaptureForPattern::~GraphicsCaptureForPattern()
+    {
+        StopCapture();
+    }
+
+    GraphicsCaptureForPattern::GraphicsCaptureForPattern(_In_ const winrt::com_ptr<ID3D11Device>& Device)
+        : mDevice(Device)
+        , mUpload(Device)
+    {
+    }
+
+    winrt::hresult GraphicsCaptureForPattern::StartCapture(_In_ TestPattern Pattern, _In_ uint32_t Width, _In_ uint32_t Height,
+        _In_ double Rate)
+    {
+        if (IsValid()) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        if (Width  == 0 || Width  > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION ||
+            Height == 0 || Height > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION ||
+            !(Rate >= 0.0)) {
+            return E_INVALIDARG;
+        }
+
+        mPattern = Pattern;
+        mWidth   = Width;
+        mHeight  = Height;
+        mRate    = Rate;
+
+        const winrt::hresult Result = mUpload.Resize(mWidth, mHeight, DXGI_FORMAT_B8G8R8A8_UNORM);
+        if (FAILED(Result)) {
+            mUpload.Reset();
+            return Result;
+        }
+
+        mAcquiredFrame  = nullptr;
+        mAcquiredIndex  = 0;
+        mNextIndex      = 0;
+        mStartTime      = std::nullopt;
+        mActive         = true;
+
+        LOG(INFO, "GraphicsCaptureForPattern::StartCapture(), target:"
+            "\n\t Pattern = %s"
+            "\n\t Size    = %ux%u"
+            "\n\t Rate    = %.3f"
+            "\n\t Barcode = %d",
+            GetTestPatternName(mPattern), mWidth, mHeight, mRate, GetFrameBarcodeHeight(mWidth) != 0);
+
+        return S_OK;
+    }
+
+    winrt::hresult GraphicsCaptureForPattern::StopCapture()
+    {
+        mActive        = false;
+        mAcquiredFrame = nullptr;
+        mUpload.Reset();
+
+        return S_OK;
+    }
+
+    winrt::hresult GraphicsCaptureForPattern::GetDirtyRect(RECT& DirtyRect) const
+    {
+        if (mAcquiredFrame == nullptr) {
+            return E_PENDING;
+        }
+
+        // Every pattern moves as a whole
+        DirtyRect = { 0, 0, static_cast<LONG>(mWidth), static_cast<LONG>(mHeight) };
+        return S_OK;
+    }
+
+    HANDLE GraphicsCaptureForPattern::GetSurfaceHandle() const
+    {
+        // The surfaces are private to our device
+        return nullptr;
+    }
+
+    winrt::com_ptr<ID3D11Texture2D> GraphicsCaptureForPattern::GetSurface() const
+    {
+        const auto Frame = mAcquiredFrame;
+        return Frame ? Frame->Surface : nullptr;
+    }
+
+    GraphicsFrameLease GraphicsCaptureForPattern::AcquireFrame() const
+    {
+        if (!IsValid()) {
+            return nullptr;
+        }
+
+        const uint64_t Due = GetDueFrame();
+        if (mAcquiredFrame == nullptr || Due != mAcquiredIndex) {
+            (void)GenerateFrame(Due);
+        }
+
+        return mAcquiredFrame;
+    }
+
+    void GraphicsCaptureForPattern::OnFrameConsumed(_In_ uint64_t Generation) const
+    {
+        if (mRate > 0.0) {
+            return;
+        }
+
+        const auto Frame = mAcquiredFrame;
+        if (Frame && Frame->Generation == Generation) {
+            mNextIndex = mAcquiredIndex + 1;
+        }
+    }
+
+    uint64_t GraphicsCaptureForPattern::GetDueFrame() const
+    {
+        if (mRate <= 0.0) {
+            return mNextIndex;
+        }
+
+        // The clock starts with the first frame that is asked for, not with StartCapture()
+        const auto Now = std::chrono::steady_clock::now();
+        if (!mStartTime) {
+            mStartTime = Now;
+        }
+
+        const std::chrono::duration<double> Elapsed = Now - *mStartTime;
+        return static_cast<uint64_t>(Elapsed.count() * mRate);
+    }
+
+    bool GraphicsCaptureForPattern::GenerateFrame(_In_ uint64_t Index) const
+    {
+        D3D11_MAPPED_SUBRESOURCE Mapped{};
+        if (FAILED(mUpload.Map(Mapped))) {
+            return false;
+        }
+
+        auto* Pixels = static_cast<uint8_t*>(Mapped.pData);
+        DrawTestPattern(mPattern, Index, Pixels, Mapped.RowPitch, mWidth, mHeight);
+
+        // Stamped last, as close to the upload as the CPU side gets
+        FrameBarcode Barcode{};
+        Barcode.Sequence  = Index + 1;
+        Barcode.Timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        (void)WriteFrameBarcode(Barcode, Pixels, Mapped.RowPitch, mWidth, mHeight);
+
+        mAcquiredIndex = Index;
+        mAcquiredFrame = std::make_shared<const GraphicsFrame>(GraphicsFrame{ mUpload.Unmap(true), Index + 1 });
+
+        return true;
+    }
+
+    bool GraphicsCaptureForPattern::IsValid() const
+    {
+        return mActive;
+    }
+
+    bool GraphicsCaptureForPattern::IsCursorCaptureEnabled() const
+    {
+        return false;
+    }
+
+    void GraphicsCaptureForPattern::IsCursorCaptureEnabled(_In_ bool Enabled)
+    {
+        UNREFERENCED_PARAMETER(Enabled);
+    }
+
+    bool GraphicsCaptureForPattern::IsBorderRequired() const
+    {
+        return false;
+    }
+
+    void GraphicsCaptureForPattern::IsBorderRequired(_In_ bool Enabled)
+    {
+        UNREFERENCED_PARAMETER(Enabled);
+    }
+
+    bool GraphicsCaptureForPattern::IsUpdateEventSupported() const
+    {
+        // Polled, AcquireFrame() generates the frame that is due
+        return false;
+    }
+
+    void GraphicsCaptureForPattern::SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mClosedHandler = Handler;
+    }
+
+    void GraphicsCaptureForPattern::SubscribeResizeEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mResizeHandler = Handler;
+    }
+
+    void GraphicsCaptureForPattern::SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mUpdateHandler = Handler;
+    }
+}
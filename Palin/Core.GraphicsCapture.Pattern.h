@@ -0,0 +1,77 @@
+#pragma once
+#include "Core.TestPattern.h"
+#include "Core.FrameBarcode.h"
+#include "Core.UploadSurfaces.h"
+
+
+namespace Mi::Core
+{
+    // Generates moving test patterns, for measurements that must not depend on another application.
+    //
+    // Every frame carries a FrameBarcode with its generation and the time it was generated, in nanoseconds of
+    // std::chrono::steady_clock, so a LatencyProbe on the presented frames can tell latency and lost frames exactly.
+    class GraphicsCaptureForPattern final : public IGraphicsCapture
+    {
+        winrt::com_ptr<ID3D11Device> mDevice{ nullptr };
+
+        TestPattern mPattern = TestPattern::Gradient;
+        uint32_t    mWidth   = 0;
+        uint32_t    mHeight  = 0;
+        double      mRate    = 0.0;
+        bool        mActive  = false;
+
+        // Render thread only
+        mutable UploadSurfaces     mUpload;
+        mutable GraphicsFrameLease mAcquiredFrame{ nullptr };
+        mutable uint64_t           mAcquiredIndex = 0;
+        mutable uint64_t           mNextIndex     = 0;     // Rate 0 only
+        mutable std::optional<std::chrono::steady_clock::time_point> mStartTime;
+
+        std::function<void(HWND)> mClosedHandler;
+        std::function<void(HWND)> mResizeHandler;
+        std::function<void(HWND)> mUpdateHandler;
+
+    public:
+        virtual ~GraphicsCaptureForPattern();
+
+        GraphicsCaptureForPattern(      GraphicsCaptureForPattern&&) = delete;
+        GraphicsCaptureForPattern(const GraphicsCaptureForPattern& ) = delete;
+        GraphicsCaptureForPattern& operator=(      GraphicsCaptureForPattern&&) = delete;
+        GraphicsCaptureForPattern& operator=(const GraphicsCaptureForPattern& ) = delete;
+
+        explicit GraphicsCaptureForPattern(
+            _In_ const winrt::com_ptr<ID3D11Device>& Device);
+
+        /* method */
+        // Rate is in frames per second. With a Rate of 0 a new frame is generated as soon as the previous was drawn.
+        winrt::hresult StartCapture(_In_ TestPattern Pattern, _In_ uint32_t Width, _In_ uint32_t Height, _In_ double Rate);
+        winrt::hresult StopCapture ();
+
+        /* interface */
+        HANDLE GetSurfaceHandle() const override;
+        winrt::com_ptr<ID3D11Texture2D> GetSurface() const override;
+        GraphicsFrameLease AcquireFrame() const override;
+        void OnFrameConsumed(_In_ uint64_t Generation) const override;
+        winrt::hresult GetDirtyRect(RECT& DirtyRect) const override;
+
+        bool IsValid() const override;
+
+        bool IsCursorCaptureEnabled() const override;
+        void IsCursorCaptureEnabled(_In_ bool Enabled) override;
+
+        bool IsBorderRequired() const override;
+        void IsBorderRequired(_In_ bool Enabled) override;
+
+        bool IsUpdateEventSupported() const override;
+
+        void SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+        void SubscribeResizeEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+        void SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+
+    private:
+        uint64_t GetDueFrame() const;
+
+        bool GenerateFrame(_In_ uint64_t Index) const;
+    };
+
+}
@@ -1,8 +1,31 @@
 #include "Core.GraphicsCapture.h"
+#include "Core.Trace.h"
 
 
 namespace Mi::Core
 {
+    // Handles shared as NT handles are only valid in the process that created them
+    static winrt::hresult DuplicateWindowProcessHandle(_In_ HWND Window, _In_ HANDLE Handle, _Out_ HANDLE& LocalHandle)
+    {
+        LocalHandle = nullptr;
+
+        DWORD TargetProcessId = 0;
+        GetWindowThreadProcessId(Window, &TargetProcessId);
+
+        const auto TargetProcess = std::unique_ptr<std::remove_pointer_t<HANDLE>, decltype(::CloseHandle)*>(
+            OpenProcess(PROCESS_DUP_HANDLE, FALSE, TargetProcessId), ::CloseHandle);
+        if (TargetProcess == nullptr) {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        if (!DuplicateHandle(TargetProcess.get(), Handle, GetCurrentProcess(), &LocalHandle,
+            0, FALSE, DUPLICATE_SAME_ACCESS)) {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        return S_OK;
+    }
+
     GraphicsCaptureForTexture::~GraphicsCaptureForTexture()
     {
         StopCapture();
@@ -14,7 +37,8 @@ namespace Mi::Core
     {
     }
 
-    winrt::hresult GraphicsCaptureForTexture::StartCapture(_In_ HWND Window, _In_ HANDLE  SharedHandle, _In_opt_ bool NtHandle)
+    winrt::hresult GraphicsCaptureForTexture::StartCapture(_In_ HWND Window, _In_ HANDLE  SharedHandle, _In_opt_ bool NtHandle,
+        _In_opt_ HANDLE FenceHandle)
     {
         if (IsValid()) {
             return DXGI_ERROR_INVALID_CALL;
@@ -24,18 +48,9 @@ namespace Mi::Core
 
         winrt::hresult Result;
         if (NtHandle) {
-            DWORD TargetProcessId = 0;
-            GetWindowThreadProcessId(Window, &TargetProcessId);
-
-            const auto TargetProcess = std::unique_ptr<std::remove_pointer_t<HANDLE>, decltype(::CloseHandle)*>(
-                OpenProcess(PROCESS_DUP_HANDLE, FALSE, TargetProcessId), ::CloseHandle);
-            if (TargetProcess == nullptr) {
-                return HRESULT_FROM_WIN32(GetLastError());
-            }
-
-            if (!DuplicateHandle(TargetProcess.get(), SharedHandle, GetCurrentProcess(), &SharedHandle,
-                0, FALSE, DUPLICATE_SAME_ACCESS)) {
-                return HRESULT_FROM_WIN32(GetLastError());
+            Result = DuplicateWindowProcessHandle(Window, SharedHandle, SharedHandle);
+            if (FAILED(Result)) {
+                return Result;
             }
             const auto NewHandle = std::unique_ptr<std::remove_pointer_t<HANDLE>, decltype(::CloseHandle)*>(
                 SharedHandle, ::CloseHandle);
@@ -59,11 +74,17 @@ namespace Mi::Core
             "\n\t Format = %d",
             TexDesc.Width, TexDesc.Height, TexDesc.Format);
 
-        try {
-            mWatchDog = std::thread(&GraphicsCaptureForTexture::WatchDog, this);
+        if (FenceHandle) {
+            Result = OpenSharedFence(FenceHandle);
+            if (FAILED(Result)) {
+                StopCapture();
+                return Result;
+            }
         }
-        catch(const std::system_error& Exception) {
-            Result = HRESULT_FROM_WIN32(Exception.code().value());
+
+        Result = StartMonitor();
+        if (FAILED(Result)) {
+            StopCapture();
         }
 
         return Result;
@@ -83,11 +104,9 @@ namespace Mi::Core
             return Result;
         }
 
-        try {
-            mWatchDog = std::thread(&GraphicsCaptureForTexture::WatchDog, this);
-        }
-        catch (const std::system_error& Exception) {
-            Result = HRESULT_FROM_WIN32(Exception.code().value());
+        Result = StartMonitor();
+        if (FAILED(Result)) {
+            StopCapture();
         }
 
         return Result;
@@ -97,10 +116,11 @@ namespace Mi::Core
     {
         mSurface = nullptr;
 
-        if (mWatchDog.joinable()) {
-            if (mWatchDog.get_id() != std::this_thread::get_id()) {
-                mWatchDog.join();
-            }
+        CloseSharedFence();
+
+        if (mMonitorCookie) {
+            WindowMonitor::GetInstance().Unregister(mMonitorCookie);
+            mMonitorCookie = 0;
         }
 
         return S_OK;
@@ -137,6 +157,31 @@ namespace Mi::Core
         return mSurface;
     }
 
+    GraphicsFrameLease GraphicsCaptureForTexture::AcquireFrame() const
+    {
+        if (mSurface == nullptr) {
+            return nullptr;
+        }
+
+        if (mFence == nullptr) {
+            return std::make_shared<const GraphicsFrame>(GraphicsFrame{ mSurface });
+        }
+
+        const TraceSpan Span("GraphicsCaptureForTexture::AcquireFrame");
+
+        // Nothing written yet, or the device was removed
+        const uint64_t Signaled = mFence->GetCompletedValue();
+        if (Signaled == 0 || Signaled == UINT64_MAX) {
+            return nullptr;
+        }
+
+        // Orders the draw after the producer's writes on the GPU. The value is already reached, so a stalled
+        // producer can never block our queue, the fence value doubles as the frame sequence number.
+        (void)mFenceContext->Wait(mFence.get(), Signaled);
+
+        return std::make_shared<const GraphicsFrame>(GraphicsFrame{ mSurface, Signaled });
+    }
+
     bool GraphicsCaptureForTexture::IsValid() const
     {
         return !!mSurface;
@@ -162,6 +207,12 @@ namespace Mi::Core
         UNREFERENCED_PARAMETER(Enabled);
     }
 
+    bool GraphicsCaptureForTexture::IsUpdateEventSupported() const
+    {
+        // Without a fence the producer writes the shared texture without telling us.
+        return !!mFence;
+    }
+
     void GraphicsCaptureForTexture::SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
     {
         mClosedHandler = Handler;
@@ -172,45 +223,136 @@ namespace Mi::Core
         mResizeHandler = Handler;
     }
 
-    winrt::hresult GraphicsCaptureForTexture::WatchDog()
+    void GraphicsCaptureForTexture::SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mUpdateHandler = Handler;
+    }
+
+    winrt::hresult GraphicsCaptureForTexture::StartMonitor()
     {
-        RECT ClientArea{};
-        if (!GetClientRect(mWindow, &ClientArea)) {
+        return WindowMonitor::GetInstance().Register(mWindow,
+            [this](HWND Window, WindowMonitorEvent Event, SIZE ClientSize)
+            {
+                switch (Event) {
+                    case WindowMonitorEvent::Resized:
+                        return OnResize(Window, { ClientSize.cx, ClientSize.cy });
+                    case WindowMonitorEvent::Closed:
+                        return OnClosed(Window);
+                }
+            },
+            mMonitorCookie);
+    }
+
+    winrt::hresult GraphicsCaptureForTexture::OpenSharedFence(_In_ HANDLE FenceHandle)
+    {
+        // Shared fences are always NT handles
+        HANDLE LocalHandle = nullptr;
+        winrt::hresult Result = DuplicateWindowProcessHandle(mWindow, FenceHandle, LocalHandle);
+        if (FAILED(Result)) {
+            return Result;
+        }
+        const auto NewHandle = std::unique_ptr<std::remove_pointer_t<HANDLE>, decltype(::CloseHandle)*>(
+            LocalHandle, ::CloseHandle);
+
+        winrt::com_ptr<ID3D11DeviceContext> Context;
+        mDevice->GetImmediateContext(Context.put());
+
+        const auto Device5 = mDevice.try_as<ID3D11Device5>();
+        mFenceContext      = Context.try_as<ID3D11DeviceContext4>();
+        if (Device5 == nullptr || mFenceContext == nullptr) {
+            LOG(ERROR, "GraphicsCaptureForTexture::OpenSharedFence(), shared fences need Direct3D 11.4.");
+            return E_NOINTERFACE;
+        }
+
+        Result = Device5->OpenSharedFence(LocalHandle, IID_PPV_ARGS(&mFence));
+        if (FAILED(Result)) {
+            LOG(ERROR, "GraphicsCaptureForTexture::OpenSharedFence(), ID3D11Device5::OpenSharedFence failed, Result=0x%0*X",
+                8, Result.value);
+            return Result;
+        }
+
+        mFenceEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
             return HRESULT_FROM_WIN32(GetLastError());
         }
 
-        while (IsValid()) {
-            if (!IsWindow(mWindow)) {
-                break;
-            }
+        static const auto FenceCallback = [](PTP_CALLBACK_INSTANCE /*Instance*/, PVOID Context,
+            PTP_WAIT /*Wait*/, TP_WAIT_RESULT /*WaitResult*/)
+        {
+            static_cast<GraphicsCaptureForTexture*>(Context)->OnFenceSignaled();
+        };
 
-            if (IsMinimized(mWindow)) {
-                break;
-            }
+        mFenceWait = CreateThreadpoolWait(FenceCallback, this, nullptr);
+        if (mFenceWait == nullptr) {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
 
-            RECT NewArea{};
-            if (!GetClientRect(mWindow, &NewArea)) {
-                break;
-            }
+        mFenceStopping = false;
+        mFenceSignaled = mFence->GetCompletedValue();
+
+        LOG(INFO, "GraphicsCaptureForTexture::OpenSharedFence(), Value=%llu", mFenceSignaled);
+
+        return ArmFenceWait();
+    }
+
+    winrt::hresult GraphicsCaptureForTexture::ArmFenceWait()
+    {
+        const winrt::hresult Result = mFence->SetEventOnCompletion(mFenceSignaled + 1, mFenceEvent);
+        if (FAILED(Result)) {
+            LOG(ERROR, "GraphicsCaptureForTexture::ArmFenceWait(), ID3D11Fence::SetEventOnCompletion(%llu) failed, Result=0x%0*X",
+                mFenceSignaled + 1, 8, Result.value);
+            return Result;
+        }
+
+        SetThreadpoolWait(mFenceWait, mFenceEvent, nullptr);
+        return S_OK;
+    }
 
-            // Resize
-            if ((ClientArea.right  - ClientArea.left) != (NewArea.right  - NewArea.left) ||
-                (ClientArea.bottom - ClientArea.top ) != (NewArea.bottom - NewArea.top )) {
+    void GraphicsCaptureForTexture::CloseSharedFence()
+    {
+        if (mFenceWait) {
+            mFenceStopping = true;
 
-                OnResize(mWindow, {
-                    (NewArea.right  - NewArea.left),
-                    (NewArea.bottom - NewArea.top)
-                });
+            // A callback that was running during the first cancel may have armed the wait again
+            for (int Pass = 0; Pass < 2; ++Pass) {
+                SetThreadpoolWait(mFenceWait, nullptr, nullptr);
+                WaitForThreadpoolWaitCallbacks(mFenceWait, TRUE);
             }
 
-            std::this_thread::yield();
+            CloseThreadpoolWait(mFenceWait);
+            mFenceWait = nullptr;
         }
 
-        if (IsValid()) {
-            OnClosed(mWindow);
+        if (mFenceEvent) {
+            CloseHandle(mFenceEvent);
+            mFenceEvent = nullptr;
         }
 
-        return S_OK;
+        mFence        = nullptr;
+        mFenceContext = nullptr;
+    }
+
+    void GraphicsCaptureForTexture::OnFenceSignaled()
+    {
+        const TraceSpan Span("GraphicsCaptureForTexture::OnFenceSignaled");
+
+        const uint64_t Signaled = mFence->GetCompletedValue();
+        if (Signaled == UINT64_MAX) {
+            LOG(ERROR, "GraphicsCaptureForTexture::OnFenceSignaled(), the fence was lost with its device.");
+            return;
+        }
+
+        if (Signaled > mFenceSignaled) {
+            mFenceSignaled = Signaled;
+
+            if (mUpdateHandler) {
+                mUpdateHandler(mWindow);
+            }
+        }
+
+        if (!mFenceStopping) {
+            (void)ArmFenceWait();
+        }
     }
 
     void GraphicsCaptureForTexture::OnResize(
@@ -230,8 +372,7 @@ namespace Mi::Core
     {
         UNREFERENCED_PARAMETER(Sender);
 
-        StopCapture();
-
+        // The render thread still waits on the fence, App::StopPlay() closes it after joining
         if (mClosedHandler) {
             mClosedHandler(mWindow);
         }
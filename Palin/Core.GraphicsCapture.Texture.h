@@ -1,6 +1,8 @@
 #pragma once
 #include <winrt/windows.graphics.h>
 
+#include "Core.WindowMonitor.h"
+
 
 namespace Mi::Core
 {
@@ -12,9 +14,18 @@ namespace Mi::Core
         winrt::com_ptr<ID3D11Device>    mDevice { nullptr };
         winrt::com_ptr<ID3D11Texture2D> mSurface{ nullptr };
 
-        std::thread mWatchDog;
+        // Optional shared fence, the producer signals an increasing value for every frame it finished writing
+        winrt::com_ptr<ID3D11Fence>          mFence       { nullptr };
+        winrt::com_ptr<ID3D11DeviceContext4> mFenceContext{ nullptr };
+        HANDLE           mFenceEvent = nullptr;
+        PTP_WAIT         mFenceWait  = nullptr;
+        uint64_t         mFenceSignaled = 0;    // threadpool callback only
+        std::atomic_bool mFenceStopping = false;
+
+        WindowMonitor::Cookie mMonitorCookie = 0;
         std::function<void(HWND)> mClosedHandler;
         std::function<void(HWND)> mResizeHandler;
+        std::function<void(HWND)> mUpdateHandler;
 
     public:
         virtual ~GraphicsCaptureForTexture();
@@ -29,13 +40,17 @@ namespace Mi::Core
             _In_ DXGI_FORMAT Format);
 
         /* method */
-        winrt::hresult StartCapture(_In_ HWND Window, _In_ HANDLE  SharedHandle, _In_opt_ bool NtHandle = false);
+        // FenceHandle is an optional ID3D11Fence shared by the producer, like an NT texture handle it is a handle
+        // value of the process that owns Window. Frames are then taken at the newest signaled value.
+        winrt::hresult StartCapture(_In_ HWND Window, _In_ HANDLE  SharedHandle, _In_opt_ bool NtHandle = false,
+            _In_opt_ HANDLE FenceHandle = nullptr);
         winrt::hresult StartCapture(_In_ HWND Window, _In_ LPCWSTR SharedName);
         winrt::hresult StopCapture ();
 
         /* interface */
         HANDLE GetSurfaceHandle() const override;
         winrt::com_ptr<ID3D11Texture2D> GetSurface() const override;
+        GraphicsFrameLease AcquireFrame() const override;
         winrt::hresult GetDirtyRect(RECT& DirtyRect) const override;
 
         bool IsValid() const override;
@@ -46,11 +61,18 @@ namespace Mi::Core
         bool IsBorderRequired() const override;
         void IsBorderRequired(_In_ bool Enabled) override;
 
+        bool IsUpdateEventSupported() const override;
+
         void SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
         void SubscribeResizeEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+        void SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
 
     private:
-        winrt::hresult WatchDog();
+        winrt::hresult StartMonitor();
+
+        winrt::hresult OpenSharedFence(_In_ HANDLE FenceHandle);
+        winrt::hresult ArmFenceWait();
+        void CloseSharedFence();
 
         /* event */
         void OnResize(
@@ -59,6 +81,8 @@ namespace Mi::Core
 
         void OnClosed(
             _In_ HWND Sender);
+
+        void OnFenceSignaled();
     };
 
 }
@@ -1,8 +1,50 @@
 #include "Core.GraphicsCapture.h"
+#include "Core.Trace.h"
 
 
 namespace Mi::Core
 {
+    static void AppendDirtyRects(_Inout_ std::vector<RECT>& Target, _In_ const std::vector<RECT>& Rects)
+    {
+        Target.insert(Target.end(), Rects.begin(), Rects.end());
+
+        if (Target.size() > MAXIMUM_DIRTY_RECTS) {
+            RECT Bounds = Target.front();
+            for (const auto& Rect : Target) {
+                UnionRect(&Bounds, &Bounds, &Rect);
+            }
+            Target.assign(1, Bounds);
+        }
+    }
+
+    static bool GetFrameDirtyRects(
+        _In_  const winrt::Windows::Graphics::Capture::Direct3D11CaptureFrame& Frame,
+        _In_  const winrt::Windows::Graphics::SizeInt32& Size,
+        _Out_ std::vector<RECT>& DirtyRects)
+    {
+        DirtyRects.clear();
+
+        const RECT Bounds{ 0, 0, Size.Width, Size.Height };
+        std::vector<RECT> Rects;
+
+        try {
+            for (const auto& Region : Frame.DirtyRegions()) {
+                const RECT Rect{ Region.X, Region.Y, Region.X + Region.Width, Region.Y + Region.Height };
+
+                RECT Clipped{};
+                if (IntersectRect(&Clipped, &Rect, &Bounds)) {
+                    Rects.emplace_back(Clipped);
+                }
+            }
+        }
+        catch (const winrt::hresult_error&) {
+            return false;
+        }
+
+        AppendDirtyRects(DirtyRects, Rects);
+        return true;
+    }
+
     GraphicsCaptureForWindow::GraphicsCaptureForWindow(
         _In_ const winrt::com_ptr<ID3D11Device>& Device,
         _In_ DXGI_FORMAT Format)
@@ -40,20 +82,34 @@ namespace Mi::Core
             mFramePool = winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool::Create(
                 mDirect3DDevice,
                 static_cast<winrt::Windows::Graphics::DirectX::DirectXPixelFormat>(mFormat),
-                2,
+                mFramePoolDepth,
                 mSize);
             mCaptureUpdateRevoker = mFramePool.FrameArrived(winrt::auto_revoke, { this, &GraphicsCaptureForWindow::OnUpdate });
 
             // Session
             mSession = mFramePool.CreateCaptureSession(mCapture);
 
+            mDirtyRegionActive = false;
+            if (mDirtyRegion) {
+                if (winrt::Windows::Foundation::Metadata::ApiInformation::IsPropertyPresent(
+                    winrt::name_of<winrt::Windows::Graphics::Capture::GraphicsCaptureSession>(), L"DirtyRegionMode")) {
+                    // Windows 11, version 24H2 (introduced in 10.0.26100.0)
+                    // ReportOnly still renders complete frames, so a frame without dirty regions can be copied whole
+                    mSession.DirtyRegionMode(winrt::Windows::Graphics::Capture::GraphicsCaptureDirtyRegionMode::ReportOnly);
+                    mDirtyRegionActive = true;
+                }
+            }
+
             // Surface
-            winrt::check_hresult(CreateSharedSurface());
+            if (!mZeroCopy) {
+                winrt::check_hresult(CreateSurfaceSet());
+            }
 
             mSession.StartCapture();
         }
         catch (const winrt::hresult_error& Exception) {
             Result = Exception.code();
+            StopCapture();
         }
 
         return Result;
@@ -68,13 +124,50 @@ namespace Mi::Core
         mFramePool      = nullptr;
         mCapture        = nullptr;
         mDirect3DDevice = nullptr;
-        mSurface        = nullptr;
+
+        mSurfaceSet.store(nullptr);
+        PublishFrame(nullptr);
 
         return S_OK;
     }
 
+    bool GraphicsCaptureForWindow::IsZeroCopyEnabled() const
+    {
+        return mZeroCopy;
+    }
+
+    void GraphicsCaptureForWindow::IsZeroCopyEnabled(_In_ bool Enabled)
+    {
+        mZeroCopy = Enabled;
+    }
+
+    bool GraphicsCaptureForWindow::IsDirtyRegionEnabled() const
+    {
+        return mDirtyRegion;
+    }
+
+    void GraphicsCaptureForWindow::IsDirtyRegionEnabled(_In_ bool Enabled)
+    {
+        mDirtyRegion = Enabled;
+    }
+
+    int32_t GraphicsCaptureForWindow::GetFramePoolDepth() const
+    {
+        return mFramePoolDepth;
+    }
+
+    void GraphicsCaptureForWindow::SetFramePoolDepth(_In_ int32_t Depth)
+    {
+        mFramePoolDepth = std::clamp(Depth, 1, MAXIMUM_FRAME_POOL_DEPTH);
+    }
+
     winrt::hresult GraphicsCaptureForWindow::GetDirtyRect(RECT& DirtyRect) const
     {
+        if (mDirtyRegionActive) {
+            DirtyRect = mAcquiredDirtyRect;
+            return S_OK;
+        }
+
         return DwmGetWindowAttribute(mWindow, DWMWA_EXTENDED_FRAME_BOUNDS,
             &DirtyRect, sizeof(DirtyRect));
     }
@@ -82,9 +175,9 @@ namespace Mi::Core
     HANDLE GraphicsCaptureForWindow::GetSurfaceHandle() const
     {
         HANDLE Handle = nullptr;
-        if (mSurface) {
+        if (const auto Surface = GetSurface()) {
             winrt::com_ptr<IDXGIResource> Resource;
-            if (SUCCEEDED(mSurface->QueryInterface(IID_PPV_ARGS(&Resource)))) {
+            if (SUCCEEDED(Surface->QueryInterface(IID_PPV_ARGS(&Resource)))) {
                 (void)Resource->GetSharedHandle(&Handle);
             }
         }
@@ -93,12 +186,72 @@ namespace Mi::Core
 
     winrt::com_ptr<ID3D11Texture2D> GraphicsCaptureForWindow::GetSurface() const
     {
-        return mSurface;
+        // Without a lease the surface may be written again at any time, prefer AcquireFrame()
+        const auto Frame = AcquireFrame();
+        return Frame ? Frame->Surface : nullptr;
+    }
+
+    GraphicsFrameLease GraphicsCaptureForWindow::AcquireFrame() const
+    {
+        if (mZeroCopy) {
+            GraphicsFrameLease Frame;
+            {
+                std::lock_guard Lock(mFrameMutex);
+                Frame = mLatestFrame;
+            }
+
+            UpdateAcquiredDirtyRect(Frame.get());
+            return Frame;
+        }
+
+        const auto Set = mSurfaceSet.load();
+        if (Set == nullptr) {
+            mAcquiredFrame = nullptr;
+            return nullptr;
+        }
+
+        const auto Slot = Set->Ring.Acquire();
+        if (!Slot) {
+            return nullptr;
+        }
+
+        const auto& Surface = Set->Surfaces[Slot->Index];
+        if (mAcquiredFrame == nullptr
+            || mAcquiredFrame->Surface.get() != Surface.get()
+            || mAcquiredFrame->Generation    != Slot->Generation) {
+            mAcquiredFrame = std::make_shared<const GraphicsFrame>(GraphicsFrame{ Surface, Slot->Generation,
+                Set->DirtyRects[Slot->Index], Set->DirtyRectsValid[Slot->Index] });
+
+            UpdateAcquiredDirtyRect(mAcquiredFrame.get());
+        }
+
+        return mAcquiredFrame;
+    }
+
+    void GraphicsCaptureForWindow::UpdateAcquiredDirtyRect(_In_opt_ const GraphicsFrame* Frame) const
+    {
+        mAcquiredDirtyRect = {};
+
+        if (Frame == nullptr) {
+            return;
+        }
+
+        if (!Frame->DirtyRectsValid) {
+            D3D11_TEXTURE2D_DESC TextureDesc{};
+            Frame->Surface->GetDesc(&TextureDesc);
+
+            mAcquiredDirtyRect = { 0, 0, static_cast<LONG>(TextureDesc.Width), static_cast<LONG>(TextureDesc.Height) };
+            return;
+        }
+
+        for (const auto& Rect : Frame->DirtyRects) {
+            UnionRect(&mAcquiredDirtyRect, &mAcquiredDirtyRect, &Rect);
+        }
     }
 
     bool GraphicsCaptureForWindow::IsValid() const
     {
-        return !!mSurface;
+        return !!mFramePool;
     }
 
     bool GraphicsCaptureForWindow::IsCursorCaptureEnabled() const
@@ -147,6 +300,11 @@ namespace Mi::Core
         }
     }
 
+    bool GraphicsCaptureForWindow::IsUpdateEventSupported() const
+    {
+        return true;
+    }
+
     void GraphicsCaptureForWindow::SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
     {
         mClosedHandler = Handler;
@@ -157,7 +315,12 @@ namespace Mi::Core
         mResizeHandler = Handler;
     }
 
-    winrt::hresult GraphicsCaptureForWindow::CreateSharedSurface()
+    void GraphicsCaptureForWindow::SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept
+    {
+        mUpdateHandler = Handler;
+    }
+
+    winrt::hresult GraphicsCaptureForWindow::CreateSurfaceSet()
     {
         D3D11_TEXTURE2D_DESC Texture2DDesc{};
         Texture2DDesc.Format             = mFormat;
@@ -170,13 +333,41 @@ namespace Mi::Core
         Texture2DDesc.BindFlags          = D3D11_BIND_SHADER_RESOURCE;
         Texture2DDesc.Usage              = D3D11_USAGE_DEFAULT;
         Texture2DDesc.MiscFlags          = D3D11_RESOURCE_MISC_SHARED;
-        return mDevice->CreateTexture2D(&Texture2DDesc, nullptr, mSurface.put());
+
+        auto Set = std::make_shared<SurfaceSet>();
+        for (auto& Surface : Set->Surfaces) {
+            const winrt::hresult Result = mDevice->CreateTexture2D(&Texture2DDesc, nullptr, Surface.put());
+            if (FAILED(Result)) {
+                return Result;
+            }
+        }
+
+        for (auto& Stale : Set->Stale) {
+            Stale.assign(1, RECT{ 0, 0, mSize.Width, mSize.Height });
+        }
+
+        // Surfaces of the previous set stay alive as long as the render thread holds a lease on them
+        mSurfaceSet.store(std::move(Set));
+        return S_OK;
+    }
+
+    void GraphicsCaptureForWindow::PublishFrame(_In_ GraphicsFrameLease Frame)
+    {
+        GraphicsFrameLease Previous;
+        {
+            std::lock_guard Lock(mFrameMutex);
+            Previous = std::exchange(mLatestFrame, std::move(Frame));
+        }
+
+        // Released outside of the lock, the last lease returns the frame to the pool
     }
 
     void GraphicsCaptureForWindow::OnUpdate(
         _In_ const winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool& Sender,
         _In_ const winrt::Windows::Foundation::IInspectable& Object)
     {
+        const TraceSpan Span("GraphicsCaptureForWindow::OnUpdate");
+
         const auto Frame = Sender.TryGetNextFrame();
         if (Frame == nullptr) {
             return;
@@ -187,26 +378,90 @@ namespace Mi::Core
             return OnResize(Sender, Object);
         }
 
-        winrt::com_ptr<ID3D11DeviceContext> D3D11Context;
-        mDevice->GetImmediateContext(D3D11Context.put());
-
         const auto WithFrame = GetDXGIInterfaceFromObject<ID3D11Texture2D>(Frame.Surface());
-        D3D11Context->CopyResource(mSurface.get(), WithFrame.get());
+
+        std::vector<RECT> DirtyRects;
+        const bool DirtyRectsValid = mDirtyRegionActive && GetFrameDirtyRects(Frame, mSize, DirtyRects);
+
+        if (mZeroCopy) {
+            // The frame stays out of the pool until the renderer drops the last lease on it
+            PublishFrame(GraphicsFrameLease(new GraphicsFrame{ WithFrame, ++mLatestGeneration,
+                std::move(DirtyRects), DirtyRectsValid }, [Frame](const GraphicsFrame* Item)
+            {
+                delete Item;
+
+                try {
+                    Frame.Close();
+                }
+                catch (const winrt::hresult_error&) {
+                }
+            }));
+        }
+        else if (const auto Set = mSurfaceSet.load()) {
+            const TraceSpan CopySpan("GraphicsCaptureForWindow::CopyFrame");
+
+            winrt::com_ptr<ID3D11DeviceContext> D3D11Context;
+            mDevice->GetImmediateContext(D3D11Context.put());
+
+            // The write slot is never the one the render thread reads from
+            const uint32_t Slot    = Set->Ring.GetWriteSlot();
+            const auto&    Surface = Set->Surfaces[Slot];
+
+            if (DirtyRectsValid) {
+                // Bring the slot up to date: everything that changed since it was last written, and this frame
+                AppendDirtyRects(Set->Stale[Slot], DirtyRects);
+
+                for (const auto& Rect : Set->Stale[Slot]) {
+                    const D3D11_BOX Box{
+                        static_cast<UINT>(Rect.left),  static_cast<UINT>(Rect.top),    0,
+                        static_cast<UINT>(Rect.right), static_cast<UINT>(Rect.bottom), 1 };
+
+                    D3D11Context->CopySubresourceRegion(Surface.get(), 0, Box.left, Box.top, 0, WithFrame.get(), 0, &Box);
+                }
+
+                for (uint32_t Index = 0; Index < SURFACE_RING_SLOTS; ++Index) {
+                    if (Index != Slot) {
+                        AppendDirtyRects(Set->Stale[Index], DirtyRects);
+                    }
+                }
+            }
+            else {
+                D3D11Context->CopyResource(Surface.get(), WithFrame.get());
+
+                for (uint32_t Index = 0; Index < SURFACE_RING_SLOTS; ++Index) {
+                    if (Index != Slot) {
+                        Set->Stale[Index].assign(1, RECT{ 0, 0, mSize.Width, mSize.Height });
+                    }
+                }
+            }
+            Set->Stale[Slot].clear();
+
+            Set->DirtyRects[Slot]      = std::move(DirtyRects);
+            Set->DirtyRectsValid[Slot] = DirtyRectsValid;
+            (void)Set->Ring.Publish();
+        }
+
+        if (mUpdateHandler) {
+            mUpdateHandler(mWindow);
+        }
     }
 
     void GraphicsCaptureForWindow::OnResize(
         _In_ const winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool& Sender,
         _In_ const winrt::Windows::Foundation::IInspectable&)
     {
-        mSurface = nullptr;
+        mSurfaceSet.store(nullptr);
+        PublishFrame(nullptr);
 
         Sender.Recreate(
             mDirect3DDevice,
             static_cast<winrt::Windows::Graphics::DirectX::DirectXPixelFormat>(mFormat),
-            2,
+            mFramePoolDepth,
             mSize);
 
-        winrt::check_hresult(CreateSharedSurface());
+        if (!mZeroCopy) {
+            winrt::check_hresult(CreateSurfaceSet());
+        }
 
         if (mResizeHandler) {
             mResizeHandler(mWindow);
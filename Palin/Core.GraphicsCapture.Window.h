@@ -4,16 +4,53 @@
 #include <winrt/Windows.Graphics.Capture.h>
 #include <Windows.Graphics.Capture.Interop.h>
 
+#include "Core.SurfaceRing.h"
+
 
 namespace Mi::Core
 {
+    // Frames held by the renderer are not available to the capture, the pool needs one more buffer per lease.
+    constexpr int32_t DEFAULT_FRAME_POOL_DEPTH = 2;
+    constexpr int32_t MAXIMUM_FRAME_POOL_DEPTH = 4;
+
+    // More dirty rects than this are merged into their bounding rect.
+    constexpr size_t MAXIMUM_DIRTY_RECTS = 16;
+
     class GraphicsCaptureForWindow final : public IGraphicsCapture
     {
         HWND        mWindow = nullptr;
         DXGI_FORMAT mFormat = DXGI_FORMAT_UNKNOWN;
 
-        winrt::com_ptr<ID3D11Device>    mDevice { nullptr };
-        winrt::com_ptr<ID3D11Texture2D> mSurface{ nullptr };
+        bool    mZeroCopy       = false;
+        bool    mDirtyRegion    = false;
+        bool    mDirtyRegionActive = false;
+        int32_t mFramePoolDepth = DEFAULT_FRAME_POOL_DEPTH;
+
+        // Copy mode writes the frames into a ring of shared surfaces, the whole set is replaced on resize
+        struct SurfaceSet
+        {
+            std::array<winrt::com_ptr<ID3D11Texture2D>, SURFACE_RING_SLOTS> Surfaces{};
+            SurfaceRing Ring;
+
+            // Dirty rects of the frame in each slot, owned together with the slot
+            std::array<std::vector<RECT>, SURFACE_RING_SLOTS> DirtyRects{};
+            std::array<bool, SURFACE_RING_SLOTS>              DirtyRectsValid{};
+
+            // Producer only, regions of each slot that are older than the newest frame
+            std::array<std::vector<RECT>, SURFACE_RING_SLOTS> Stale{};
+        };
+
+        winrt::com_ptr<ID3D11Device>             mDevice { nullptr };
+        std::atomic<std::shared_ptr<SurfaceSet>> mSurfaceSet{ nullptr };
+
+        // Render thread only, AcquireFrame() hands out the same lease until there is a new frame
+        mutable GraphicsFrameLease mAcquiredFrame{ nullptr };
+        mutable RECT               mAcquiredDirtyRect{};
+
+        // Zero-copy mode publishes a lease on the newest frame of the pool
+        mutable std::mutex mFrameMutex;
+        GraphicsFrameLease mLatestFrame{ nullptr };
+        uint64_t           mLatestGeneration = 0;
 
         winrt::Windows::Graphics::SizeInt32                            mSize          { 0 };
         winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice mDirect3DDevice{ nullptr };
@@ -26,6 +63,7 @@ namespace Mi::Core
 
         std::function<void(HWND)> mClosedHandler;
         std::function<void(HWND)> mResizeHandler;
+        std::function<void(HWND)> mUpdateHandler;
 
     public:
         virtual ~GraphicsCaptureForWindow() = default;
@@ -43,9 +81,23 @@ namespace Mi::Core
         winrt::hresult StartCapture(_In_ HWND Window);
         winrt::hresult StopCapture ();
 
+        // Zero-copy mode hands the frames of the pool to the renderer instead of copying them into a shared surface.
+        // GetSurfaceHandle() returns nullptr in this mode. Both settings apply on the next StartCapture.
+        bool IsZeroCopyEnabled() const;
+        void IsZeroCopyEnabled(_In_ bool Enabled);
+
+        int32_t GetFramePoolDepth() const;
+        void SetFramePoolDepth(_In_ int32_t Depth);
+
+        // Dirty-region mode copies only the regions the capture session reports as changed, and hands them to
+        // the renderer with the frame. Needs Windows 11 24H2, it is ignored on older systems.
+        bool IsDirtyRegionEnabled() const;
+        void IsDirtyRegionEnabled(_In_ bool Enabled);
+
         /* interface */
         HANDLE GetSurfaceHandle() const override;
         winrt::com_ptr<ID3D11Texture2D> GetSurface() const override;
+        GraphicsFrameLease AcquireFrame() const override;
         winrt::hresult GetDirtyRect(RECT& DirtyRect) const override;
 
         bool IsValid() const override;
@@ -56,11 +108,17 @@ namespace Mi::Core
         bool IsBorderRequired() const override;
         void IsBorderRequired(_In_ bool Enabled) override;
 
+        bool IsUpdateEventSupported() const override;
+
         void SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
         void SubscribeResizeEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
+        void SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept override;
 
     private:
-        winrt::hresult CreateSharedSurface();
+        winrt::hresult CreateSurfaceSet();
+
+        void PublishFrame(_In_ GraphicsFrameLease Frame);
+        void UpdateAcquiredDirtyRect(_In_opt_ const GraphicsFrame* Frame) const;
 
         /* event */
         void OnUpdate(
@@ -3,11 +3,37 @@
 
 namespace Mi::Core
 {
+    struct GraphicsFrame
+    {
+        winrt::com_ptr<ID3D11Texture2D> Surface{ nullptr };
+        uint64_t                        Generation = 0;    // increases with every frame, 0 if unknown
+
+        // Regions that changed since the frame with Generation - 1, in surface coordinates.
+        // Only valid if DirtyRectsValid is set, otherwise the whole surface has to be treated as changed.
+        std::vector<RECT>               DirtyRects{};
+        bool                            DirtyRectsValid = false;
+    };
+
+    // Keeps a captured surface alive while it is in use.
+    // Sources that lend out their own frames get them back when the last lease is released.
+    using GraphicsFrameLease = std::shared_ptr<const GraphicsFrame>;
+
     class IGraphicsCapture
     {
     public:
         virtual HANDLE GetSurfaceHandle() const = 0;
         virtual winrt::com_ptr<ID3D11Texture2D> GetSurface() const = 0;
+
+        // Newest frame. Called from the render thread only, a source may reuse the previous frame's surface
+        // for writing once the next frame has been acquired.
+        virtual GraphicsFrameLease AcquireFrame() const = 0;
+
+        // Called from the render thread once the frame with Generation was drawn or found unchanged.
+        // Sources that hand out frames at the pace of their consumer advance here, the others ignore it.
+        virtual void OnFrameConsumed(_In_ uint64_t Generation) const { UNREFERENCED_PARAMETER(Generation); }
+
+        // Union of the regions that changed in the last acquired frame, in surface coordinates, for sources that
+        // report dirty regions. Other sources return the bounds of the source window on the desktop.
         virtual winrt::hresult GetDirtyRect(RECT& DirtyRect) const = 0;
 
         virtual bool IsValid() const = 0;
@@ -18,10 +44,18 @@ namespace Mi::Core
         virtual bool IsBorderRequired() const = 0;
         virtual void IsBorderRequired(_In_ bool Enabled) = 0;
 
+        // Sources that can not tell when a new frame was written return false,
+        // their consumers have to poll GetSurface() instead of waiting for the update event.
+        virtual bool IsUpdateEventSupported() const = 0;
+
         virtual void SubscribeClosedEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept = 0;
         virtual void SubscribeResizeEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept = 0;
+        virtual void SubscribeUpdateEvent(_In_ const std::function<void(_In_ HWND Window)>& Handler) noexcept = 0;
     };
 }
 
 #include "Core.GraphicsCapture.Window.h"
 #include "Core.GraphicsCapture.Texture.h"
+#include "Core.GraphicsCapture.Memory.h"
+#include "Core.GraphicsCapture.File.h"
+#include "Core.GraphicsCapture.Pattern.h"
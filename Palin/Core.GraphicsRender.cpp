@@ -1,7 +1,10 @@
 #include "Core.GraphicsRender.h"
+#include "Core.ShaderCache.h"
+#include "Core.Trace.h"
 
-#include <d3dcompiler.h>
-#pragma comment(lib, "d3dcompiler.lib")
+// Generated by FxCompile into $(IntDir)
+#include "Shader.VertexShader.h"
+#include "Shader.PixelShader.h"
 
 namespace Mi::Core
 {
@@ -17,11 +20,22 @@ namespace Mi::Core
         DXGI_SWAP_CHAIN_DESC1 SwapChainDesc{};
         winrt::check_hresult(SwapChain->GetDesc1(&SwapChainDesc));
         winrt::check_hresult(SwapChain->GetDevice(IID_PPV_ARGS(&mDevice)));
+        mDevice->GetImmediateContext(mDeviceContext.put());
+
+        mSwapChainSize = { static_cast<LONG>(SwapChainDesc.Width), static_cast<LONG>(SwapChainDesc.Height) };
+
+        mTearingSupported = !!(SwapChainDesc.Flags & DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING);
+
+        if (SwapChainDesc.Flags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT) {
+            mFrameLatencyWaitable.attach(mSwapChain.as<IDXGISwapChain2>()->GetFrameLatencyWaitableObject());
+        }
+
         winrt::check_hresult(CreateRenderTargetView());
         winrt::check_hresult(SetViewPort(SwapChainDesc.Width, SwapChainDesc.Height));
         winrt::check_hresult(CreateSamplerState());
         winrt::check_hresult(CreateBlendState());
         winrt::check_hresult(CreateShaders());
+        winrt::check_hresult(CreateVertexBuffer());
     }
 
     GraphicsRender::~GraphicsRender()
@@ -40,15 +54,18 @@ namespace Mi::Core
         _In_opt_ const DXGI_PRESENT_PARAMETERS* PresentParameters
     ) const
     {
+        const TraceSpan Span("GraphicsRender::EndFrame");
+
         constexpr DXGI_PRESENT_PARAMETERS Empty{};
         if (PresentParameters == nullptr) {
             PresentParameters = &Empty;
         }
 
-        return mSwapChain->Present1(
-            SyncInterval,
-            SyncInterval ? PresentFlags : (PresentFlags | DXGI_PRESENT_ALLOW_TEARING),
-            PresentParameters);
+        // Tearing is only valid for sync interval 0 on swap chains created with DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING
+        const UINT Flags = (SyncInterval == 0 && mTearingSupported)
+            ? PresentFlags : (PresentFlags & ~DXGI_PRESENT_ALLOW_TEARING);
+
+        return mSwapChain->Present1(SyncInterval, Flags, PresentParameters);
     }
 
     winrt::hresult GraphicsRender::Draw(
@@ -56,83 +73,72 @@ namespace Mi::Core
         _In_opt_ const RECT*  Dirty,
         _In_opt_ const bool   BlendState,
         _In_opt_ const POINT  Offset,
-        _In_opt_ const DXGI_MODE_ROTATION RotationMode) const
+        _In_opt_ const DXGI_MODE_ROTATION RotationMode)
     {
-        winrt::hresult Result;
-
-        do {
-
-            D3D11_TEXTURE2D_DESC TextureDesc{};
-            Texture->GetDesc(&TextureDesc);
-
-            VERTEX Vertices[NUMBER_VERTICES]{};
-            Result = SetDirtyVertex(Vertices, Dirty, { static_cast<long>(TextureDesc.Width), static_cast<long>(TextureDesc.Height) },
-                Offset, RotationMode);
-            if (FAILED(Result)) {
-                return Result;
-            }
-
-            // Create new shader resource view
-            D3D11_SHADER_RESOURCE_VIEW_DESC ShaderDesc{};
-            ShaderDesc.Format                    = TextureDesc.Format;
-            ShaderDesc.ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D;
-            ShaderDesc.Texture2D.MostDetailedMip = TextureDesc.MipLevels - 1;
-            ShaderDesc.Texture2D.MipLevels       = TextureDesc.MipLevels;
+        const TraceSpan Span("GraphicsRender::Draw");
 
-            winrt::com_ptr<ID3D11ShaderResourceView> ShaderResource{};
-            Result = mDevice->CreateShaderResourceView(Texture, &ShaderDesc, ShaderResource.put());
-            if (FAILED(Result)) {
-                return Result;
-            }
+        ++mFrameNumber;
 
-            // Create vertex buffer
-            D3D11_BUFFER_DESC BufferDesc{};
-            BufferDesc.Usage            = D3D11_USAGE_DEFAULT;
-            BufferDesc.ByteWidth        = sizeof(VERTEX) * NUMBER_VERTICES;
-            BufferDesc.BindFlags        = D3D11_BIND_VERTEX_BUFFER;
-            BufferDesc.CPUAccessFlags   = 0;
-
-            D3D11_SUBRESOURCE_DATA InitData{};
-            InitData.pSysMem = Vertices;
-            
-            winrt::com_ptr<ID3D11Buffer> VertexBuffer{};
-            Result = mDevice->CreateBuffer(&BufferDesc, &InitData, VertexBuffer.put());
-            if (FAILED(Result)) {
-                break;
-            }
+        D3D11_TEXTURE2D_DESC TextureDesc{};
+        Texture->GetDesc(&TextureDesc);
 
-            // Set draw parameters
-            winrt::com_ptr<ID3D11DeviceContext> DeviceContext{};
-            mDevice->GetImmediateContext(DeviceContext.put());
+        winrt::com_ptr<ID3D11ShaderResourceView> ShaderResource{};
+        winrt::hresult Result = GetShaderResourceView(Texture, TextureDesc, ShaderResource.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
 
-            constexpr FLOAT BlendFactor[4] = { 0.f, 0.f, 0.f, 0.f };
-            DeviceContext->OMSetBlendState(BlendState ? mBlendState.get() : nullptr, BlendFactor, 0xFFFFFFFF);
+        Result = UpdateVertexBuffer(Dirty, { static_cast<long>(TextureDesc.Width), static_cast<long>(TextureDesc.Height) },
+            Offset, RotationMode);
+        if (FAILED(Result)) {
+            return Result;
+        }
 
-            DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-            DeviceContext->IASetInputLayout(mInputLayout.get());
-            DeviceContext->VSSetShader(mVertexShader.get(), nullptr, 0);
-            DeviceContext->PSSetShader(mPixelShader.get(), nullptr, 0);
+        const bool GpuTiming = BeginGpuTiming();
 
-            ID3D11ShaderResourceView* const ShaderResources[] = { ShaderResource.get() };
-            DeviceContext->PSSetShaderResources(0, _countof(ShaderResources), ShaderResources);
+        // Set draw parameters, only the state that changed since the last frame is rebound
+        const bool Rebind = !mPipelineBound;
+        if (Rebind) {
+            mDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            mDeviceContext->IASetInputLayout(mInputLayout.get());
+            mDeviceContext->VSSetShader(mVertexShader.get(), nullptr, 0);
+            mDeviceContext->PSSetShader(mPixelShader.get(), nullptr, 0);
 
             ID3D11SamplerState* const Samplers[] = { mSamplerState.get() };
-            DeviceContext->PSSetSamplers(0, _countof(Samplers), Samplers);
+            mDeviceContext->PSSetSamplers(0, _countof(Samplers), Samplers);
 
             UINT Stride   = sizeof(VERTEX);
             UINT VBOffset = 0;
-            ID3D11Buffer* const VertexBuffers[] = { VertexBuffer.get() };
-            DeviceContext->IASetVertexBuffers(0, _countof(VertexBuffers), VertexBuffers, &Stride, &VBOffset);
+            ID3D11Buffer* const VertexBuffers[] = { mVertexBuffer.get() };
+            mDeviceContext->IASetVertexBuffers(0, _countof(VertexBuffers), VertexBuffers, &Stride, &VBOffset);
+
+            mPipelineBound = true;
+        }
+
+        // Flip model swap chains unbind the back buffer on every Present
+        ID3D11RenderTargetView* const RenderTargets[] = { mRenderTargetView.get() };
+        mDeviceContext->OMSetRenderTargets(_countof(RenderTargets), RenderTargets, nullptr);
+
+        if (const auto NewBlendState = BlendState ? mBlendState.get() : nullptr; Rebind || NewBlendState != mBoundBlendState) {
+            constexpr FLOAT BlendFactor[4] = { 0.f, 0.f, 0.f, 0.f };
+            mDeviceContext->OMSetBlendState(NewBlendState, BlendFactor, 0xFFFFFFFF);
+            mBoundBlendState = NewBlendState;
+        }
 
-            ID3D11RenderTargetView* const RenderTargets[] = { mRenderTargetView.get() };
-            DeviceContext->OMSetRenderTargets(_countof(RenderTargets), RenderTargets, nullptr);
+        if (Rebind || ShaderResource.get() != mBoundShaderResource) {
+            ID3D11ShaderResourceView* const ShaderResources[] = { ShaderResource.get() };
+            mDeviceContext->PSSetShaderResources(0, _countof(ShaderResources), ShaderResources);
+            mBoundShaderResource = ShaderResource.get();
+        }
 
-            // Draw
-            DeviceContext->Draw(NUMBER_VERTICES, 0);
+        // Draw
+        mDeviceContext->Draw(NUMBER_VERTICES, 0);
 
-        } while (false);
+        if (GpuTiming) {
+            EndGpuTiming();
+        }
 
-        return Result;
+        return S_OK;
     }
 
     winrt::hresult GraphicsRender::GetBackBuffer(ID3D11Texture2D** BackBuffer) const
@@ -145,9 +151,27 @@ namespace Mi::Core
         return mSwapChain;
     }
 
+    HANDLE GraphicsRender::GetFrameLatencyWaitableObject() const
+    {
+        return mFrameLatencyWaitable.get();
+    }
+
+    winrt::hresult GraphicsRender::SetMaximumFrameLatency(_In_ const UINT MaxLatency) const
+    {
+        if (!mFrameLatencyWaitable) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        return mSwapChain.as<IDXGISwapChain2>()->SetMaximumFrameLatency(MaxLatency);
+    }
+
     winrt::hresult GraphicsRender::Resize(_In_ const UINT Width, _In_ const UINT Height, _In_ const DXGI_FORMAT Format)
     {
+        // The swap chain buffers can not be resized while still bound
+        mDeviceContext->OMSetRenderTargets(0, nullptr, nullptr);
         mRenderTargetView = nullptr;
+        mPipelineBound    = false;
+        mVertexBufferKey.reset();
 
         DXGI_SWAP_CHAIN_DESC1 SwapChainDesc{};
         winrt::hresult Result = mSwapChain->GetDesc1(&SwapChainDesc);
@@ -160,6 +184,8 @@ namespace Mi::Core
             return Result;
         }
 
+        mSwapChainSize = { static_cast<LONG>(Width), static_cast<LONG>(Height) };
+
         Result = CreateRenderTargetView();
         if (FAILED(Result)) {
             return Result;
@@ -173,8 +199,129 @@ namespace Mi::Core
         return S_OK;
     }
 
+    winrt::hresult GraphicsRender::SetGpuTiming(_In_ const bool Enable)
+    {
+        mGpuTimingQueries.clear();
+        mGpuTimingWrite = 0;
+        mGpuTimingRead  = 0;
+
+        if (!Enable) {
+            return S_OK;
+        }
+
+        std::vector<GpuTimingQuery> Queries(GPU_TIMING_QUERY_COUNT);
+        for (auto& Query : Queries) {
+            D3D11_QUERY_DESC QueryDesc{};
+            QueryDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+
+            winrt::hresult Result = mDevice->CreateQuery(&QueryDesc, Query.Disjoint.put());
+            if (FAILED(Result)) {
+                return Result;
+            }
+
+            QueryDesc.Query = D3D11_QUERY_TIMESTAMP;
+
+            Result = mDevice->CreateQuery(&QueryDesc, Query.Begin.put());
+            if (FAILED(Result)) {
+                return Result;
+            }
+
+            Result = mDevice->CreateQuery(&QueryDesc, Query.End.put());
+            if (FAILED(Result)) {
+                return Result;
+            }
+        }
+
+        mGpuTimingQueries = std::move(Queries);
+        return S_OK;
+    }
+
+    winrt::hresult GraphicsRender::ReadGpuTiming(_Out_ GpuTiming& Timing)
+    {
+        Timing = {};
+
+        while (!mGpuTimingQueries.empty()) {
+            auto& Query = mGpuTimingQueries[mGpuTimingRead];
+            if (!Query.Pending) {
+                return S_FALSE;
+            }
+
+            // D3D11_ASYNC_GETDATA_DONOTFLUSH keeps this from stalling or flushing the render thread
+            D3D11_QUERY_DATA_TIMESTAMP_DISJOINT Disjoint{};
+            winrt::hresult Result = mDeviceContext->GetData(Query.Disjoint.get(), &Disjoint, sizeof(Disjoint),
+                D3D11_ASYNC_GETDATA_DONOTFLUSH);
+            if (Result != S_OK) {
+                return Result;
+            }
+
+            UINT64 Begin = 0;
+            UINT64 End   = 0;
+            Result = mDeviceContext->GetData(Query.Begin.get(), &Begin, sizeof(Begin), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+            if (Result != S_OK) {
+                return Result;
+            }
+
+            Result = mDeviceContext->GetData(Query.End.get(), &End, sizeof(End), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+            if (Result != S_OK) {
+                return Result;
+            }
+
+            Query.Pending  = false;
+            mGpuTimingRead = (mGpuTimingRead + 1) % mGpuTimingQueries.size();
+
+            // The counter frequency changed in between, the timestamps can not be used
+            if (Disjoint.Disjoint || Disjoint.Frequency == 0 || End < Begin) {
+                continue;
+            }
+
+            Timing.FrameNumber = Query.FrameNumber;
+            Timing.Duration    = std::chrono::nanoseconds(static_cast<int64_t>(
+                static_cast<double>(End - Begin) * 1'000'000'000.0 / static_cast<double>(Disjoint.Frequency)));
+            return S_OK;
+        }
+
+        return S_FALSE;
+    }
+
+    uint64_t GraphicsRender::GetFrameNumber() const
+    {
+        return mFrameNumber;
+    }
+
+    GraphicsRenderStatistics GraphicsRender::GetStatistics() const
+    {
+        return mStatistics;
+    }
+
+    void GraphicsRender::ResetStatistics()
+    {
+        mStatistics = {};
+    }
+
+    void GraphicsRender::ReleaseResourceCache()
+    {
+        if (mDeviceContext) {
+            ID3D11ShaderResourceView* const ShaderResources[] = { nullptr };
+            mDeviceContext->PSSetShaderResources(0, _countof(ShaderResources), ShaderResources);
+        }
+
+        mBoundShaderResource = nullptr;
+        mResourceCache.clear();
+    }
+
     void GraphicsRender::Close()
     {
+        ReleaseResourceCache();
+
+        mGpuTimingQueries.clear();
+        mGpuTimingWrite   = 0;
+        mGpuTimingRead    = 0;
+
+        mVertexBuffer     = nullptr;
+        mVertexBufferKey.reset();
+        mPipelineBound    = false;
+        mBoundBlendState  = nullptr;
+
         mVertexShader     = nullptr;
         mPixelShader      = nullptr;
         mInputLayout      = nullptr;
@@ -182,108 +329,220 @@ namespace Mi::Core
         mSamplerState     = nullptr;
         mBlendState       = nullptr;
         mSwapChain        = nullptr;
+        mFrameLatencyWaitable.close();
+        mDeviceContext    = nullptr;
         mDevice           = nullptr;
     }
 
+    bool GraphicsRender::BeginGpuTiming()
+    {
+        if (mGpuTimingQueries.empty()) {
+            return false;
+        }
+
+        const auto& Query = mGpuTimingQueries[mGpuTimingWrite];
+        if (Query.Pending) {
+            return false;
+        }
+
+        mDeviceContext->Begin(Query.Disjoint.get());
+        mDeviceContext->End(Query.Begin.get());
+        return true;
+    }
+
+    void GraphicsRender::EndGpuTiming()
+    {
+        auto& Query = mGpuTimingQueries[mGpuTimingWrite];
+
+        mDeviceContext->End(Query.End.get());
+        mDeviceContext->End(Query.Disjoint.get());
+
+        Query.FrameNumber = mFrameNumber;
+        Query.Pending     = true;
+        mGpuTimingWrite   = (mGpuTimingWrite + 1) % mGpuTimingQueries.size();
+    }
+
     winrt::hresult GraphicsRender::CreateShaders()
     {
-        winrt::hresult Result;
-
-        do {
-            // Create the vertex shader
-            static constexpr char VERTEX_SHADER[] = R"(
-                struct VS_INPUT
-                {
-                    float4 Pos : POSITION;
-                    float2 Tex : TEXCOORD;
-                };
-
-                struct VS_OUTPUT
-                {
-                    float4 Pos : SV_POSITION;
-                    float2 Tex : TEXCOORD;
-                };
-
-                VS_OUTPUT VS(VS_INPUT input)
-                {
-                    return input;
-                }
-            )";
-
-            winrt::com_ptr<ID3DBlob> ErrorMsgBlob{};
-            winrt::com_ptr<ID3DBlob> VertexShaderBlob{};
-            Result = D3DCompile(VERTEX_SHADER, _countof(VERTEX_SHADER), nullptr, nullptr, nullptr,
-                "VS", "vs_4_0", 0, 0, VertexShaderBlob.put(), ErrorMsgBlob.put());
-            if (FAILED(Result)) {
-                break;
-            }
+        // The bytecode is compiled by FxCompile at build time, see Shader.*.hlsl
+        winrt::hresult Result = mDevice->CreateVertexShader(VERTEX_SHADER_BYTECODE, sizeof(VERTEX_SHADER_BYTECODE),
+            nullptr, mVertexShader.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        Result = mDevice->CreatePixelShader(PIXEL_SHADER_BYTECODE, sizeof(PIXEL_SHADER_BYTECODE),
+            nullptr, mPixelShader.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        static constexpr D3D11_INPUT_ELEMENT_DESC INPUT_LAYOUT[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+        };
 
-            Result = mDevice->CreateVertexShader(VertexShaderBlob->GetBufferPointer(), VertexShaderBlob->GetBufferSize(),
-                nullptr, mVertexShader.put());
+        Result = mDevice->CreateInputLayout(INPUT_LAYOUT, _countof(INPUT_LAYOUT),
+            VERTEX_SHADER_BYTECODE, sizeof(VERTEX_SHADER_BYTECODE), mInputLayout.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        mDeviceContext->PSSetShader(mPixelShader.get(), nullptr, 0);
+        mDeviceContext->VSSetShader(mVertexShader.get(), nullptr, 0);
+        mDeviceContext->IASetInputLayout(mInputLayout.get());
+
+        return S_OK;
+    }
+
+    winrt::hresult GraphicsRender::SetPixelShader(_In_ std::string_view Source, _In_opt_ LPCSTR EntryPoint)
+    {
+        winrt::com_ptr<ID3D11PixelShader> PixelShader{};
+
+        if (Source.empty()) {
+            const winrt::hresult Result = mDevice->CreatePixelShader(PIXEL_SHADER_BYTECODE, sizeof(PIXEL_SHADER_BYTECODE),
+                nullptr, PixelShader.put());
             if (FAILED(Result)) {
                 return Result;
             }
+        }
+        else {
+            std::vector<uint8_t> Bytecode;
 
-            // Create the pixel shader
-            static constexpr char PIXEL_SHADER[] = R"(
-                Texture2D tx : register( t0 );
-                SamplerState samLinear : register( s0 );
-
-                struct PS_INPUT
-                {
-                    float4 Pos : SV_POSITION;
-                    float2 Tex : TEXCOORD;
-                };
-
-                float4 PS(PS_INPUT input) : SV_Target
-                {
-                    return tx.Sample( samLinear, input.Tex );
-                }
-            )";
-
-            winrt::com_ptr<ID3DBlob> PixelShaderBlob{};
-            Result = D3DCompile(PIXEL_SHADER, _countof(PIXEL_SHADER), nullptr, nullptr, nullptr,
-                "PS", "ps_4_0", 0, 0, PixelShaderBlob.put(), ErrorMsgBlob.put());
+            winrt::hresult Result = ShaderCache(ShaderCache::GetDefaultDirectory()).Compile(
+                Source, EntryPoint ? EntryPoint : "PS", "ps_4_0", Bytecode);
             if (FAILED(Result)) {
-                break;
+                return Result;
             }
 
-            Result = mDevice->CreatePixelShader(PixelShaderBlob->GetBufferPointer(), PixelShaderBlob->GetBufferSize(),
-                nullptr, mPixelShader.put());
+            Result = mDevice->CreatePixelShader(Bytecode.data(), Bytecode.size(), nullptr, PixelShader.put());
             if (FAILED(Result)) {
                 return Result;
             }
+        }
+
+        mPixelShader   = std::move(PixelShader);
+        mPipelineBound = false;
+
+        return S_OK;
+    }
+
+    winrt::hresult GraphicsRender::CreateVertexBuffer()
+    {
+        D3D11_BUFFER_DESC BufferDesc{};
+        BufferDesc.Usage            = D3D11_USAGE_DYNAMIC;
+        BufferDesc.ByteWidth        = sizeof(VERTEX) * NUMBER_VERTICES;
+        BufferDesc.BindFlags        = D3D11_BIND_VERTEX_BUFFER;
+        BufferDesc.CPUAccessFlags   = D3D11_CPU_ACCESS_WRITE;
+
+        return mDevice->CreateBuffer(&BufferDesc, nullptr, mVertexBuffer.put());
+    }
+
+    winrt::hresult GraphicsRender::GetShaderResourceView(
+        _In_  ID3D11Texture2D* Texture,
+        _In_  const D3D11_TEXTURE2D_DESC& TextureDesc,
+        _Out_ ID3D11ShaderResourceView** ShaderResource)
+    {
+        *ShaderResource = nullptr;
 
-            static constexpr D3D11_INPUT_ELEMENT_DESC INPUT_LAYOUT[] =
+        // The entry holds a reference to the texture, so its address can not be reused while cached.
+        const auto Entry = std::find_if(mResourceCache.begin(), mResourceCache.end(), [&](const ResourceCacheEntry& Item)
+        {
+            return Item.Texture.get()         == Texture
+                && Item.TextureDesc.Width     == TextureDesc.Width
+                && Item.TextureDesc.Height    == TextureDesc.Height
+                && Item.TextureDesc.Format    == TextureDesc.Format
+                && Item.TextureDesc.MipLevels == TextureDesc.MipLevels;
+        });
+
+        if (Entry != mResourceCache.end()) {
+            ++mStatistics.ResourceCacheHits;
+
+            Entry->LastUsed = mFrameNumber;
+            Entry->ShaderResource.copy_to(ShaderResource);
+            return S_OK;
+        }
+
+        ++mStatistics.ResourceCacheMisses;
+
+        // Create new shader resource view
+        D3D11_SHADER_RESOURCE_VIEW_DESC ShaderDesc{};
+        ShaderDesc.Format                    = TextureDesc.Format;
+        ShaderDesc.ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D;
+        ShaderDesc.Texture2D.MostDetailedMip = TextureDesc.MipLevels - 1;
+        ShaderDesc.Texture2D.MipLevels       = TextureDesc.MipLevels;
+
+        ResourceCacheEntry NewEntry{};
+        const winrt::hresult Result = mDevice->CreateShaderResourceView(Texture, &ShaderDesc, NewEntry.ShaderResource.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        NewEntry.Texture.copy_from(Texture);
+        NewEntry.TextureDesc = TextureDesc;
+        NewEntry.LastUsed    = mFrameNumber;
+        NewEntry.ShaderResource.copy_to(ShaderResource);
+
+        if (mResourceCache.size() >= RESOURCE_CACHE_CAPACITY) {
+            const auto Oldest = std::min_element(mResourceCache.begin(), mResourceCache.end(),
+                [](const ResourceCacheEntry& Left, const ResourceCacheEntry& Right)
             {
-                { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-                { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-            };
+                return Left.LastUsed < Right.LastUsed;
+            });
 
-            Result = mDevice->CreateInputLayout(INPUT_LAYOUT, _countof(INPUT_LAYOUT),
-                VertexShaderBlob->GetBufferPointer(),
-                VertexShaderBlob->GetBufferSize(), mInputLayout.put());
-            if (FAILED(Result)) {
-                return Result;
+            if (Oldest->ShaderResource.get() == mBoundShaderResource) {
+                mBoundShaderResource = nullptr;
             }
+            *Oldest = std::move(NewEntry);
+        }
+        else {
+            mResourceCache.emplace_back(std::move(NewEntry));
+        }
+
+        return S_OK;
+    }
+
+    winrt::hresult GraphicsRender::UpdateVertexBuffer(
+        _In_opt_ const RECT* Dirty,
+        _In_     const SIZE  ThisSize,
+        _In_opt_ const POINT Offset,
+        _In_opt_ const DXGI_MODE_ROTATION RotationMode)
+    {
+        VertexBufferKey Key{};
+        Key.Dirty         = Dirty ? *Dirty : RECT{ 0, 0, ThisSize.cx, ThisSize.cy };
+        Key.ThisSize      = ThisSize;
+        Key.SwapChainSize = mSwapChainSize;
+        Key.Offset        = Offset;
+        Key.RotationMode  = RotationMode;
+
+        if (mVertexBufferKey == Key) {
+            return S_OK;
+        }
+
+        VERTEX Vertices[NUMBER_VERTICES]{};
+        winrt::hresult Result = SetDirtyVertex(Vertices, Dirty, ThisSize, Offset, RotationMode);
+        if (FAILED(Result)) {
+            return Result;
+        }
 
-            winrt::com_ptr<ID3D11DeviceContext> DeviceContext{};
-            mDevice->GetImmediateContext(DeviceContext.put());
+        D3D11_MAPPED_SUBRESOURCE Mapped{};
+        Result = mDeviceContext->Map(mVertexBuffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &Mapped);
+        if (FAILED(Result)) {
+            return Result;
+        }
 
-            DeviceContext->PSSetShader(mPixelShader.get(), nullptr, 0);
-            DeviceContext->VSSetShader(mVertexShader.get(), nullptr, 0);
-            DeviceContext->IASetInputLayout(mInputLayout.get());
+        memcpy(Mapped.pData, Vertices, sizeof(Vertices));
+        mDeviceContext->Unmap(mVertexBuffer.get(), 0);
 
-        } while (false);
+        ++mStatistics.VertexBufferUpdates;
 
-        return Result;
+        mVertexBufferKey = Key;
+        return S_OK;
     }
 
     winrt::hresult GraphicsRender::CreateRenderTargetView()
     {
-        winrt::com_ptr<ID3D11DeviceContext> DeviceContext{};
-        mDevice->GetImmediateContext(DeviceContext.put());
-        
         winrt::com_ptr<ID3D11Texture2D> BackBuffer{};
         winrt::hresult Result = mSwapChain->GetBuffer(0, IID_PPV_ARGS(&BackBuffer));
         if (FAILED(Result)) {
@@ -300,15 +559,12 @@ namespace Mi::Core
             mRenderTargetView.get()
         };
 
-        DeviceContext->OMSetRenderTargets(_countof(RenderTargets), RenderTargets, nullptr);
+        mDeviceContext->OMSetRenderTargets(_countof(RenderTargets), RenderTargets, nullptr);
         return S_OK;
     }
 
     winrt::hresult GraphicsRender::CreateSamplerState()
     {
-        winrt::com_ptr<ID3D11DeviceContext> DeviceContext{};
-        mDevice->GetImmediateContext(DeviceContext.put());
-
         D3D11_SAMPLER_DESC SamplerDesc{};
         SamplerDesc.Filter          = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
         SamplerDesc.AddressU        = D3D11_TEXTURE_ADDRESS_CLAMP;
@@ -328,7 +584,7 @@ namespace Mi::Core
             mSamplerState.get()
         };
 
-        DeviceContext->PSSetSamplers(0, _countof(Samplers), Samplers);
+        mDeviceContext->PSSetSamplers(0, _countof(Samplers), Samplers);
         return S_OK;
     }
 
@@ -359,10 +615,7 @@ namespace Mi::Core
         ViewPort.TopLeftX   = 0.0f;
         ViewPort.TopLeftY   = 0.0f;
 
-        winrt::com_ptr<ID3D11DeviceContext> DeviceContext{};
-        mDevice->GetImmediateContext(DeviceContext.put());
-
-        DeviceContext->RSSetViewports(1, &ViewPort);
+        mDeviceContext->RSSetViewports(1, &ViewPort);
         return S_OK;
     }
 
@@ -373,13 +626,8 @@ namespace Mi::Core
         _In_opt_ const POINT Offset,
         _In_opt_ const DXGI_MODE_ROTATION RotationMode) const
     {
-        DXGI_SWAP_CHAIN_DESC1 SwapChainDesc{};
-        if (const winrt::hresult Result = mSwapChain->GetDesc1(&SwapChainDesc); FAILED(Result)) {
-            return Result;
-        }
-
-        const INT CenterX = static_cast<INT>(SwapChainDesc.Width ) / 2;
-        const INT CenterY = static_cast<INT>(SwapChainDesc.Height) / 2;
+        const INT CenterX = static_cast<INT>(mSwapChainSize.cx) / 2;
+        const INT CenterY = static_cast<INT>(mSwapChainSize.cy) / 2;
 
         const INT Width   = ThisSize.cx;
         const INT Height  = ThisSize.cy;
@@ -3,6 +3,23 @@
 namespace Mi::Core
 {
     constexpr size_t NUMBER_VERTICES = 6;
+    constexpr size_t RESOURCE_CACHE_CAPACITY = 4;
+
+    // Timestamp query sets in flight, results are read back this many frames late at most.
+    constexpr size_t GPU_TIMING_QUERY_COUNT = 4;
+
+    struct GpuTiming
+    {
+        uint64_t                 FrameNumber = 0;
+        std::chrono::nanoseconds Duration{ 0 };
+    };
+
+    struct GraphicsRenderStatistics
+    {
+        uint64_t ResourceCacheHits   = 0;
+        uint64_t ResourceCacheMisses = 0;
+        uint64_t VertexBufferUpdates = 0;
+    };
 
     class GraphicsRender
     {
@@ -27,26 +44,63 @@ namespace Mi::Core
             _In_opt_ const RECT*  Dirty = nullptr,
             _In_opt_ bool   BlendState  = true,
             _In_opt_ POINT  Offset      = {},
-            _In_opt_ DXGI_MODE_ROTATION RotationMode = DXGI_MODE_ROTATION::DXGI_MODE_ROTATION_IDENTITY) const;
+            _In_opt_ DXGI_MODE_ROTATION RotationMode = DXGI_MODE_ROTATION::DXGI_MODE_ROTATION_IDENTITY);
 
         winrt::hresult GetBackBuffer(_Out_ ID3D11Texture2D** BackBuffer) const;
         [[nodiscard]] winrt::com_ptr<IDXGISwapChain1> GetSwapChain() const;
 
+        // Only available when the swap chain was created with DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT.
+        [[nodiscard]] HANDLE GetFrameLatencyWaitableObject() const;
+        winrt::hresult SetMaximumFrameLatency(_In_ UINT MaxLatency) const;
+
         winrt::hresult Resize(
             _In_ UINT Width,
             _In_ UINT Height,
             _In_ DXGI_FORMAT Format
         );
 
+        // Replaces the built-in pixel shader, an empty source restores it.
+        // Custom shaders are compiled at runtime and cached on disk by content hash.
+        winrt::hresult SetPixelShader(
+            _In_     std::string_view Source,
+            _In_opt_ LPCSTR EntryPoint = nullptr);
+
+        // Brackets Draw() with timestamp queries. Frames are skipped rather than waiting when all query sets are in flight.
+        winrt::hresult SetGpuTiming(_In_ bool Enable);
+
+        // Returns S_FALSE while the oldest query set is not ready yet, never blocks.
+        winrt::hresult ReadGpuTiming(_Out_ GpuTiming& Timing);
+
+        [[nodiscard]] uint64_t GetFrameNumber() const;
+        [[nodiscard]] GraphicsRenderStatistics GetStatistics() const;
+        void ResetStatistics();
+        void ReleaseResourceCache();
+
         void Close();
 
     private:
         winrt::hresult CreateShaders();
+        winrt::hresult CreateVertexBuffer();
         winrt::hresult CreateRenderTargetView();
         winrt::hresult CreateSamplerState();
         winrt::hresult CreateBlendState();
         [[nodiscard]] winrt::hresult SetViewPort(_In_ UINT Width, _In_ UINT Height) const;
 
+        // Returns false when timing is disabled or every query set is still in flight.
+        bool BeginGpuTiming();
+        void EndGpuTiming();
+
+        winrt::hresult GetShaderResourceView(
+            _In_  ID3D11Texture2D* Texture,
+            _In_  const D3D11_TEXTURE2D_DESC& TextureDesc,
+            _Out_ ID3D11ShaderResourceView** ShaderResource);
+
+        winrt::hresult UpdateVertexBuffer(
+            _In_opt_ const RECT* Dirty,
+            _In_       SIZE  ThisSize,
+            _In_opt_   POINT Offset,
+            _In_opt_   DXGI_MODE_ROTATION RotationMode);
+
         winrt::hresult SetDirtyVertex(
             _Out_writes_(NUMBER_VERTICES) struct VERTEX* Vertices,
             _In_ const RECT* Dirty,
@@ -55,8 +109,43 @@ namespace Mi::Core
             _In_opt_   DXGI_MODE_ROTATION RotationMode) const;
 
     private:
+        struct ResourceCacheEntry
+        {
+            winrt::com_ptr<ID3D11Texture2D>          Texture{};
+            winrt::com_ptr<ID3D11ShaderResourceView> ShaderResource{};
+            D3D11_TEXTURE2D_DESC                     TextureDesc{};
+            uint64_t                                 LastUsed = 0;
+        };
+
+        struct GpuTimingQuery
+        {
+            winrt::com_ptr<ID3D11Query> Disjoint{};
+            winrt::com_ptr<ID3D11Query> Begin{};
+            winrt::com_ptr<ID3D11Query> End{};
+            uint64_t                    FrameNumber = 0;
+            bool                        Pending     = false;
+        };
+
+        struct VertexBufferKey
+        {
+            RECT               Dirty{};
+            SIZE               ThisSize{};
+            SIZE               SwapChainSize{};
+            POINT              Offset{};
+            DXGI_MODE_ROTATION RotationMode = DXGI_MODE_ROTATION_UNSPECIFIED;
+
+            bool operator==(const VertexBufferKey& Other) const noexcept
+            {
+                return memcmp(this, &Other, sizeof(VertexBufferKey)) == 0;
+            }
+        };
+
         winrt::com_ptr<ID3D11Device>            mDevice{};
+        winrt::com_ptr<ID3D11DeviceContext>     mDeviceContext{};
         winrt::com_ptr<IDXGISwapChain1>         mSwapChain{};
+        SIZE                                    mSwapChainSize{};
+        winrt::handle                           mFrameLatencyWaitable{};
+        bool                                    mTearingSupported = false;
 
         winrt::com_ptr<ID3D11RenderTargetView>  mRenderTargetView{};
         winrt::com_ptr<ID3D11SamplerState>      mSamplerState{};
@@ -65,6 +154,24 @@ namespace Mi::Core
         winrt::com_ptr<ID3D11VertexShader>      mVertexShader{};
         winrt::com_ptr<ID3D11PixelShader>       mPixelShader{};
         winrt::com_ptr<ID3D11InputLayout>       mInputLayout{};
+
+        // Steady-state frames reuse these instead of creating new D3D objects.
+        winrt::com_ptr<ID3D11Buffer>            mVertexBuffer{};
+        std::optional<VertexBufferKey>          mVertexBufferKey{};
+        std::vector<ResourceCacheEntry>         mResourceCache{};
+        uint64_t                                mFrameNumber = 0;
+
+        // Last state bound to the immediate context by Draw().
+        bool                                    mPipelineBound = false;
+        ID3D11ShaderResourceView*               mBoundShaderResource = nullptr;
+        ID3D11BlendState*                       mBoundBlendState     = nullptr;
+
+        // Ring of timestamp queries, written by Draw() and read in order by ReadGpuTiming().
+        std::vector<GpuTimingQuery>             mGpuTimingQueries{};
+        size_t                                  mGpuTimingWrite = 0;
+        size_t                                  mGpuTimingRead  = 0;
+
+        GraphicsRenderStatistics                mStatistics{};
     };
 
 }
@@ -0,0 +1,126 @@
+#include "Core.ImageFile.h"
+
+#include <wincodec.h>
+#pragma comment(lib, "windowscodecs.lib")
+
+
+namespace Mi::Core
+{
+    static const GUID* GetOpaquePixelFormat(_In_ DXGI_FORMAT Format) noexcept
+    {
+        switch (Format) {
+            case DXGI_FORMAT_B8G8R8A8_UNORM:
+            case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            case DXGI_FORMAT_B8G8R8X8_UNORM:
+            case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+                return &GUID_WICPixelFormat32bppBGR;
+            case DXGI_FORMAT_R8G8B8A8_UNORM:
+            case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+                return &GUID_WICPixelFormat32bppRGB;
+            default:
+                return nullptr;
+        }
+    }
+
+    static winrt::hresult EncodePng(_In_ const ReadbackFrame& Frame, _In_ const GUID& PixelFormat,
+        _In_ const std::filesystem::path& Path)
+    {
+        winrt::com_ptr<IWICImagingFactory> Factory;
+        winrt::hresult Result = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER,
+            IID_PPV_ARGS(Factory.put()));
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        // The mapped rows are wrapped, not copied
+        winrt::com_ptr<IWICBitmap> Bitmap;
+        Result = Factory->CreateBitmapFromMemory(Frame.Width, Frame.Height, PixelFormat, Frame.RowPitch,
+            Frame.RowPitch * Frame.Height, const_cast<BYTE*>(Frame.Data), Bitmap.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        winrt::com_ptr<IWICStream> Stream;
+        Result = Factory->CreateStream(Stream.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        Result = Stream->InitializeFromFilename(Path.c_str(), GENERIC_WRITE);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        winrt::com_ptr<IWICBitmapEncoder> Encoder;
+        Result = Factory->CreateEncoder(GUID_ContainerFormatPng, nullptr, Encoder.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        Result = Encoder->Initialize(Stream.get(), WICBitmapEncoderNoCache);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        winrt::com_ptr<IWICBitmapFrameEncode> FrameEncode;
+        winrt::com_ptr<IPropertyBag2> Options;
+        Result = Encoder->CreateNewFrame(FrameEncode.put(), Options.put());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        Result = FrameEncode->Initialize(Options.get());
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        Result = FrameEncode->SetSize(Frame.Width, Frame.Height);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        // The encoder picks the closest format it supports, WriteSource() converts to it
+        WICPixelFormatGUID EncodeFormat = PixelFormat;
+        Result = FrameEncode->SetPixelFormat(&EncodeFormat);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        Result = FrameEncode->WriteSource(Bitmap.get(), nullptr);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        Result = FrameEncode->Commit();
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        return Encoder->Commit();
+    }
+
+    winrt::hresult SaveFrameAsPng(_In_ const ReadbackFrame& Frame, _In_ const std::filesystem::path& Path)
+    {
+        const auto PixelFormat = GetOpaquePixelFormat(Frame.Format);
+        if (PixelFormat == nullptr || Frame.Data == nullptr) {
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+
+        // Called on worker threads that did not join an apartment, RPC_E_CHANGED_MODE means one is already there
+        const HRESULT InitializeResult = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        if (FAILED(InitializeResult) && InitializeResult != RPC_E_CHANGED_MODE) {
+            return InitializeResult;
+        }
+
+        const winrt::hresult Result = EncodePng(Frame, *PixelFormat, Path);
+        if (FAILED(Result)) {
+            LOG(ERROR, "SaveFrameAsPng(%ls) failed, Result=0x%0*X", Path.c_str(), 8, Result.value);
+        }
+
+        if (SUCCEEDED(InitializeResult)) {
+            CoUninitialize();
+        }
+
+        return Result;
+    }
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "Core.AsyncReadback.h"
+
+
+namespace Mi::Core
+{
+    // Encodes a frame that was read back as PNG. The alpha channel is dropped, swap chain and capture
+    // surfaces do not carry a meaningful one. Only 8 bit BGRA and RGBA surfaces are supported.
+    winrt::hresult SaveFrameAsPng(_In_ const ReadbackFrame& Frame, _In_ const std::filesystem::path& Path);
+}
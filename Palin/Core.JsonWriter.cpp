@@ -0,0 +1,183 @@
+#include "Core.JsonWriter.h"
+
+#include <charconv>
+#include <cmath>
+
+
+namespace Mi::Core
+{
+    JsonWriter::JsonWriter(_In_opt_ bool Indent)
+        : mIndent(Indent)
+    {
+    }
+
+    JsonWriter& JsonWriter::BeginObject()
+    {
+        BeginItem();
+        mBuffer.push_back('{');
+        mHasItems.push_back(false);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::EndObject()
+    {
+        const bool HasItems = !mHasItems.empty() && mHasItems.back();
+        if (!mHasItems.empty()) {
+            mHasItems.pop_back();
+        }
+        if (HasItems) {
+            WriteNewLine();
+        }
+        mBuffer.push_back('}');
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::BeginArray()
+    {
+        BeginItem();
+        mBuffer.push_back('[');
+        mHasItems.push_back(false);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::EndArray()
+    {
+        const bool HasItems = !mHasItems.empty() && mHasItems.back();
+        if (!mHasItems.empty()) {
+            mHasItems.pop_back();
+        }
+        if (HasItems) {
+            WriteNewLine();
+        }
+        mBuffer.push_back(']');
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Key(_In_ std::string_view Name)
+    {
+        BeginItem();
+        WriteString(Name);
+        mBuffer.append(mIndent ? ": " : ":");
+        mAfterKey = true;
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Value(_In_ std::string_view Text)
+    {
+        BeginItem();
+        WriteString(Text);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Value(_In_ bool Boolean)
+    {
+        BeginItem();
+        mBuffer.append(Boolean ? "true" : "false");
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Value(_In_ int64_t Number)
+    {
+        BeginItem();
+
+        char Text[24];
+        const auto End = std::to_chars(Text, Text + sizeof(Text), Number).ptr;
+        mBuffer.append(Text, End);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Value(_In_ uint64_t Number)
+    {
+        BeginItem();
+
+        char Text[24];
+        const auto End = std::to_chars(Text, Text + sizeof(Text), Number).ptr;
+        mBuffer.append(Text, End);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Value(_In_ double Number)
+    {
+        if (!std::isfinite(Number)) {
+            return Null();
+        }
+
+        BeginItem();
+
+        // Shortest text that reads back as the same double
+        char Text[32];
+        const auto End = std::to_chars(Text, Text + sizeof(Text), Number).ptr;
+        mBuffer.append(Text, End);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Null()
+    {
+        BeginItem();
+        mBuffer.append("null");
+        return *this;
+    }
+
+    void JsonWriter::Clear()
+    {
+        mBuffer.clear();
+        mHasItems.clear();
+        mAfterKey = false;
+    }
+
+    void JsonWriter::BeginItem()
+    {
+        // A value after its key is part of the same item
+        if (mAfterKey) {
+            mAfterKey = false;
+            return;
+        }
+
+        if (mHasItems.empty()) {
+            return;
+        }
+
+        if (mHasItems.back()) {
+            mBuffer.push_back(',');
+        }
+        mHasItems.back() = true;
+        WriteNewLine();
+    }
+
+    void JsonWriter::WriteNewLine()
+    {
+        if (mIndent) {
+            mBuffer.push_back('\n');
+            mBuffer.append(mHasItems.size() * 2, ' ');
+        }
+    }
+
+    void JsonWriter::WriteString(_In_ std::string_view Text)
+    {
+        static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+        mBuffer.push_back('"');
+        for (const char Character : Text) {
+            switch (Character) {
+                case '"':  mBuffer.append("\\\""); break;
+                case '\\': mBuffer.append("\\\\"); break;
+                case '\b': mBuffer.append("\\b");  break;
+                case '\f': mBuffer.append("\\f");  break;
+                case '\n': mBuffer.append("\\n");  break;
+                case '\r': mBuffer.append("\\r");  break;
+                case '\t': mBuffer.append("\\t");  break;
+                default:
+                    if (static_cast<unsigned char>(Character) < 0x20) {
+                        mBuffer.append("\\u00");
+                        mBuffer.push_back(HEX_DIGITS[(Character >> 4) & 0xF]);
+                        mBuffer.push_back(HEX_DIGITS[Character & 0xF]);
+                    }
+                    else {
+                        mBuffer.push_back(Character);
+                    }
+                    break;
+            }
+        }
+        mBuffer.push_back('"');
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+
+
+namespace Mi::Core
+{
+    // Streams JSON into a string. Keys and values are written in call order, nesting is tracked but not validated
+    // beyond separators, the caller is expected to pair every Begin with its End.
+    class JsonWriter
+    {
+        std::string       mBuffer;
+        std::vector<bool> mHasItems;    // per open container
+        bool              mIndent   = false;
+        bool              mAfterKey = false;
+
+    public:
+        explicit JsonWriter(_In_opt_ bool Indent = false);
+
+        JsonWriter& BeginObject();
+        JsonWriter& EndObject();
+        JsonWriter& BeginArray();
+        JsonWriter& EndArray();
+
+        JsonWriter& Key(_In_ std::string_view Name);
+
+        JsonWriter& Value(_In_ std::string_view Text);
+        JsonWriter& Value(_In_ const char* Text) { return Value(std::string_view(Text)); }
+        JsonWriter& Value(_In_ bool Boolean);
+        JsonWriter& Value(_In_ int64_t Number);
+        JsonWriter& Value(_In_ uint64_t Number);
+        JsonWriter& Value(_In_ int32_t Number)  { return Value(static_cast<int64_t>(Number)); }
+        JsonWriter& Value(_In_ uint32_t Number) { return Value(static_cast<uint64_t>(Number)); }
+        // NaN and infinities are written as null.
+        JsonWriter& Value(_In_ double Number);
+        JsonWriter& Null();
+
+        template <typename T>
+        JsonWriter& Member(_In_ std::string_view Name, _In_ const T& Item)
+        {
+            return Key(Name).Value(Item);
+        }
+
+        [[nodiscard]] const std::string& GetString() const noexcept { return mBuffer; }
+        void Clear();
+
+    private:
+        void BeginItem();
+        void WriteNewLine();
+        void WriteString(_In_ std::string_view Text);
+    };
+}
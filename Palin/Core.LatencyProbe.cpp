@@ -0,0 +1,185 @@
+#include "Core.LatencyProbe.h"
+
+
+namespace Mi::Core
+{
+    LatencyProbe::~LatencyProbe()
+    {
+        (void)Stop();
+    }
+
+    LatencyProbe::LatencyProbe(_In_ const winrt::com_ptr<ID3D11Device>& Device)
+        : mReadback(Device)
+    {
+    }
+
+    winrt::hresult LatencyProbe::Start()
+    {
+        {
+            std::lock_guard Lock(mMutex);
+            mGenerationToPresent.Reset();
+            mDecoded      = 0;
+            mUndecodable  = 0;
+            mSkipped      = 0;
+            mRepeated     = 0;
+            mLastSubmit   = std::nullopt;
+            mLastSequence = 0;
+            mPresented.fill({});
+            mGenerated.fill({});
+        }
+        mSubmitted = 0;
+        mAwaitingPresent.reset();
+
+        // A few more slots than a recording, the copies are tiny and every dropped one hides a present
+        const winrt::hresult Result = mReadback.Start([this](const ReadbackFrame& Frame) { OnReadback(Frame); },
+            DEFAULT_READBACK_SLOTS * 2);
+        if (FAILED(Result)) {
+            LOG(ERROR, "LatencyProbe::Start(), AsyncReadback::Start failed, Result=0x%0*X", 8, Result.value);
+            return Result;
+        }
+
+        return S_OK;
+    }
+
+    winrt::hresult LatencyProbe::Stop()
+    {
+        if (mReadback.Stop() != S_OK) {
+            return S_FALSE;
+        }
+
+        const auto Statistics = GetStatistics();
+        LOG(INFO, "LatencyProbe::Stop(), statistics:"
+            "\n\t Decoded             = %llu"
+            "\n\t Undecodable         = %llu"
+            "\n\t Skipped             = %llu"
+            "\n\t Repeated            = %llu"
+            "\n\t Unobserved          = %llu"
+            "\n\t GenerationToPresent = mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms",
+            Statistics.Decoded, Statistics.Undecodable, Statistics.Skipped, Statistics.Repeated, Statistics.Unobserved,
+            Statistics.GenerationToPresent.Mean.count() / 1e6, Statistics.GenerationToPresent.P50.count() / 1e6,
+            Statistics.GenerationToPresent.P99.count() / 1e6, Statistics.GenerationToPresent.Max.count() / 1e6);
+
+        return S_OK;
+    }
+
+    bool LatencyProbe::IsActive()
+    {
+        return mReadback.IsActive();
+    }
+
+    void LatencyProbe::Submit(_In_ ID3D11Texture2D* BackBuffer)
+    {
+        D3D11_TEXTURE2D_DESC Desc{};
+        BackBuffer->GetDesc(&Desc);
+
+        const uint32_t StripHeight = GetFrameBarcodeHeight(Desc.Width);
+
+        // Numbered even if dropped, the worker sees the gap and does not count across it
+        const uint64_t Submit = mSubmitted++;
+        mAwaitingPresent.reset();
+
+        if (StripHeight == 0 || StripHeight > Desc.Height) {
+            std::lock_guard Lock(mMutex);
+            ++mUndecodable;
+            return;
+        }
+
+        const D3D11_BOX Strip{ 0, 0, 0, Desc.Width, StripHeight, 1 };
+        if (mReadback.Enqueue(BackBuffer, Submit, nullptr, &Strip)) {
+            mAwaitingPresent = Submit;
+        }
+    }
+
+    void LatencyProbe::OnPresented()
+    {
+        if (!mAwaitingPresent) {
+            return;
+        }
+
+        const uint64_t Submit = *mAwaitingPresent;
+        mAwaitingPresent.reset();
+
+        const auto Presented = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+
+        std::lock_guard Lock(mMutex);
+
+        auto& Generated = mGenerated[Submit % PENDING_SLOTS];
+        if (Generated.Submit == Submit) {
+            RecordGenerationToPresent(Generated.Time, Presented);
+            Generated = {};
+        }
+        else {
+            mPresented[Submit % PENDING_SLOTS] = { Submit, Presented };
+        }
+    }
+
+    LatencyProbeStatistics LatencyProbe::GetStatistics() const
+    {
+        const auto Readback = mReadback.GetStatistics();
+
+        std::lock_guard Lock(mMutex);
+
+        LatencyProbeStatistics Statistics{};
+        Statistics.Decoded     = mDecoded;
+        Statistics.Undecodable = mUndecodable;
+        Statistics.Skipped     = mSkipped;
+        Statistics.Repeated    = mRepeated;
+        Statistics.Unobserved  = Readback.Dropped + Readback.Failed;
+
+        auto& Summary   = Statistics.GenerationToPresent;
+        Summary.Count   = mGenerationToPresent.GetCount();
+        Summary.Mean    = std::chrono::nanoseconds(mGenerationToPresent.GetMean());
+        Summary.P50     = std::chrono::nanoseconds(mGenerationToPresent.GetPercentile(50.0));
+        Summary.P95     = std::chrono::nanoseconds(mGenerationToPresent.GetPercentile(95.0));
+        Summary.P99     = std::chrono::nanoseconds(mGenerationToPresent.GetPercentile(99.0));
+        Summary.Max     = std::chrono::nanoseconds(mGenerationToPresent.GetMax());
+        return Statistics;
+    }
+
+    void LatencyProbe::OnReadback(_In_ const ReadbackFrame& Frame)
+    {
+        const auto Barcode = (Frame.Format == DXGI_FORMAT_B8G8R8A8_UNORM || Frame.Format == DXGI_FORMAT_R8G8B8A8_UNORM)
+            ? ReadFrameBarcode(Frame.Data, Frame.RowPitch, Frame.Width, Frame.Height)
+            : std::nullopt;
+
+        std::lock_guard Lock(mMutex);
+
+        if (!Barcode) {
+            ++mUndecodable;
+            mLastSubmit = std::nullopt;
+            return;
+        }
+
+        ++mDecoded;
+
+        // Frame.Time is when the copy was queued, before Present(), the present time comes from OnPresented()
+        auto& Presented = mPresented[Frame.Sequence % PENDING_SLOTS];
+        if (Presented.Submit == Frame.Sequence) {
+            RecordGenerationToPresent(Barcode->Timestamp, Presented.Time);
+            Presented = {};
+        }
+        else {
+            mGenerated[Frame.Sequence % PENDING_SLOTS] = { Frame.Sequence, Barcode->Timestamp };
+        }
+
+        if (mLastSubmit && *mLastSubmit + 1 == Frame.Sequence) {
+            if (Barcode->Sequence == mLastSequence) {
+                ++mRepeated;
+            }
+            else if (Barcode->Sequence > mLastSequence + 1) {
+                mSkipped += Barcode->Sequence - mLastSequence - 1;
+            }
+        }
+
+        mLastSubmit   = Frame.Sequence;
+        mLastSequence = Barcode->Sequence;
+    }
+
+    void LatencyProbe::RecordGenerationToPresent(_In_ uint64_t Generated, _In_ uint64_t Presented)
+    {
+        if (Presented >= Generated) {
+            mGenerationToPresent.Record(Presented - Generated);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "Core.AsyncReadback.h"
+#include "Core.FrameTiming.h"
+#include "Core.FrameBarcode.h"
+
+
+namespace Mi::Core
+{
+    struct LatencyProbeStatistics
+    {
+        uint64_t Decoded     = 0;   // presented frames with a valid barcode
+        uint64_t Undecodable = 0;   // presented frames without one, e.g. rotated or scaled vertically
+        uint64_t Skipped     = 0;   // source frames that were never presented
+        uint64_t Repeated    = 0;   // presents that showed the same source frame again
+        uint64_t Unobserved  = 0;   // presents the readback could not keep up with, these hide skips and repeats
+
+        // From the generation timestamp in the barcode to the return of the Present() that showed the frame
+        FrameStageSummary GenerationToPresent{};
+    };
+
+    // Reads the FrameBarcode back from every presented frame of a GraphicsCaptureForPattern session.
+    //
+    // Only the rows of the strip are copied, so the readback costs little even at high resolutions.
+    // Skips and repeats are only counted between presents that were both read back.
+    class LatencyProbe
+    {
+        // More than the readback has in flight
+        static constexpr uint32_t PENDING_SLOTS = 32;
+
+        struct PendingTime
+        {
+            uint64_t Submit = UINT64_MAX;
+            uint64_t Time   = 0;
+        };
+
+        AsyncReadback    mReadback;
+
+        // Render thread
+        uint64_t                mSubmitted = 0;
+        std::optional<uint64_t> mAwaitingPresent;
+
+        // Worker thread, read under the mutex
+        mutable std::mutex mMutex;
+        LatencyHistogram   mGenerationToPresent;
+        uint64_t           mDecoded     = 0;
+        uint64_t           mUndecodable = 0;
+        uint64_t           mSkipped     = 0;
+        uint64_t           mRepeated    = 0;
+        std::optional<uint64_t> mLastSubmit;
+        uint64_t           mLastSequence = 0;
+
+        // The present returns before or after the readback of its frame, whichever comes second records the pair
+        std::array<PendingTime, PENDING_SLOTS> mPresented{};     // Present() return per submit
+        std::array<PendingTime, PENDING_SLOTS> mGenerated{};     // barcode timestamp per submit
+
+    public:
+        ~LatencyProbe();
+
+        explicit LatencyProbe(_In_ const winrt::com_ptr<ID3D11Device>& Device);
+        LatencyProbe(      LatencyProbe&&) = delete;
+        LatencyProbe(const LatencyProbe& ) = delete;
+        LatencyProbe& operator=(      LatencyProbe&&) = delete;
+        LatencyProbe& operator=(const LatencyProbe& ) = delete;
+
+        // Resets the statistics.
+        winrt::hresult Start();
+        winrt::hresult Stop ();
+
+        [[nodiscard]] bool IsActive();
+
+        // Render thread, right before Present().
+        void Submit(_In_ ID3D11Texture2D* BackBuffer);
+
+        // Render thread, once the Present() after Submit() returned.
+        void OnPresented();
+
+        [[nodiscard]] LatencyProbeStatistics GetStatistics() const;
+
+    private:
+        void OnReadback(_In_ const ReadbackFrame& Frame);
+
+        // Under the mutex
+        void RecordGenerationToPresent(_In_ uint64_t Generated, _In_ uint64_t Presented);
+    };
+}
@@ -0,0 +1,755 @@
+#include "Core.Logger.h"
+#include "Core.FrameTiming.h"
+
+#include <condition_variable>
+#include <ctime>
+#include <cwchar>
+#include <fstream>
+#include <thread>
+
+
+namespace Mi::Core
+{
+    static constexpr size_t LOG_RING_CAPACITY  = 256;      // records per thread
+    static constexpr size_t LOG_PAYLOAD_SIZE   = sizeof(LogRecord::Payload);
+    static constexpr auto   LOG_DRAIN_INTERVAL = std::chrono::milliseconds(10);
+
+    static constexpr char LOG_PREFIX_ERROR[] = "[Mi.Palin][!] ";
+    static constexpr char LOG_PREFIX_INFO [] = "[Mi.Palin][+] ";
+
+    struct LogRing
+    {
+        SpscRing<LogRecord, LOG_RING_CAPACITY> Records;
+        std::atomic_uint64_t Dropped = 0;
+        std::atomic_bool     Retired = false;  // the thread has exited, the ring goes once it is empty
+    };
+
+    // Set once the logger is gone, LOG from the destructors of other statics is then ignored
+    static std::atomic_bool LoggerClosed = false;
+
+    // The ring of the calling thread, plain pointers so the hot path does not check for construction
+    static thread_local LogRing* ThreadRing    = nullptr;
+    static thread_local bool     ThreadExited  = false;
+
+    struct LogRingRetirer
+    {
+        LogRing* Ring = nullptr;
+
+        ~LogRingRetirer()
+        {
+            if (Ring != nullptr) {
+                Ring->Retired.store(true, std::memory_order_release);
+            }
+            ThreadRing   = nullptr;
+            ThreadExited = true;
+        }
+    };
+
+    static uint64_t GetSteadyNanoseconds() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static void AppendUtf8(_Inout_ std::string& Text, _In_reads_(Length) const wchar_t* Wide, _In_ size_t Length)
+    {
+        for (size_t Index = 0; Index < Length; ++Index) {
+            uint32_t Code = static_cast<uint32_t>(Wide[Index]);
+
+            // UTF-16 on Windows, a pair of surrogates is one code point
+            if (Code >= 0xD800 && Code <= 0xDBFF && Index + 1 < Length) {
+                const uint32_t Low = static_cast<uint32_t>(Wide[Index + 1]);
+                if (Low >= 0xDC00 && Low <= 0xDFFF) {
+                    Code = 0x10000 + ((Code - 0xD800) << 10) + (Low - 0xDC00);
+                    ++Index;
+                }
+            }
+            if ((Code >= 0xD800 && Code <= 0xDFFF) || Code > 0x10FFFF) {
+                Code = 0xFFFD;
+            }
+
+            if (Code < 0x80) {
+                Text.push_back(static_cast<char>(Code));
+            }
+            else if (Code < 0x800) {
+                Text.push_back(static_cast<char>(0xC0 | (Code >> 6)));
+                Text.push_back(static_cast<char>(0x80 | (Code & 0x3F)));
+            }
+            else if (Code < 0x10000) {
+                Text.push_back(static_cast<char>(0xE0 | (Code >> 12)));
+                Text.push_back(static_cast<char>(0x80 | ((Code >> 6) & 0x3F)));
+                Text.push_back(static_cast<char>(0x80 | (Code & 0x3F)));
+            }
+            else {
+                Text.push_back(static_cast<char>(0xF0 | (Code >> 18)));
+                Text.push_back(static_cast<char>(0x80 | ((Code >> 12) & 0x3F)));
+                Text.push_back(static_cast<char>(0x80 | ((Code >> 6) & 0x3F)));
+                Text.push_back(static_cast<char>(0x80 | (Code & 0x3F)));
+            }
+        }
+    }
+
+    namespace LogDetail
+    {
+        void AppendValue(_Inout_ LogRecord& Record, _In_ LogArgumentType Type, _In_reads_bytes_(Size) const void* Value,
+            _In_ size_t Size) noexcept
+        {
+            if (Record.Size + 1 + Size > LOG_PAYLOAD_SIZE) {
+                Record.Truncated = true;
+                return;
+            }
+
+            Record.Payload[Record.Size] = static_cast<uint8_t>(Type);
+            memcpy(Record.Payload + Record.Size + 1, Value, Size);
+            Record.Size = static_cast<uint16_t>(Record.Size + 1 + Size);
+        }
+
+        template <typename Char>
+        static void AppendCharacters(_Inout_ LogRecord& Record, _In_ LogArgumentType Type, _In_opt_ const Char* Text) noexcept
+        {
+            static constexpr Char Null[] = { '(', 'n', 'u', 'l', 'l', ')', 0 };
+            if (Text == nullptr) {
+                Text = Null;
+            }
+
+            // Type and length, then as many characters as fit
+            if (static_cast<size_t>(Record.Size) + 3 > LOG_PAYLOAD_SIZE) {
+                Record.Truncated = true;
+                return;
+            }
+
+            const size_t Available = (LOG_PAYLOAD_SIZE - Record.Size - 3) / sizeof(Char);
+            size_t Length = 0;
+            if constexpr (std::is_same_v<Char, char>) {
+                Length = strnlen(Text, Available);
+            }
+            else {
+                Length = wcsnlen(Text, Available);
+            }
+            if (Length == Available && Text[Length] != 0) {
+                Record.Truncated = true;
+            }
+
+            const uint16_t Count = static_cast<uint16_t>(Length);
+            Record.Payload[Record.Size] = static_cast<uint8_t>(Type);
+            memcpy(Record.Payload + Record.Size + 1, &Count, sizeof(Count));
+            memcpy(Record.Payload + Record.Size + 3, Text, Length * sizeof(Char));
+            Record.Size = static_cast<uint16_t>(Record.Size + 3 + Length * sizeof(Char));
+        }
+
+        void AppendString(_Inout_ LogRecord& Record, _In_opt_ const char* Text) noexcept
+        {
+            AppendCharacters(Record, LogArgumentType::String, Text);
+        }
+
+        void AppendString(_Inout_ LogRecord& Record, _In_opt_ const wchar_t* Text) noexcept
+        {
+            AppendCharacters(Record, LogArgumentType::WideString, Text);
+        }
+    }
+
+    // Reads the arguments of a record back in order
+    class LogArgumentReader
+    {
+        const LogRecord& mRecord;
+        size_t           mOffset = 0;
+
+    public:
+        explicit LogArgumentReader(_In_ const LogRecord& Record)
+            : mRecord(Record)
+        {
+        }
+
+        [[nodiscard]] std::optional<LogArgumentType> PeekType() const noexcept
+        {
+            if (mOffset >= mRecord.Size) {
+                return std::nullopt;
+            }
+            return static_cast<LogArgumentType>(mRecord.Payload[mOffset]);
+        }
+
+        template <typename T>
+        [[nodiscard]] T ReadValue() noexcept
+        {
+            T Value{};
+            memcpy(&Value, mRecord.Payload + mOffset + 1, sizeof(T));
+            mOffset += 1 + sizeof(T);
+            return Value;
+        }
+
+        // Any integer as 64 bits, the types of printf do not have to match the argument exactly
+        [[nodiscard]] std::optional<uint64_t> ReadInteger() noexcept
+        {
+            switch (PeekType().value_or(LogArgumentType::Double)) {
+                case LogArgumentType::Int32:   return static_cast<uint64_t>(static_cast<int64_t>(ReadValue<int32_t>()));
+                case LogArgumentType::UInt32:  return ReadValue<uint32_t>();
+                case LogArgumentType::Int64:   return static_cast<uint64_t>(ReadValue<int64_t>());
+                case LogArgumentType::UInt64:
+                case LogArgumentType::Pointer: return ReadValue<uint64_t>();
+                default:                       return std::nullopt;
+            }
+        }
+
+        void ReadText(_Inout_ std::string& Text) noexcept
+        {
+            const auto Type = static_cast<LogArgumentType>(mRecord.Payload[mOffset]);
+
+            uint16_t Length = 0;
+            memcpy(&Length, mRecord.Payload + mOffset + 1, sizeof(Length));
+            const uint8_t* Characters = mRecord.Payload + mOffset + 3;
+
+            if (Type == LogArgumentType::String) {
+                Text.append(reinterpret_cast<const char*>(Characters), Length);
+                mOffset += 3 + Length;
+            }
+            else {
+                std::wstring Wide(Length, L'\0');
+                memcpy(Wide.data(), Characters, Length * sizeof(wchar_t));
+                AppendUtf8(Text, Wide.data(), Wide.size());
+                mOffset += 3 + Length * sizeof(wchar_t);
+            }
+        }
+
+        void Skip() noexcept
+        {
+            switch (PeekType().value_or(LogArgumentType::Int32)) {
+                case LogArgumentType::String:
+                case LogArgumentType::WideString: {
+                    std::string Ignored;
+                    ReadText(Ignored);
+                    break;
+                }
+                case LogArgumentType::Int32:
+                case LogArgumentType::UInt32:  mOffset += 1 + 4; break;
+                default:                       mOffset += 1 + 8; break;
+            }
+        }
+    };
+
+    template <typename... Args>
+    static void AppendFormatted(_Inout_ std::string& Text, _In_z_ const char* Format, _In_ Args... Arguments)
+    {
+        char Buffer[128];
+        const int Length = snprintf(Buffer, sizeof(Buffer), Format, Arguments...);
+        if (Length < 0) {
+            return;
+        }
+        if (static_cast<size_t>(Length) < sizeof(Buffer)) {
+            Text.append(Buffer, static_cast<size_t>(Length));
+            return;
+        }
+
+        const size_t Offset = Text.size();
+        Text.resize(Offset + static_cast<size_t>(Length) + 1);
+        (void)snprintf(Text.data() + Offset, static_cast<size_t>(Length) + 1, Format, Arguments...);
+        Text.resize(Offset + static_cast<size_t>(Length));
+    }
+
+    static void FormatRecordTo(_Inout_ std::string& Text, _In_ const LogRecord& Record)
+    {
+        static constexpr char Unknown[] = "<?>";
+
+        LogArgumentReader Arguments(Record);
+        const char* Cursor = Record.Format != nullptr ? Record.Format : "";
+
+        while (*Cursor != '\0') {
+            if (*Cursor != '%') {
+                const char* Next = strchr(Cursor, '%');
+                const size_t Length = Next != nullptr ? static_cast<size_t>(Next - Cursor) : strlen(Cursor);
+                Text.append(Cursor, Length);
+                Cursor += Length;
+                continue;
+            }
+            if (Cursor[1] == '%') {
+                Text.push_back('%');
+                Cursor += 2;
+                continue;
+            }
+
+            // Flags, width and precision are kept, a * takes its value from the arguments
+            std::string Spec = "%";
+            ++Cursor;
+            while (*Cursor != '\0' && strchr("-+ #0", *Cursor) != nullptr) {
+                Spec.push_back(*Cursor++);
+            }
+
+            bool Valid = true;
+            const auto CopyNumber = [&]()
+            {
+                if (*Cursor == '*') {
+                    ++Cursor;
+                    const auto Value = Arguments.ReadInteger();
+                    Valid = Valid && Value.has_value();
+                    Spec += std::to_string(static_cast<int32_t>(Value.value_or(0)));
+                    return;
+                }
+                while (*Cursor >= '0' && *Cursor <= '9') {
+                    Spec.push_back(*Cursor++);
+                }
+            };
+            CopyNumber();
+            if (*Cursor == '.') {
+                Spec.push_back(*Cursor++);
+                CopyNumber();
+            }
+
+            // The length modifier follows from the stored argument instead
+            while (*Cursor != '\0' && strchr("hljztLIw", *Cursor) != nullptr) {
+                if (Cursor[0] == 'I' && ((Cursor[1] == '3' && Cursor[2] == '2') || (Cursor[1] == '6' && Cursor[2] == '4'))) {
+                    Cursor += 2;
+                }
+                ++Cursor;
+            }
+
+            const char Conversion = *Cursor;
+            if (Conversion == '\0') {
+                break;
+            }
+            ++Cursor;
+
+            const auto Type = Arguments.PeekType();
+            if (!Valid || !Type) {
+                Text.append(Unknown);
+                continue;
+            }
+
+            switch (Conversion) {
+                case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c': {
+                    const bool Wide = *Type == LogArgumentType::Int64 || *Type == LogArgumentType::UInt64
+                        || *Type == LogArgumentType::Pointer;
+                    const auto Value = Arguments.ReadInteger();
+                    if (!Value) {
+                        Arguments.Skip();
+                        Text.append(Unknown);
+                    }
+                    else if (Wide && Conversion != 'c') {
+                        AppendFormatted(Text, (Spec + "ll" + Conversion).c_str(), static_cast<long long>(*Value));
+                    }
+                    else {
+                        AppendFormatted(Text, (Spec + Conversion).c_str(), static_cast<int>(*Value));
+                    }
+                    break;
+                }
+                case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                    if (*Type == LogArgumentType::Double) {
+                        AppendFormatted(Text, (Spec + Conversion).c_str(), Arguments.ReadValue<double>());
+                    }
+                    else {
+                        Arguments.Skip();
+                        Text.append(Unknown);
+                    }
+                    break;
+                }
+                case 's': case 'S': {
+                    if (*Type == LogArgumentType::String || *Type == LogArgumentType::WideString) {
+                        std::string Value;
+                        Arguments.ReadText(Value);
+                        AppendFormatted(Text, (Spec + 's').c_str(), Value.c_str());
+                    }
+                    else {
+                        Arguments.Skip();
+                        Text.append(Unknown);
+                    }
+                    break;
+                }
+                case 'p': {
+                    const auto Value = Arguments.ReadInteger();
+                    if (Value) {
+                        AppendFormatted(Text, "0x%0*llX", static_cast<int>(sizeof(void*) * 2), static_cast<unsigned long long>(*Value));
+                    }
+                    else {
+                        Arguments.Skip();
+                        Text.append(Unknown);
+                    }
+                    break;
+                }
+                default:
+                    Arguments.Skip();
+                    Text.append(Unknown);
+                    break;
+            }
+        }
+
+        if (Record.Truncated) {
+            Text.append(" <truncated>");
+        }
+    }
+
+    class LoggerState
+    {
+        std::mutex mLock;
+        std::condition_variable mWake;
+        std::condition_variable mFlushed;
+
+        std::vector<std::unique_ptr<LogRing>> mRings;
+        std::thread mWorker;
+        bool        mStop = false;
+
+        uint64_t mFlushRequested = 0;
+        uint64_t mFlushCompleted = 0;
+
+        bool                  mConsole = true;
+        std::ofstream         mFile;
+        std::filesystem::path mFilePath;
+        uint64_t              mFileBytes    = 0;
+        uint64_t              mMaximumBytes = 0;
+        uint32_t              mMaximumFiles = 0;
+
+        std::atomic_uint64_t mWritten = 0;
+        std::atomic_uint64_t mDropped = 0;
+
+        // Wall time of the file lines, from the steady time of the records
+        const std::chrono::system_clock::time_point mWallBase = std::chrono::system_clock::now();
+        const uint64_t                              mSteadyBase = GetSteadyNanoseconds();
+
+    public:
+        LoggerState() = default;
+
+        ~LoggerState()
+        {
+            LoggerClosed.store(true);
+
+            std::thread Worker;
+            {
+                std::lock_guard Guard(mLock);
+                mStop = true;
+                Worker = std::move(mWorker);
+            }
+            mWake.notify_one();
+
+            if (Worker.joinable()) {
+                Worker.join();
+            }
+        }
+
+        LoggerState(const LoggerState&)            = delete;
+        LoggerState& operator=(const LoggerState&) = delete;
+        LoggerState(LoggerState&&)                 = delete;
+        LoggerState& operator=(LoggerState&&)      = delete;
+
+        LogRing* RegisterRing()
+        {
+            static thread_local LogRingRetirer Retirer;
+
+            auto Ring = std::make_unique<LogRing>();
+
+            std::lock_guard Guard(mLock);
+            if (mStop) {
+                return nullptr;
+            }
+            if (!mWorker.joinable()) {
+                mWorker = std::thread([this] { Run(); });
+            }
+
+            Retirer.Ring = Ring.get();
+            mRings.push_back(std::move(Ring));
+            return mRings.back().get();
+        }
+
+        void SetConsole(_In_ bool Enable)
+        {
+            std::lock_guard Guard(mLock);
+            mConsole = Enable;
+        }
+
+        bool IsConsoleEnabled()
+        {
+            std::lock_guard Guard(mLock);
+            return mConsole;
+        }
+
+        bool SetFile(_In_ const std::filesystem::path& Path, _In_ uint64_t MaximumBytes, _In_ uint32_t MaximumFiles)
+        {
+            std::lock_guard Guard(mLock);
+
+            mFile.close();
+            mFilePath.clear();
+            if (Path.empty()) {
+                return true;
+            }
+
+            mFile.open(Path, std::ios::binary | std::ios::app);
+            if (!mFile) {
+                return false;
+            }
+
+            std::error_code Error;
+            const auto Size = std::filesystem::file_size(Path, Error);
+
+            mFilePath     = Path;
+            mFileBytes    = Error ? 0 : Size;
+            mMaximumBytes = std::max<uint64_t>(MaximumBytes, 4096);
+            mMaximumFiles = MaximumFiles;
+            return true;
+        }
+
+        void Flush(_In_ std::chrono::milliseconds Timeout)
+        {
+            std::unique_lock Guard(mLock);
+            if (!mWorker.joinable() || mWorker.get_id() == std::this_thread::get_id()) {
+                return;
+            }
+
+            const uint64_t Ticket = ++mFlushRequested;
+            mWake.notify_one();
+            (void)mFlushed.wait_for(Guard, Timeout, [&] { return mFlushCompleted >= Ticket; });
+        }
+
+        [[nodiscard]] LoggerStatistics GetStatistics() const noexcept
+        {
+            return { mWritten.load(std::memory_order_relaxed), mDropped.load(std::memory_order_relaxed) };
+        }
+
+    private:
+        void Run()
+        {
+            std::vector<LogRing*>  Active;
+            std::vector<LogRecord> Batch;
+            std::string ConsoleText;
+            std::string FileText;
+            FILE*       ConsoleStream = nullptr;
+
+            std::unique_lock Guard(mLock);
+            for (;;) {
+                (void)mWake.wait_for(Guard, LOG_DRAIN_INTERVAL, [&] { return mStop || mFlushRequested != mFlushCompleted; });
+
+                // Only this thread removes rings, the pointers stay valid without the lock
+                const uint64_t Ticket   = mFlushRequested;
+                const bool     Stopping = mStop;
+                Active.clear();
+                for (const auto& Ring : mRings) {
+                    Active.push_back(Ring.get());
+                }
+                const bool Console = mConsole;
+                const bool File    = mFile.is_open();
+                Guard.unlock();
+
+                Batch.clear();
+                uint64_t Dropped = 0;
+                for (LogRing* Ring : Active) {
+                    LogRecord Record;
+                    while (Ring->Records.Pop(Record)) {
+                        Batch.push_back(Record);
+                    }
+                    Dropped += Ring->Dropped.exchange(0, std::memory_order_relaxed);
+                }
+
+                // Each ring is in order already, across threads the time decides
+                std::stable_sort(Batch.begin(), Batch.end(), [](const LogRecord& Left, const LogRecord& Right)
+                {
+                    return Left.Time < Right.Time;
+                });
+
+                if (Dropped != 0) {
+                    mDropped.fetch_add(Dropped, std::memory_order_relaxed);
+                }
+
+                ConsoleText.clear();
+                FileText.clear();
+                std::string Line;
+                const auto Emit = [&](_In_ LogLevel Level, _In_ uint64_t Time)
+                {
+                    const char* Prefix = Level == LogLevel::Error ? LOG_PREFIX_ERROR : LOG_PREFIX_INFO;
+
+                    // Errors and info go to different streams, in the order they were written
+                    if (Console) {
+                        FILE* Stream = Level == LogLevel::Error ? stderr : stdout;
+                        if (Stream != ConsoleStream) {
+                            WriteConsole(ConsoleStream, ConsoleText);
+                            ConsoleStream = Stream;
+                        }
+                        ConsoleText.append(Prefix);
+                        ConsoleText.append(Line);
+                        ConsoleText.push_back('\n');
+                    }
+                    if (File) {
+                        AppendWallTime(FileText, Time);
+                        FileText.append(Prefix);
+                        FileText.append(Line);
+                        FileText.push_back('\n');
+                    }
+                };
+
+                for (const LogRecord& Record : Batch) {
+                    Line.clear();
+                    FormatRecordTo(Line, Record);
+                    Emit(Record.Level, Record.Time);
+                }
+                if (Dropped != 0) {
+                    Line = "Logger dropped " + std::to_string(Dropped) + " records, the ring of a thread was full";
+                    Emit(LogLevel::Error, GetSteadyNanoseconds());
+                }
+                WriteConsole(ConsoleStream, ConsoleText);
+
+                Guard.lock();
+                if (!FileText.empty() && mFile.is_open()) {
+                    WriteFile(FileText);
+                }
+                mWritten.fetch_add(Batch.size(), std::memory_order_relaxed);
+
+                // A retired ring gets no more records once it is seen empty
+                std::erase_if(mRings, [](const std::unique_ptr<LogRing>& Ring)
+                {
+                    return Ring->Retired.load(std::memory_order_acquire) && Ring->Records.Size() == 0;
+                });
+
+                mFlushCompleted = Ticket;
+                mFlushed.notify_all();
+
+                if (Stopping) {
+                    break;
+                }
+            }
+        }
+
+        static void WriteConsole(_In_opt_ FILE* Stream, _Inout_ std::string& Text)
+        {
+            if (Stream == nullptr || Text.empty()) {
+                return;
+            }
+            (void)fwrite(Text.data(), 1, Text.size(), Stream);
+            (void)fflush(Stream);
+            Text.clear();
+        }
+
+        void AppendWallTime(_Inout_ std::string& Text, _In_ uint64_t Time) const
+        {
+            const auto Wall = mWallBase + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(static_cast<int64_t>(Time - mSteadyBase)));
+            const time_t Seconds = std::chrono::system_clock::to_time_t(Wall);
+            const auto Milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(Wall.time_since_epoch()).count() % 1000;
+
+            tm Local{};
+#ifdef _WIN32
+            (void)localtime_s(&Local, &Seconds);
+#else
+            (void)localtime_r(&Seconds, &Local);
+#endif
+            AppendFormatted(Text, "%04d-%02d-%02d %02d:%02d:%02d.%03d ", Local.tm_year + 1900, Local.tm_mon + 1, Local.tm_mday,
+                Local.tm_hour, Local.tm_min, Local.tm_sec, static_cast<int>(Milliseconds));
+        }
+
+        // Called with the lock held
+        void WriteFile(_In_ const std::string& Text)
+        {
+            if (mFileBytes != 0 && mFileBytes + Text.size() > mMaximumBytes) {
+                Rotate();
+                if (!mFile.is_open()) {
+                    return;
+                }
+            }
+
+            mFile.write(Text.data(), static_cast<std::streamsize>(Text.size()));
+            mFile.flush();
+            mFileBytes += Text.size();
+        }
+
+        // Path becomes Path.1, Path.1 becomes Path.2 and so on, the oldest is deleted
+        void Rotate()
+        {
+            mFile.close();
+
+            std::error_code Error;
+            const auto Numbered = [&](_In_ uint32_t Number)
+            {
+                auto Name = mFilePath;
+                Name += ".";
+                Name += std::to_string(Number);
+                return Name;
+            };
+
+            if (mMaximumFiles == 0) {
+                std::filesystem::remove(mFilePath, Error);
+            }
+            else {
+                std::filesystem::remove(Numbered(mMaximumFiles), Error);
+                for (uint32_t Number = mMaximumFiles; Number > 1; --Number) {
+                    std::filesystem::rename(Numbered(Number - 1), Numbered(Number), Error);
+                }
+                std::filesystem::rename(mFilePath, Numbered(1), Error);
+            }
+
+            mFile.open(mFilePath, std::ios::binary | std::ios::trunc);
+            mFileBytes = 0;
+        }
+    };
+
+    static LoggerState& GetLoggerState()
+    {
+        static LoggerState State;
+        return State;
+    }
+
+    LogRecord* Logger::BeginRecord() noexcept
+    {
+        if (LoggerClosed.load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+
+        LogRing* Ring = ThreadRing;
+        if (Ring == nullptr) {
+            if (ThreadExited) {
+                return nullptr;
+            }
+            try {
+                Ring = GetLoggerState().RegisterRing();
+            }
+            catch (...) {
+                Ring = nullptr;
+            }
+            if (Ring == nullptr) {
+                return nullptr;
+            }
+            ThreadRing = Ring;
+        }
+
+        LogRecord* Record = Ring->Records.BeginPush();
+        if (Record == nullptr) {
+            Ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Record->Time = GetSteadyNanoseconds();
+        return Record;
+    }
+
+    void Logger::CommitRecord() noexcept
+    {
+        ThreadRing->Records.CommitPush();
+    }
+
+    void Logger::SetConsole(_In_ bool Enable) noexcept
+    {
+        GetLoggerState().SetConsole(Enable);
+    }
+
+    bool Logger::IsConsoleEnabled() noexcept
+    {
+        return GetLoggerState().IsConsoleEnabled();
+    }
+
+    bool Logger::SetFile(_In_ const std::filesystem::path& Path, _In_opt_ uint64_t MaximumBytes, _In_opt_ uint32_t MaximumFiles)
+    {
+        return GetLoggerState().SetFile(Path, MaximumBytes, MaximumFiles);
+    }
+
+    void Logger::Flush(_In_opt_ std::chrono::milliseconds Timeout) noexcept
+    {
+        if (LoggerClosed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        GetLoggerState().Flush(Timeout);
+    }
+
+    LoggerStatistics Logger::GetStatistics() noexcept
+    {
+        return GetLoggerState().GetStatistics();
+    }
+
+    std::string Logger::FormatRecord(_In_ const LogRecord& Record)
+    {
+        std::string Text;
+        FormatRecordTo(Text, Record);
+        return Text;
+    }
+}
@@ -0,0 +1,290 @@
+#pragma once
+#include <array>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+namespace Mi::Core
+{
+    // Values of LOG_ERROR and LOG_INFO in pch.h.
+    enum class LogLevel : uint32_t
+    {
+        Error = 0,
+        Info  = 1,
+    };
+
+    constexpr size_t LOG_RECORD_SIZE = 512;
+
+    enum class LogArgumentType : uint8_t
+    {
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Double,
+        Pointer,
+        String,         // length and characters follow, without terminator
+        WideString,
+    };
+
+    // One call of LOG, the format is a string literal and the arguments are copied into Payload.
+    // Strings that do not fit are cut, arguments that do not fit at all are printed as <?>.
+    struct LogRecord
+    {
+        const char* Format = nullptr;
+        uint64_t    Time   = 0;     // nanoseconds of std::chrono::steady_clock
+        LogLevel    Level  = LogLevel::Info;
+        uint16_t    Size   = 0;     // bytes of Payload in use
+        bool        Truncated = false;
+        uint8_t     Payload[LOG_RECORD_SIZE - 24];
+    };
+    static_assert(sizeof(LogRecord) == LOG_RECORD_SIZE);
+
+    struct LoggerStatistics
+    {
+        uint64_t Written = 0;       // records formatted and written
+        uint64_t Dropped = 0;       // records lost because the ring of their thread was full
+    };
+
+    namespace LogDetail
+    {
+        void AppendValue (_Inout_ LogRecord& Record, _In_ LogArgumentType Type, _In_reads_bytes_(Size) const void* Value,
+            _In_ size_t Size) noexcept;
+        void AppendString(_Inout_ LogRecord& Record, _In_opt_ const char* Text) noexcept;
+        void AppendString(_Inout_ LogRecord& Record, _In_opt_ const wchar_t* Text) noexcept;
+
+        // The type an argument is stored as, what printf would receive after the default argument promotions
+        template <typename T>
+        consteval LogArgumentType GetArgumentType() noexcept
+        {
+            if constexpr (std::is_enum_v<T>) {
+                return GetArgumentType<std::underlying_type_t<T>>();
+            }
+            else if constexpr (std::is_convertible_v<const T&, const char*> && !std::is_null_pointer_v<T>) {
+                return LogArgumentType::String;
+            }
+            else if constexpr (std::is_convertible_v<const T&, const wchar_t*> && !std::is_null_pointer_v<T>) {
+                return LogArgumentType::WideString;
+            }
+            else if constexpr (std::is_integral_v<T> && sizeof(T) <= 4) {
+                return std::is_unsigned_v<T> && sizeof(T) == 4 ? LogArgumentType::UInt32 : LogArgumentType::Int32;
+            }
+            else if constexpr (std::is_integral_v<T>) {
+                return std::is_unsigned_v<T> ? LogArgumentType::UInt64 : LogArgumentType::Int64;
+            }
+            else if constexpr (std::is_floating_point_v<T>) {
+                return LogArgumentType::Double;
+            }
+            else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+                return LogArgumentType::Pointer;
+            }
+            else {
+                static_assert(std::is_void_v<T>, "LOG takes numbers, enums, pointers and C strings only.");
+                return LogArgumentType::Pointer;
+            }
+        }
+
+        template <typename T>
+        void AppendArgument(_Inout_ LogRecord& Record, _In_ const T& Value) noexcept
+        {
+            constexpr LogArgumentType Type = GetArgumentType<T>();
+
+            if constexpr (Type == LogArgumentType::String) {
+                AppendString(Record, static_cast<const char*>(Value));
+            }
+            else if constexpr (Type == LogArgumentType::WideString) {
+                AppendString(Record, static_cast<const wchar_t*>(Value));
+            }
+            else if constexpr (Type == LogArgumentType::Int32) {
+                const int32_t Number = static_cast<int32_t>(Value);
+                AppendValue(Record, Type, &Number, sizeof(Number));
+            }
+            else if constexpr (Type == LogArgumentType::UInt32) {
+                const uint32_t Number = static_cast<uint32_t>(Value);
+                AppendValue(Record, Type, &Number, sizeof(Number));
+            }
+            else if constexpr (Type == LogArgumentType::Int64) {
+                const int64_t Number = static_cast<int64_t>(Value);
+                AppendValue(Record, Type, &Number, sizeof(Number));
+            }
+            else if constexpr (Type == LogArgumentType::UInt64) {
+                const uint64_t Number = static_cast<uint64_t>(Value);
+                AppendValue(Record, Type, &Number, sizeof(Number));
+            }
+            else if constexpr (Type == LogArgumentType::Double) {
+                const double Number = static_cast<double>(Value);
+                AppendValue(Record, Type, &Number, sizeof(Number));
+            }
+            else {
+                const uint64_t Address = reinterpret_cast<uintptr_t>(static_cast<const volatile void*>(Value));
+                AppendValue(Record, Type, &Address, sizeof(Address));
+            }
+        }
+
+        enum class FormatError : uint8_t
+        {
+            None,
+            TooFewArguments,
+            TooManyArguments,
+            WrongArgument,      // an argument the conversion would print as <?>
+            BadConversion,      // a conversion the formatter does not know, or a % at the end
+        };
+
+        // Walks Format the way the formatter does. The length modifiers are skipped there, so only the kind of
+        // each argument has to fit its conversion.
+        template <typename... Args>
+        constexpr FormatError CheckFormat(_In_z_ const char* Format) noexcept
+        {
+            constexpr std::array<LogArgumentType, sizeof...(Args)> Types = { GetArgumentType<Args>()... };
+
+            const auto IsInteger = [](_In_ LogArgumentType Type)
+            {
+                return Type != LogArgumentType::Double && Type != LogArgumentType::String
+                    && Type != LogArgumentType::WideString;
+            };
+            const auto IsOneOf = [](_In_ std::string_view Characters, _In_ char Character)
+            {
+                return Character != '\0' && Characters.find(Character) != std::string_view::npos;
+            };
+
+            size_t Next = 0;
+            const char* Cursor = Format;
+            while (*Cursor != '\0') {
+                if (*Cursor++ != '%') {
+                    continue;
+                }
+                if (*Cursor == '%') {
+                    ++Cursor;
+                    continue;
+                }
+
+                while (IsOneOf("-+ #0", *Cursor)) {
+                    ++Cursor;
+                }
+                for (bool Precision = false; ; Precision = true) {
+                    if (*Cursor == '*') {
+                        ++Cursor;
+                        if (Next == Types.size()) {
+                            return FormatError::TooFewArguments;
+                        }
+                        if (!IsInteger(Types[Next++])) {
+                            return FormatError::WrongArgument;
+                        }
+                    }
+                    while (*Cursor >= '0' && *Cursor <= '9') {
+                        ++Cursor;
+                    }
+                    if (Precision || *Cursor != '.') {
+                        break;
+                    }
+                    ++Cursor;
+                }
+                while (IsOneOf("hljztLIw", *Cursor)) {
+                    if (Cursor[0] == 'I' && ((Cursor[1] == '3' && Cursor[2] == '2') || (Cursor[1] == '6' && Cursor[2] == '4'))) {
+                        Cursor += 2;
+                    }
+                    ++Cursor;
+                }
+
+                const char Conversion = *Cursor;
+                if (!IsOneOf("diuxXocfFeEgGaAsSp", Conversion)) {
+                    return FormatError::BadConversion;
+                }
+                ++Cursor;
+                if (Next == Types.size()) {
+                    return FormatError::TooFewArguments;
+                }
+
+                const LogArgumentType Type = Types[Next++];
+                const bool Fits = IsOneOf("fFeEgGaA", Conversion) ? Type == LogArgumentType::Double
+                    : IsOneOf("sS", Conversion) ? Type == LogArgumentType::String || Type == LogArgumentType::WideString
+                    : IsInteger(Type);
+                if (!Fits) {
+                    return FormatError::WrongArgument;
+                }
+            }
+            return Next == Types.size() ? FormatError::None : FormatError::TooManyArguments;
+        }
+
+        // Never defined, a LOG that does not fit its format fails to compile with one of these in the error
+        void LogFormatHasTooFewArguments();
+        void LogFormatHasTooManyArguments();
+        void LogFormatHasWrongArgument();
+        void LogFormatHasBadConversion();
+
+        // The format of a LOG call, checked against the types of its arguments at compile time.
+        template <typename... Args>
+        class FormatString final
+        {
+        public:
+            consteval FormatString(_In_z_ const char* Text) noexcept
+                : mText(Text)
+            {
+                switch (CheckFormat<Args...>(Text)) {
+                    case FormatError::None:             break;
+                    case FormatError::TooFewArguments:  LogFormatHasTooFewArguments();  break;
+                    case FormatError::TooManyArguments: LogFormatHasTooManyArguments(); break;
+                    case FormatError::WrongArgument:    LogFormatHasWrongArgument();    break;
+                    case FormatError::BadConversion:    LogFormatHasBadConversion();    break;
+                }
+            }
+
+            [[nodiscard]] constexpr const char* Get() const noexcept { return mText; }
+
+        private:
+            const char* mText;
+        };
+    }
+
+    // Asynchronous logger behind the LOG macro.
+    //
+    // Every thread that logs gets a ring of records of its own. Write() copies the format pointer and the arguments
+    // into the next free record and returns, it never locks, allocates after the first call of a thread, or waits:
+    // when the ring is full the record is dropped and counted. A background thread drains the rings, formats the
+    // records in time order and writes them to the console and, if set, a rotating log file.
+    class Logger final
+    {
+    public:
+        // The format must be a string literal, whose conversions are checked against Arguments at compile time.
+        template <typename... Args>
+        static void Write(_In_ LogLevel Level, _In_ LogDetail::FormatString<std::type_identity_t<Args>...> Format,
+            _In_ const Args&... Arguments) noexcept
+        {
+            LogRecord* Record = BeginRecord();
+            if (Record == nullptr) {
+                return;
+            }
+
+            Record->Format    = Format.Get();
+            Record->Level     = Level;
+            Record->Size      = 0;
+            Record->Truncated = false;
+            (LogDetail::AppendArgument(*Record, Arguments), ...);
+
+            CommitRecord();
+        }
+
+        // Console output is on by default, info goes to stdout and errors to stderr.
+        static void SetConsole(_In_ bool Enable) noexcept;
+        [[nodiscard]] static bool IsConsoleEnabled() noexcept;
+
+        // Also writes to Path, which is renamed to Path.1 and so on once it grows past MaximumBytes, keeping
+        // MaximumFiles old files. An empty path closes the file. Returns false if the file can not be created.
+        static bool SetFile(_In_ const std::filesystem::path& Path, _In_opt_ uint64_t MaximumBytes = 8ull << 20,
+            _In_opt_ uint32_t MaximumFiles = 3);
+
+        // Returns once every record written before the call is out, or after Timeout.
+        static void Flush(_In_opt_ std::chrono::milliseconds Timeout = std::chrono::milliseconds(1000)) noexcept;
+
+        [[nodiscard]] static LoggerStatistics GetStatistics() noexcept;
+
+        // Formats one record the way the background thread does, without the prefix and the newline.
+        [[nodiscard]] static std::string FormatRecord(_In_ const LogRecord& Record);
+
+    private:
+        // The record of the calling thread to fill, nullptr if its ring is full.
+        [[nodiscard]] static LogRecord* BeginRecord() noexcept;
+        static void CommitRecord() noexcept;
+    };
+}
@@ -0,0 +1,117 @@
+#include "Core.ShaderCache.h"
+
+#include <fstream>
+#include <ShlObj.h>
+#include <d3dcompiler.h>
+#pragma comment(lib, "d3dcompiler.lib")
+
+
+namespace Mi::Core
+{
+    static constexpr UINT SHADER_COMPILE_FLAGS = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+
+    static uint64_t HashBytes(_In_ uint64_t Hash, _In_reads_bytes_(Size) const void* Data, _In_ size_t Size)
+    {
+        // FNV-1a 64
+        const auto Bytes = static_cast<const uint8_t*>(Data);
+        for (size_t Idx = 0; Idx < Size; ++Idx) {
+            Hash ^= Bytes[Idx];
+            Hash *= 0x100000001B3ull;
+        }
+        return Hash;
+    }
+
+    ShaderCache::ShaderCache(_In_ std::filesystem::path Directory)
+        : mDirectory(std::move(Directory))
+    {
+    }
+
+    std::filesystem::path ShaderCache::GetDefaultDirectory()
+    {
+        PWSTR LocalAppData = nullptr;
+        if (FAILED(SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_DEFAULT, nullptr, &LocalAppData))) {
+            std::error_code Error;
+            return std::filesystem::temp_directory_path(Error) / L"Mi.Palin" / L"ShaderCache";
+        }
+
+        std::filesystem::path Directory = LocalAppData;
+        CoTaskMemFree(LocalAppData);
+
+        return Directory / L"Mi.Palin" / L"ShaderCache";
+    }
+
+    winrt::hresult ShaderCache::Compile(
+        _In_  std::string_view Source,
+        _In_  LPCSTR EntryPoint,
+        _In_  LPCSTR Target,
+        _Out_ std::vector<uint8_t>& Bytecode) const
+    {
+        Bytecode.clear();
+
+        const auto CachePath = GetCachePath(Source, EntryPoint, Target);
+
+        // Cache hit, d3dcompiler is never loaded
+        if (std::ifstream Stream(CachePath, std::ios::binary | std::ios::ate); Stream) {
+            const auto Size = static_cast<size_t>(Stream.tellg());
+            if (Size != 0) {
+                Bytecode.resize(Size);
+                Stream.seekg(0);
+                if (Stream.read(reinterpret_cast<char*>(Bytecode.data()), static_cast<std::streamsize>(Size))) {
+                    return S_OK;
+                }
+            }
+
+            Bytecode.clear();
+        }
+
+        winrt::com_ptr<ID3DBlob> ErrorMsgBlob{};
+        winrt::com_ptr<ID3DBlob> ShaderBlob{};
+        const winrt::hresult Result = D3DCompile(Source.data(), Source.size(), nullptr, nullptr, nullptr,
+            EntryPoint, Target, SHADER_COMPILE_FLAGS, 0, ShaderBlob.put(), ErrorMsgBlob.put());
+        if (FAILED(Result)) {
+            LOG(ERROR, "ShaderCache::Compile(%s, %s) failed, Result=0x%0*X\n%s", EntryPoint, Target, 8, Result.value,
+                ErrorMsgBlob ? static_cast<const char*>(ErrorMsgBlob->GetBufferPointer()) : "");
+            return Result;
+        }
+
+        const auto Data = static_cast<const uint8_t*>(ShaderBlob->GetBufferPointer());
+        Bytecode.assign(Data, Data + ShaderBlob->GetBufferSize());
+
+        // A failure to write the cache is not fatal, the next run compiles again.
+        std::error_code Error;
+        if (std::filesystem::create_directories(mDirectory, Error); !Error) {
+            auto TempPath = CachePath;
+            TempPath += L".tmp";
+
+            if (std::ofstream Stream(TempPath, std::ios::binary | std::ios::trunc); Stream) {
+                Stream.write(reinterpret_cast<const char*>(Bytecode.data()), static_cast<std::streamsize>(Bytecode.size()));
+                Stream.close();
+
+                std::filesystem::rename(TempPath, CachePath, Error);
+            }
+        }
+
+        return S_OK;
+    }
+
+    std::filesystem::path ShaderCache::GetCachePath(
+        _In_ std::string_view Source,
+        _In_ LPCSTR EntryPoint,
+        _In_ LPCSTR Target) const
+    {
+        constexpr UINT CompilerVersion = D3D_COMPILER_VERSION;
+        constexpr UINT CompileFlags    = SHADER_COMPILE_FLAGS;
+
+        uint64_t Hash = 0xCBF29CE484222325ull;
+        Hash = HashBytes(Hash, Source.data(), Source.size());
+        Hash = HashBytes(Hash, EntryPoint, strlen(EntryPoint) + 1);
+        Hash = HashBytes(Hash, Target, strlen(Target) + 1);
+        Hash = HashBytes(Hash, &CompilerVersion, sizeof(CompilerVersion));
+        Hash = HashBytes(Hash, &CompileFlags, sizeof(CompileFlags));
+
+        wchar_t FileName[32]{};
+        swprintf_s(FileName, L"%016llX.cso", Hash);
+
+        return mDirectory / FileName;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+
+namespace Mi::Core
+{
+    // Compiles HLSL at runtime and keeps the bytecode in a local directory keyed by content hash.
+    // Only used for custom shaders, the built-in ones are compiled at build time.
+    class ShaderCache
+    {
+        std::filesystem::path mDirectory;
+
+    public:
+        explicit ShaderCache(_In_ std::filesystem::path Directory);
+
+        // %LOCALAPPDATA%\Mi.Palin\ShaderCache
+        static std::filesystem::path GetDefaultDirectory();
+
+        winrt::hresult Compile(
+            _In_  std::string_view Source,
+            _In_  LPCSTR EntryPoint,
+            _In_  LPCSTR Target,
+            _Out_ std::vector<uint8_t>& Bytecode) const;
+
+    private:
+        [[nodiscard]] std::filesystem::path GetCachePath(
+            _In_ std::string_view Source,
+            _In_ LPCSTR EntryPoint,
+            _In_ LPCSTR Target) const;
+    };
+}
@@ -0,0 +1,257 @@
+#include "Core.SharedFrameRing.h"
+#include <cstring>
+
+
+namespace Mi::Core
+{
+    constexpr uint32_t SHARED_FRAME_BYTES_PER_PIXEL = 4;
+    constexpr uint32_t SHARED_FRAME_MAXIMUM_SLOTS   = 64;
+
+    // The block is mapped into processes that do not share our atomics, every shared field is accessed in place
+    template <typename T>
+    static std::atomic_ref<T> Shared(_In_ const T& Field) noexcept
+    {
+        return std::atomic_ref<T>(const_cast<T&>(Field));
+    }
+
+    static uint32_t AlignSlotSize(_In_ uint32_t SlotSize) noexcept
+    {
+        return (SlotSize + SHARED_FRAME_RING_ALIGNMENT - 1) & ~(SHARED_FRAME_RING_ALIGNMENT - 1);
+    }
+
+    static const SharedFrameRingHeader* GetHeader(_In_ const uint8_t* Memory) noexcept
+    {
+        return reinterpret_cast<const SharedFrameRingHeader*>(Memory);
+    }
+
+    static const SharedFrameSlotHeader* GetSlot(_In_ const uint8_t* Memory, _In_ uint64_t Sequence) noexcept
+    {
+        const auto Header = GetHeader(Memory);
+        const size_t Index  = static_cast<size_t>(Sequence % Header->SlotCount);
+        const size_t Offset = sizeof(SharedFrameRingHeader) + Index * (sizeof(SharedFrameSlotHeader) + Header->SlotSize);
+
+        return reinterpret_cast<const SharedFrameSlotHeader*>(Memory + Offset);
+    }
+
+    static const uint8_t* GetPixels(_In_ const SharedFrameSlotHeader* Slot) noexcept
+    {
+        return reinterpret_cast<const uint8_t*>(Slot + 1);
+    }
+
+    static bool IsFrameValid(_In_ uint32_t SlotSize, _In_ uint32_t Width, _In_ uint32_t Height, _In_ uint32_t Stride,
+        _In_ SharedFrameFormat Format) noexcept
+    {
+        if (Format != SharedFrameFormat::B8G8R8A8 && Format != SharedFrameFormat::R8G8B8A8) {
+            return false;
+        }
+        if (Width == 0 || Height == 0 || Stride / SHARED_FRAME_BYTES_PER_PIXEL < Width) {
+            return false;
+        }
+        return static_cast<uint64_t>(Stride) * Height <= SlotSize;
+    }
+
+    size_t GetSharedFrameRingSize(_In_ uint32_t SlotCount, _In_ uint32_t SlotSize) noexcept
+    {
+        if (SlotCount < 2 || SlotCount > SHARED_FRAME_MAXIMUM_SLOTS || SlotSize == 0 || SlotSize > UINT32_MAX / 2) {
+            return 0;
+        }
+
+        return sizeof(SharedFrameRingHeader)
+            + static_cast<size_t>(SlotCount) * (sizeof(SharedFrameSlotHeader) + AlignSlotSize(SlotSize));
+    }
+
+    bool SharedFrameRingWriter::Initialize(_Out_writes_bytes_(Size) void* Memory, _In_ size_t Size,
+        _In_ uint32_t SlotCount, _In_ uint32_t SlotSize) noexcept
+    {
+        const size_t Required = GetSharedFrameRingSize(SlotCount, SlotSize);
+        if (Memory == nullptr || Required == 0 || Size < Required
+            || reinterpret_cast<uintptr_t>(Memory) % SHARED_FRAME_RING_ALIGNMENT) {
+            return false;
+        }
+
+        std::memset(Memory, 0, Required);
+
+        const auto Header = static_cast<SharedFrameRingHeader*>(Memory);
+        Header->Version   = SHARED_FRAME_RING_VERSION;
+        Header->SlotCount = SlotCount;
+        Header->SlotSize  = AlignSlotSize(SlotSize);
+
+        // Readers check the magic first, it is published last
+        Shared(Header->Magic).store(SHARED_FRAME_RING_MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    SharedFrameRingWriter::SharedFrameRingWriter(_In_ void* Memory, _In_ size_t Size) noexcept
+        : mMemory(static_cast<uint8_t*>(Memory))
+        , mSize(Size)
+    {
+    }
+
+    bool SharedFrameRingWriter::IsValid() const noexcept
+    {
+        return SharedFrameRingReader(mMemory, mSize).IsValid();
+    }
+
+    uint8_t* SharedFrameRingWriter::BeginWrite(_In_ uint32_t Width, _In_ uint32_t Height, _In_ uint32_t Stride,
+        _In_ SharedFrameFormat Format) noexcept
+    {
+        if (mWriting || !IsValid()) {
+            return nullptr;
+        }
+
+        const auto Header = GetHeader(mMemory);
+        if (!IsFrameValid(Header->SlotSize, Width, Height, Stride, Format)) {
+            return nullptr;
+        }
+
+        // Only this writer changes the sequence, a relaxed load sees its own last store
+        const uint64_t Sequence = Shared(Header->LatestSequence).load(std::memory_order_relaxed) + 1;
+        const auto Slot = const_cast<SharedFrameSlotHeader*>(GetSlot(mMemory, Sequence));
+
+        // Odd before any pixel is touched, the release fence keeps the writes below after the lock
+        const auto Lock = Shared(Slot->Lock);
+        Lock.store(Lock.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Shared(Slot->Sequence).store(Sequence, std::memory_order_relaxed);
+        Shared(Slot->Width   ).store(Width,    std::memory_order_relaxed);
+        Shared(Slot->Height  ).store(Height,   std::memory_order_relaxed);
+        Shared(Slot->Stride  ).store(Stride,   std::memory_order_relaxed);
+        Shared(Slot->Format  ).store(Format,   std::memory_order_relaxed);
+
+        mWriting = Sequence;
+        return const_cast<uint8_t*>(GetPixels(Slot));
+    }
+
+    uint64_t SharedFrameRingWriter::EndWrite() noexcept
+    {
+        if (mWriting == 0) {
+            return 0;
+        }
+
+        const auto Header = const_cast<SharedFrameRingHeader*>(GetHeader(mMemory));
+        const auto Slot   = GetSlot(mMemory, mWriting);
+
+        const auto Lock = Shared(Slot->Lock);
+        Lock.store(Lock.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        Shared(Header->LatestSequence).store(mWriting, std::memory_order_release);
+
+        const uint64_t Sequence = mWriting;
+        mWriting = 0;
+        return Sequence;
+    }
+
+    uint64_t SharedFrameRingWriter::Write(_In_ const void* Pixels, _In_ uint32_t Width, _In_ uint32_t Height,
+        _In_ uint32_t Stride, _In_ SharedFrameFormat Format) noexcept
+    {
+        const auto Destination = BeginWrite(Width, Height, Stride, Format);
+        if (Destination == nullptr) {
+            return 0;
+        }
+
+        std::memcpy(Destination, Pixels, static_cast<size_t>(Stride) * Height);
+        return EndWrite();
+    }
+
+    SharedFrameRingReader::SharedFrameRingReader(_In_ const void* Memory, _In_ size_t Size) noexcept
+        : mMemory(static_cast<const uint8_t*>(Memory))
+        , mSize(Size)
+    {
+    }
+
+    bool SharedFrameRingReader::IsValid() const noexcept
+    {
+        if (mMemory == nullptr || mSize < sizeof(SharedFrameRingHeader)
+            || reinterpret_cast<uintptr_t>(mMemory) % SHARED_FRAME_RING_ALIGNMENT) {
+            return false;
+        }
+
+        const auto Header = GetHeader(mMemory);
+        if (Shared(Header->Magic).load(std::memory_order_acquire) != SHARED_FRAME_RING_MAGIC
+            || Header->Version != SHARED_FRAME_RING_VERSION
+            || Header->SlotSize % SHARED_FRAME_RING_ALIGNMENT) {
+            return false;
+        }
+
+        const size_t Required = GetSharedFrameRingSize(Header->SlotCount, Header->SlotSize);
+        return Required && Required <= mSize;
+    }
+
+    uint64_t SharedFrameRingReader::GetLatestSequence() const noexcept
+    {
+        return Shared(GetHeader(mMemory)->LatestSequence).load(std::memory_order_acquire);
+    }
+
+    std::optional<SharedFrameInfo> SharedFrameRingReader::Peek() const noexcept
+    {
+        constexpr int MAXIMUM_ATTEMPTS = 4;
+
+        const auto Header = GetHeader(mMemory);
+
+        for (int Attempt = 0; Attempt < MAXIMUM_ATTEMPTS; ++Attempt) {
+            const uint64_t Sequence = GetLatestSequence();
+            if (Sequence == 0) {
+                return std::nullopt;
+            }
+
+            const auto Slot = GetSlot(mMemory, Sequence);
+
+            const uint64_t Before = Shared(Slot->Lock).load(std::memory_order_acquire);
+            if (Before & 1) {
+                continue;
+            }
+
+            SharedFrameInfo Info{};
+            Info.Sequence = Shared(Slot->Sequence).load(std::memory_order_relaxed);
+            Info.Width    = Shared(Slot->Width   ).load(std::memory_order_relaxed);
+            Info.Height   = Shared(Slot->Height  ).load(std::memory_order_relaxed);
+            Info.Stride   = Shared(Slot->Stride  ).load(std::memory_order_relaxed);
+            Info.Format   = Shared(Slot->Format  ).load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (Shared(Slot->Lock).load(std::memory_order_relaxed) != Before || Info.Sequence != Sequence) {
+                continue;
+            }
+
+            // The writer validated it, but the memory is shared with a process we do not trust
+            if (!IsFrameValid(Header->SlotSize, Info.Width, Info.Height, Info.Stride, Info.Format)) {
+                return std::nullopt;
+            }
+
+            return Info;
+        }
+
+        return std::nullopt;
+    }
+
+    bool SharedFrameRingReader::Read(_In_ const SharedFrameInfo& Info, _Out_ void* Destination,
+        _In_ size_t DestinationPitch) const noexcept
+    {
+        const auto Header = GetHeader(mMemory);
+        if (Info.Sequence == 0 || !IsFrameValid(Header->SlotSize, Info.Width, Info.Height, Info.Stride, Info.Format)) {
+            return false;
+        }
+
+        const size_t RowSize = static_cast<size_t>(Info.Width) * SHARED_FRAME_BYTES_PER_PIXEL;
+        if (DestinationPitch < RowSize) {
+            return false;
+        }
+
+        const auto Slot = GetSlot(mMemory, Info.Sequence);
+
+        const uint64_t Before = Shared(Slot->Lock).load(std::memory_order_acquire);
+        if ((Before & 1) || Shared(Slot->Sequence).load(std::memory_order_relaxed) != Info.Sequence) {
+            return false;
+        }
+
+        const auto Source = GetPixels(Slot);
+        const auto Target = static_cast<uint8_t*>(Destination);
+        for (uint32_t Row = 0; Row < Info.Height; ++Row) {
+            std::memcpy(Target + Row * DestinationPitch, Source + static_cast<size_t>(Row) * Info.Stride, RowSize);
+        }
+
+        // Any write to the slot during the copy moved the lock on
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return Shared(Slot->Lock).load(std::memory_order_relaxed) == Before;
+    }
+}
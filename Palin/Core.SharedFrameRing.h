@@ -0,0 +1,112 @@
+#pragma once
+
+
+namespace Mi::Core
+{
+    // Ring of CPU frames in a block of shared memory, for producers without a D3D device.
+    //
+    // Layout, every part aligned to SHARED_FRAME_RING_ALIGNMENT:
+    //   SharedFrameRingHeader
+    //   SlotCount x { SharedFrameSlotHeader, SlotSize bytes of pixels }
+    //
+    // There is one writer. It fills the slots round-robin, every slot is guarded by a seqlock: Lock is odd while the
+    // slot is written. Readers never block the writer, they copy the newest slot and drop the copy if Lock changed.
+    // All counters are 64 bit and accessed atomically, so the block can be shared between 32 and 64 bit processes.
+
+    constexpr uint32_t SHARED_FRAME_RING_MAGIC     = 0x52464C50;    // "PLFR"
+    constexpr uint32_t SHARED_FRAME_RING_VERSION   = 1;
+    constexpr uint32_t SHARED_FRAME_RING_ALIGNMENT = 64;
+
+    enum class SharedFrameFormat : uint32_t
+    {
+        Unknown,
+        B8G8R8A8,
+        R8G8B8A8,
+    };
+
+    struct alignas(SHARED_FRAME_RING_ALIGNMENT) SharedFrameRingHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t SlotCount;
+        uint32_t SlotSize;          // bytes of pixels per slot, a multiple of SHARED_FRAME_RING_ALIGNMENT
+        uint64_t LatestSequence;    // newest published frame, 0 before the first one
+    };
+
+    struct alignas(SHARED_FRAME_RING_ALIGNMENT) SharedFrameSlotHeader
+    {
+        uint64_t Lock;              // seqlock, odd while the writer owns the slot
+        uint64_t Sequence;          // frame in the slot, numbered from 1
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t Stride;            // bytes per row, at least Width * 4
+        SharedFrameFormat Format;
+    };
+
+    static_assert(sizeof(SharedFrameRingHeader) == SHARED_FRAME_RING_ALIGNMENT);
+    static_assert(sizeof(SharedFrameSlotHeader) == SHARED_FRAME_RING_ALIGNMENT);
+
+    struct SharedFrameInfo
+    {
+        uint64_t Sequence = 0;
+        uint32_t Width    = 0;
+        uint32_t Height   = 0;
+        uint32_t Stride   = 0;
+        SharedFrameFormat Format = SharedFrameFormat::Unknown;
+    };
+
+    // Bytes needed for a ring, 0 if the arguments are out of range.
+    [[nodiscard]] size_t GetSharedFrameRingSize(_In_ uint32_t SlotCount, _In_ uint32_t SlotSize) noexcept;
+
+    // Producer side, one per ring.
+    class SharedFrameRingWriter
+    {
+        uint8_t* mMemory = nullptr;
+        size_t   mSize   = 0;
+        uint64_t mWriting = 0;  // sequence between BeginWrite() and EndWrite(), 0 otherwise
+
+    public:
+        // Formats Memory as an empty ring, SlotSize is rounded up to the alignment.
+        static bool Initialize(_Out_writes_bytes_(Size) void* Memory, _In_ size_t Size,
+            _In_ uint32_t SlotCount, _In_ uint32_t SlotSize) noexcept;
+
+        SharedFrameRingWriter() = default;
+        SharedFrameRingWriter(_In_ void* Memory, _In_ size_t Size) noexcept;
+
+        [[nodiscard]] bool IsValid() const noexcept;
+
+        // Locks the next slot and returns where its pixels go, or nullptr if the frame does not fit a slot.
+        [[nodiscard]] uint8_t* BeginWrite(_In_ uint32_t Width, _In_ uint32_t Height, _In_ uint32_t Stride,
+            _In_ SharedFrameFormat Format) noexcept;
+
+        // Unlocks the slot and publishes it as the newest frame, returns its sequence.
+        uint64_t EndWrite() noexcept;
+
+        // BeginWrite(), a copy of the rows and EndWrite(). Returns 0 if the frame does not fit a slot.
+        uint64_t Write(_In_ const void* Pixels, _In_ uint32_t Width, _In_ uint32_t Height, _In_ uint32_t Stride,
+            _In_ SharedFrameFormat Format) noexcept;
+    };
+
+    // Consumer side, any number of them.
+    class SharedFrameRingReader
+    {
+        const uint8_t* mMemory = nullptr;
+        size_t         mSize   = 0;
+
+    public:
+        SharedFrameRingReader() = default;
+        SharedFrameRingReader(_In_ const void* Memory, _In_ size_t Size) noexcept;
+
+        // The header was written by a compatible writer and all slots are inside the block.
+        [[nodiscard]] bool IsValid() const noexcept;
+
+        [[nodiscard]] uint64_t GetLatestSequence() const noexcept;
+
+        // Metadata of the newest frame, std::nullopt before the first frame or while the writer laps the reader.
+        [[nodiscard]] std::optional<SharedFrameInfo> Peek() const noexcept;
+
+        // Copies Info.Width * 4 bytes of each row of frame Info.Sequence to Destination.
+        // Returns false if the writer reused the slot in the meantime, the copy is then torn and has to be dropped.
+        bool Read(_In_ const SharedFrameInfo& Info, _Out_ void* Destination, _In_ size_t DestinationPitch) const noexcept;
+    };
+}
@@ -0,0 +1,37 @@
+#include "Core.SurfaceRing.h"
+
+
+namespace Mi::Core
+{
+    uint32_t SurfaceRing::GetWriteSlot() const noexcept
+    {
+        return mWrite;
+    }
+
+    uint64_t SurfaceRing::Publish() noexcept
+    {
+        const uint64_t Generation = mNextGeneration++;
+        mGenerations[mWrite] = Generation;
+
+        // Release the written slot, acquire the one the consumer gave up
+        const uint32_t Previous = mMiddle.exchange(mWrite | FRESH_BIT, std::memory_order_acq_rel);
+        mWrite = Previous & INDEX_MASK;
+
+        return Generation;
+    }
+
+    std::optional<SurfaceRingSlot> SurfaceRing::Acquire() noexcept
+    {
+        if (mMiddle.load(std::memory_order_relaxed) & FRESH_BIT) {
+            // Only the consumer clears FRESH_BIT, so the exchanged slot is fresh until this exchange
+            const uint32_t Previous = mMiddle.exchange(mRead, std::memory_order_acq_rel);
+            mRead = Previous & INDEX_MASK;
+        }
+
+        if (mGenerations[mRead] == 0) {
+            return std::nullopt;
+        }
+
+        return SurfaceRingSlot{ mRead, mGenerations[mRead] };
+    }
+}
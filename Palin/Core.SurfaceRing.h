@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+
+
+namespace Mi::Core
+{
+    constexpr uint32_t SURFACE_RING_SLOTS = 3;
+
+    struct SurfaceRingSlot
+    {
+        uint32_t Index      = 0;
+        uint64_t Generation = 0;
+    };
+
+    // Lock-free triple buffer slot states, for one producer and one consumer thread.
+    //
+    // The producer owns a write slot, the consumer owns a read slot and the third one is exchanged between them.
+    // Publish() hands the written slot over and takes the exchanged one back, Acquire() takes the exchanged slot
+    // only if it holds a newer frame. Neither side ever waits, and the consumer always gets the newest frame.
+    class SurfaceRing
+    {
+        static constexpr uint32_t INDEX_MASK = 0x3;
+        static constexpr uint32_t FRESH_BIT  = 0x4;
+
+        // Index of the exchanged slot, and FRESH_BIT while the consumer has not taken it yet.
+        std::atomic_uint32_t mMiddle = 1;
+
+        // Each generation is only written by the side that owns the slot, the exchange publishes it.
+        std::array<uint64_t, SURFACE_RING_SLOTS> mGenerations{};
+
+        // Producer side
+        uint32_t mWrite          = 0;
+        uint64_t mNextGeneration = 1;
+
+        // Consumer side
+        uint32_t mRead = 2;
+
+    public:
+        SurfaceRing() = default;
+        SurfaceRing(      SurfaceRing&&) = delete;
+        SurfaceRing(const SurfaceRing& ) = delete;
+        SurfaceRing& operator=(      SurfaceRing&&) = delete;
+        SurfaceRing& operator=(const SurfaceRing& ) = delete;
+
+        // Producer: the slot to write the next frame into, it is not read by the consumer until published.
+        [[nodiscard]] uint32_t GetWriteSlot() const noexcept;
+
+        // Producer: makes the write slot the newest frame, returns its generation.
+        uint64_t Publish() noexcept;
+
+        // Consumer: the newest published frame, or std::nullopt before the first publish.
+        // The slot stays owned by the consumer until the next Acquire().
+        [[nodiscard]] std::optional<SurfaceRingSlot> Acquire() noexcept;
+    };
+}
@@ -0,0 +1,255 @@
+#include "Core.TestPattern.h"
+
+#include <cstdio>
+#include <cstring>
+
+
+namespace Mi::Core
+{
+    static constexpr uint32_t GLYPH_WIDTH  = 5;
+    static constexpr uint32_t GLYPH_HEIGHT = 7;
+
+    // 5x7, one byte per row, the most significant of the low 5 bits is the leftmost column
+    static const uint8_t* GetGlyph(_In_ char Character) noexcept
+    {
+        static constexpr uint8_t Digits[10][GLYPH_HEIGHT] = {
+            { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },
+            { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },
+            { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },
+            { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },
+            { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },
+            { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },
+            { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },
+            { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },
+            { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },
+            { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },
+        };
+        static constexpr uint8_t Letters[26][GLYPH_HEIGHT] = {
+            { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 },
+            { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E },
+            { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E },
+            { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C },
+            { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F },
+            { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 },
+            { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F },
+            { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },
+            { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },
+            { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C },
+            { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },
+            { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F },
+            { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 },
+            { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },
+            { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },
+            { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 },
+            { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D },
+            { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 },
+            { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E },
+            { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },
+            { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },
+            { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 },
+            { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A },
+            { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 },
+            { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 },
+            { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F },
+        };
+        static constexpr uint8_t Period[GLYPH_HEIGHT] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C };
+        static constexpr uint8_t Hyphen[GLYPH_HEIGHT] = { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 };
+        static constexpr uint8_t Colon [GLYPH_HEIGHT] = { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 };
+        static constexpr uint8_t Space [GLYPH_HEIGHT] = {};
+
+        if (Character >= '0' && Character <= '9') {
+            return Digits[Character - '0'];
+        }
+        if (Character >= 'A' && Character <= 'Z') {
+            return Letters[Character - 'A'];
+        }
+        if (Character >= 'a' && Character <= 'z') {
+            return Letters[Character - 'a'];
+        }
+
+        switch (Character) {
+        case '.': return Period;
+        case '-': return Hyphen;
+        case ':': return Colon;
+        default:  return Space;
+        }
+    }
+
+    static void WritePixel(_Out_writes_bytes_(4) uint8_t* Pixel, _In_ uint8_t R, _In_ uint8_t G, _In_ uint8_t B) noexcept
+    {
+        Pixel[0] = B;
+        Pixel[1] = G;
+        Pixel[2] = R;
+        Pixel[3] = 0xFF;
+    }
+
+    static void DrawGradient(_In_ uint64_t Frame,
+        _Out_ uint8_t* Pixels, _In_ uint32_t Pitch, _In_ uint32_t Width, _In_ uint32_t Height) noexcept
+    {
+        const uint64_t Shift = Frame * 4;
+        const uint8_t  Blue  = static_cast<uint8_t>(Frame * 2);
+
+        // Red only depends on the column, it is computed once per frame
+        std::vector<uint8_t> Reds(Width);
+        for (uint32_t X = 0; X < Width; ++X) {
+            Reds[X] = static_cast<uint8_t>((X + Shift) % Width * 255 / std::max<uint32_t>(Width - 1, 1));
+        }
+
+        for (uint32_t Y = 0; Y < Height; ++Y) {
+            uint8_t* Row = Pixels + static_cast<size_t>(Y) * Pitch;
+            const auto Green = static_cast<uint8_t>(static_cast<uint64_t>(Y) * 255 / std::max<uint32_t>(Height - 1, 1));
+
+            for (uint32_t X = 0; X < Width; ++X) {
+                WritePixel(Row + static_cast<size_t>(X) * 4, Reds[X], Green, Blue);
+            }
+        }
+    }
+
+    static void DrawCheckerboard(_In_ uint64_t Frame,
+        _Out_ uint8_t* Pixels, _In_ uint32_t Pitch, _In_ uint32_t Width, _In_ uint32_t Height) noexcept
+    {
+        const uint32_t Square = std::max<uint32_t>(std::min(Width, Height) / 16, 8);
+        const uint32_t Shift  = static_cast<uint32_t>(Frame * 2 % (Square * 2));
+
+        // There are only two different rows, every row is a copy of one of them
+        std::vector<uint8_t> Rows(static_cast<size_t>(Width) * 4 * 2);
+        for (uint32_t X = 0; X < Width; ++X) {
+            const bool Light = ((X + Shift) / Square) & 1;
+            const uint8_t Even = Light ? 0xE0 : 0x20;
+            const uint8_t Odd  = Light ? 0x20 : 0xE0;
+            WritePixel(Rows.data() + static_cast<size_t>(X) * 4, Even, Even, Even);
+            WritePixel(Rows.data() + static_cast<size_t>(Width + X) * 4, Odd, Odd, Odd);
+        }
+
+        for (uint32_t Y = 0; Y < Height; ++Y) {
+            const uint32_t RowParity = ((Y + Shift) / Square) & 1;
+            memcpy(Pixels + static_cast<size_t>(Y) * Pitch, Rows.data() + static_cast<size_t>(RowParity) * Width * 4,
+                static_cast<size_t>(Width) * 4);
+        }
+    }
+
+    static void DrawScrollingText(_In_ uint64_t Frame,
+        _Out_ uint8_t* Pixels, _In_ uint32_t Pitch, _In_ uint32_t Width, _In_ uint32_t Height) noexcept
+    {
+        char Text[64];
+        const int Length = snprintf(Text, sizeof(Text), "MI.PALIN TEST PATTERN - FRAME %08llu -  ",
+            static_cast<unsigned long long>(Frame));
+
+        const uint32_t Scale       = std::max<uint32_t>(Height / 120, 1);
+        const uint32_t CellWidth   = (GLYPH_WIDTH + 1) * Scale;
+        const uint32_t LineHeight  = (GLYPH_HEIGHT + 3) * Scale;
+        const uint32_t TextWidth   = CellWidth * static_cast<uint32_t>(std::max(Length, 1));
+
+        // The text is rendered once per glyph row, every line then copies a scrolled window of it
+        std::vector<uint32_t> Strips(static_cast<size_t>(TextWidth) * (GLYPH_HEIGHT + 1));
+        const uint32_t Background = 0xFF101030;     // A8R8G8B8 as a little endian value, B8G8R8A8 in memory
+        const uint32_t Foreground = 0xFFF0F0F0;
+
+        for (uint32_t GlyphRow = 0; GlyphRow <= GLYPH_HEIGHT; ++GlyphRow) {
+            uint32_t* Strip = Strips.data() + static_cast<size_t>(GlyphRow) * TextWidth;
+
+            for (uint32_t Column = 0; Column < TextWidth; ++Column) {
+                const uint32_t GlyphColumn = (Column % CellWidth) / Scale;
+
+                bool Lit = false;
+                if (GlyphRow < GLYPH_HEIGHT && GlyphColumn < GLYPH_WIDTH) {
+                    const uint8_t* Glyph = GetGlyph(Text[Column / CellWidth]);
+                    Lit = (Glyph[GlyphRow] >> (GLYPH_WIDTH - 1 - GlyphColumn)) & 1;
+                }
+                Strip[Column] = Lit ? Foreground : Background;
+            }
+        }
+
+        for (uint32_t Y = 0; Y < Height; ++Y) {
+            uint8_t* Row = Pixels + static_cast<size_t>(Y) * Pitch;
+
+            // Every line scrolls at its own speed, odd lines the other way
+            const uint32_t Line     = Y / LineHeight;
+            const uint32_t GlyphRow = std::min<uint32_t>((Y % LineHeight) / Scale, GLYPH_HEIGHT);
+            const uint64_t Speed    = (Line % 4 + 1) * 2;
+            const uint32_t Shift    = static_cast<uint32_t>(Frame * Speed % TextWidth);
+            const uint32_t* Strip   = Strips.data() + static_cast<size_t>(GlyphRow) * TextWidth;
+
+            uint32_t Column = (Line & 1) ? (TextWidth - Shift) % TextWidth : Shift;
+            for (uint32_t X = 0; X < Width; ) {
+                const uint32_t Count = std::min(TextWidth - Column, Width - X);
+                memcpy(Row + static_cast<size_t>(X) * 4, Strip + Column, static_cast<size_t>(Count) * 4);
+                X     += Count;
+                Column = 0;
+            }
+        }
+    }
+
+    static void DrawNoise(_In_ uint64_t Frame,
+        _Out_ uint8_t* Pixels, _In_ uint32_t Pitch, _In_ uint32_t Width, _In_ uint32_t Height) noexcept
+    {
+        // xorshift64*, seeded by the frame so frames are reproducible
+        uint64_t State = (Frame + 1) * 0x9E3779B97F4A7C15ull;
+
+        for (uint32_t Y = 0; Y < Height; ++Y) {
+            uint8_t* Row = Pixels + static_cast<size_t>(Y) * Pitch;
+
+            for (uint32_t X = 0; X < Width; X += 2) {
+                State ^= State >> 12;
+                State ^= State << 25;
+                State ^= State >> 27;
+                const uint64_t Value = State * 0x2545F4914F6CDD1Dull;
+
+                // One draw colors two pixels
+                WritePixel(Row + static_cast<size_t>(X) * 4,
+                    static_cast<uint8_t>(Value), static_cast<uint8_t>(Value >> 8), static_cast<uint8_t>(Value >> 16));
+                if (X + 1 < Width) {
+                    WritePixel(Row + static_cast<size_t>(X + 1) * 4,
+                        static_cast<uint8_t>(Value >> 32), static_cast<uint8_t>(Value >> 40), static_cast<uint8_t>(Value >> 48));
+                }
+            }
+        }
+    }
+
+    const char* GetTestPatternName(_In_ TestPattern Pattern) noexcept
+    {
+        switch (Pattern) {
+        case TestPattern::Gradient:      return "gradient";
+        case TestPattern::Checkerboard:  return "checkerboard";
+        case TestPattern::ScrollingText: return "text";
+        case TestPattern::Noise:         return "noise";
+        default:                         return "unknown";
+        }
+    }
+
+    std::optional<TestPattern> ParseTestPatternName(_In_ std::string_view Name) noexcept
+    {
+        for (const auto Pattern : { TestPattern::Gradient, TestPattern::Checkerboard, TestPattern::ScrollingText, TestPattern::Noise }) {
+            if (Name == GetTestPatternName(Pattern)) {
+                return Pattern;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void DrawTestPattern(_In_ TestPattern Pattern, _In_ uint64_t Frame,
+        _Out_writes_bytes_(Pitch * Height) uint8_t* Pixels, _In_ uint32_t Pitch, _In_ uint32_t Width, _In_ uint32_t Height) noexcept
+    {
+        if (Width == 0 || Height == 0 || Pitch < Width * 4) {
+            return;
+        }
+
+        switch (Pattern) {
+        case TestPattern::Gradient:
+            DrawGradient(Frame, Pixels, Pitch, Width, Height);
+            break;
+        case TestPattern::Checkerboard:
+            DrawCheckerboard(Frame, Pixels, Pitch, Width, Height);
+            break;
+        case TestPattern::ScrollingText:
+            DrawScrollingText(Frame, Pixels, Pitch, Width, Height);
+            break;
+        case TestPattern::Noise:
+            DrawNoise(Frame, Pixels, Pitch, Width, Height);
+            break;
+        default:
+            memset(Pixels, 0, static_cast<size_t>(Pitch) * Height);
+            break;
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+
+namespace Mi::Core
+{
+    enum class TestPattern
+    {
+        Gradient,       // color ramps drifting horizontally
+        Checkerboard,   // squares scrolling diagonally
+        ScrollingText,  // lines of text with the frame number scrolling horizontally
+        Noise,          // every pixel changes every frame, defeats any dirty rect or compression shortcut
+    };
+
+    [[nodiscard]] const char* GetTestPatternName(_In_ TestPattern Pattern) noexcept;
+
+    // Returns std::nullopt for an unknown name.
+    [[nodiscard]] std::optional<TestPattern> ParseTestPatternName(_In_ std::string_view Name) noexcept;
+
+    // Draws frame Frame of Pattern into a B8G8R8A8 image. The same frame always produces the same pixels.
+    void DrawTestPattern(_In_ TestPattern Pattern, _In_ uint64_t Frame,
+        _Out_writes_bytes_(Pitch * Height) uint8_t* Pixels, _In_ uint32_t Pitch, _In_ uint32_t Width, _In_ uint32_t Height) noexcept;
+}
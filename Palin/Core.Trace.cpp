@@ -0,0 +1,259 @@
+#include "Core.Trace.h"
+
+#include <array>
+#include <fstream>
+#include <string>
+
+
+namespace Mi::Core
+{
+    static constexpr size_t TRACE_RING_CAPACITY = 16384;   // spans per thread, a power of two
+    static constexpr size_t TRACE_RETIRED_RINGS = 16;      // buffers of exited threads that are kept
+
+    // One span, guarded by a sequence lock: odd while the owner writes it, 2 * (index + 1) once written
+    struct TraceSlot
+    {
+        std::atomic_uint64_t     Sequence = 0;
+        std::atomic<const char*> Name     = nullptr;
+        std::atomic_uint64_t     Begin    = 0;
+        std::atomic_uint64_t     End      = 0;
+    };
+
+    struct TraceRing
+    {
+        std::array<TraceSlot, TRACE_RING_CAPACITY> Slots;
+        std::atomic_uint64_t     Count   = 0;      // spans recorded, written by the owner only
+        std::atomic<const char*> Name    = nullptr;
+        std::atomic_bool         Retired = false;
+        uint32_t                 Id      = 0;
+    };
+
+    static std::mutex                              TraceLock;
+    static std::vector<std::unique_ptr<TraceRing>> TraceRings;
+    static uint32_t                                TraceNextId = 1;
+
+    static thread_local TraceRing* ThreadTraceRing = nullptr;
+    static thread_local bool       ThreadTraceExited = false;
+
+    struct TraceRingRetirer
+    {
+        TraceRing* Ring = nullptr;
+
+        ~TraceRingRetirer()
+        {
+            if (Ring != nullptr) {
+                Ring->Retired.store(true, std::memory_order_release);
+            }
+            ThreadTraceRing   = nullptr;
+            ThreadTraceExited = true;
+        }
+    };
+
+    static TraceRing* GetThreadTraceRing() noexcept
+    {
+        if (ThreadTraceRing != nullptr || ThreadTraceExited) {
+            return ThreadTraceRing;
+        }
+
+        static thread_local TraceRingRetirer Retirer;
+
+        try {
+            auto Ring = std::make_unique<TraceRing>();
+
+            std::lock_guard Guard(TraceLock);
+            Ring->Id = TraceNextId++;
+
+            // Threads come and go with every capture session, only the newest exited ones are kept
+            size_t Retired = 0;
+            for (const auto& Item : TraceRings) {
+                Retired += Item->Retired.load(std::memory_order_acquire) ? 1 : 0;
+            }
+            for (auto Item = TraceRings.begin(); Retired > TRACE_RETIRED_RINGS && Item != TraceRings.end();) {
+                if ((*Item)->Retired.load(std::memory_order_acquire)) {
+                    Item = TraceRings.erase(Item);
+                    --Retired;
+                }
+                else {
+                    ++Item;
+                }
+            }
+
+            Retirer.Ring = Ring.get();
+            TraceRings.push_back(std::move(Ring));
+            ThreadTraceRing = TraceRings.back().get();
+        }
+        catch (...) {
+            return nullptr;
+        }
+
+        return ThreadTraceRing;
+    }
+
+    namespace TraceDetail
+    {
+        uint64_t Now() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        void Record(_In_z_ const char* Name, _In_ uint64_t Begin, _In_ uint64_t End) noexcept
+        {
+            TraceRing* Ring = GetThreadTraceRing();
+            if (Ring == nullptr) {
+                return;
+            }
+
+            const uint64_t Index = Ring->Count.load(std::memory_order_relaxed);
+            TraceSlot& Slot = Ring->Slots[Index & (TRACE_RING_CAPACITY - 1)];
+
+            Slot.Sequence.store(Index * 2 + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            Slot.Name.store(Name, std::memory_order_relaxed);
+            Slot.Begin.store(Begin, std::memory_order_relaxed);
+            Slot.End.store(End, std::memory_order_relaxed);
+            Slot.Sequence.store(Index * 2 + 2, std::memory_order_release);
+
+            Ring->Count.store(Index + 1, std::memory_order_relaxed);
+        }
+    }
+
+    void Trace::SetEnabled(_In_ bool Enable) noexcept
+    {
+        TraceDetail::Enabled.store(Enable, std::memory_order_relaxed);
+    }
+
+    void Trace::SetThreadName(_In_z_ const char* Name)
+    {
+        if (TraceRing* Ring = GetThreadTraceRing()) {
+            Ring->Name.store(Name, std::memory_order_relaxed);
+        }
+    }
+
+    void Trace::WriteChromeTrace(_Inout_ JsonWriter& Json, _In_ std::chrono::steady_clock::time_point From,
+        _In_ std::chrono::steady_clock::time_point To)
+    {
+        struct Span
+        {
+            const char* Name;
+            uint64_t    Begin;
+            uint64_t    End;
+            uint32_t    Thread;
+        };
+
+        struct Thread
+        {
+            uint32_t    Id;
+            std::string Name;
+        };
+
+        const auto ToNanoseconds = [](std::chrono::steady_clock::time_point Time)
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Time.time_since_epoch()).count());
+        };
+        const uint64_t Start = ToNanoseconds(From);
+        const uint64_t Stop  = ToNanoseconds(To);
+
+        std::vector<Span>   Spans;
+        std::vector<Thread> Threads;
+        {
+            std::lock_guard Guard(TraceLock);
+            for (const auto& Ring : TraceRings) {
+                const size_t First = Spans.size();
+
+                for (const TraceSlot& Slot : Ring->Slots) {
+                    const uint64_t Sequence = Slot.Sequence.load(std::memory_order_acquire);
+                    if (Sequence == 0 || (Sequence & 1) != 0) {
+                        continue;
+                    }
+
+                    const Span Item{
+                        Slot.Name.load(std::memory_order_relaxed),
+                        Slot.Begin.load(std::memory_order_relaxed),
+                        Slot.End.load(std::memory_order_relaxed),
+                        Ring->Id };
+
+                    // Overwritten while it was read
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (Slot.Sequence.load(std::memory_order_relaxed) != Sequence) {
+                        continue;
+                    }
+
+                    if (Item.End >= Start && Item.Begin <= Stop) {
+                        Spans.push_back(Item);
+                    }
+                }
+
+                if (Spans.size() != First) {
+                    const char* Name = Ring->Name.load(std::memory_order_relaxed);
+                    Threads.push_back({ Ring->Id, Name != nullptr ? Name : "Thread " + std::to_string(Ring->Id) });
+                }
+            }
+        }
+
+        std::sort(Spans.begin(), Spans.end(), [](const Span& Left, const Span& Right)
+        {
+            return Left.Begin < Right.Begin;
+        });
+
+        // Microseconds from From, spans that cross the edges are cut to the window
+        const auto ToMicroseconds = [Start](uint64_t Time)
+        {
+            return static_cast<double>(Time - Start) / 1000.0;
+        };
+
+        Json.BeginObject();
+        Json.Key("traceEvents").BeginArray();
+        for (const auto& Item : Threads) {
+            Json.BeginObject()
+                .Member("name", "thread_name")
+                .Member("ph", "M")
+                .Member("pid", 1)
+                .Member("tid", Item.Id)
+                .Key("args").BeginObject().Member("name", std::string_view(Item.Name)).EndObject()
+                .EndObject();
+        }
+        for (const auto& Item : Spans) {
+            const uint64_t Begin = std::max(Item.Begin, Start);
+            const uint64_t End   = std::max(std::min(Item.End, Stop), Begin);
+
+            Json.BeginObject()
+                .Member("name", Item.Name)
+                .Member("cat", "palin")
+                .Member("ph", "X")
+                .Member("pid", 1)
+                .Member("tid", Item.Thread)
+                .Member("ts", ToMicroseconds(Begin))
+                .Member("dur", static_cast<double>(End - Begin) / 1000.0)
+                .EndObject();
+        }
+        Json.EndArray();
+        Json.Member("displayTimeUnit", "ms");
+        Json.EndObject();
+    }
+
+    bool Trace::SaveChromeTrace(_In_ const std::filesystem::path& Path, _In_ std::chrono::steady_clock::time_point From,
+        _In_ std::chrono::steady_clock::time_point To)
+    {
+        JsonWriter Json;
+        WriteChromeTrace(Json, From, To);
+
+        std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+        File.write(Json.GetString().data(), static_cast<std::streamsize>(Json.GetString().size()));
+        return static_cast<bool>(File.flush());
+    }
+
+    TraceStatistics Trace::GetStatistics()
+    {
+        TraceStatistics Statistics{};
+
+        std::lock_guard Guard(TraceLock);
+        for (const auto& Ring : TraceRings) {
+            const uint64_t Count = Ring->Count.load(std::memory_order_relaxed);
+            Statistics.Recorded    += Count;
+            Statistics.Overwritten += Count > TRACE_RING_CAPACITY ? Count - TRACE_RING_CAPACITY : 0;
+            ++Statistics.Threads;
+        }
+        return Statistics;
+    }
+}
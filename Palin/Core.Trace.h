@@ -0,0 +1,77 @@
+#pragma once
+#include "Core.JsonWriter.h"
+
+
+namespace Mi::Core
+{
+    struct TraceStatistics
+    {
+        uint64_t Recorded    = 0;   // spans since the start, over all threads
+        uint64_t Overwritten = 0;   // of those, spans the per-thread buffers no longer hold
+        uint32_t Threads     = 0;
+    };
+
+    namespace TraceDetail
+    {
+        inline std::atomic_bool Enabled = false;
+
+        [[nodiscard]] uint64_t Now() noexcept;
+        void Record(_In_z_ const char* Name, _In_ uint64_t Begin, _In_ uint64_t End) noexcept;
+    }
+
+    // Scoped spans of the capture and render pipeline, exported in the Chrome trace event format that
+    // chrome://tracing and ui.perfetto.dev open.
+    //
+    // Every thread records into a buffer of its own that keeps its newest spans, so a trace can be taken of any
+    // recent time window without stopping anything. Tracing is off by default, a span then costs one branch.
+    class Trace final
+    {
+    public:
+        [[nodiscard]] static bool IsEnabled() noexcept
+        {
+            return TraceDetail::Enabled.load(std::memory_order_relaxed);
+        }
+
+        // Spans recorded so far are kept when tracing is turned off.
+        static void SetEnabled(_In_ bool Enable) noexcept;
+
+        // Names the calling thread in the trace, Name must outlive the process, e.g. a string literal.
+        static void SetThreadName(_In_z_ const char* Name);
+
+        // Writes the spans that overlap From..To as a trace object, times are relative to From.
+        static void WriteChromeTrace(_Inout_ JsonWriter& Json, _In_ std::chrono::steady_clock::time_point From,
+            _In_ std::chrono::steady_clock::time_point To);
+
+        // WriteChromeTrace into a file, returns false if it can not be written.
+        static bool SaveChromeTrace(_In_ const std::filesystem::path& Path, _In_ std::chrono::steady_clock::time_point From,
+            _In_ std::chrono::steady_clock::time_point To);
+
+        [[nodiscard]] static TraceStatistics GetStatistics();
+    };
+
+    // Records the time from construction to destruction under Name, a string literal.
+    class TraceSpan final
+    {
+        const char* mName;
+        uint64_t    mBegin;     // 0 if tracing was off at the start
+
+    public:
+        explicit TraceSpan(_In_z_ const char* Name) noexcept
+            : mName(Name)
+            , mBegin(Trace::IsEnabled() ? TraceDetail::Now() : 0)
+        {
+        }
+
+        ~TraceSpan()
+        {
+            if (mBegin != 0) {
+                TraceDetail::Record(mName, mBegin, TraceDetail::Now());
+            }
+        }
+
+        TraceSpan(const TraceSpan&)            = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+        TraceSpan(TraceSpan&&)                 = delete;
+        TraceSpan& operator=(TraceSpan&&)      = delete;
+    };
+}
@@ -0,0 +1,252 @@
+#include "Core.TrigramIndex.h"
+
+#include <cwctype>
+
+
+namespace Mi::Core
+{
+    static void ToLower(_In_ std::wstring_view Text, _Inout_ std::wstring& Lower)
+    {
+        Lower.resize(Text.size());
+        for (size_t Index = 0; Index < Text.size(); ++Index) {
+            const wchar_t Character = Text[Index];
+
+            // Titles are mostly ASCII, towlower goes through the locale
+            if (Character < 0x80) {
+                Lower[Index] = (Character >= L'A' && Character <= L'Z') ? static_cast<wchar_t>(Character + (L'a' - L'A')) : Character;
+            }
+            else {
+                Lower[Index] = static_cast<wchar_t>(std::towlower(static_cast<std::wint_t>(Character)));
+            }
+        }
+    }
+
+    // 21 bits per character, all of Unicode
+    static constexpr uint64_t PackTrigram(_In_ wchar_t First, _In_ wchar_t Second, _In_ wchar_t Third) noexcept
+    {
+        constexpr uint64_t MASK = (1u << 21) - 1;
+        return ((static_cast<uint64_t>(First)  & MASK) << 42)
+             | ((static_cast<uint64_t>(Second) & MASK) << 21)
+             |  (static_cast<uint64_t>(Third)  & MASK);
+    }
+
+    static void AppendTrigrams(_In_ std::wstring_view Text, _Inout_ std::vector<uint64_t>& Trigrams)
+    {
+        for (size_t Index = 0; Index + 3 <= Text.size(); ++Index) {
+            Trigrams.push_back(PackTrigram(Text[Index], Text[Index + 1], Text[Index + 2]));
+        }
+    }
+
+    static bool IsWordCharacter(_In_ wchar_t Character) noexcept
+    {
+        return Character >= 0x80
+            || (Character >= L'0' && Character <= L'9')
+            || (Character >= L'a' && Character <= L'z')
+            || (Character >= L'A' && Character <= L'Z');
+    }
+
+    // The first one and two characters of every word behind one or two NULs, what short queries look up
+    static void AppendWordStarts(_In_ std::wstring_view Text, _Inout_ std::vector<uint64_t>& Trigrams)
+    {
+        for (size_t Index = 0; Index < Text.size(); ++Index) {
+            if (!IsWordCharacter(Text[Index]) || (Index > 0 && IsWordCharacter(Text[Index - 1]))) {
+                continue;
+            }
+
+            Trigrams.push_back(PackTrigram(0, 0, Text[Index]));
+            if (Index + 1 < Text.size()) {
+                Trigrams.push_back(PackTrigram(0, Text[Index], Text[Index + 1]));
+            }
+        }
+    }
+
+    static void SortUnique(_Inout_ std::vector<uint64_t>& Trigrams)
+    {
+        std::sort(Trigrams.begin(), Trigrams.end());
+        Trigrams.erase(std::unique(Trigrams.begin(), Trigrams.end()), Trigrams.end());
+    }
+
+    void TrigramIndex::Insert(_In_ uint64_t Id, _In_ std::wstring_view Title, _In_ std::wstring_view ClassName,
+        _In_ std::wstring_view ProcessName)
+    {
+        (void)Erase(Id);
+
+        uint32_t Slot;
+        if (!mFreeSlots.empty()) {
+            Slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+        else {
+            Slot = static_cast<uint32_t>(mDocuments.size());
+            mDocuments.emplace_back();
+        }
+
+        Document& Item = mDocuments[Slot];
+        Item.Id   = Id;
+        Item.Used = true;
+        ToLower(Title,       Item.Fields[FIELD_TITLE]);
+        ToLower(ClassName,   Item.Fields[FIELD_CLASS_NAME]);
+        ToLower(ProcessName, Item.Fields[FIELD_PROCESS_NAME]);
+
+        // Per field, a trigram across two fields would match text nobody typed
+        Item.Trigrams.clear();
+        for (const auto& Text : Item.Fields) {
+            AppendTrigrams(Text, Item.Trigrams);
+            AppendWordStarts(Text, Item.Trigrams);
+        }
+        SortUnique(Item.Trigrams);
+
+        for (const uint64_t Trigram : Item.Trigrams) {
+            mPostings[Trigram].push_back(Slot);
+        }
+
+        mSlots.emplace(Id, Slot);
+    }
+
+    bool TrigramIndex::Erase(_In_ uint64_t Id)
+    {
+        const auto Found = mSlots.find(Id);
+        if (Found == mSlots.end()) {
+            return false;
+        }
+
+        const uint32_t Slot = Found->second;
+        mSlots.erase(Found);
+
+        Document& Item = mDocuments[Slot];
+        for (const uint64_t Trigram : Item.Trigrams) {
+            const auto Posting = mPostings.find(Trigram);
+            if (Posting == mPostings.end()) {
+                continue;
+            }
+
+            // Order does not matter, the last slot moves into the hole
+            auto& Slots = Posting->second;
+            if (const auto Entry = std::find(Slots.begin(), Slots.end(), Slot); Entry != Slots.end()) {
+                *Entry = Slots.back();
+                Slots.pop_back();
+            }
+            if (Slots.empty()) {
+                mPostings.erase(Posting);
+            }
+        }
+
+        Item.Used = false;
+        Item.Trigrams.clear();
+        for (auto& Text : Item.Fields) {
+            Text.clear();
+        }
+        mFreeSlots.push_back(Slot);
+
+        return true;
+    }
+
+    void TrigramIndex::Clear()
+    {
+        mDocuments.clear();
+        mFreeSlots.clear();
+        mSlots.clear();
+        mPostings.clear();
+    }
+
+    float TrigramIndex::RankDocument(_In_ const Document& Item, _In_ float TrigramShare) const
+    {
+        const std::wstring& Title = Item.Fields[FIELD_TITLE];
+
+        float Score = TrigramShare;
+        if (const auto Position = Title.find(mQuery); Position != std::wstring::npos) {
+            Score += 1.0f;
+            Score += Position == 0 ? 0.25f : 0.0f;
+        }
+        else if (Item.Fields[FIELD_CLASS_NAME].find(mQuery)   != std::wstring::npos
+              || Item.Fields[FIELD_PROCESS_NAME].find(mQuery) != std::wstring::npos) {
+            Score += 0.5f;
+        }
+
+        return Score;
+    }
+
+    void TrigramIndex::Search(_In_ std::wstring_view Query, _In_ size_t MaxResults, _Inout_ std::vector<TrigramMatch>& Matches)
+    {
+        Matches.clear();
+
+        ToLower(Query.substr(0, MAXIMUM_QUERY_LENGTH), mQuery);
+        if (mQuery.empty() || MaxResults == 0) {
+            return;
+        }
+
+        mCandidates.clear();
+
+        mQueryTrigrams.clear();
+        AppendTrigrams(mQuery, mQueryTrigrams);
+        SortUnique(mQueryTrigrams);
+
+        if (mQueryTrigrams.empty()) {
+            // One or two characters as the user starts to type, the documents with a word that starts with them
+            const uint64_t WordStart = mQuery.size() == 1
+                ? PackTrigram(0, 0, mQuery[0])
+                : PackTrigram(0, mQuery[0], mQuery[1]);
+
+            if (const auto Posting = mPostings.find(WordStart); Posting != mPostings.end()) {
+                for (const uint32_t Slot : Posting->second) {
+                    mCandidates.push_back({ Slot, RankDocument(mDocuments[Slot], 0.0f) });
+                }
+            }
+        }
+        else {
+            mCounts.resize(mDocuments.size());
+            mTouched.clear();
+
+            for (const uint64_t Trigram : mQueryTrigrams) {
+                const auto Posting = mPostings.find(Trigram);
+                if (Posting == mPostings.end()) {
+                    continue;
+                }
+
+                for (const uint32_t Slot : Posting->second) {
+                    if (mCounts[Slot]++ == 0) {
+                        mTouched.push_back(Slot);
+                    }
+                }
+            }
+
+            // Half the trigrams of the query, so a typo in a short word still finds it
+            const size_t Total   = mQueryTrigrams.size();
+            const size_t Minimum = std::max<size_t>(Total / 2, 1);
+
+            for (const uint32_t Slot : mTouched) {
+                const size_t Count = mCounts[Slot];
+                mCounts[Slot] = 0;
+
+                if (Count >= Minimum) {
+                    const float Share = static_cast<float>(Count) / static_cast<float>(Total);
+                    mCandidates.push_back({ Slot, RankDocument(mDocuments[Slot], Share) });
+                }
+            }
+        }
+
+        // Equal scores go to the shorter title, the closer match
+        const auto Better = [this](const Candidate& Left, const Candidate& Right)
+        {
+            if (Left.Score != Right.Score) {
+                return Left.Score > Right.Score;
+            }
+
+            const size_t LeftLength  = mDocuments[Left.Slot].Fields[FIELD_TITLE].size();
+            const size_t RightLength = mDocuments[Right.Slot].Fields[FIELD_TITLE].size();
+            if (LeftLength != RightLength) {
+                return LeftLength < RightLength;
+            }
+
+            return mDocuments[Left.Slot].Id < mDocuments[Right.Slot].Id;
+        };
+
+        const size_t Count = std::min(MaxResults, mCandidates.size());
+        std::partial_sort(mCandidates.begin(), mCandidates.begin() + static_cast<ptrdiff_t>(Count), mCandidates.end(), Better);
+
+        Matches.reserve(Count);
+        for (size_t Index = 0; Index < Count; ++Index) {
+            Matches.push_back({ mDocuments[mCandidates[Index].Slot].Id, mCandidates[Index].Score });
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <array>
+#include <string>
+#include <unordered_map>
+
+
+namespace Mi::Core
+{
+    struct TrigramMatch
+    {
+        uint64_t Id    = 0;
+        float    Score = 0.0f;      // higher is better, above 1 for a match of the whole query
+    };
+
+    // Fuzzy search over the title, class name and process name of a set of documents, case-insensitive.
+    //
+    // Every field is cut into the trigrams, three character runs, it contains, and each trigram has the list of
+    // documents that carry it. A query counts the trigrams it shares with each document, so a typo only costs
+    // the trigrams around it. Documents come and go one at a time, nothing is rebuilt.
+    //
+    // Ranking: the share of query trigrams found, then the query as a whole in the title, then in the class or
+    // process name, then the title starting with it. Queries shorter than a trigram match the start of a word,
+    // the first one and two characters of every word are indexed too.
+    class TrigramIndex
+    {
+    public:
+        // Document fields
+        static constexpr size_t FIELD_TITLE        = 0;
+        static constexpr size_t FIELD_CLASS_NAME   = 1;
+        static constexpr size_t FIELD_PROCESS_NAME = 2;
+        static constexpr size_t FIELD_COUNT        = 3;
+
+        // Longer queries are cut, the counters are 16 bits.
+        static constexpr size_t MAXIMUM_QUERY_LENGTH = 256;
+
+    private:
+        struct Document
+        {
+            uint64_t                              Id   = 0;
+            bool                                  Used = false;
+            std::array<std::wstring, FIELD_COUNT> Fields;       // lower case
+            std::vector<uint64_t>                 Trigrams;     // unique, to take the document out of the postings
+        };
+
+        struct Candidate
+        {
+            uint32_t Slot  = 0;
+            float    Score = 0.0f;
+        };
+
+        std::vector<Document>                                  mDocuments;     // slots, freed ones are reused
+        std::vector<uint32_t>                                  mFreeSlots;
+        std::unordered_map<uint64_t, uint32_t>                 mSlots;         // from Id
+        std::unordered_map<uint64_t, std::vector<uint32_t>>    mPostings;      // from trigram to slots
+
+        // Reused by Search
+        std::wstring           mQuery;
+        std::vector<uint64_t>  mQueryTrigrams;
+        std::vector<uint16_t>  mCounts;        // per slot
+        std::vector<uint32_t>  mTouched;
+        std::vector<Candidate> mCandidates;
+
+    public:
+        TrigramIndex() = default;
+
+        TrigramIndex(      TrigramIndex&&) = default;
+        TrigramIndex(const TrigramIndex& ) = delete;
+        TrigramIndex& operator=(      TrigramIndex&&) = default;
+        TrigramIndex& operator=(const TrigramIndex& ) = delete;
+
+        // Adds a document, or replaces the fields of the one with the same Id.
+        void Insert(_In_ uint64_t Id, _In_ std::wstring_view Title, _In_ std::wstring_view ClassName,
+            _In_ std::wstring_view ProcessName);
+
+        // Returns false if there is no such document.
+        bool Erase(_In_ uint64_t Id);
+
+        void Clear();
+
+        [[nodiscard]] size_t GetSize() const noexcept { return mSlots.size(); }
+
+        // The best MaxResults documents for Query, best first. An empty query matches nothing.
+        void Search(_In_ std::wstring_view Query, _In_ size_t MaxResults, _Inout_ std::vector<TrigramMatch>& Matches);
+
+    private:
+        [[nodiscard]] float RankDocument(_In_ const Document& Item, _In_ float TrigramShare) const;
+    };
+}
@@ -0,0 +1,121 @@
+#include "Core.UploadSurfaces.h"
+
+
+namespace Mi::Core
+{
+    UploadSurfaces::UploadSurfaces(_In_ const winrt::com_ptr<ID3D11Device>& Device)
+        : mDevice(Device)
+    {
+    }
+
+    bool UploadSurfaces::IsFormatSupported(_In_ DXGI_FORMAT Format) noexcept
+    {
+        switch (Format) {
+            case DXGI_FORMAT_B8G8R8A8_UNORM:
+            case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            case DXGI_FORMAT_R8G8B8A8_UNORM:
+            case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    winrt::hresult UploadSurfaces::Resize(_In_ uint32_t Width, _In_ uint32_t Height, _In_ DXGI_FORMAT Format)
+    {
+        if (mMapped || !IsFormatSupported(Format)) {
+            return E_INVALIDARG;
+        }
+
+        if (mSurfaces[0]) {
+            D3D11_TEXTURE2D_DESC CurrentDesc{};
+            mSurfaces[0]->GetDesc(&CurrentDesc);
+
+            if (CurrentDesc.Width == Width && CurrentDesc.Height == Height && CurrentDesc.Format == Format) {
+                return S_OK;
+            }
+        }
+
+        D3D11_TEXTURE2D_DESC TextureDesc{};
+        TextureDesc.Width            = Width;
+        TextureDesc.Height           = Height;
+        TextureDesc.MipLevels        = 1;
+        TextureDesc.ArraySize        = 1;
+        TextureDesc.Format           = Format;
+        TextureDesc.SampleDesc.Count = 1;
+        TextureDesc.Usage            = D3D11_USAGE_DYNAMIC;
+        TextureDesc.BindFlags        = D3D11_BIND_SHADER_RESOURCE;
+        TextureDesc.CPUAccessFlags   = D3D11_CPU_ACCESS_WRITE;
+
+        // The lease of the current frame keeps its old surface alive
+        std::array<winrt::com_ptr<ID3D11Texture2D>, 2> Surfaces{};
+        for (auto& Surface : Surfaces) {
+            const winrt::hresult Result = mDevice->CreateTexture2D(&TextureDesc, nullptr, Surface.put());
+            if (FAILED(Result)) {
+                LOG(ERROR, "UploadSurfaces::Resize(%ux%u, %d), ID3D11Device::CreateTexture2D failed, Result=0x%0*X",
+                    Width, Height, Format, 8, Result.value);
+                return Result;
+            }
+        }
+
+        mSurfaces = std::move(Surfaces);
+        return S_OK;
+    }
+
+    winrt::hresult UploadSurfaces::Map(_Out_ D3D11_MAPPED_SUBRESOURCE& Mapped)
+    {
+        Mapped = {};
+        if (mMapped || mSurfaces[0] == nullptr) {
+            return E_NOT_VALID_STATE;
+        }
+
+        if (mContext == nullptr) {
+            mDevice->GetImmediateContext(mContext.put());
+        }
+
+        const uint32_t Next = mShown ? (mCurrent ^ 1) : mCurrent;
+
+        const winrt::hresult Result = mContext->Map(mSurfaces[Next].get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &Mapped);
+        if (FAILED(Result)) {
+            LOG(ERROR, "UploadSurfaces::Map(), ID3D11DeviceContext::Map failed, Result=0x%0*X", 8, Result.value);
+            return Result;
+        }
+
+        mMapped = true;
+        return S_OK;
+    }
+
+    winrt::com_ptr<ID3D11Texture2D> UploadSurfaces::Unmap(_In_ bool Publish)
+    {
+        if (!mMapped) {
+            return nullptr;
+        }
+
+        const uint32_t Next = mShown ? (mCurrent ^ 1) : mCurrent;
+        mContext->Unmap(mSurfaces[Next].get(), 0);
+        mMapped = false;
+
+        if (!Publish) {
+            return nullptr;
+        }
+
+        mCurrent = Next;
+        mShown   = true;
+        return mSurfaces[Next];
+    }
+
+    bool UploadSurfaces::Owns(_In_ const ID3D11Texture2D* Surface) const noexcept
+    {
+        return Surface && (Surface == mSurfaces[0].get() || Surface == mSurfaces[1].get());
+    }
+
+    void UploadSurfaces::Reset()
+    {
+        (void)Unmap(false);
+
+        mSurfaces = {};
+        mContext  = nullptr;
+        mCurrent  = 0;
+        mShown    = false;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <array>
+
+
+namespace Mi::Core
+{
+    // Two dynamic surfaces the CPU writes frames into, for capture sources that produce the pixels themselves.
+    //
+    // A frame is written into the surface that is not shown, so the one the renderer draws is never mapped while
+    // in use and a frame that fails half way is never drawn. The surfaces are only recreated when the size or the
+    // format changes, the lease of the shown frame keeps its old surface alive. Render thread only.
+    class UploadSurfaces
+    {
+        winrt::com_ptr<ID3D11Device>        mDevice { nullptr };
+        winrt::com_ptr<ID3D11DeviceContext> mContext{ nullptr };
+
+        std::array<winrt::com_ptr<ID3D11Texture2D>, 2> mSurfaces{};
+        uint32_t mCurrent = 0;      // the shown surface
+        bool     mShown   = false;  // mCurrent was published since the last Reset()
+        bool     mMapped  = false;
+
+    public:
+        explicit UploadSurfaces(_In_ const winrt::com_ptr<ID3D11Device>& Device);
+
+        UploadSurfaces(      UploadSurfaces&&) = delete;
+        UploadSurfaces(const UploadSurfaces& ) = delete;
+        UploadSurfaces& operator=(      UploadSurfaces&&) = delete;
+        UploadSurfaces& operator=(const UploadSurfaces& ) = delete;
+
+        // 8 bit BGRA and RGBA, the formats the renderer samples.
+        [[nodiscard]] static bool IsFormatSupported(_In_ DXGI_FORMAT Format) noexcept;
+
+        // Creates the surfaces, unless they already have this size and format.
+        winrt::hresult Resize(_In_ uint32_t Width, _In_ uint32_t Height, _In_ DXGI_FORMAT Format);
+
+        // Maps the surface that is not shown for writing, its previous content is discarded.
+        winrt::hresult Map(_Out_ D3D11_MAPPED_SUBRESOURCE& Mapped);
+
+        // Unmaps the surface. With Publish it becomes the shown surface and is returned, otherwise nullptr.
+        winrt::com_ptr<ID3D11Texture2D> Unmap(_In_ bool Publish);
+
+        // Whether Surface is one of the current surfaces, frames on any other one are from before a resize.
+        [[nodiscard]] bool Owns(_In_ const ID3D11Texture2D* Surface) const noexcept;
+
+        void Reset();
+    };
+}
@@ -1,4 +1,5 @@
 #include "Core.WindowList.h"
+#include "Core.Trace.h"
 
 
 
@@ -6,16 +7,64 @@ namespace Mi::Core
 {
     std::wstring Window::GetTitleName() const
     {
-        std::array<WCHAR, 1024> WindowText;
-        ::GetWindowText(mWindow, WindowText.data(), (int)WindowText.size());
-        return WindowText.data();
+        std::wstring WindowText(static_cast<size_t>(std::max(::GetWindowTextLengthW(mWindow), 0)) + 1, L'\0');
+        WindowText.resize(static_cast<size_t>(::GetWindowTextW(mWindow, WindowText.data(), static_cast<int>(WindowText.size()))));
+        return WindowText;
+    }
+
+    bool Window::TryGetTitleName(_In_ UINT Timeout, _Out_ std::wstring& Title) const
+    {
+        static constexpr UINT FLAGS = SMTO_ABORTIFHUNG | SMTO_ERRORONEXIT;
+
+        Title.clear();
+
+        DWORD_PTR Length = 0;
+        if (!SendMessageTimeoutW(mWindow, WM_GETTEXTLENGTH, 0, 0, FLAGS, Timeout, &Length)) {
+            return false;
+        }
+
+        Title.resize(static_cast<size_t>(Length) + 1);
+
+        DWORD_PTR Copied = 0;
+        if (!SendMessageTimeoutW(mWindow, WM_GETTEXT, static_cast<WPARAM>(Title.size()),
+            reinterpret_cast<LPARAM>(Title.data()), FLAGS, Timeout, &Copied)) {
+            Title.clear();
+            return false;
+        }
+
+        Title.resize(std::min(static_cast<size_t>(Copied), static_cast<size_t>(Length)));
+        return true;
     }
 
     std::wstring Window::GetClassName() const
     {
-        std::array<WCHAR, 1024> ClassName;
-        ::GetClassName(mWindow, ClassName.data(), (int)ClassName.size());
-        return ClassName.data();
+        // Class names are at most 256 characters
+        std::array<WCHAR, 257> ClassName;
+        const int Length = ::GetClassNameW(mWindow, ClassName.data(), static_cast<int>(ClassName.size()));
+        return std::wstring(ClassName.data(), static_cast<size_t>(std::max(Length, 0)));
+    }
+
+    std::wstring Window::GetProcessName() const
+    {
+        DWORD ProcessId = 0;
+        if (!GetWindowThreadProcessId(mWindow, &ProcessId) || ProcessId == 0) {
+            return {};
+        }
+
+        // Enough for processes of other users and elevated ones, the window can be listed either way
+        const auto Process = std::unique_ptr<std::remove_pointer_t<HANDLE>, decltype(::CloseHandle)*>(
+            OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, ProcessId), ::CloseHandle);
+        if (!Process) {
+            return {};
+        }
+
+        std::array<WCHAR, MAX_PATH> Path;
+        DWORD Length = static_cast<DWORD>(Path.size());
+        if (!QueryFullProcessImageNameW(Process.get(), 0, Path.data(), &Length)) {
+            return {};
+        }
+
+        return std::filesystem::path(std::wstring_view(Path.data(), Length)).filename().wstring();
     }
 
     bool Window::IsShellWindow() const
@@ -50,11 +99,12 @@ namespace Mi::Core
         return false;
     }
 
-    static bool IsAltTabWindow(Window Window)
+    constexpr UINT WM_WINDOWLIST_UPDATE = WM_APP + 1;
+
+    // The cheap checks come first, the title is only fetched for windows that pass them
+    static bool IsAltTabWindow(_In_ Window Window, _Out_ std::wstring& Title)
     {
-        if (Window.GetTitleName().empty()) {
-            return false;
-        }
+        Title.clear();
 
         if (!Window.IsVisible()) {
             return false;
@@ -72,52 +122,98 @@ namespace Mi::Core
             return false;
         }
 
-        return true;
+        // A hung window keeps its caption, Windows reads it without sending it a message
+        if (!Window.TryGetTitleName(WindowList::TITLE_TIMEOUT_MILLISECONDS, Title)) {
+            std::array<WCHAR, 512> Caption;
+            const int Length = InternalGetWindowText(static_cast<HWND>(Window), Caption.data(), static_cast<int>(Caption.size()));
+            Title.assign(Caption.data(), static_cast<size_t>(std::max(Length, 0)));
+        }
+
+        return !Title.empty();
+    }
+
+    class DesktopWindowProvider final : public IWindowProvider
+    {
+        const std::atomic_bool& mStopping;
+
+    public:
+        explicit DesktopWindowProvider(_In_ const std::atomic_bool& Stopping)
+            : mStopping(Stopping) { }
+
+        void EnumerateWindows(_Inout_ std::vector<WindowId>& Windows) override
+        {
+            EnumWindows([](HWND Window, LPARAM LParam)
+            {
+                reinterpret_cast<std::vector<WindowId>*>(LParam)->push_back(reinterpret_cast<uintptr_t>(Window));
+                return TRUE;
+            }, reinterpret_cast<LPARAM>(&Windows));
+        }
+
+        bool DescribeWindow(_In_ WindowId Window, _Out_ std::wstring& Title, _Out_ std::wstring& ClassName,
+            _Out_ std::wstring& ProcessName) override
+        {
+            const Core::Window Item{ reinterpret_cast<HWND>(static_cast<uintptr_t>(Window)) };
+
+            Title.clear();
+            ClassName.clear();
+            ProcessName.clear();
+
+            // Nothing is shown any more, the shutdown does not wait on the remaining windows
+            if (mStopping.load(std::memory_order_relaxed)) {
+                return false;
+            }
+
+            if (!IsAltTabWindow(Item, Title)) {
+                return false;
+            }
+
+            ClassName   = Item.GetClassName();
+            ProcessName = Item.GetProcessName();
+            return true;
+        }
+    };
+
+    static HWND ToWindowHandle(_In_ WindowId Window)
+    {
+        return reinterpret_cast<HWND>(static_cast<uintptr_t>(Window));
     }
 
     static thread_local WindowList* WindowListForThread;
 
     WindowList::~WindowList()
     {
-        if (mWinEventHook) {
-            UnhookWinEvent(mWinEventHook);
-            mWinEventHook = nullptr;
+        mStopping = true;
+        if (mThreadId) {
+            (void)PostThreadMessageW(mThreadId, WM_QUIT, 0, 0);
+        }
+
+        if (mThread.joinable()) {
+            mThread.join();
         }
     }
 
-    WindowList::WindowList()
+    WindowList::WindowList(_In_ const winrt::Windows::System::DispatcherQueue& Queue)
+        : mQueue(Queue)
     {
-        WINRT_ASSERT(WindowListForThread == nullptr);
-        WindowListForThread = this;
+        std::promise<void> Ready;
+        auto ReadyFuture = Ready.get_future();
 
-        Update();
+        mThread   = std::thread([this, &Ready] { Run(Ready); });
+        mThreadId = GetThreadId(mThread.native_handle());
 
-        static const auto WinEventHandler = [](HWINEVENTHOOK /*WinEventHook*/, DWORD Event, HWND Window,
-            LONG /*IdObject*/, LONG IdChild, DWORD /*IdEventThread*/, DWORD /*EventTime*/)
-        {
-            if (Event == EVENT_OBJECT_DESTROY) {
-                if (IdChild == CHILDID_SELF) {
-                    WindowListForThread->RemoveWindow(Window);
-                    return;
-                }
-            }
-        };
-
-        mWinEventHook = winrt::check_pointer(SetWinEventHook(EVENT_OBJECT_DESTROY, EVENT_OBJECT_DESTROY,
-            nullptr, WinEventHandler, 0, 0, WINEVENT_OUTOFCONTEXT));
+        // Only until the worker has a message queue, the enumeration itself runs after this returns
+        ReadyFuture.get();
+        Update();
     }
 
     void WindowList::Update()
     {
-        EnumWindows([](HWND Window, LPARAM LParam)
-        {
-            if (IsAltTabWindow(Core::Window{ Window })) {
-                const auto That = reinterpret_cast<WindowList*>(LParam);
-                That->AddWindow(Window);
+        // Drop-downs opened while an enumeration is pending share it
+        if (!mUpdateRequested.exchange(true)) {
+            if (!PostThreadMessageW(mThreadId, WM_WINDOWLIST_UPDATE, 0, 0)) {
+                mUpdateRequested = false;
             }
-
-            return TRUE;
-        }, reinterpret_cast<LPARAM>(this));
+        }
     }
 
     void WindowList::RegisterComboBoxForUpdates(_In_ HWND ComboBox)
@@ -131,59 +227,259 @@ namespace Mi::Core
         mComboBoxes.erase(ComboBox);
     }
 
-    void WindowList::AddWindow(_In_ HWND Window)
+    std::vector<WindowSearchResult> WindowList::Search(_In_ std::wstring_view Query, _In_ size_t MaxResults)
     {
-        auto Guard = std::unique_lock(mMutex);
+        const TraceSpan Span("WindowList::Search");
 
-        if (!mWindows.contains(Window)) {
-            mWindows.emplace(Window);
+        mSearchIndex.Search(Query, MaxResults, mMatches);
 
-            for (auto& ComboBox : mComboBoxes) {
-                const auto Index = ComboBox_AddString(ComboBox, Core::Window(Window).GetTitleName().c_str());
+        std::vector<WindowSearchResult> Results;
+        Results.reserve(mMatches.size());
+        for (const auto& Match : mMatches) {
+            const auto Window = ToWindowHandle(Match.Id);
+            if (const auto Item = mItemIndex.find(Window); Item != mItemIndex.end()) {
+                Results.push_back({ Window, mItems[Item->second].Title, Item->second, Match.Score });
+            }
+        }
 
-                if (Index != CB_ERR && Index != CB_ERRSPACE) {
-                    ComboBox_SetItemData(ComboBox, Index, Window);
-                }
+        return Results;
+    }
+
+    void WindowList::Run(_Inout_ std::promise<void>& Ready)
+    {
+        WindowListForThread = this;
+        Trace::SetThreadName("WindowList::Worker");
+
+        // Creates the message queue, thread messages posted before that would be lost
+        MSG Message{};
+        (void)PeekMessageW(&Message, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+
+        mProvider = std::make_unique<DesktopWindowProvider>(mStopping);
+        mRegistry = std::make_unique<WindowRegistry>(*mProvider);
+        mRegistry->SetObserver([this](WindowRegistryAction Action, uint32_t Index)
+        {
+            OnRegistryChange(Action, Index);
+        });
+
+        static const auto WinEventHandler = [](HWINEVENTHOOK /*WinEventHook*/, DWORD Event, HWND Window,
+            LONG IdObject, LONG IdChild, DWORD /*IdEventThread*/, DWORD /*EventTime*/)
+        {
+            if (IdObject == OBJID_WINDOW && IdChild == CHILDID_SELF && WindowListForThread) {
+                WindowListForThread->OnWinEvent(Event, Window);
+            }
+        };
+
+        // Not one range, it would take in the location changes of every window on the desktop
+        static constexpr std::pair<DWORD, DWORD> EVENT_RANGES[] = {
+            { EVENT_OBJECT_CREATE,     EVENT_OBJECT_HIDE       },   // create, destroy, show, hide
+            { EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE },
+            { EVENT_OBJECT_CLOAKED,    EVENT_OBJECT_UNCLOAKED  },
+        };
+
+        // Out-of-context hooks call back on the thread that installed them, here
+        for (const auto& [First, Last] : EVENT_RANGES) {
+            if (const auto Hook = SetWinEventHook(First, Last, nullptr, WinEventHandler, 0, 0, WINEVENT_OUTOFCONTEXT)) {
+                mWinEventHooks.push_back(Hook);
+            }
+            else {
+                LOG(ERROR, "WindowList::Run(), SetWinEventHook failed, Result=0x%0*X",
+                    8, HRESULT_FROM_WIN32(GetLastError()));
+            }
+        }
+
+        Ready.set_value();
+
+        while (GetMessageW(&Message, nullptr, 0, 0) > 0) {
+            if (Message.hwnd == nullptr && Message.message == WM_WINDOWLIST_UPDATE) {
+                mUpdateRequested = false;
+                Rebuild();
+                continue;
+            }
+
+            TranslateMessage(&Message);
+            DispatchMessageW(&Message);
+        }
+
+        for (const auto Hook : mWinEventHooks) {
+            UnhookWinEvent(Hook);
+        }
+        mWinEventHooks.clear();
+
+        mRegistry = nullptr;
+        mProvider = nullptr;
+
+        WindowListForThread = nullptr;
+    }
+
+    void WindowList::Rebuild()
+    {
+        const TraceSpan Span("WindowList::Rebuild");
+        mRegistry->Rebuild();
+    }
+
+    void WindowList::OnWinEvent(_In_ DWORD Event, _In_ HWND Window)
+    {
+        WindowEvent Change;
+        switch (Event) {
+            case EVENT_OBJECT_CREATE:     Change = WindowEvent::Created;     break;
+            case EVENT_OBJECT_SHOW:
+            case EVENT_OBJECT_UNCLOAKED:  Change = WindowEvent::Shown;       break;
+            case EVENT_OBJECT_HIDE:
+            case EVENT_OBJECT_CLOAKED:    Change = WindowEvent::Hidden;      break;
+            case EVENT_OBJECT_NAMECHANGE: Change = WindowEvent::NameChanged; break;
+            case EVENT_OBJECT_DESTROY:    Change = WindowEvent::Destroyed;   break;
+            default:
+                return;
+        }
+
+        // Child windows of every process on the desktop raise the same events, only top-level ones are listed.
+        // A destroyed window can not be asked any more, the registry ignores windows it does not know.
+        if (Change != WindowEvent::Destroyed && GetAncestor(Window, GA_ROOT) != Window) {
+            return;
+        }
+
+        mRegistry->OnEvent(Change, reinterpret_cast<uintptr_t>(Window));
+    }
+
+    void WindowList::OnRegistryChange(_In_ WindowRegistryAction Action, _In_ uint32_t Index)
+    {
+        Change Item{ Action, Index };
+
+        // A removal moves an entry the UI thread already has
+        if (Action != WindowRegistryAction::Removed) {
+            const auto& Entry = mRegistry->GetEntries()[Index];
+            Item.Window      = ToWindowHandle(Entry.Window);
+            Item.Title       = Entry.Title;
+            Item.ClassName   = Entry.ClassName;
+            Item.ProcessName = Entry.ProcessName;
+        }
+
+        bool Queue;
+        {
+            auto Guard = std::unique_lock(mMutex);
+            mChanges.push_back(std::move(Item));
+            Queue = !std::exchange(mApplyQueued, true);
+        }
+
+        // One callback for a whole burst, like the first enumeration
+        if (Queue) {
+            QueueApplyChanges();
+        }
+    }
+
+    void WindowList::QueueApplyChanges()
+    {
+        (void)mQueue.TryEnqueue([this, Alive = std::weak_ptr<bool>(mAlive)]
+        {
+            if (!Alive.expired()) {
+                ApplyChanges();
+            }
+        });
+    }
+
+    void WindowList::ApplyChanges()
+    {
+        std::vector<Change> Batch;
+        bool More;
+        {
+            auto Guard = std::unique_lock(mMutex);
+
+            const auto Count = std::min(mChanges.size(), CHANGE_BATCH_SIZE);
+            Batch.assign(std::make_move_iterator(mChanges.begin()), std::make_move_iterator(mChanges.begin() + Count));
+            mChanges.erase(mChanges.begin(), mChanges.begin() + Count);
+
+            More = !mChanges.empty();
+            mApplyQueued = More;
+        }
+
+        // The rest goes after the input that is already queued
+        if (More) {
+            QueueApplyChanges();
+        }
+
+        // Removals and renames delete items, the selection follows its window
+        std::vector<std::pair<HWND, HWND>> Selections;
+        for (const auto ComboBox : mComboBoxes) {
+            if (const auto Selected = ComboBox_GetCurSel(ComboBox); Selected != CB_ERR) {
+                Selections.emplace_back(ComboBox, reinterpret_cast<HWND>(ComboBox_GetItemData(ComboBox, Selected)));
+            }
+        }
+
+        for (auto& Item : Batch) {
+            ApplyChange(Item);
+        }
+
+        for (const auto& [ComboBox, Window] : Selections) {
+            const auto Item     = mItemIndex.find(Window);
+            const int  Selected = Item != mItemIndex.end() ? static_cast<int>(Item->second) : -1;
+            if (ComboBox_GetCurSel(ComboBox) != Selected) {
+                (void)ComboBox_SetCurSel(ComboBox, Selected);
             }
         }
     }
 
-    bool WindowList::RemoveWindow(_In_ HWND Window)
+    void WindowList::ApplyChange(_In_ Change& Item)
     {
-        auto Guard = std::unique_lock(mMutex);
+        const auto Index = static_cast<int>(Item.Index);
+
+        switch (Item.Action) {
+            case WindowRegistryAction::Added:
+                mSearchIndex.Insert(reinterpret_cast<uintptr_t>(Item.Window), Item.Title, Item.ClassName, Item.ProcessName);
+                mItemIndex[Item.Window] = static_cast<uint32_t>(mItems.size());
+                mItems.push_back({ Item.Window, std::move(Item.Title) });
+                for (const auto ComboBox : mComboBoxes) {
+                    InsertComboBoxItem(ComboBox, -1, mItems.back());
+                }
+                break;
 
-        if (mWindows.contains(Window)) {
-            mWindows.erase(Window);
+            case WindowRegistryAction::Removed: {
+                const auto Last = static_cast<int>(mItems.size()) - 1;
 
-            for (auto& ComboBox : mComboBoxes) {
+                (void)mSearchIndex.Erase(reinterpret_cast<uintptr_t>(mItems[Index].Window));
+                mItemIndex.erase(mItems[Index].Window);
+                if (Index != Last) {
+                    mItems[Index] = std::move(mItems[Last]);
+                    mItemIndex[mItems[Index].Window] = Item.Index;
+                }
+                mItems.pop_back();
 
-                const auto ItemCount = static_cast<uint32_t>(ComboBox_GetCount(ComboBox));
-                for (uint32_t Idx = 0ul; Idx < ItemCount; ++Idx) {
+                for (const auto ComboBox : mComboBoxes) {
+                    (void)ComboBox_DeleteString(ComboBox, Index);
 
-                    const auto TargetWindow = reinterpret_cast<HWND>(ComboBox_GetItemData(ComboBox, Idx));
-                    if (TargetWindow == Window) {
-                        ComboBox_DeleteString(ComboBox, Idx);
-                        break;
+                    // The last item follows the last entry into the hole
+                    if (Index != Last) {
+                        (void)ComboBox_DeleteString(ComboBox, Last - 1);
+                        InsertComboBoxItem(ComboBox, Index, mItems[Index]);
                     }
                 }
+                break;
             }
+
+            case WindowRegistryAction::Renamed:
+                mSearchIndex.Insert(reinterpret_cast<uintptr_t>(Item.Window), Item.Title, Item.ClassName, Item.ProcessName);
+                mItems[Index].Title = std::move(Item.Title);
+                for (const auto ComboBox : mComboBoxes) {
+                    (void)ComboBox_DeleteString(ComboBox, Index);
+                    InsertComboBoxItem(ComboBox, Index, mItems[Index]);
+                }
+                break;
         }
+    }
 
-        return false;
+    void WindowList::InsertComboBoxItem(_In_ HWND ComboBox, _In_ int Position, _In_ const Item& Entry) const
+    {
+        const auto Index = ComboBox_InsertString(ComboBox, Position, Entry.Title.c_str());
+        if (Index != CB_ERR && Index != CB_ERRSPACE) {
+            ComboBox_SetItemData(ComboBox, Index, Entry.Window);
+        }
     }
 
     void WindowList::ForceUpdateComboBox(_In_ HWND ComboBox)
     {
-        auto Guard = std::unique_lock(mMutex);
-
         ComboBox_ResetContent(ComboBox);
 
-        for (auto& Window : mWindows) {
-            const auto Index = ComboBox_AddString(ComboBox, Core::Window(Window).GetTitleName().c_str());
-
-            if (Index != CB_ERR && Index != CB_ERRSPACE) {
-                ComboBox_SetItemData(ComboBox, Index, Window);
-            }
+        for (const auto& Entry : mItems) {
+            InsertComboBoxItem(ComboBox, -1, Entry);
         }
     }
 }
@@ -1,5 +1,10 @@
 #pragma once
+#include "Core.TrigramIndex.h"
+#include "Core.WindowRegistry.h"
+
+#include <deque>
 #include <mutex>
+#include <thread>
 
 
 namespace Mi::Core
@@ -15,8 +20,14 @@ namespace Mi::Core
         explicit operator HWND() const noexcept { return mWindow; }
 
         std::wstring GetTitleName() const;
+
+        // Asks the window for its title through WM_GETTEXT, false if it does not answer within Timeout.
+        bool TryGetTitleName(_In_ UINT Timeout, _Out_ std::wstring& Title) const;
         std::wstring GetClassName() const;
 
+        // The file name of the executable that owns the window, empty if the process can not be opened.
+        std::wstring GetProcessName() const;
+
         [[nodiscard]] bool IsShellWindow  () const;
         [[nodiscard]] bool IsToolWindow   () const;
         [[nodiscard]] bool IsVisible      () const;
@@ -24,31 +35,101 @@ namespace Mi::Core
         [[nodiscard]] bool IsCloaked      () const;
     };
 
+    struct WindowSearchResult
+    {
+        HWND         Window = nullptr;
+        std::wstring Title;
+        uint32_t     Index  = 0;        // of the item in every registered combo box
+        float        Score  = 0.0f;
+    };
+
+    // Keeps combo boxes filled with the windows that can be captured, like the Alt+Tab list.
+    //
+    // A worker thread owns a WindowRegistry and the WinEvent hooks that keep it up to date, so titles are
+    // fetched, with a timeout, off the UI thread. Changes reach the UI thread in batches through the
+    // DispatcherQueue, where every combo box mirrors the entries of the registry slot for slot and a TrigramIndex
+    // keeps them searchable. Nothing on the UI thread waits on another process.
     class WindowList
     {
-        std::mutex mMutex;
-        std::unordered_set<HWND> mWindows;
-        std::unordered_set<HWND> mComboBoxes;
+    public:
+        // A title fetch waits this long for a window that does not answer, then takes the caption Windows keeps.
+        static constexpr UINT   TITLE_TIMEOUT_MILLISECONDS = 50;
+
+        // Changes applied to the combo boxes per DispatcherQueue callback.
+        static constexpr size_t CHANGE_BATCH_SIZE = 64;
+
+    private:
+        struct Change
+        {
+            WindowRegistryAction Action = WindowRegistryAction::Added;
+            uint32_t             Index  = 0;
+            HWND                 Window = nullptr;     // of the entry at Index, Added and Renamed only
+            std::wstring         Title;
+            std::wstring         ClassName;
+            std::wstring         ProcessName;
+        };
+
+        struct Item
+        {
+            HWND         Window = nullptr;
+            std::wstring Title;
+        };
+
+        winrt::Windows::System::DispatcherQueue mQueue{ nullptr };
+
+        // Worker thread
+        std::thread                      mThread;
+        DWORD                            mThreadId = 0;
+        std::atomic_bool                 mStopping = false;
+        std::atomic_bool                 mUpdateRequested = false;
+        std::unique_ptr<IWindowProvider> mProvider;
+        std::unique_ptr<WindowRegistry>  mRegistry;
+        std::vector<HWINEVENTHOOK>       mWinEventHooks;
+
+        // From the worker to the UI thread
+        std::mutex                       mMutex;
+        std::deque<Change>               mChanges;
+        bool                             mApplyQueued = false;
 
-        HWINEVENTHOOK mWinEventHook = nullptr;
+        // UI thread
+        std::vector<Item>                  mItems;
+        std::unordered_map<HWND, uint32_t> mItemIndex;      // from window to its slot in mItems
+        TrigramIndex                       mSearchIndex;
+        std::vector<TrigramMatch>          mMatches;        // reused by Search
+        std::unordered_set<HWND>           mComboBoxes;
+        std::shared_ptr<bool>              mAlive = std::make_shared<bool>(true);
 
     public:
         ~WindowList();
 
-        WindowList();
+        // Queue is the one of the UI thread, where the combo boxes live.
+        explicit WindowList(_In_ const winrt::Windows::System::DispatcherQueue& Queue);
         WindowList(      WindowList&&) = delete;
         WindowList(const WindowList& ) = delete;
         WindowList& operator=(      WindowList&&) = delete;
         WindowList& operator=(const WindowList& ) = delete;
 
+        // Asks the worker for a full enumeration and returns right away, the changes follow in batches.
         void Update();
 
         void RegisterComboBoxForUpdates(_In_ HWND ComboBox);
         void UnRegisterComboBox(_In_ HWND ComboBox);
 
+        // The best MaxResults windows for Query over title, class and process name, best first. UI thread only.
+        [[nodiscard]] std::vector<WindowSearchResult> Search(_In_ std::wstring_view Query, _In_ size_t MaxResults);
+
     private:
-        void AddWindow   (_In_ HWND Window);
-        bool RemoveWindow(_In_ HWND Window);
+        void Run(_Inout_ std::promise<void>& Ready);
+        void Rebuild();
+
+        void OnWinEvent(_In_ DWORD Event, _In_ HWND Window);
+        void OnRegistryChange(_In_ WindowRegistryAction Action, _In_ uint32_t Index);
+
+        void QueueApplyChanges();
+        void ApplyChanges();
+        void ApplyChange(_In_ Change& Item);
+
+        void InsertComboBoxItem(_In_ HWND ComboBox, _In_ int Position, _In_ const Item& Entry) const;
         void ForceUpdateComboBox(_In_ HWND ComboBox);
     };
 }
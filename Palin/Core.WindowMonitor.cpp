@@ -0,0 +1,262 @@
+#include "Core.WindowMonitor.h"
+
+
+namespace Mi::Core
+{
+    constexpr UINT WM_MONITOR_REGISTER   = WM_APP + 1;
+    constexpr UINT WM_MONITOR_UNREGISTER = WM_APP + 2;
+
+    struct RegisterRequest
+    {
+        HWND                            Window = nullptr;
+        const WindowMonitor::Handler*   Handler = nullptr;
+        WindowMonitor::Cookie           Cookie = 0;
+    };
+
+    static thread_local WindowMonitor* WindowMonitorForThread;
+
+    static SIZE GetClientSize(_In_ HWND Window)
+    {
+        RECT ClientArea{};
+        if (!GetClientRect(Window, &ClientArea)) {
+            return {};
+        }
+
+        return { ClientArea.right - ClientArea.left, ClientArea.bottom - ClientArea.top };
+    }
+
+    WindowMonitor& WindowMonitor::GetInstance()
+    {
+        static WindowMonitor Instance;
+        return Instance;
+    }
+
+    WindowMonitor::WindowMonitor()
+    {
+        std::promise<HWND> Ready;
+        auto ReadyFuture = Ready.get_future();
+
+        mThread = std::thread([this, &Ready] { Run(Ready); });
+        mMessageWindow = ReadyFuture.get();
+    }
+
+    WindowMonitor::~WindowMonitor()
+    {
+        if (mMessageWindow) {
+            PostMessageW(mMessageWindow, WM_QUIT, 0, 0);
+        }
+
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+    }
+
+    winrt::hresult WindowMonitor::Register(_In_ HWND Window, _In_ const Handler& Handler, _Out_ Cookie& Cookie)
+    {
+        Cookie = 0;
+
+        if (mMessageWindow == nullptr) {
+            return E_UNEXPECTED;
+        }
+
+        // Hooks deliver their events to the thread that installed them, so they are installed on the monitor thread
+        RegisterRequest Request{ Window, &Handler };
+
+        const winrt::hresult Result = static_cast<HRESULT>(SendMessageW(mMessageWindow, WM_MONITOR_REGISTER,
+            0, reinterpret_cast<LPARAM>(&Request)));
+        if (SUCCEEDED(Result)) {
+            Cookie = Request.Cookie;
+        }
+
+        return Result;
+    }
+
+    void WindowMonitor::Unregister(_In_ Cookie Cookie)
+    {
+        // A cross-thread SendMessage is only processed between handlers, a call from a handler runs directly
+        if (mMessageWindow && Cookie) {
+            (void)SendMessageW(mMessageWindow, WM_MONITOR_UNREGISTER, static_cast<WPARAM>(Cookie), 0);
+        }
+    }
+
+    void WindowMonitor::Run(_In_ std::promise<HWND>& Ready)
+    {
+        WindowMonitorForThread = this;
+
+        static const auto WindowProc = [](HWND Window, UINT Message, WPARAM WParam, LPARAM LParam) -> LRESULT
+        {
+            const auto That = WindowMonitorForThread;
+
+            switch (Message) {
+                case WM_MONITOR_REGISTER:
+                {
+                    const auto Request = reinterpret_cast<RegisterRequest*>(LParam);
+                    return That->OnRegister(Request->Window, *Request->Handler, Request->Cookie);
+                }
+                case WM_MONITOR_UNREGISTER:
+                {
+                    That->OnUnregister(static_cast<Cookie>(WParam));
+                    return 0;
+                }
+                case WM_TIMER:
+                {
+                    That->OnResizeTimer(static_cast<Cookie>(WParam));
+                    return 0;
+                }
+                default:
+                {
+                    return DefWindowProcW(Window, Message, WParam, LParam);
+                }
+            }
+        };
+
+        WNDCLASSEXW WindowClass{ sizeof(WindowClass) };
+        WindowClass.lpfnWndProc   = WindowProc;
+        WindowClass.hInstance     = HINST_THISCOMPONENT;
+        WindowClass.lpszClassName = L"Mi.Palin.WindowMonitor";
+        (void)RegisterClassExW(&WindowClass);
+
+        const HWND MessageWindow = CreateWindowExW(0, WindowClass.lpszClassName, nullptr, 0, 0, 0, 0, 0,
+            HWND_MESSAGE, nullptr, HINST_THISCOMPONENT, nullptr);
+        if (MessageWindow == nullptr) {
+            LOG(ERROR, "WindowMonitor::Run(), CreateWindowExW failed, Result=0x%0*X",
+                8, HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        Ready.set_value(MessageWindow);
+        if (MessageWindow == nullptr) {
+            return;
+        }
+
+        MSG Message{};
+        while (GetMessageW(&Message, nullptr, 0, 0) > 0) {
+            TranslateMessage(&Message);
+            DispatchMessageW(&Message);
+        }
+
+        while (!mRegistrations.empty()) {
+            OnUnregister(mRegistrations.begin()->first);
+        }
+
+        DestroyWindow(MessageWindow);
+    }
+
+    winrt::hresult WindowMonitor::OnRegister(_In_ HWND Window, _In_ const Handler& Handler, _Out_ Cookie& Cookie)
+    {
+        Cookie = 0;
+
+        DWORD ProcessId = 0;
+        const DWORD ThreadId = GetWindowThreadProcessId(Window, &ProcessId);
+        if (ThreadId == 0) {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_WINDOW_HANDLE);
+        }
+
+        static const auto WinEventHandler = [](HWINEVENTHOOK /*WinEventHook*/, DWORD Event, HWND Window,
+            LONG IdObject, LONG IdChild, DWORD /*IdEventThread*/, DWORD /*EventTime*/)
+        {
+            if (IdObject == OBJID_WINDOW && IdChild == CHILDID_SELF) {
+                WindowMonitorForThread->OnWinEvent(Event, Window);
+            }
+        };
+
+        Registration Item{};
+        Item.Window     = Window;
+        Item.Callback   = Handler;
+        Item.ClientSize = GetClientSize(Window);
+
+        // Only the events of the thread that owns the window, so other windows cost nothing
+        for (const DWORD Event : { EVENT_OBJECT_DESTROY, EVENT_OBJECT_LOCATIONCHANGE, EVENT_SYSTEM_MINIMIZESTART }) {
+            const HWINEVENTHOOK Hook = SetWinEventHook(Event, Event, nullptr, WinEventHandler,
+                ProcessId, ThreadId, WINEVENT_OUTOFCONTEXT);
+            if (Hook == nullptr) {
+                const winrt::hresult Result = HRESULT_FROM_WIN32(GetLastError());
+
+                for (const auto Installed : Item.Hooks) {
+                    UnhookWinEvent(Installed);
+                }
+                return FAILED(Result) ? Result : E_FAIL;
+            }
+
+            Item.Hooks.emplace_back(Hook);
+        }
+
+        Cookie = mNextCookie++;
+        mRegistrations.emplace(Cookie, std::move(Item));
+
+        return S_OK;
+    }
+
+    void WindowMonitor::OnUnregister(_In_ Cookie Cookie)
+    {
+        const auto Item = mRegistrations.find(Cookie);
+        if (Item == mRegistrations.end()) {
+            return;
+        }
+
+        for (const auto Hook : Item->second.Hooks) {
+            UnhookWinEvent(Hook);
+        }
+        KillTimer(mMessageWindow, static_cast<UINT_PTR>(Cookie));
+
+        mRegistrations.erase(Item);
+    }
+
+    void WindowMonitor::OnWinEvent(_In_ DWORD Event, _In_ HWND Window)
+    {
+        for (auto& [Cookie, Item] : mRegistrations) {
+            if (Item.Window != Window || Item.Closed) {
+                continue;
+            }
+
+            if (Event == EVENT_OBJECT_LOCATIONCHANGE) {
+                // Restarting the timer on every event reports a drag or an animation once, after it settled
+                SetTimer(mMessageWindow, static_cast<UINT_PTR>(Cookie), RESIZE_COALESCE_MILLISECONDS, nullptr);
+                return;
+            }
+
+            Item.Closed = true;
+            KillTimer(mMessageWindow, static_cast<UINT_PTR>(Cookie));
+
+            return Dispatch(Cookie, WindowMonitorEvent::Closed);
+        }
+    }
+
+    void WindowMonitor::OnResizeTimer(_In_ Cookie Cookie)
+    {
+        KillTimer(mMessageWindow, static_cast<UINT_PTR>(Cookie));
+
+        const auto Item = mRegistrations.find(Cookie);
+        if (Item == mRegistrations.end() || Item->second.Closed) {
+            return;
+        }
+
+        auto& Registration = Item->second;
+        if (!IsWindow(Registration.Window)) {
+            Registration.Closed = true;
+            return Dispatch(Cookie, WindowMonitorEvent::Closed);
+        }
+
+        const SIZE ClientSize = GetClientSize(Registration.Window);
+        if (ClientSize.cx == Registration.ClientSize.cx && ClientSize.cy == Registration.ClientSize.cy) {
+            return;
+        }
+
+        Registration.ClientSize = ClientSize;
+        Dispatch(Cookie, WindowMonitorEvent::Resized);
+    }
+
+    void WindowMonitor::Dispatch(_In_ Cookie Cookie, _In_ WindowMonitorEvent Event)
+    {
+        const auto Item = mRegistrations.find(Cookie);
+        if (Item == mRegistrations.end() || !Item->second.Callback) {
+            return;
+        }
+
+        // Copied, the handler may unregister itself
+        const auto Callback   = Item->second.Callback;
+        const auto Window     = Item->second.Window;
+        const auto ClientSize = Item->second.ClientSize;
+
+        Callback(Window, Event, ClientSize);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <unordered_map>
+
+
+namespace Mi::Core
+{
+    enum class WindowMonitorEvent
+    {
+        Resized,    // client area size changed, bursts of moves and resizes are reported once
+        Closed,     // destroyed or minimized
+    };
+
+    // One shared thread that watches the windows of all sessions through WinEvent hooks,
+    // instead of a polling thread per session.
+    class WindowMonitor
+    {
+    public:
+        using Handler = std::function<void(_In_ HWND Window, _In_ WindowMonitorEvent Event, _In_ SIZE ClientSize)>;
+        using Cookie  = uint64_t;
+
+        // Location changes closer together than this are coalesced into one resize check.
+        static constexpr UINT RESIZE_COALESCE_MILLISECONDS = 30;
+
+        static WindowMonitor& GetInstance();
+
+        // Handlers run on the monitor thread and must not block on the thread that calls Unregister.
+        winrt::hresult Register(_In_ HWND Window, _In_ const Handler& Handler, _Out_ Cookie& Cookie);
+
+        // No handler of the registration runs after this returns. It may be called from within a handler.
+        void Unregister(_In_ Cookie Cookie);
+
+    private:
+        struct Registration
+        {
+            HWND                        Window = nullptr;
+            Handler                     Callback;
+            SIZE                        ClientSize{};
+            bool                        Closed = false;
+            std::vector<HWINEVENTHOOK>  Hooks;
+        };
+
+        std::thread mThread;
+        HWND        mMessageWindow = nullptr;
+
+        // Only touched on the monitor thread, other threads go through SendMessage to mMessageWindow
+        std::unordered_map<Cookie, Registration> mRegistrations;
+        Cookie      mNextCookie = 1;
+
+        WindowMonitor();
+        ~WindowMonitor();
+
+        WindowMonitor(      WindowMonitor&&) = delete;
+        WindowMonitor(const WindowMonitor& ) = delete;
+        WindowMonitor& operator=(      WindowMonitor&&) = delete;
+        WindowMonitor& operator=(const WindowMonitor& ) = delete;
+
+        void Run(_In_ std::promise<HWND>& Ready);
+
+        winrt::hresult OnRegister  (_In_ HWND Window, _In_ const Handler& Handler, _Out_ Cookie& Cookie);
+        void           OnUnregister(_In_ Cookie Cookie);
+        void           OnWinEvent  (_In_ DWORD Event, _In_ HWND Window);
+        void           OnResizeTimer(_In_ Cookie Cookie);
+
+        void Dispatch(_In_ Cookie Cookie, _In_ WindowMonitorEvent Event);
+    };
+}
@@ -0,0 +1,134 @@
+#include "Core.WindowRegistry.h"
+
+
+namespace Mi::Core
+{
+    WindowRegistry::WindowRegistry(_In_ IWindowProvider& Provider)
+        : mProvider(Provider)
+    {
+    }
+
+    void WindowRegistry::SetObserver(_In_ const Observer& Handler)
+    {
+        mObserver = Handler;
+    }
+
+    void WindowRegistry::Rebuild()
+    {
+        ++mRebuild;
+
+        mEnumerated.clear();
+        mProvider.EnumerateWindows(mEnumerated);
+
+        std::wstring Title;
+        std::wstring ClassName;
+        std::wstring ProcessName;
+        for (const WindowId Window : mEnumerated) {
+            if (const auto Item = mIndex.find(Window); Item != mIndex.end()) {
+                mSeen[Item->second] = mRebuild;
+                continue;
+            }
+
+            if (mProvider.DescribeWindow(Window, Title, ClassName, ProcessName)) {
+                Add(Window, std::move(Title), std::move(ClassName), std::move(ProcessName));
+                mSeen.back() = mRebuild;
+            }
+        }
+
+        // Backwards, so the entry that moves into a hole was already checked
+        for (size_t Index = mEntries.size(); Index-- > 0;) {
+            if (mSeen[Index] != mRebuild) {
+                Remove(static_cast<uint32_t>(Index));
+            }
+        }
+    }
+
+    void WindowRegistry::OnEvent(_In_ WindowEvent Event, _In_ WindowId Window)
+    {
+        const auto Item  = mIndex.find(Window);
+        const bool Known = Item != mIndex.end();
+
+        switch (Event) {
+            case WindowEvent::Created:
+            case WindowEvent::Shown: {
+                // Most windows are created hidden, they are described once they show
+                std::wstring Title;
+                std::wstring ClassName;
+                std::wstring ProcessName;
+                if (!Known && mProvider.DescribeWindow(Window, Title, ClassName, ProcessName)) {
+                    Add(Window, std::move(Title), std::move(ClassName), std::move(ProcessName));
+                }
+                break;
+            }
+
+            case WindowEvent::Hidden:
+            case WindowEvent::Destroyed: {
+                if (Known) {
+                    Remove(Item->second);
+                }
+                break;
+            }
+
+            case WindowEvent::NameChanged: {
+                // A window without a title does not belong in the list, one that just got a title might
+                std::wstring Title;
+                std::wstring ClassName;
+                std::wstring ProcessName;
+                const bool Listed = mProvider.DescribeWindow(Window, Title, ClassName, ProcessName);
+
+                if (Known && !Listed) {
+                    Remove(Item->second);
+                }
+                else if (Known && mEntries[Item->second].Title != Title) {
+                    mEntries[Item->second].Title = std::move(Title);
+                    Notify(WindowRegistryAction::Renamed, Item->second);
+                }
+                else if (!Known && Listed) {
+                    Add(Window, std::move(Title), std::move(ClassName), std::move(ProcessName));
+                }
+                break;
+            }
+        }
+    }
+
+    const WindowRegistryEntry* WindowRegistry::Find(_In_ WindowId Window) const
+    {
+        const auto Item = mIndex.find(Window);
+        return Item != mIndex.end() ? &mEntries[Item->second] : nullptr;
+    }
+
+    void WindowRegistry::Add(_In_ WindowId Window, _In_ std::wstring&& Title, _In_ std::wstring&& ClassName,
+        _In_ std::wstring&& ProcessName)
+    {
+        const auto Index = static_cast<uint32_t>(mEntries.size());
+
+        mEntries.push_back({ Window, std::move(Title), std::move(ClassName), std::move(ProcessName) });
+        mSeen.push_back(0);
+        mIndex.emplace(Window, Index);
+
+        Notify(WindowRegistryAction::Added, Index);
+    }
+
+    void WindowRegistry::Remove(_In_ uint32_t Index)
+    {
+        const auto Last = static_cast<uint32_t>(mEntries.size() - 1);
+
+        mIndex.erase(mEntries[Index].Window);
+        if (Index != Last) {
+            mEntries[Index] = std::move(mEntries[Last]);
+            mSeen[Index]    = mSeen[Last];
+            mIndex[mEntries[Index].Window] = Index;
+        }
+        mEntries.pop_back();
+        mSeen.pop_back();
+
+        Notify(WindowRegistryAction::Removed, Index);
+    }
+
+    void WindowRegistry::Notify(_In_ WindowRegistryAction Action, _In_ uint32_t Index) const
+    {
+        if (mObserver) {
+            mObserver(Action, Index);
+        }
+    }
+}
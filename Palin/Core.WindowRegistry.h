@@ -0,0 +1,94 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+
+
+namespace Mi::Core
+{
+    // A top-level window, the HWND value on Windows.
+    using WindowId = uint64_t;
+
+    // Where WindowRegistry gets its windows from, the desktop or a fake one.
+    class IWindowProvider
+    {
+    public:
+        virtual ~IWindowProvider() = default;
+
+        // Every top-level window, in z-order.
+        virtual void EnumerateWindows(_Inout_ std::vector<WindowId>& Windows) = 0;
+
+        // Fills in the title, class and process name of a window that belongs in the list, false for windows that
+        // do not, like hidden, cloaked, tool and untitled windows.
+        virtual bool DescribeWindow(_In_ WindowId Window, _Out_ std::wstring& Title, _Out_ std::wstring& ClassName,
+            _Out_ std::wstring& ProcessName) = 0;
+    };
+
+    enum class WindowEvent
+    {
+        Created,
+        Shown,          // also uncloaked
+        Hidden,         // also cloaked
+        NameChanged,
+        Destroyed,
+    };
+
+    enum class WindowRegistryAction
+    {
+        Added,          // the entry is at Index, the last one
+        Removed,        // the last entry moved to Index unless Index is now the count
+        Renamed,        // the title of the entry at Index changed
+    };
+
+    struct WindowRegistryEntry
+    {
+        WindowId     Window = 0;
+        std::wstring Title;
+        std::wstring ClassName;
+        std::wstring ProcessName;   // the file name of the executable
+    };
+
+    // The windows that belong in a window picker, kept up to date one event at a time.
+    //
+    // Titles, class and process names are fetched once per window and cached. Entries sit in a dense array with an index
+    // from window to slot, a removal moves the last entry into the hole, so every event costs the same however
+    // many windows are open. An observer sees each change with the slot it affects and can mirror the array.
+    class WindowRegistry
+    {
+    public:
+        using Observer = std::function<void(_In_ WindowRegistryAction Action, _In_ uint32_t Index)>;
+
+    private:
+        IWindowProvider&                       mProvider;
+        Observer                               mObserver;
+        std::vector<WindowRegistryEntry>       mEntries;
+        std::unordered_map<WindowId, uint32_t> mIndex;
+        std::vector<uint64_t>                  mSeen;           // per entry, the last Rebuild that found it
+        std::vector<WindowId>                  mEnumerated;     // reused by Rebuild
+        uint64_t                               mRebuild = 0;
+
+    public:
+        explicit WindowRegistry(_In_ IWindowProvider& Provider);
+
+        WindowRegistry(      WindowRegistry&&) = delete;
+        WindowRegistry(const WindowRegistry& ) = delete;
+        WindowRegistry& operator=(      WindowRegistry&&) = delete;
+        WindowRegistry& operator=(const WindowRegistry& ) = delete;
+
+        void SetObserver(_In_ const Observer& Handler);
+
+        // Enumerates all windows again. Known windows keep their cached names, new ones are described and
+        // windows that are gone are removed.
+        void Rebuild();
+
+        void OnEvent(_In_ WindowEvent Event, _In_ WindowId Window);
+
+        [[nodiscard]] const std::vector<WindowRegistryEntry>& GetEntries() const noexcept { return mEntries; }
+        [[nodiscard]] const WindowRegistryEntry* Find(_In_ WindowId Window) const;
+
+    private:
+        void Add   (_In_ WindowId Window, _In_ std::wstring&& Title, _In_ std::wstring&& ClassName,
+            _In_ std::wstring&& ProcessName);
+        void Remove(_In_ uint32_t Index);
+        void Notify(_In_ WindowRegistryAction Action, _In_ uint32_t Index) const;
+    };
+}
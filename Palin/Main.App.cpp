@@ -1,4 +1,5 @@
 #include "Main.App.h"
+#include "Core.Trace.h"
 
 
 namespace Mi::Palin
@@ -9,6 +10,7 @@ namespace Mi::Palin
     }
 
     App::App()
+        : mStartupTime(std::chrono::steady_clock::now())
     {
         UINT Flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
 
@@ -40,6 +42,27 @@ namespace Mi::Palin
         }
         winrt::check_hresult(Result);
 
+        // The capture callbacks copy frames on the immediate context while the render thread draws with it
+        if (const auto Multithread = mDevice.try_as<ID3D11Multithread>()) {
+            (void)Multithread->SetMultithreadProtected(TRUE);
+        }
+
+        mRender            = std::make_unique<Core::GraphicsRender>(CreateSwapChain(0));
+        mCaptureForTexture = std::make_unique<Core::GraphicsCaptureForTexture>(mDevice, DXGI_FORMAT_B8G8R8A8_UNORM);
+        mCaptureForWindow  = std::make_unique<Core::GraphicsCaptureForWindow >(mDevice, DXGI_FORMAT_B8G8R8A8_UNORM);
+        mCaptureForMemory  = std::make_unique<Core::GraphicsCaptureForMemory >(mDevice);
+        mCaptureForFile    = std::make_unique<Core::GraphicsCaptureForFile   >(mDevice);
+        mCaptureForPattern = std::make_unique<Core::GraphicsCaptureForPattern>(mDevice);
+        mRecorder          = std::make_unique<Core::FrameRecorder>(mDevice);
+        mLatencyProbe      = std::make_unique<Core::LatencyProbe>(mDevice);
+        mSnapshotReadback  = std::make_unique<Core::AsyncReadback>(mDevice);
+
+        LOG(INFO, "App::App() startup took %lld us.", static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mStartupTime).count()));
+    }
+
+    winrt::com_ptr<IDXGISwapChain1> App::CreateSwapChain(_In_ UINT Flags) const
+    {
         const HWND BackgroundWindow = GetShellWindow();
 
         RECT WindowRect{};
@@ -59,6 +82,15 @@ namespace Mi::Palin
         winrt::com_ptr<IDXGIFactory2> Factory;
         winrt::check_hresult(Adapter->GetParent(IID_PPV_ARGS(&Factory)));
 
+        // Needed by the uncapped and adaptive vsync pacing policies
+        if (const auto Factory5 = Factory.try_as<IDXGIFactory5>()) {
+            BOOL AllowTearing = FALSE;
+            if (SUCCEEDED(Factory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING,
+                &AllowTearing, sizeof(AllowTearing))) && AllowTearing) {
+                Flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+            }
+        }
+
         DXGI_SWAP_CHAIN_DESC1 SwapChainDesc = {};
         SwapChainDesc.Width              = WindowSize.Width;
         SwapChainDesc.Height             = WindowSize.Height;
@@ -70,22 +102,35 @@ namespace Mi::Palin
         SwapChainDesc.Scaling            = DXGI_SCALING_STRETCH;
         SwapChainDesc.SwapEffect         = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
         SwapChainDesc.AlphaMode          = DXGI_ALPHA_MODE_UNSPECIFIED;
+        SwapChainDesc.Flags              = Flags;
 
         winrt::com_ptr<IDXGISwapChain1> SwapChain{};
-        winrt::check_hresult(Factory->CreateSwapChainForComposition(
-            mDevice.get(), &SwapChainDesc, nullptr, SwapChain.put()));
+        winrt::hresult Result = Factory->CreateSwapChainForComposition(
+            mDevice.get(), &SwapChainDesc, nullptr, SwapChain.put());
+        if (FAILED(Result) && (SwapChainDesc.Flags & DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING)) {
+            SwapChainDesc.Flags &= ~DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
 
-        mRender            = std::make_unique<Core::GraphicsRender>(SwapChain);
-        mCaptureForTexture = std::make_unique<Core::GraphicsCaptureForTexture>(mDevice, DXGI_FORMAT_B8G8R8A8_UNORM);
-        mCaptureForWindow  = std::make_unique<Core::GraphicsCaptureForWindow >(mDevice, DXGI_FORMAT_B8G8R8A8_UNORM);
+            Result = Factory->CreateSwapChainForComposition(
+                mDevice.get(), &SwapChainDesc, nullptr, SwapChain.put());
+        }
+        winrt::check_hresult(Result);
+
+        return SwapChain;
     }
 
     void App::Close()
     {
         StopPlay();
 
+        mRecorder          = nullptr;
+        mLatencyProbe      = nullptr;
+        mSnapshotReadback  = nullptr;
         mCaptureForTexture = nullptr;
         mCaptureForWindow  = nullptr;
+        mCaptureForMemory  = nullptr;
+        mCaptureForFile    = nullptr;
+        mCaptureForPattern = nullptr;
+        mChangeDetector    = nullptr;
         mRender            = nullptr;
         mDevice            = nullptr;
     }
@@ -98,12 +143,14 @@ namespace Mi::Palin
         return { nullptr };
     }
 
-    void App::SetKeyedMutex(_In_ bool Enable, _In_ UINT32 AcquireKey, _In_ UINT32 ReleaseKey, _In_ UINT32 Timeout)
+    void App::SetKeyedMutex(_In_ bool Enable, _In_ UINT32 AcquireKey, _In_ UINT32 ReleaseKey, _In_ UINT32 Timeout,
+        _In_opt_ KeyedMutexFallback Fallback)
     {
         mKeyedMutex = Enable;
         mAcquireKey = AcquireKey;
         mReleaseKey = ReleaseKey;
         mTimeout    = Timeout;
+        mKeyedMutexFallback = Fallback;
     }
 
     void App::SetRotationMode(_In_ DXGI_MODE_ROTATION Mode)
@@ -111,6 +158,138 @@ namespace Mi::Palin
         mRotationMode = Mode;
     }
 
+    winrt::hresult App::SetLowLatencyMode(_In_ bool Enable, _In_ UINT MaximumFrameLatency)
+    {
+        if (mStarted) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        // The waitable flag can only be chosen when the swap chain is created
+        if (Enable != (mRender->GetFrameLatencyWaitableObject() != nullptr)) {
+            try {
+                mRender = std::make_unique<Core::GraphicsRender>(
+                    CreateSwapChain(Enable ? DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT : 0));
+            }
+            catch (const winrt::hresult_error& Exception) {
+                LOG(ERROR, "App::SetLowLatencyMode(%d) failed, Result=0x%0*X", Enable, 8, Exception.code().value);
+                return Exception.code();
+            }
+        }
+
+        if (Enable) {
+            return mRender->SetMaximumFrameLatency(MaximumFrameLatency);
+        }
+
+        return S_OK;
+    }
+
+    winrt::hresult App::SetZeroCopyCapture(_In_ bool Enable, _In_ int32_t FramePoolDepth)
+    {
+        if (mStarted) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        mCaptureForWindow->IsZeroCopyEnabled(Enable);
+        mCaptureForWindow->SetFramePoolDepth(FramePoolDepth);
+        return S_OK;
+    }
+
+    winrt::hresult App::SetDirtyRegionMode(_In_ bool Enable)
+    {
+        if (mStarted) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        mCaptureForWindow->IsDirtyRegionEnabled(Enable);
+        return S_OK;
+    }
+
+    winrt::hresult App::SetFramePacing(_In_ Core::FramePacingPolicy Policy, _In_opt_ double TargetRate)
+    {
+        if (mStarted) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        if (Policy == Core::FramePacingPolicy::FixedRate && TargetRate <= 0.0) {
+            return E_INVALIDARG;
+        }
+
+        mFramePacer.SetPolicy(Policy, TargetRate);
+        return S_OK;
+    }
+
+    winrt::hresult App::SetFrameTiming(_In_ bool GpuTiming, _In_opt_ std::chrono::milliseconds DumpInterval)
+    {
+        if (mStarted) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        mGpuTiming = GpuTiming;
+        mFrameTimingDumpInterval = DumpInterval;
+        return S_OK;
+    }
+
+    winrt::hresult App::SetLatencyProbe(_In_ bool Enable)
+    {
+        if (mStarted) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        mLatencyProbeEnabled = Enable;
+        return S_OK;
+    }
+
+    Core::LatencyProbeStatistics App::GetLatencyProbeStatistics() const
+    {
+        return mLatencyProbe ? mLatencyProbe->GetStatistics() : Core::LatencyProbeStatistics{};
+    }
+
+    Core::FrameTimingSummary App::GetFrameTimingSummary()
+    {
+        return mFrameTiming.GetSummary();
+    }
+
+    KeyedMutexStatistics App::GetKeyedMutexStatistics() const
+    {
+        KeyedMutexStatistics Statistics{};
+        Statistics.Acquired    = mKeyedMutexAcquired;
+        Statistics.Contended   = mKeyedMutexContended;
+        Statistics.Repeated    = mKeyedMutexRepeated;
+        Statistics.Skipped     = mKeyedMutexSkipped;
+        Statistics.TotalWait   = std::chrono::nanoseconds(mKeyedMutexTotalWait);
+        Statistics.MaximumWait = std::chrono::nanoseconds(mKeyedMutexMaximumWait);
+        return Statistics;
+    }
+
+    SessionStatistics App::GetSessionStatistics() const
+    {
+        SessionStatistics Statistics{};
+        Statistics.UnchangedFrames = mUnchangedFrames;
+        Statistics.PartialPresents = mPartialPresents;
+        Statistics.DroppedFrames   = mDroppedFrames;
+        Statistics.DuplicateFrames = mDuplicateFrames;
+        if (mSessionEnd > mSessionStart) {
+            Statistics.Duration    = std::chrono::duration_cast<std::chrono::nanoseconds>(mSessionEnd - mSessionStart);
+        }
+        if (mRender) {
+            Statistics.Render = mRender->GetStatistics();
+        }
+        return Statistics;
+    }
+
+    void App::SetChangeDetection(_In_ bool Enable)
+    {
+        if (Enable && mChangeDetector == nullptr) {
+            mChangeDetector = std::make_unique<Core::FrameChangeDetector>(mDevice);
+
+            if (!mChangeDetector->IsSupported()) {
+                LOG(INFO, "App::SetChangeDetection(), compute shaders are not supported by this device.");
+            }
+        }
+
+        mChangeDetection = Enable;
+    }
+
     winrt::hresult App::StartPlay(_In_ HWND Window)
     {
         const auto Result = mCaptureForWindow->StartCapture(Window);
@@ -131,9 +310,9 @@ namespace Mi::Palin
         return StartRenderThread(mCaptureForTexture.get());
     }
 
-    winrt::hresult App::StartPlay(_In_ HWND Window, _In_ HANDLE Handle, _In_ bool NtHandle)
+    winrt::hresult App::StartPlay(_In_ HWND Window, _In_ HANDLE Handle, _In_ bool NtHandle, _In_opt_ HANDLE FenceHandle)
     {
-        const auto Result = mCaptureForTexture->StartCapture(Window, Handle, NtHandle);
+        const auto Result = mCaptureForTexture->StartCapture(Window, Handle, NtHandle, FenceHandle);
         if (FAILED(Result)) {
             return Result;
         }
@@ -141,9 +320,77 @@ namespace Mi::Palin
         return StartRenderThread(mCaptureForTexture.get());
     }
 
+    winrt::hresult App::StartPlayFromMemory(_In_ HWND Window, _In_ LPCWSTR MappingName)
+    {
+        const auto Result = mCaptureForMemory->StartCapture(Window, MappingName);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        return StartRenderThread(mCaptureForMemory.get());
+    }
+
+    winrt::hresult App::StartPlayFromFile(_In_ const std::filesystem::path& Path, _In_opt_ Core::ReplayTiming Timing,
+        _In_opt_ bool Loop)
+    {
+        const auto Result = mCaptureForFile->StartCapture(Path, Timing, Loop);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        return StartRenderThread(mCaptureForFile.get());
+    }
+
+    winrt::hresult App::StartPlayFromPattern(_In_ Core::TestPattern Pattern, _In_ uint32_t Width, _In_ uint32_t Height,
+        _In_ double Rate)
+    {
+        const auto Result = mCaptureForPattern->StartCapture(Pattern, Width, Height, Rate);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        return StartRenderThread(mCaptureForPattern.get());
+    }
+
     winrt::hresult App::StartRenderThread(Core::IGraphicsCapture* Capture)
     {
         mResizeCount = 1;
+        mRender->ResetStatistics();
+
+        mUnchangedFrames = 0;
+        mPartialPresents = 0;
+        mDroppedFrames   = 0;
+        mDuplicateFrames = 0;
+        mKeyedMutexAcquired   = 0;
+        mKeyedMutexContended  = 0;
+        mKeyedMutexRepeated   = 0;
+        mKeyedMutexSkipped    = 0;
+        mKeyedMutexTotalWait  = 0;
+        mKeyedMutexMaximumWait = 0;
+        if (mChangeDetector) {
+            mChangeDetector->Reset();
+        }
+
+        mFramePacer.Reset();
+        mPacedGeneration = 0;
+        mFrameTiming.Reset();
+        mSessionStart = std::chrono::steady_clock::now();
+        mSessionEnd   = {};
+
+        if (const auto Result = mRender->SetGpuTiming(mGpuTiming); FAILED(Result)) {
+            LOG(ERROR, "App::StartRenderThread(), GraphicsRender::SetGpuTiming(%d) failed, Result=0x%0*X", mGpuTiming, 8, Result.value);
+        }
+
+        if (mLatencyProbeEnabled) {
+            (void)mLatencyProbe->Start();
+        }
+
+        DWM_TIMING_INFO TimingInfo{};
+        TimingInfo.cbSize = sizeof(TimingInfo);
+        if (SUCCEEDED(DwmGetCompositionTimingInfo(nullptr, &TimingInfo)) && TimingInfo.rateRefresh.uiDenominator) {
+            mFramePacer.SetRefreshRate(
+                static_cast<double>(TimingInfo.rateRefresh.uiNumerator) / TimingInfo.rateRefresh.uiDenominator);
+        }
 
         Capture->IsBorderRequired(false);
         Capture->IsCursorCaptureEnabled(false);
@@ -151,29 +398,59 @@ namespace Mi::Palin
         Capture->SubscribeResizeEvent([this](HWND)
         {
             ++mResizeCount;
+            mFrameSignal.Notify();
+        });
+        Capture->SubscribeUpdateEvent([this](HWND)
+        {
+            mFrameSignal.Notify();
         });
 
+        mFrameSignal.Reset();
+
         const auto RenderThread = [this, Capture]
         {
             LOG(INFO, "App::RenderThread() startup.");
+            Core::Trace::SetThreadName("App::RenderThread");
+
+            // Redraw once after startup and resize even if the source has no new frame
+            bool Redraw = true;
+
+            // In low latency mode a back buffer is reserved before the newest surface is picked,
+            // the reservation is held until the next present.
+            const HANDLE FrameLatencyWaitable = mRender->GetFrameLatencyWaitableObject();
+            bool FrameLatencyReserved = false;
+
+            using Clock = std::chrono::steady_clock;
+            auto LastTimingDump = Clock::now();
+
+            // Generation of the frame the back buffers are up to date with, and the regions that changed since
+            uint64_t DrawnGeneration = 0;
+            std::vector<RECT> DirtyRects;
+
+            // Generation of the frame on screen, for the dropped and duplicate frame accounting
+            uint64_t PresentedGeneration = 0;
 
             while (mStarted) {
                 winrt::hresult Result;
 
-                const auto& Surface = Capture->GetSurface();
-                if (Surface == nullptr) {
-                    std::this_thread::yield();
-                    continue;
+                if (FrameLatencyWaitable && !FrameLatencyReserved) {
+                    if (WaitForSingleObjectEx(FrameLatencyWaitable,
+                        static_cast<DWORD>(FRAME_WAIT_TIMEOUT.count()), TRUE) != WAIT_OBJECT_0) {
+                        continue;
+                    }
+                    FrameLatencyReserved = true;
                 }
 
-                winrt::com_ptr<IDXGIKeyedMutex> SurfaceMutex{ nullptr };
-                if (mKeyedMutex) {
-                    (void)Surface->QueryInterface(IID_PPV_ARGS(&SurfaceMutex));
+                // The lease keeps a zero-copy frame out of the capture pool until it is dropped
+                auto Frame = Capture->AcquireFrame();
+                if (Frame == nullptr) {
+                    (void)mFrameSignal.WaitFor(FRAME_WAIT_TIMEOUT);
+                    continue;
                 }
 
                 if (mResizeCount) {
                     D3D11_TEXTURE2D_DESC TextureDesc{};
-                    Surface->GetDesc(&TextureDesc);
+                    Frame->Surface->GetDesc(&TextureDesc);
 
                     Result = mRender->Resize(TextureDesc.Width, TextureDesc.Height, DXGI_FORMAT_B8G8R8A8_UNORM);
                     if (FAILED(Result)) {
@@ -182,30 +459,260 @@ namespace Mi::Palin
                         break;
                     }
 
-                    --mResizeCount; continue;
+                    --mResizeCount;
+                    Redraw = true;
+                    continue;
+                }
+                Frame = nullptr;
+
+                // A snapshot needs a frame that is drawn and presented, even if the source did not change
+                if (mSnapshotState == SnapshotState::Requested) {
+                    Redraw = true;
                 }
 
+                // Sources without an update event are paced by Present() alone
+                bool Signaled = !Capture->IsUpdateEventSupported();
+                if (!Signaled && !Redraw) {
+                    if (!mFrameSignal.WaitFor(FRAME_WAIT_TIMEOUT)) {
+                        continue;
+                    }
+                    if (!mStarted || mResizeCount) {
+                        continue;
+                    }
+                    Signaled = true;
+                }
+
+                // Take the newest frame again, the one above may have been replaced while waiting
+                Frame = Capture->AcquireFrame();
+                if (Frame == nullptr) {
+                    continue;
+                }
+                NoteSourceFrame(*Frame, Signaled);
+
+                const auto Decision = mFramePacer.Decide();
+                if (Decision.Delay.count() > 0) {
+                    // Not held over the delay, the source may replace the frame meanwhile
+                    Frame = nullptr;
+
+                    WaitForPacingDelay(Capture, Decision.Delay);
+                    if (!mStarted || mResizeCount) {
+                        continue;
+                    }
+
+                    Frame = Capture->AcquireFrame();
+                    if (Frame == nullptr) {
+                        continue;
+                    }
+                }
+                if (!Decision.Present && !Redraw) {
+                    continue;
+                }
+                const auto Surface = Frame->Surface;
+
+                winrt::com_ptr<IDXGIKeyedMutex> SurfaceMutex{ nullptr };
+                if (mKeyedMutex) {
+                    (void)Surface->QueryInterface(IID_PPV_ARGS(&SurfaceMutex));
+                }
+
+                const bool ForceRedraw = Redraw;
+                Redraw = false;
+
+                // Dirty rects are only usable if they are relative to the frame that was drawn last,
+                // and the rotation keeps surface and back buffer coordinates the same
+                const uint64_t Generation = Frame->Generation;
+                bool PartialPresent = !ForceRedraw
+                    && Frame->DirtyRectsValid
+                    && Generation == DrawnGeneration + 1
+                    && (mRotationMode == DXGI_MODE_ROTATION_IDENTITY || mRotationMode == DXGI_MODE_ROTATION_UNSPECIFIED);
+                if (PartialPresent) {
+                    DirtyRects = Frame->DirtyRects;
+                }
+                DrawnGeneration = 0;
+
+                const auto IsSurfaceChanged = [&]
+                {
+                    if (ForceRedraw) {
+                        return true;
+                    }
+                    if (PartialPresent && DirtyRects.empty()) {
+                        return false;
+                    }
+                    return DetectSurfaceChange(Capture, Surface.get());
+                };
+
+                const Core::TraceSpan FrameSpan("App::RenderFrame");
+
+                Core::FrameTimingSample Timing{};
+                const auto FrameStart = Clock::now();
+                mFramePacer.OnFrameStart();
+
                 try {
+                    bool Changed   = true;
+                    bool Contended = false;
+
+                    const auto DrawSurface = [&](ID3D11Texture2D* Source)
+                    {
+                        const auto DrawStart = Clock::now();
+                        winrt::check_hresult(mRender->Draw(Source,
+                            nullptr, false, {}, mRotationMode));
+                        Timing.Set(Core::FrameStage::Draw, Clock::now() - DrawStart);
+                    };
+
+                    // Only new frames, a repeated copy of the last good frame is not recorded again
+                    const auto RecordSurface = [&](ID3D11Texture2D* Source)
+                    {
+                        if (mRecorder) {
+                            mRecorder->Record(Source, Generation, PartialPresent ? &DirtyRects : nullptr);
+                        }
+                    };
+
                     winrt::check_hresult(mRender->BeginFrame());
                     {
                         if (SurfaceMutex) {
-                            Result = SurfaceMutex->AcquireSync(mAcquireKey, mTimeout);
-                            if (SUCCEEDED(Result)) {
-                                winrt::check_hresult(mRender->Draw(Surface.get(),
-                                    nullptr, false, {}, mRotationMode));
+                            const auto AcquireStart = Clock::now();
+                            Result = AcquireSurface(SurfaceMutex.get());
+                            Timing.Set(Core::FrameStage::Acquire, Clock::now() - AcquireStart);
+
+                            // AcquireSync() reports WAIT_TIMEOUT and WAIT_ABANDONED as success codes,
+                            // an abandoned mutex is held all the same and has to be released
+                            if (Result == S_OK || Result == static_cast<HRESULT>(WAIT_ABANDONED)) {
+                                Changed = IsSurfaceChanged();
+                                if (Changed) {
+                                    DrawSurface(Surface.get());
+                                    RecordSurface(Surface.get());
+
+                                    if (mKeyedMutexFallback == KeyedMutexFallback::RepeatLastFrame) {
+                                        (void)UpdateLastGoodSurface(Surface.get());
+                                    }
+                                }
+                                DrawnGeneration = Generation;
 
                                 (void)SurfaceMutex->ReleaseSync(mReleaseKey);
                             }
+                            else {
+                                if (Result != static_cast<HRESULT>(WAIT_TIMEOUT)) {
+                                    LOG(ERROR, "App::RenderThread, IDXGIKeyedMutex::AcquireSync(%u) failed, Result=0x%0*X",
+                                        mAcquireKey, 8, Result.value);
+                                }
+
+                                Contended = true;
+                                PartialPresent = false;
+
+                                if (mKeyedMutexFallback == KeyedMutexFallback::RepeatLastFrame && mLastGoodSurface) {
+                                    DrawSurface(mLastGoodSurface.get());
+                                    ++mKeyedMutexRepeated;
+                                }
+                                else {
+                                    Changed = false;
+
+                                    // A redraw that could not happen is still owed
+                                    Redraw = ForceRedraw;
+                                }
+                            }
                         }
                         else {
-                            winrt::check_hresult(mRender->Draw(Surface.get(),
-                                nullptr, false, {}, mRotationMode));
+                            Changed = IsSurfaceChanged();
+                            if (Changed) {
+                                DrawSurface(Surface.get());
+                                RecordSurface(Surface.get());
+                            }
+                            DrawnGeneration = Generation;
+                        }
+                    }
+
+                    // The draw is submitted, the frame can go back to the capture pool
+                    Frame = nullptr;
+                    if (!Contended) {
+                        Capture->OnFrameConsumed(Generation);
+                    }
+
+                    if (!Changed) {
+                        if (Contended) {
+                            ++mKeyedMutexSkipped;
+                        }
+                        else {
+                            ++mUnchangedFrames;
+                        }
+
+                        // Nothing to present, wait for the next composition pass instead of Present()
+                        if (FAILED(DwmFlush())) {
+                            (void)mFrameSignal.WaitFor(std::chrono::milliseconds(16));
+                        }
+                        continue;
+                    }
+
+                    // The whole frame is drawn, the dirty rects tell DWM which parts of it need to be composed
+                    DXGI_PRESENT_PARAMETERS PresentParameters{};
+                    if (PartialPresent) {
+                        PresentParameters.DirtyRectsCount = static_cast<UINT>(DirtyRects.size());
+                        PresentParameters.pDirtyRects     = DirtyRects.data();
+                        ++mPartialPresents;
+                    }
+
+                    // Copied before Present(), afterwards the back buffer belongs to DWM
+                    const bool ProbeFrame = mLatencyProbeEnabled && mLatencyProbe->IsActive();
+                    if (mSnapshotState == SnapshotState::Requested || ProbeFrame) {
+                        winrt::com_ptr<ID3D11Texture2D> BackBuffer;
+                        if (SUCCEEDED(mRender->GetBackBuffer(BackBuffer.put()))) {
+                            if (mSnapshotState == SnapshotState::Requested) {
+                                mSnapshotState = SnapshotState::Queued;
+                                if (!mSnapshotReadback->Enqueue(BackBuffer.get(), Contended ? PresentedGeneration : Generation)) {
+                                    mSnapshotState = SnapshotState::Requested;
+                                }
+                            }
+                            if (ProbeFrame) {
+                                mLatencyProbe->Submit(BackBuffer.get());
+                            }
                         }
                     }
-                    winrt::check_hresult(mRender->EndFrame(1, 0));
+
+                    const auto PresentStart = Clock::now();
+                    winrt::check_hresult(mRender->EndFrame(
+                        Decision.SyncInterval, Decision.AllowTearing ? DXGI_PRESENT_ALLOW_TEARING : 0, &PresentParameters));
+                    mFramePacer.OnPresented();
+                    if (ProbeFrame) {
+                        mLatencyProbe->OnPresented();
+                    }
+                    FrameLatencyReserved = false;
+
+                    // A repeated last good frame shows what was presented before
+                    if (const uint64_t Shown = Contended ? PresentedGeneration : Generation; Shown) {
+                        if (Shown == PresentedGeneration) {
+                            ++mDuplicateFrames;
+                        }
+                        else if (PresentedGeneration && Shown > PresentedGeneration + 1) {
+                            mDroppedFrames += Shown - PresentedGeneration - 1;
+                        }
+                        PresentedGeneration = Shown;
+                    }
+
+                    const auto FrameEnd = Clock::now();
+                    Timing.Set(Core::FrameStage::Present, FrameEnd - PresentStart);
+                    Timing.Set(Core::FrameStage::Frame,   FrameEnd - FrameStart);
+                    Timing.FrameNumber = mRender->GetFrameNumber();
+                    mFrameTiming.Push(Timing);
+
+                    // GPU results arrive a few frames late, they are pushed as samples of their own
+                    Core::GpuTiming GpuResult{};
+                    while (mRender->ReadGpuTiming(GpuResult) == S_OK) {
+                        Core::FrameTimingSample GpuSample{};
+                        GpuSample.FrameNumber = GpuResult.FrameNumber;
+                        GpuSample.Set(Core::FrameStage::Gpu, GpuResult.Duration);
+                        mFrameTiming.Push(GpuSample);
+                    }
+
+                    if (mFrameTimingDumpInterval.count() > 0 && FrameEnd - LastTimingDump >= mFrameTimingDumpInterval) {
+                        LastTimingDump = FrameEnd;
+                        LogFrameTimingSummary();
+                    }
+
+                    if (!mFirstPresented.exchange(true)) {
+                        LOG(INFO, "App::RenderThread() first present at %lld us since App::App().", static_cast<long long>(
+                            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mStartupTime).count()));
+                    }
 
                 } catch (const winrt::hresult_error& Exception) {
-                    std::this_thread::yield();
+                    (void)mFrameSignal.WaitFor(std::chrono::milliseconds(1));
                     Result = Exception.code();
                     LOG(ERROR, "App::RenderThread() has unhandled exception, Result=0x%0*X", 8, Result.value);
                 }
@@ -216,22 +723,237 @@ namespace Mi::Palin
 
         winrt::hresult Result;
         try {
-            mRenderThread = std::thread(RenderThread);
             mStarted      = true;
+            mRenderThread = std::thread(RenderThread);
         }
         catch (const std::system_error& Exception) {
-            Result = HRESULT_FROM_WIN32(Exception.code().value());
+            mStarted = false;
+            Result   = HRESULT_FROM_WIN32(Exception.code().value());
             LOG(ERROR, "App::RenderThread() startup failed., Result=0x%0*X", 8, Result.value);
         }
 
         return Result;
     }
 
+    void App::LogFrameTimingSummary()
+    {
+        const auto Summary = mFrameTiming.GetSummary();
+
+        LOG(INFO, "App::LogFrameTimingSummary(), Frames=%llu, Dropped=%llu",
+            Summary.Frames, Summary.Dropped);
+
+        for (size_t Index = 0; Index < Core::FRAME_STAGE_COUNT; ++Index) {
+            const auto  Stage = static_cast<Core::FrameStage>(Index);
+            const auto& Item  = Summary[Stage];
+            if (Item.Count == 0) {
+                continue;
+            }
+
+            const auto Us = [](std::chrono::nanoseconds Value)
+            {
+                return static_cast<double>(Value.count()) / 1000.0;
+            };
+
+            LOG(INFO, "\t %-8s Count=%-8llu Mean=%9.1fus P50=%9.1fus P95=%9.1fus P99=%9.1fus Max=%9.1fus",
+                Core::GetFrameStageName(Stage), Item.Count,
+                Us(Item.Mean), Us(Item.P50), Us(Item.P95), Us(Item.P99), Us(Item.Max));
+        }
+    }
+
+    void App::WaitForPacingDelay(_In_ Core::IGraphicsCapture* Capture, _In_ std::chrono::nanoseconds Delay)
+    {
+        const Core::TraceSpan Span("App::WaitForPacingDelay");
+
+        const auto Deadline = std::chrono::steady_clock::now() + Delay;
+
+        while (mStarted && !mResizeCount) {
+            const auto Now = std::chrono::steady_clock::now();
+            if (Now >= Deadline) {
+                break;
+            }
+
+            // Frames arriving during the delay are folded into the one about to be drawn
+            if (mFrameSignal.WaitFor(Deadline - Now) && Capture->IsUpdateEventSupported()) {
+                if (const auto Frame = Capture->AcquireFrame(); Frame) {
+                    NoteSourceFrame(*Frame, true);
+                }
+            }
+        }
+    }
+
+    void App::NoteSourceFrame(_In_ const Core::GraphicsFrame& Frame, _In_ bool Signaled)
+    {
+        // Sources that do not number their frames only have the update event to go by
+        if (Frame.Generation == 0) {
+            if (Signaled) {
+                mFramePacer.OnSourceFrame();
+            }
+            return;
+        }
+
+        if (Frame.Generation != mPacedGeneration) {
+            mPacedGeneration = Frame.Generation;
+            mFramePacer.OnSourceFrame();
+        }
+    }
+
+    winrt::hresult App::AcquireSurface(_In_ IDXGIKeyedMutex* SurfaceMutex)
+    {
+        const Core::TraceSpan Span("App::AcquireSurface");
+
+        const auto Start = std::chrono::steady_clock::now();
+
+        // Long and infinite timeouts are waited in slices, a stalled producer must not hold up StopPlay() or a resize
+        const auto Slice = static_cast<DWORD>(FRAME_WAIT_TIMEOUT.count());
+        DWORD Remaining  = mTimeout;
+
+        winrt::hresult Result;
+        for (;;) {
+            const DWORD Timeout = std::min(Remaining, Slice);
+
+            Result = SurfaceMutex->AcquireSync(mAcquireKey, Timeout);
+            if (Result != static_cast<HRESULT>(WAIT_TIMEOUT)) {
+                break;
+            }
+
+            if (Remaining != INFINITE) {
+                Remaining -= Timeout;
+            }
+            if (Remaining == 0 || !mStarted || mResizeCount) {
+                break;
+            }
+        }
+
+        const int64_t Wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - Start).count();
+
+        // Only the render thread writes the counters
+        mKeyedMutexTotalWait += Wait;
+        if (Wait > mKeyedMutexMaximumWait) {
+            mKeyedMutexMaximumWait = Wait;
+        }
+
+        // An abandoned mutex is still held by this thread, the producer died or lost its device while holding it
+        if (Result == S_OK || Result == static_cast<HRESULT>(WAIT_ABANDONED)) {
+            ++mKeyedMutexAcquired;
+
+            if (Result == static_cast<HRESULT>(WAIT_ABANDONED)) {
+                LOG(INFO, "App::AcquireSurface(), IDXGIKeyedMutex::AcquireSync(%u) abandoned, the surface may be incomplete.",
+                    mAcquireKey);
+            }
+        }
+        else if (Result == static_cast<HRESULT>(WAIT_TIMEOUT)) {
+            ++mKeyedMutexContended;
+        }
+
+        return Result;
+    }
+
+    winrt::hresult App::UpdateLastGoodSurface(_In_ ID3D11Texture2D* Surface)
+    {
+        D3D11_TEXTURE2D_DESC SurfaceDesc{};
+        Surface->GetDesc(&SurfaceDesc);
+
+        if (mLastGoodSurface) {
+            D3D11_TEXTURE2D_DESC CacheDesc{};
+            mLastGoodSurface->GetDesc(&CacheDesc);
+
+            if (CacheDesc.Width     != SurfaceDesc.Width  ||
+                CacheDesc.Height    != SurfaceDesc.Height ||
+                CacheDesc.Format    != SurfaceDesc.Format ||
+                CacheDesc.MipLevels != SurfaceDesc.MipLevels ||
+                CacheDesc.ArraySize != SurfaceDesc.ArraySize) {
+                mLastGoodSurface = nullptr;
+            }
+        }
+
+        if (mLastGoodSurface == nullptr) {
+            // A private copy, it is read without the keyed mutex
+            SurfaceDesc.Usage          = D3D11_USAGE_DEFAULT;
+            SurfaceDesc.BindFlags      = D3D11_BIND_SHADER_RESOURCE;
+            SurfaceDesc.CPUAccessFlags = 0;
+            SurfaceDesc.MiscFlags      = 0;
+
+            const winrt::hresult Result = mDevice->CreateTexture2D(&SurfaceDesc, nullptr, mLastGoodSurface.put());
+            if (FAILED(Result)) {
+                LOG(ERROR, "App::UpdateLastGoodSurface(), ID3D11Device::CreateTexture2D(%ux%u, %d) failed, Result=0x%0*X",
+                    SurfaceDesc.Width, SurfaceDesc.Height, SurfaceDesc.Format, 8, Result.value);
+                return Result;
+            }
+        }
+
+        winrt::com_ptr<ID3D11DeviceContext> Context;
+        mDevice->GetImmediateContext(Context.put());
+        Context->CopyResource(mLastGoodSurface.get(), Surface);
+
+        return S_OK;
+    }
+
+    bool App::DetectSurfaceChange(_In_ Core::IGraphicsCapture* Capture, _In_ ID3D11Texture2D* Surface)
+    {
+        // Sources with an update event are only drawn when they reported a new frame anyway
+        if (!mChangeDetection || !mChangeDetector || Capture->IsUpdateEventSupported()) {
+            return true;
+        }
+
+        return mChangeDetector->Update(Surface) != Core::FrameChange::Unchanged;
+    }
+
     winrt::hresult App::StopPlay()
     {
         mStarted = false;
+        mFrameSignal.Notify();
         if (mRenderThread.joinable()) {
             mRenderThread.join();
+            mSessionEnd = std::chrono::steady_clock::now();
+
+            if (mRender) {
+                const auto Statistics = mRender->GetStatistics();
+
+                LOG(INFO, "App::StopPlay(), render statistics:"
+                    "\n\t ResourceCacheHits   = %llu"
+                    "\n\t ResourceCacheMisses = %llu"
+                    "\n\t VertexBufferUpdates = %llu"
+                    "\n\t UnchangedFrames     = %llu"
+                    "\n\t PartialPresents     = %llu"
+                    "\n\t DroppedFrames       = %llu"
+                    "\n\t DuplicateFrames     = %llu",
+                    Statistics.ResourceCacheHits, Statistics.ResourceCacheMisses, Statistics.VertexBufferUpdates,
+                    mUnchangedFrames, mPartialPresents, mDroppedFrames, mDuplicateFrames);
+            }
+
+            if (mKeyedMutex) {
+                const auto Statistics = GetKeyedMutexStatistics();
+
+                LOG(INFO, "App::StopPlay(), keyed mutex statistics:"
+                    "\n\t Acquired    = %llu"
+                    "\n\t Contended   = %llu"
+                    "\n\t Repeated    = %llu"
+                    "\n\t Skipped     = %llu"
+                    "\n\t TotalWait   = %.3f ms"
+                    "\n\t MaximumWait = %.3f ms",
+                    Statistics.Acquired, Statistics.Contended, Statistics.Repeated, Statistics.Skipped,
+                    static_cast<double>(Statistics.TotalWait.count()) / 1e6,
+                    static_cast<double>(Statistics.MaximumWait.count()) / 1e6);
+            }
+
+            mLastGoodSurface = nullptr;
+
+            if (mLatencyProbe) {
+                (void)mLatencyProbe->Stop();
+            }
+
+            // Queued snapshots are still written, one that never got a frame or failed to map is aborted
+            if (mSnapshotReadback) {
+                (void)mSnapshotReadback->Stop();
+            }
+            AbortSnapshot();
+
+            LogFrameTimingSummary();
+        }
+
+        if (mRender) {
+            mRender->ReleaseResourceCache();
         }
 
         if (mCaptureForTexture) {
@@ -240,10 +962,113 @@ namespace Mi::Palin
         if (mCaptureForWindow) {
             mCaptureForWindow->StopCapture();
         }
+        if (mCaptureForMemory) {
+            mCaptureForMemory->StopCapture();
+        }
+        if (mCaptureForFile) {
+            mCaptureForFile->StopCapture();
+        }
+        if (mCaptureForPattern) {
+            mCaptureForPattern->StopCapture();
+        }
+
+        return S_OK;
+    }
+
+    winrt::hresult App::StartRecording(_In_ const std::filesystem::path& Path)
+    {
+        if (mRecorder == nullptr) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        return mRecorder->Start(Path);
+    }
+
+    winrt::hresult App::StopRecording()
+    {
+        if (mRecorder == nullptr) {
+            return S_FALSE;
+        }
+
+        return mRecorder->Stop();
+    }
+
+    Core::FrameRecorderStatistics App::GetRecordingStatistics() const
+    {
+        return mRecorder ? mRecorder->GetStatistics() : Core::FrameRecorderStatistics{};
+    }
+
+    winrt::hresult App::SaveSnapshot(_In_ const std::filesystem::path& Path,
+        _In_opt_ const std::function<void(winrt::hresult)>& Completed)
+    {
+        std::lock_guard Lock(mSnapshotMutex);
+
+        if (!mStarted || mSnapshotReadback == nullptr) {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+        if (mSnapshotState != SnapshotState::Idle) {
+            return E_PENDING;
+        }
+
+        if (!mSnapshotReadback->IsActive()) {
+            const winrt::hresult Result = mSnapshotReadback->Start(
+                [this](const Core::ReadbackFrame& Frame) { OnSnapshotReadback(Frame); }, 2);
+            if (FAILED(Result)) {
+                LOG(ERROR, "App::SaveSnapshot(), AsyncReadback::Start failed, Result=0x%0*X", 8, Result.value);
+                return Result;
+            }
+        }
+
+        mSnapshotPath      = Path;
+        mSnapshotCompleted = Completed;
+        mSnapshotState     = SnapshotState::Requested;
+        mFrameSignal.Notify();
 
         return S_OK;
     }
 
+    void App::OnSnapshotReadback(_In_ const Core::ReadbackFrame& Frame)
+    {
+        std::filesystem::path Path;
+        std::function<void(winrt::hresult)> Completed;
+        {
+            std::lock_guard Lock(mSnapshotMutex);
+            Path      = std::move(mSnapshotPath);
+            Completed = std::move(mSnapshotCompleted);
+        }
+
+        const winrt::hresult Result = Core::SaveFrameAsPng(Frame, Path);
+        if (SUCCEEDED(Result)) {
+            LOG(INFO, "App::OnSnapshotReadback(), %ls (%ux%u, Generation=%llu) took %lld us after the copy.",
+                Path.c_str(), Frame.Width, Frame.Height, Frame.Sequence, static_cast<long long>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - Frame.Time).count()));
+        }
+
+        mSnapshotState = SnapshotState::Idle;
+        if (Completed) {
+            Completed(Result);
+        }
+    }
+
+    void App::AbortSnapshot()
+    {
+        std::function<void(winrt::hresult)> Completed;
+        {
+            std::lock_guard Lock(mSnapshotMutex);
+            if (mSnapshotState == SnapshotState::Idle) {
+                return;
+            }
+
+            mSnapshotState = SnapshotState::Idle;
+            mSnapshotPath.clear();
+            Completed = std::move(mSnapshotCompleted);
+        }
+
+        if (Completed) {
+            Completed(E_ABORT);
+        }
+    }
+
     void App::RegisterClosedRevoker(const std::function<void()>& Revoker)
     {
         mClosedRevoker = Revoker;
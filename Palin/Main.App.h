@@ -3,28 +3,116 @@
 #include "Window.DesktopWindow.h"
 #include "Core.GraphicsRender.h"
 #include "Core.GraphicsCapture.h"
+#include "Core.FrameSignal.h"
+#include "Core.FrameChangeDetector.h"
+#include "Core.FramePacer.h"
+#include "Core.FrameTiming.h"
 #include "Core.WindowList.h"
+#include "Core.FrameRecorder.h"
+#include "Core.LatencyProbe.h"
+#include "Core.ImageFile.h"
 
 
 namespace Mi::Palin
 {
+    // What the render thread does when the producer still holds the keyed mutex after the timeout.
+    enum class KeyedMutexFallback
+    {
+        RepeatLastFrame,    // draw the copy of the last acquired frame, or skip if there is none yet
+        SkipPresent,        // keep showing what was presented last
+    };
+
+    struct KeyedMutexStatistics
+    {
+        uint64_t Acquired  = 0;     // acquires that got the surface
+        uint64_t Contended = 0;     // acquires that timed out while the producer held the surface
+        uint64_t Repeated  = 0;     // contended frames drawn from the last acquired copy
+        uint64_t Skipped   = 0;     // contended frames that were not presented
+        std::chrono::nanoseconds TotalWait  { 0 };
+        std::chrono::nanoseconds MaximumWait{ 0 };
+    };
+
+    struct SessionStatistics
+    {
+        uint64_t UnchangedFrames = 0;   // frames that were not presented because the content did not change
+        uint64_t PartialPresents = 0;
+        uint64_t DroppedFrames   = 0;
+        uint64_t DuplicateFrames = 0;
+        Core::GraphicsRenderStatistics Render{};
+        std::chrono::nanoseconds Duration{ 0 };     // from the start of the render thread to StopPlay
+    };
+
     class App final
     {
+        // Upper bound for how long the render thread sleeps without any signal
+        static constexpr std::chrono::milliseconds FRAME_WAIT_TIMEOUT{ 250 };
+
         winrt::com_ptr<ID3D11Device>    mDevice { nullptr };
 
         std::thread mRenderThread;
+        Core::FrameSignal mFrameSignal;
+        Core::FramePacer  mFramePacer;
+        uint64_t mPacedGeneration = 0;      // newest frame the pacer was told about, render thread only
+        Core::FrameTimingCollector mFrameTiming;
+        bool mGpuTiming = true;
+        std::chrono::milliseconds mFrameTimingDumpInterval{ 0 };
         std::atomic_int64_t mResizeCount = 1;
         std::unique_ptr<Core::GraphicsRender> mRender{ nullptr };
         std::unique_ptr<Core::GraphicsCaptureForTexture> mCaptureForTexture;
         std::unique_ptr<Core::GraphicsCaptureForWindow>  mCaptureForWindow;
+        std::unique_ptr<Core::GraphicsCaptureForMemory>  mCaptureForMemory;
+        std::unique_ptr<Core::GraphicsCaptureForFile>    mCaptureForFile;
+        std::unique_ptr<Core::GraphicsCaptureForPattern> mCaptureForPattern;
+        std::unique_ptr<Core::FrameChangeDetector>       mChangeDetector;
+        std::unique_ptr<Core::FrameRecorder>             mRecorder;
+        std::unique_ptr<Core::LatencyProbe>              mLatencyProbe;
+        bool mLatencyProbeEnabled = false;
+
+        // A snapshot is read back from the back buffer of the next presented frame, one at a time
+        enum class SnapshotState
+        {
+            Idle,
+            Requested,
+            Queued,
+        };
+
+        std::unique_ptr<Core::AsyncReadback> mSnapshotReadback;
+        std::mutex                          mSnapshotMutex;
+        std::atomic<SnapshotState>          mSnapshotState = SnapshotState::Idle;
+        std::filesystem::path               mSnapshotPath;
+        std::function<void(winrt::hresult)> mSnapshotCompleted;
+
+        bool     mChangeDetection = false;
+        uint64_t mUnchangedFrames = 0;
+        uint64_t mPartialPresents = 0;
+
+        // From gaps and repeats in the frame generations, exact for sources that number their frames
+        uint64_t mDroppedFrames   = 0;
+        uint64_t mDuplicateFrames = 0;
 
         bool   mKeyedMutex = false;
         UINT32 mAcquireKey = 1;
         UINT32 mReleaseKey = 0;
         UINT32 mTimeout    = INFINITE;
+        KeyedMutexFallback mKeyedMutexFallback = KeyedMutexFallback::RepeatLastFrame;
+
+        // Copy of the last frame acquired through the keyed mutex, render thread only
+        winrt::com_ptr<ID3D11Texture2D> mLastGoodSurface{ nullptr };
+
+        std::atomic_uint64_t mKeyedMutexAcquired  = 0;
+        std::atomic_uint64_t mKeyedMutexContended = 0;
+        std::atomic_uint64_t mKeyedMutexRepeated  = 0;
+        std::atomic_uint64_t mKeyedMutexSkipped   = 0;
+        std::atomic_int64_t  mKeyedMutexTotalWait = 0;
+        std::atomic_int64_t  mKeyedMutexMaximumWait = 0;
+
         DXGI_MODE_ROTATION mRotationMode = DXGI_MODE_ROTATION_IDENTITY;
 
         std::atomic_bool mStarted = false;
+        std::atomic_bool mFirstPresented = false;
+        std::chrono::steady_clock::time_point mStartupTime{};
+        std::chrono::steady_clock::time_point mSessionStart{};
+        std::chrono::steady_clock::time_point mSessionEnd{};
         std::function<void()> mClosedRevoker = nullptr;
 
     public:
@@ -40,18 +128,95 @@ namespace Mi::Palin
 
         [[nodiscard]] winrt::com_ptr<IDXGISwapChain1> GetSwapChain() const;
 
-        void SetKeyedMutex  (_In_ bool Enable, _In_ UINT32 AcquireKey, _In_ UINT32 ReleaseKey, _In_ UINT32 Timeout);
+        // Timeout is in milliseconds, 0 polls. INFINITE waits for the producer, but still returns to StopPlay().
+        void SetKeyedMutex  (_In_ bool Enable, _In_ UINT32 AcquireKey, _In_ UINT32 ReleaseKey, _In_ UINT32 Timeout,
+            _In_opt_ KeyedMutexFallback Fallback = KeyedMutexFallback::RepeatLastFrame);
         void SetRotationMode(_In_ DXGI_MODE_ROTATION Mode);
 
+        // Opt-in: skips Draw and Present for sources without an update event when the content did not change.
+        void SetChangeDetection(_In_ bool Enable);
+
+        // Opt-in: recreates the swap chain with a frame latency waitable object, call before StartPlay.
+        winrt::hresult SetLowLatencyMode(_In_ bool Enable, _In_ UINT MaximumFrameLatency = 1);
+
+        // Opt-in: window capture hands its frames to the renderer without a copy, call before StartPlay.
+        // Every frame held by the render thread is missing from the pool, so zero-copy wants a deeper pool.
+        winrt::hresult SetZeroCopyCapture(_In_ bool Enable, _In_ int32_t FramePoolDepth = 3);
+
+        // Opt-in: window capture copies and presents only the regions that changed, call before StartPlay.
+        winrt::hresult SetDirtyRegionMode(_In_ bool Enable);
+
+        // TargetRate is in frames per second and only used by FramePacingPolicy::FixedRate, call before StartPlay.
+        winrt::hresult SetFramePacing(_In_ Core::FramePacingPolicy Policy, _In_opt_ double TargetRate = 0.0);
+
+        // GPU timestamp queries and the periodic dump of the percentiles to the log (0 disables it), call before StartPlay.
+        winrt::hresult SetFrameTiming(_In_ bool GpuTiming, _In_opt_ std::chrono::milliseconds DumpInterval = {});
+
+        // Opt-in: reads the frame barcode back from every presented frame, call before StartPlay.
+        // Only sources that stamp their frames, like StartPlayFromPattern, produce anything but undecodable frames.
+        winrt::hresult SetLatencyProbe(_In_ bool Enable);
+
+        // Latency and frame loss of the current or last session, only complete once StopPlay returned.
+        [[nodiscard]] Core::LatencyProbeStatistics GetLatencyProbeStatistics() const;
+
+        // Per-stage percentiles of the current or last session.
+        [[nodiscard]] Core::FrameTimingSummary GetFrameTimingSummary();
+
+        // Keyed mutex counters of the current or last session, the wait percentiles are the Acquire stage of the timing.
+        [[nodiscard]] KeyedMutexStatistics GetKeyedMutexStatistics() const;
+
+        // Counters of the last session, only complete once StopPlay returned.
+        [[nodiscard]] SessionStatistics GetSessionStatistics() const;
+
         winrt::hresult StartPlay(_In_ HWND Window);
         winrt::hresult StartPlay(_In_ HWND Window, _In_ LPCWSTR Name);
-        winrt::hresult StartPlay(_In_ HWND Window, _In_ HANDLE Handle, _In_ bool NtHandle);
+        winrt::hresult StartPlay(_In_ HWND Window, _In_ HANDLE Handle, _In_ bool NtHandle, _In_opt_ HANDLE FenceHandle = nullptr);
+        // Frames rendered on the CPU, published through a shared frame ring in the named file mapping.
+        winrt::hresult StartPlayFromMemory(_In_ HWND Window, _In_ LPCWSTR MappingName);
+        // Replays a recording of StartRecording, the session ends after the last frame unless Loop is set.
+        winrt::hresult StartPlayFromFile(_In_ const std::filesystem::path& Path,
+            _In_opt_ Core::ReplayTiming Timing = Core::ReplayTiming::Original, _In_opt_ bool Loop = false);
+        // Generated test patterns with a frame barcode, Rate 0 generates a new frame as soon as the last was drawn.
+        winrt::hresult StartPlayFromPattern(_In_ Core::TestPattern Pattern, _In_ uint32_t Width, _In_ uint32_t Height,
+            _In_ double Rate);
         winrt::hresult StopPlay();
 
+        // Records every new frame of the current and following sessions until StopRecording.
+        winrt::hresult StartRecording(_In_ const std::filesystem::path& Path);
+        winrt::hresult StopRecording();
+        [[nodiscard]] Core::FrameRecorderStatistics GetRecordingStatistics() const;
+
+        // Saves the next presented frame as PNG without stalling the render thread, Completed is called
+        // from a worker thread once the file is written. Fails with E_PENDING while a snapshot is in flight.
+        winrt::hresult SaveSnapshot(_In_ const std::filesystem::path& Path,
+            _In_opt_ const std::function<void(winrt::hresult)>& Completed = nullptr);
+
         void RegisterClosedRevoker(const std::function<void()>& Revoker);
 
     private:
+        [[nodiscard]] winrt::com_ptr<IDXGISwapChain1> CreateSwapChain(_In_ UINT Flags) const;
+
         winrt::hresult StartRenderThread(Core::IGraphicsCapture* Capture);
+
+        void LogFrameTimingSummary();
+
+        void OnSnapshotReadback(_In_ const Core::ReadbackFrame& Frame);
+        // Only while the snapshot readback is stopped.
+        void AbortSnapshot();
+
+        void WaitForPacingDelay(_In_ Core::IGraphicsCapture* Capture, _In_ std::chrono::nanoseconds Delay);
+
+        // Tells the pacer about a frame it has not seen yet. Forced redraws of the same frame are not source frames,
+        // Signaled is whether the update event reported one, for sources that leave Generation at 0.
+        void NoteSourceFrame(_In_ const Core::GraphicsFrame& Frame, _In_ bool Signaled);
+
+        // S_OK or WAIT_ABANDONED with the mutex held, WAIT_TIMEOUT if the producer still holds it, or the acquire error.
+        winrt::hresult AcquireSurface(_In_ IDXGIKeyedMutex* SurfaceMutex);
+
+        // Keeps a copy of the acquired surface for KeyedMutexFallback::RepeatLastFrame.
+        winrt::hresult UpdateLastGoodSurface(_In_ ID3D11Texture2D* Surface);
+
+        bool DetectSurfaceChange(_In_ Core::IGraphicsCapture* Capture, _In_ ID3D11Texture2D* Surface);
     };
 
 }
@@ -0,0 +1,369 @@
+#include "Main.Benchmark.h"
+#include "Core.Console.h"
+#include "Core.GraphicsRender.h"
+#include "Core.TestPattern.h"
+
+
+namespace Mi::Palin
+{
+    static constexpr UINT BENCHMARK_WIDTH  = 1920;
+    static constexpr UINT BENCHMARK_HEIGHT = 1080;
+    static constexpr uint64_t BENCHMARK_FRAME_BYTES = static_cast<uint64_t>(BENCHMARK_WIDTH) * 4 * BENCHMARK_HEIGHT;
+
+    static std::string ToUtf8(_In_ std::wstring_view Text)
+    {
+        if (Text.empty()) {
+            return {};
+        }
+
+        const int Size = WideCharToMultiByte(CP_UTF8, 0, Text.data(), static_cast<int>(Text.size()),
+            nullptr, 0, nullptr, nullptr);
+        std::string Result(static_cast<size_t>(Size), '\0');
+        WideCharToMultiByte(CP_UTF8, 0, Text.data(), static_cast<int>(Text.size()),
+            Result.data(), Size, nullptr, nullptr);
+        return Result;
+    }
+
+    bool Benchmark::IsRequested(_In_ int Argc, _In_reads_(Argc) wchar_t** Argv)
+    {
+        for (int Index = 1; Index < Argc; ++Index) {
+            if (_wcsicmp(Argv[Index], L"--benchmark") == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Benchmark::PrintUsage()
+    {
+        fwprintf(stderr,
+            L"Usage: Mi.Palin.exe --benchmark [options]\n"
+            L"\n"
+            L"  --filter <text>                only benchmarks whose name contains the text\n"
+            L"  --sample-time <ms>             default 50, the time one sample is calibrated to\n"
+            L"  --samples <count>              default 15\n"
+            L"  --no-gpu                       only the CPU benchmarks\n"
+            L"  --output <path>                JSON results, stdout if omitted\n"
+            L"\n"
+            L"Compare two results with Tools\\Compare-Benchmark.ps1 -Baseline <path> -Current <path>.\n");
+    }
+
+    winrt::hresult Benchmark::Parse(_In_ int Argc, _In_reads_(Argc) wchar_t** Argv)
+    {
+        BenchmarkCommandOptions Options{};
+
+        for (int Index = 1; Index < Argc; ++Index) {
+            const std::wstring_view Name = Argv[Index];
+
+            if (Name == L"--benchmark") {
+                continue;
+            }
+            if (Name == L"--help" || Name == L"-?") {
+                PrintUsage();
+                return S_FALSE;
+            }
+            if (Name == L"--no-gpu") {
+                Options.Gpu = false;
+                continue;
+            }
+
+            if (Index + 1 >= Argc) {
+                fwprintf(stderr, L"Invalid: %ls needs a value.\n", Argv[Index]);
+                return E_INVALIDARG;
+            }
+            const wchar_t* Value = Argv[++Index];
+
+            wchar_t* End = nullptr;
+            if (Name == L"--filter") {
+                Options.Suite.Filter = ToUtf8(Value);
+            }
+            else if (Name == L"--sample-time") {
+                const unsigned long Milliseconds = wcstoul(Value, &End, 10);
+                if (End == Value || *End != L'\0' || Milliseconds == 0 || Milliseconds > 60'000) {
+                    fwprintf(stderr, L"Invalid: %ls %ls\n", Name.data(), Value);
+                    return E_INVALIDARG;
+                }
+                Options.Suite.SampleTime = std::chrono::milliseconds(Milliseconds);
+            }
+            else if (Name == L"--samples") {
+                const unsigned long Samples = wcstoul(Value, &End, 10);
+                if (End == Value || *End != L'\0' || Samples == 0 || Samples > 1'000) {
+                    fwprintf(stderr, L"Invalid: %ls %ls\n", Name.data(), Value);
+                    return E_INVALIDARG;
+                }
+                Options.Suite.Samples = static_cast<uint32_t>(Samples);
+            }
+            else if (Name == L"--output") {
+                Options.Output = Value;
+            }
+            else {
+                fwprintf(stderr, L"Invalid: unknown option %ls\n", Name.data());
+                return E_INVALIDARG;
+            }
+        }
+
+        mOptions = std::move(Options);
+        return S_OK;
+    }
+
+    int Benchmark::Run()
+    {
+        // The JSON goes to the original stdout, the log is moved to stderr so the two do not mix
+        FILE* Output = nullptr;
+        if (mOptions.Output.empty()) {
+            Output = Core::SeparateDataOutput();
+        }
+
+        Core::BenchmarkSuite Suite;
+        Core::AddKernelBenchmarks(Suite);
+
+        winrt::hresult Result = S_OK;
+        if (mOptions.Gpu) {
+            Result = CreateDevice();
+            if (SUCCEEDED(Result)) {
+                AddGpuBenchmarks(Suite);
+            }
+            else {
+                LOG(ERROR, "Benchmark::Run(), no D3D11 device, Result=0x%0*X", 8, Result.value);
+            }
+        }
+
+        const auto Results = Suite.Run(mOptions.Suite);
+
+        if (!mOptions.Output.empty()) {
+            if (_wfopen_s(&Output, mOptions.Output.c_str(), L"w") != 0) {
+                fwprintf(stderr, L"Failed: can not create %ls.\n", mOptions.Output.c_str());
+                return HRESULT_FROM_WIN32(ERROR_OPEN_FAILED);
+            }
+        }
+
+        SYSTEM_INFO SystemInfo{};
+        GetNativeSystemInfo(&SystemInfo);
+
+        Core::JsonWriter Json(true);
+        Json.BeginObject();
+        Json.Member("version", 1);
+
+        Json.Key("machine").BeginObject()
+            .Member("processors", static_cast<uint32_t>(SystemInfo.dwNumberOfProcessors))
+            .Member("adapter", mAdapter)
+            .EndObject();
+
+        Json.Member("sample_time_ms", static_cast<int64_t>(mOptions.Suite.SampleTime.count()));
+        Json.Key("benchmarks");
+        Core::BenchmarkSuite::WriteResults(Json, Results);
+        Json.EndObject();
+
+        fprintf(Output, "%s\n", Json.GetString().c_str());
+        fflush(Output);
+        if (Output != stdout) {
+            fclose(Output);
+        }
+
+        return FAILED(Result) ? static_cast<int>(Result.value) : 0;
+    }
+
+    winrt::hresult Benchmark::CreateDevice()
+    {
+        winrt::hresult Result = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+            nullptr, 0, D3D11_SDK_VERSION, mDevice.put(), nullptr, nullptr);
+        if (Result == DXGI_ERROR_UNSUPPORTED) {
+            Result = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+                nullptr, 0, D3D11_SDK_VERSION, mDevice.put(), nullptr, nullptr);
+        }
+        if (FAILED(Result)) {
+            return Result;
+        }
+        mDevice->GetImmediateContext(mContext.put());
+
+        // Results of different adapters are not comparable, the name goes into the output
+        winrt::com_ptr<IDXGIAdapter> Adapter;
+        if (SUCCEEDED(mDevice.as<IDXGIDevice>()->GetAdapter(Adapter.put()))) {
+            DXGI_ADAPTER_DESC AdapterDesc{};
+            if (SUCCEEDED(Adapter->GetDesc(&AdapterDesc))) {
+                mAdapter = ToUtf8(AdapterDesc.Description);
+            }
+        }
+
+        return S_OK;
+    }
+
+    void Benchmark::WaitForGpu() const
+    {
+        D3D11_QUERY_DESC QueryDesc{ D3D11_QUERY_EVENT, 0 };
+
+        winrt::com_ptr<ID3D11Query> Query;
+        if (FAILED(mDevice->CreateQuery(&QueryDesc, Query.put()))) {
+            return;
+        }
+
+        mContext->End(Query.get());
+        mContext->Flush();
+
+        BOOL Done = FALSE;
+        while (mContext->GetData(Query.get(), &Done, sizeof(Done), 0) == S_FALSE) {
+            YieldProcessor();
+        }
+    }
+
+    winrt::com_ptr<ID3D11Texture2D> Benchmark::CreateFrameTexture(_In_ UINT BindFlags, _In_opt_ UINT MiscFlags) const
+    {
+        D3D11_TEXTURE2D_DESC TextureDesc{};
+        TextureDesc.Width            = BENCHMARK_WIDTH;
+        TextureDesc.Height           = BENCHMARK_HEIGHT;
+        TextureDesc.MipLevels        = 1;
+        TextureDesc.ArraySize        = 1;
+        TextureDesc.Format           = DXGI_FORMAT_B8G8R8A8_UNORM;
+        TextureDesc.SampleDesc.Count = 1;
+        TextureDesc.Usage            = D3D11_USAGE_DEFAULT;
+        TextureDesc.BindFlags        = BindFlags;
+        TextureDesc.MiscFlags        = MiscFlags;
+
+        // A real frame, a cleared texture may be compressed by the driver
+        std::vector<uint8_t> Pixels(BENCHMARK_FRAME_BYTES);
+        Core::DrawTestPattern(Core::TestPattern::Noise, 0, Pixels.data(), BENCHMARK_WIDTH * 4, BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+        const D3D11_SUBRESOURCE_DATA InitialData{ Pixels.data(), BENCHMARK_WIDTH * 4, 0 };
+
+        winrt::com_ptr<ID3D11Texture2D> Texture;
+        const winrt::hresult Result = mDevice->CreateTexture2D(&TextureDesc, &InitialData, Texture.put());
+        if (FAILED(Result)) {
+            LOG(ERROR, "Benchmark::CreateFrameTexture(), ID3D11Device::CreateTexture2D failed, Result=0x%0*X", 8, Result.value);
+            return nullptr;
+        }
+        return Texture;
+    }
+
+    void Benchmark::AddGpuBenchmarks(_Inout_ Core::BenchmarkSuite& Suite)
+    {
+        // GraphicsRender on a composition swap chain of its own, like App's but never shown
+        const auto CreateRender = [this]() -> std::shared_ptr<Core::GraphicsRender>
+        {
+            winrt::com_ptr<IDXGIAdapter> Adapter;
+            winrt::com_ptr<IDXGIFactory2> Factory;
+            if (FAILED(mDevice.as<IDXGIDevice>()->GetAdapter(Adapter.put())) ||
+                FAILED(Adapter->GetParent(IID_PPV_ARGS(&Factory)))) {
+                return nullptr;
+            }
+
+            DXGI_SWAP_CHAIN_DESC1 SwapChainDesc{};
+            SwapChainDesc.Width            = BENCHMARK_WIDTH;
+            SwapChainDesc.Height           = BENCHMARK_HEIGHT;
+            SwapChainDesc.Format           = DXGI_FORMAT_B8G8R8A8_UNORM;
+            SwapChainDesc.BufferUsage      = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+            SwapChainDesc.SampleDesc.Count = 1;
+            SwapChainDesc.BufferCount      = 2;
+            SwapChainDesc.Scaling          = DXGI_SCALING_STRETCH;
+            SwapChainDesc.SwapEffect       = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
+            SwapChainDesc.AlphaMode        = DXGI_ALPHA_MODE_UNSPECIFIED;
+
+            winrt::com_ptr<IDXGISwapChain1> SwapChain;
+            const winrt::hresult Result = Factory->CreateSwapChainForComposition(mDevice.get(), &SwapChainDesc, nullptr, SwapChain.put());
+            if (FAILED(Result)) {
+                LOG(ERROR, "Benchmark::AddGpuBenchmarks(), CreateSwapChainForComposition failed, Result=0x%0*X", 8, Result.value);
+                return nullptr;
+            }
+
+            try {
+                return std::make_shared<Core::GraphicsRender>(SwapChain);
+            }
+            catch (const winrt::hresult_error& Error) {
+                LOG(ERROR, "Benchmark::AddGpuBenchmarks(), GraphicsRender failed, Result=0x%0*X", 8, Error.code().value);
+                return nullptr;
+            }
+        };
+
+        const auto Render = CreateRender();
+        const auto Source = CreateFrameTexture(D3D11_BIND_SHADER_RESOURCE);
+
+        // Draw and Present of a full frame, what the render thread does for every new frame
+        Suite.Add("render.draw_present.1080p", [this, Render, Source](uint64_t Iterations)
+        {
+            if (Render == nullptr || Source == nullptr) {
+                return false;
+            }
+
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                (void)Render->BeginFrame();
+                if (FAILED(Render->Draw(Source.get())) || FAILED(Render->EndFrame(0, 0))) {
+                    return false;
+                }
+            }
+            WaitForGpu();
+            return true;
+        }, BENCHMARK_FRAME_BYTES);
+
+        // A different dirty rect every frame, every Draw recomputes and uploads the vertices
+        Suite.Add("render.draw_dirty_rects.1080p", [this, Render, Source](uint64_t Iterations)
+        {
+            if (Render == nullptr || Source == nullptr) {
+                return false;
+            }
+
+            static constexpr RECT DirtyRects[] = {
+                {   0,   0,  960,  540 },
+                { 960,   0, 1920,  540 },
+                {   0, 540,  960, 1080 },
+                { 960, 540, 1920, 1080 },
+            };
+
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                if (FAILED(Render->Draw(Source.get(), &DirtyRects[Index % std::size(DirtyRects)]))) {
+                    return false;
+                }
+            }
+            WaitForGpu();
+            return true;
+        });
+
+        // The copy GraphicsCaptureForWindow::OnUpdate makes of every captured frame
+        const auto CopySource = CreateFrameTexture(0);
+        const auto CopyTarget = CreateFrameTexture(D3D11_BIND_SHADER_RESOURCE);
+        Suite.Add("capture.copy_resource.1080p", [this, CopySource, CopyTarget](uint64_t Iterations)
+        {
+            if (CopySource == nullptr || CopyTarget == nullptr) {
+                return false;
+            }
+
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                mContext->CopyResource(CopyTarget.get(), CopySource.get());
+            }
+            WaitForGpu();
+            return true;
+        }, BENCHMARK_FRAME_BYTES);
+
+        // Producer and consumer device handing a shared surface back and forth, one iteration is a full round trip
+        const auto Shared = CreateFrameTexture(D3D11_BIND_SHADER_RESOURCE, D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX);
+
+        winrt::com_ptr<ID3D11Device>    Producer;
+        winrt::com_ptr<ID3D11Texture2D> ProducerSurface;
+        HANDLE SharedHandle = nullptr;
+        if (Shared && SUCCEEDED(Shared.as<IDXGIResource>()->GetSharedHandle(&SharedHandle)) &&
+            SUCCEEDED(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+                nullptr, 0, D3D11_SDK_VERSION, Producer.put(), nullptr, nullptr))) {
+            (void)Producer->OpenSharedResource(SharedHandle, IID_PPV_ARGS(&ProducerSurface));
+        }
+
+        Suite.Add("keyed_mutex.round_trip", [Shared, ProducerSurface](uint64_t Iterations)
+        {
+            if (Shared == nullptr || ProducerSurface == nullptr) {
+                return false;
+            }
+
+            const auto ProducerMutex = ProducerSurface.as<IDXGIKeyedMutex>();
+            const auto ConsumerMutex = Shared.as<IDXGIKeyedMutex>();
+
+            for (uint64_t Index = 0; Index < Iterations; ++Index) {
+                if (FAILED(ProducerMutex->AcquireSync(0, INFINITE))) {
+                    return false;
+                }
+                (void)ProducerMutex->ReleaseSync(1);
+
+                if (FAILED(ConsumerMutex->AcquireSync(1, INFINITE))) {
+                    return false;
+                }
+                (void)ConsumerMutex->ReleaseSync(0);
+            }
+            return true;
+        });
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Core.Benchmark.h"
+
+
+namespace Mi::Palin
+{
+    struct BenchmarkCommandOptions
+    {
+        Core::BenchmarkOptions Suite{};
+        bool                   Gpu = true;      // the D3D11 benchmarks, off for machines without a usable adapter
+        std::filesystem::path  Output;          // stdout if empty
+    };
+
+    // Runs the micro-benchmarks of the portable kernels and the D3D11 macro-benchmarks of the render and capture
+    // hot paths, and writes the results as JSON. Tools\Compare-Benchmark.ps1 compares two such files.
+    class Benchmark final
+    {
+        BenchmarkCommandOptions mOptions;
+
+        winrt::com_ptr<ID3D11Device>        mDevice { nullptr };
+        winrt::com_ptr<ID3D11DeviceContext> mContext{ nullptr };
+        std::string                         mAdapter;
+
+    public:
+        Benchmark() = default;
+        Benchmark(      Benchmark&&) = delete;
+        Benchmark(const Benchmark& ) = delete;
+        Benchmark& operator=(      Benchmark&&) = delete;
+        Benchmark& operator=(const Benchmark& ) = delete;
+
+        // True if the command line asks for the benchmarks.
+        static bool IsRequested(_In_ int Argc, _In_reads_(Argc) wchar_t** Argv);
+
+        static void PrintUsage();
+
+        // Prints what is wrong to stderr and returns E_INVALIDARG for a bad command line.
+        winrt::hresult Parse(_In_ int Argc, _In_reads_(Argc) wchar_t** Argv);
+
+        // Returns the process exit code, 0 or the HRESULT that failed the run.
+        int Run();
+
+    private:
+        winrt::hresult CreateDevice();
+
+        void AddGpuBenchmarks(_Inout_ Core::BenchmarkSuite& Suite);
+
+        // Submits the queued work and spins until the GPU finished it.
+        void WaitForGpu() const;
+
+        [[nodiscard]] winrt::com_ptr<ID3D11Texture2D> CreateFrameTexture(_In_ UINT BindFlags, _In_opt_ UINT MiscFlags = 0) const;
+    };
+}
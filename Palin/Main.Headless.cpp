@@ -0,0 +1,651 @@
+#include "Main.Headless.h"
+#include "Core.Console.h"
+#include "Core.JsonWriter.h"
+#include "Core.Trace.h"
+
+
+namespace Mi::Palin
+{
+    static std::string ToUtf8(_In_ std::wstring_view Text)
+    {
+        if (Text.empty()) {
+            return {};
+        }
+
+        const int Size = WideCharToMultiByte(CP_UTF8, 0, Text.data(), static_cast<int>(Text.size()),
+            nullptr, 0, nullptr, nullptr);
+        std::string Result(static_cast<size_t>(Size), '\0');
+        WideCharToMultiByte(CP_UTF8, 0, Text.data(), static_cast<int>(Text.size()),
+            Result.data(), Size, nullptr, nullptr);
+        return Result;
+    }
+
+    static std::string FormatHResult(_In_ winrt::hresult Result)
+    {
+        char Text[16]{};
+        sprintf_s(Text, "0x%08X", static_cast<uint32_t>(Result.value));
+        return Text;
+    }
+
+    static bool ParseUnsigned(_In_ const wchar_t* Text, _In_ int Base, _Out_ uint64_t& Value)
+    {
+        wchar_t* End = nullptr;
+        errno = 0;
+        Value = wcstoull(Text, &End, Base);
+        return End != Text && *End == L'\0' && errno == 0;
+    }
+
+    // Pumps messages, the capture sources deliver their events through the dispatcher queue of this thread.
+    // Returns true if Event was signaled before the deadline.
+    static bool PumpMessagesUntil(_In_opt_ HANDLE Event, _In_ std::chrono::steady_clock::time_point Deadline)
+    {
+        while (true) {
+            const auto Now = std::chrono::steady_clock::now();
+            if (Now >= Deadline) {
+                return false;
+            }
+
+            const auto Remaining = std::chrono::ceil<std::chrono::milliseconds>(Deadline - Now);
+            const DWORD Wait = MsgWaitForMultipleObjectsEx(Event ? 1 : 0, Event ? &Event : nullptr,
+                static_cast<DWORD>(std::min<int64_t>(Remaining.count(), INFINITE - 1)), QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            if (Event && Wait == WAIT_OBJECT_0) {
+                return true;
+            }
+
+            MSG Message{};
+            while (PeekMessageW(&Message, nullptr, 0, 0, PM_REMOVE)) {
+                TranslateMessage(&Message);
+                DispatchMessageW(&Message);
+            }
+        }
+    }
+
+    Headless::Headless(const std::shared_ptr<App>& App)
+        : mApp(App)
+    {
+    }
+
+    bool Headless::IsRequested(_In_ int Argc, _In_reads_(Argc) wchar_t** Argv)
+    {
+        for (int Index = 1; Index < Argc; ++Index) {
+            if (_wcsicmp(Argv[Index], L"--headless") == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Headless::PrintUsage()
+    {
+        fwprintf(stderr,
+            L"Usage: Mi.Palin.exe --headless [options]\n"
+            L"\n"
+            L"Source, window capture of --window if none is given:\n"
+            L"  --window <title|0xHWND>        source window, required by the shared texture sources\n"
+            L"  --shared-name <name>           shared texture opened by name\n"
+            L"  --shared-handle <hex>          shared texture handle of the --window process\n"
+            L"  --nt-handle                    --shared-handle is an NT handle\n"
+            L"  --shared-fence <hex>           shared ID3D11Fence handle of the --window process\n"
+            L"  --shared-memory <name>         file mapping of a shared frame ring\n"
+            L"  --replay <path>                recording made with --record\n"
+            L"  --replay-timing <original|fast>\n"
+            L"  --loop                         replay until --duration is over\n"
+            L"  --pattern <gradient|checkerboard|text|noise>\n"
+            L"                                 generated test pattern with a frame barcode\n"
+            L"  --pattern-size <width>x<height> default 1920x1080\n"
+            L"  --pattern-rate <fps>           default 60, 0 generates a frame whenever the last was drawn\n"
+            L"\n"
+            L"Rendering:\n"
+            L"  --keyed-mutex <acquire>:<release>[:<timeout ms>]\n"
+            L"  --rotation <identity|90|180|270|unspecified>\n"
+            L"  --pacing <vsync|uncapped|adaptive|match-source|<fps>>\n"
+            L"  --low-latency\n"
+            L"  --latency-probe                read the barcode of --pattern back from every presented frame\n"
+            L"\n"
+            L"Session:\n"
+            L"  --duration <seconds>           default 10, a closed source or the end of a replay ends it earlier\n"
+            L"  --record <path>                record the presented source frames\n"
+            L"  --snapshot <path>              save the last presented frame as PNG\n"
+            L"  --trace <path>                 Chrome trace JSON of the pipeline spans, for ui.perfetto.dev\n"
+            L"  --output <path>                JSON summary, stdout if omitted\n"
+            L"  --log-file <path>              also write the log to a file, rotated at 8 MB\n");
+    }
+
+    winrt::hresult Headless::Parse(_In_ int Argc, _In_reads_(Argc) wchar_t** Argv)
+    {
+        HeadlessOptions Options{};
+        int SourceCount = 0;
+
+        for (int Index = 1; Index < Argc; ++Index) {
+            const std::wstring_view Name = Argv[Index];
+
+            const auto NextValue = [&]() -> const wchar_t*
+            {
+                if (Index + 1 >= Argc) {
+                    fwprintf(stderr, L"Invalid: %ls needs a value.\n", Argv[Index]);
+                    return nullptr;
+                }
+                return Argv[++Index];
+            };
+
+            const auto Invalid = [&](const wchar_t* Value)
+            {
+                fwprintf(stderr, L"Invalid: %ls %ls\n", Name.data(), Value);
+                return E_INVALIDARG;
+            };
+
+            if (Name == L"--headless") {
+                continue;
+            }
+            if (Name == L"--help" || Name == L"-?") {
+                PrintUsage();
+                return S_FALSE;
+            }
+            if (Name == L"--nt-handle") {
+                Options.NtHandle = true;
+                continue;
+            }
+            if (Name == L"--loop") {
+                Options.Loop = true;
+                continue;
+            }
+            if (Name == L"--low-latency") {
+                Options.LowLatency = true;
+                continue;
+            }
+            if (Name == L"--latency-probe") {
+                Options.LatencyProbe = true;
+                continue;
+            }
+
+            const wchar_t* Value = NextValue();
+            if (Value == nullptr) {
+                return E_INVALIDARG;
+            }
+
+            uint64_t Number = 0;
+
+            if (Name == L"--window") {
+                Options.Window = Value;
+            }
+            else if (Name == L"--shared-name") {
+                Options.Source     = HeadlessSource::SharedName;
+                Options.SharedName = Value;
+                ++SourceCount;
+            }
+            else if (Name == L"--shared-handle") {
+                if (!ParseUnsigned(Value, 16, Number)) {
+                    return Invalid(Value);
+                }
+                Options.Source       = HeadlessSource::SharedHandle;
+                Options.SharedHandle = reinterpret_cast<HANDLE>(static_cast<uintptr_t>(Number));
+                ++SourceCount;
+            }
+            else if (Name == L"--shared-fence") {
+                if (!ParseUnsigned(Value, 16, Number)) {
+                    return Invalid(Value);
+                }
+                Options.SharedFence = reinterpret_cast<HANDLE>(static_cast<uintptr_t>(Number));
+            }
+            else if (Name == L"--shared-memory") {
+                Options.Source     = HeadlessSource::SharedMemory;
+                Options.SharedName = Value;
+                ++SourceCount;
+            }
+            else if (Name == L"--replay") {
+                Options.Source = HeadlessSource::File;
+                Options.Replay = Value;
+                ++SourceCount;
+            }
+            else if (Name == L"--replay-timing") {
+                if (_wcsicmp(Value, L"original") == 0) {
+                    Options.ReplayTiming = Core::ReplayTiming::Original;
+                }
+                else if (_wcsicmp(Value, L"fast") == 0) {
+                    Options.ReplayTiming = Core::ReplayTiming::AsFastAsPossible;
+                }
+                else {
+                    return Invalid(Value);
+                }
+            }
+            else if (Name == L"--pattern") {
+                const auto Pattern = Core::ParseTestPatternName(ToUtf8(Value));
+                if (!Pattern) {
+                    return Invalid(Value);
+                }
+                Options.Source  = HeadlessSource::Pattern;
+                Options.Pattern = *Pattern;
+                ++SourceCount;
+            }
+            else if (Name == L"--pattern-size") {
+                // <width>x<height>
+                const std::wstring Size = Value;
+                const size_t Separator = Size.find_first_of(L"xX");
+                uint64_t Width = 0, Height = 0;
+                if (Separator == std::wstring::npos
+                    || !ParseUnsigned(Size.substr(0, Separator).c_str(), 10, Width)
+                    || !ParseUnsigned(Size.substr(Separator + 1).c_str(), 10, Height)
+                    || Width  == 0 || Width  > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION
+                    || Height == 0 || Height > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION) {
+                    return Invalid(Value);
+                }
+                Options.PatternWidth  = static_cast<uint32_t>(Width);
+                Options.PatternHeight = static_cast<uint32_t>(Height);
+            }
+            else if (Name == L"--pattern-rate") {
+                wchar_t* End = nullptr;
+                const double Rate = wcstod(Value, &End);
+                if (End == Value || *End != L'\0' || !(Rate >= 0.0) || Rate > 10'000.0) {
+                    return Invalid(Value);
+                }
+                Options.PatternRate = Rate;
+            }
+            else if (Name == L"--keyed-mutex") {
+                // <acquire>:<release>[:<timeout>]
+                std::wstring Keys = Value;
+                std::array<uint64_t, 3> Parts{ 0, 0, INFINITE };
+                size_t Count = 0;
+                for (size_t Start = 0; Count < Parts.size() && Start <= Keys.size(); ++Count) {
+                    const size_t End = std::min(Keys.find(L':', Start), Keys.size());
+                    const std::wstring Part = Keys.substr(Start, End - Start);
+                    if (!ParseUnsigned(Part.c_str(), 10, Parts[Count]) || Parts[Count] > UINT32_MAX) {
+                        return Invalid(Value);
+                    }
+                    Start = End + 1;
+                }
+                if (Count < 2 || Keys.find(L':') == std::wstring::npos) {
+                    return Invalid(Value);
+                }
+                Options.KeyedMutex = true;
+                Options.AcquireKey = static_cast<UINT32>(Parts[0]);
+                Options.ReleaseKey = static_cast<UINT32>(Parts[1]);
+                Options.Timeout    = static_cast<UINT32>(Parts[2]);
+            }
+            else if (Name == L"--rotation") {
+                static const std::pair<const wchar_t*, DXGI_MODE_ROTATION> RotationModes[] = {
+                    { L"unspecified", DXGI_MODE_ROTATION_UNSPECIFIED },
+                    { L"identity"   , DXGI_MODE_ROTATION_IDENTITY    },
+                    { L"90"         , DXGI_MODE_ROTATION_ROTATE90    },
+                    { L"180"        , DXGI_MODE_ROTATION_ROTATE180   },
+                    { L"270"        , DXGI_MODE_ROTATION_ROTATE270   },
+                };
+
+                const auto Mode = std::find_if(std::begin(RotationModes), std::end(RotationModes),
+                    [Value](const auto& Item) { return _wcsicmp(Item.first, Value) == 0; });
+                if (Mode == std::end(RotationModes)) {
+                    return Invalid(Value);
+                }
+                Options.Rotation = Mode->second;
+            }
+            else if (Name == L"--pacing") {
+                if (_wcsicmp(Value, L"vsync") == 0) {
+                    Options.Pacing = Core::FramePacingPolicy::VSync;
+                }
+                else if (_wcsicmp(Value, L"uncapped") == 0) {
+                    Options.Pacing = Core::FramePacingPolicy::Uncapped;
+                }
+                else if (_wcsicmp(Value, L"adaptive") == 0) {
+                    Options.Pacing = Core::FramePacingPolicy::AdaptiveVSync;
+                }
+                else if (_wcsicmp(Value, L"match-source") == 0) {
+                    Options.Pacing = Core::FramePacingPolicy::MatchSource;
+                }
+                else {
+                    wchar_t* End = nullptr;
+                    const double Rate = wcstod(Value, &End);
+                    if (End == Value || *End != L'\0' || !(Rate > 0.0)) {
+                        return Invalid(Value);
+                    }
+                    Options.Pacing     = Core::FramePacingPolicy::FixedRate;
+                    Options.TargetRate = Rate;
+                }
+            }
+            else if (Name == L"--duration") {
+                wchar_t* End = nullptr;
+                const double Seconds = wcstod(Value, &End);
+                if (End == Value || *End != L'\0' || !(Seconds > 0.0) || Seconds > 7 * 24 * 3600.0) {
+                    return Invalid(Value);
+                }
+                Options.Duration = std::chrono::milliseconds(static_cast<int64_t>(Seconds * 1000.0));
+            }
+            else if (Name == L"--record") {
+                Options.Record = Value;
+            }
+            else if (Name == L"--snapshot") {
+                Options.Snapshot = Value;
+            }
+            else if (Name == L"--trace") {
+                Options.Trace = Value;
+            }
+            else if (Name == L"--output") {
+                Options.Output = Value;
+            }
+            else if (Name == L"--log-file") {
+                Options.LogFile = Value;
+            }
+            else {
+                fwprintf(stderr, L"Invalid: unknown option %ls\n", Name.data());
+                return E_INVALIDARG;
+            }
+        }
+
+        if (SourceCount > 1) {
+            fwprintf(stderr, L"Invalid: only one of --shared-name, --shared-handle, --shared-memory, --replay and --pattern.\n");
+            return E_INVALIDARG;
+        }
+
+        // The shared texture sources find the producer process through its window
+        const bool WindowRequired = Options.Source == HeadlessSource::Window
+            || Options.Source == HeadlessSource::SharedName
+            || Options.Source == HeadlessSource::SharedHandle;
+        if (WindowRequired && Options.Window.empty()) {
+            fwprintf(stderr, L"Invalid: --window is required by this source.\n");
+            return E_INVALIDARG;
+        }
+
+        mOptions = std::move(Options);
+        return S_OK;
+    }
+
+    winrt::hresult Headless::Configure() const
+    {
+        mApp->SetRotationMode(mOptions.Rotation);
+
+        if (mOptions.KeyedMutex) {
+            mApp->SetKeyedMutex(true, mOptions.AcquireKey, mOptions.ReleaseKey, mOptions.Timeout);
+        }
+
+        winrt::hresult Result = mApp->SetLowLatencyMode(mOptions.LowLatency);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        Result = mApp->SetLatencyProbe(mOptions.LatencyProbe);
+        if (FAILED(Result)) {
+            return Result;
+        }
+
+        return mApp->SetFramePacing(mOptions.Pacing, mOptions.TargetRate);
+    }
+
+    winrt::hresult Headless::StartPlay() const
+    {
+        HWND Window = nullptr;
+        if (!mOptions.Window.empty()) {
+            uint64_t Handle = 0;
+            if ((mOptions.Window.starts_with(L"0x") || mOptions.Window.starts_with(L"0X"))
+                && ParseUnsigned(mOptions.Window.c_str() + 2, 16, Handle)) {
+                Window = reinterpret_cast<HWND>(static_cast<uintptr_t>(Handle));
+            }
+            else {
+                Window = FindWindowW(nullptr, mOptions.Window.c_str());
+            }
+
+            if (!IsWindow(Window)) {
+                fwprintf(stderr, L"Invalid: no window %ls.\n", mOptions.Window.c_str());
+                return HRESULT_FROM_WIN32(ERROR_INVALID_WINDOW_HANDLE);
+            }
+        }
+
+        switch (mOptions.Source) {
+            case HeadlessSource::Window:
+                return mApp->StartPlay(Window);
+            case HeadlessSource::SharedName:
+                return mApp->StartPlay(Window, mOptions.SharedName.c_str());
+            case HeadlessSource::SharedHandle:
+                return mApp->StartPlay(Window, mOptions.SharedHandle, mOptions.NtHandle, mOptions.SharedFence);
+            case HeadlessSource::SharedMemory:
+                return mApp->StartPlayFromMemory(Window, mOptions.SharedName.c_str());
+            case HeadlessSource::File:
+                return mApp->StartPlayFromFile(mOptions.Replay, mOptions.ReplayTiming, mOptions.Loop);
+            case HeadlessSource::Pattern:
+                return mApp->StartPlayFromPattern(mOptions.Pattern, mOptions.PatternWidth, mOptions.PatternHeight,
+                    mOptions.PatternRate);
+            default:
+                return E_INVALIDARG;
+        }
+    }
+
+    int Headless::Run()
+    {
+        // The JSON goes to the original stdout, the log of App is moved to stderr so the two do not mix
+        FILE* Output = nullptr;
+        if (mOptions.Output.empty()) {
+            Output = Core::SeparateDataOutput();
+        }
+
+        if (!mOptions.LogFile.empty() && !Core::Logger::SetFile(mOptions.LogFile)) {
+            fwprintf(stderr, L"Failed: can not create %ls.\n", mOptions.LogFile.c_str());
+        }
+
+        const auto TraceStart = std::chrono::steady_clock::now();
+        if (!mOptions.Trace.empty()) {
+            Core::Trace::SetThreadName("Headless");
+            Core::Trace::SetEnabled(true);
+        }
+
+        // Window capture creates its frame pool on a thread with a dispatcher queue
+        const auto Controller = CreateDispatcherQueueController(DQTYPE_THREAD_CURRENT, DQTAT_COM_NONE);
+
+        const HANDLE Closed = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        mApp->RegisterClosedRevoker([Closed] { SetEvent(Closed); });
+
+        winrt::hresult Result = Configure();
+        if (SUCCEEDED(Result)) {
+            Result = StartPlay();
+        }
+
+        bool ClosedEarly = false;
+        winrt::hresult SnapshotResult = S_FALSE;
+
+        if (SUCCEEDED(Result)) {
+            if (!mOptions.Record.empty()) {
+                if (const auto RecordResult = mApp->StartRecording(mOptions.Record); FAILED(RecordResult)) {
+                    LOG(ERROR, "Headless::Run(), App::StartRecording failed, Result=0x%0*X", 8, RecordResult.value);
+                }
+            }
+
+            ClosedEarly = PumpMessagesUntil(Closed, std::chrono::steady_clock::now() + mOptions.Duration);
+
+            if (!mOptions.Snapshot.empty()) {
+                const HANDLE Saved = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+                const auto   State = std::make_shared<std::atomic<HRESULT>>(E_PENDING);
+
+                SnapshotResult = mApp->SaveSnapshot(mOptions.Snapshot, [Saved, State](winrt::hresult Completed)
+                {
+                    State->store(Completed.value);
+                    SetEvent(Saved);
+                });
+                if (SUCCEEDED(SnapshotResult)) {
+                    (void)PumpMessagesUntil(Saved, std::chrono::steady_clock::now() + std::chrono::seconds(5));
+                    SnapshotResult = State->load();
+                }
+
+                // Stopping aborts a snapshot that is still pending, the callback may run until then
+                (void)mApp->StopPlay();
+                CloseHandle(Saved);
+            }
+
+            (void)mApp->StopRecording();
+        }
+
+        (void)mApp->StopPlay();
+        mApp->RegisterClosedRevoker(nullptr);
+        CloseHandle(Closed);
+
+        // Queued work, like the closing of capture sessions, finishes before the thread returns
+        const auto Shutdown = Controller.ShutdownQueueAsync();
+        while (Shutdown.Status() == winrt::Windows::Foundation::AsyncStatus::Started) {
+            (void)PumpMessagesUntil(nullptr, std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+        }
+
+        if (!mOptions.Trace.empty()) {
+            Core::Trace::SetEnabled(false);
+            if (!Core::Trace::SaveChromeTrace(mOptions.Trace, TraceStart, std::chrono::steady_clock::now())) {
+                fwprintf(stderr, L"Failed: can not create %ls.\n", mOptions.Trace.c_str());
+            }
+        }
+
+        if (!mOptions.Output.empty()) {
+            if (_wfopen_s(&Output, mOptions.Output.c_str(), L"w") != 0) {
+                fwprintf(stderr, L"Failed: can not create %ls.\n", mOptions.Output.c_str());
+                Output = nullptr;
+            }
+        }
+
+        if (Output) {
+            WriteSummary(Output, Result, ClosedEarly, SnapshotResult);
+            if (Output != stdout) {
+                fclose(Output);
+            }
+        }
+
+        return FAILED(Result) ? static_cast<int>(Result.value) : 0;
+    }
+
+    void Headless::WriteSummary(_In_ FILE* Output, _In_ winrt::hresult Result, _In_ bool ClosedEarly,
+        _In_ winrt::hresult SnapshotResult) const
+    {
+        static constexpr const char* SOURCE_NAMES[] = { "window", "shared-name", "shared-handle", "shared-memory", "replay", "pattern" };
+
+        const auto ToMilliseconds = [](std::chrono::nanoseconds Duration)
+        {
+            return static_cast<double>(Duration.count()) / 1e6;
+        };
+
+        const auto Session = mApp->GetSessionStatistics();
+        const auto Timing  = mApp->GetFrameTimingSummary();
+        const auto Seconds = static_cast<double>(Session.Duration.count()) / 1e9;
+
+        Core::JsonWriter Json(true);
+        Json.BeginObject();
+        Json.Member("version", 1);
+        Json.Member("source", SOURCE_NAMES[static_cast<size_t>(mOptions.Source)]);
+        Json.Member("result", FormatHResult(Result));
+        Json.Member("closed_early", ClosedEarly);
+        Json.Member("duration_ms", ToMilliseconds(Session.Duration));
+        Json.Member("fps", Seconds > 0.0 ? static_cast<double>(Timing.Frames) / Seconds : 0.0);
+
+        Json.Key("frames").BeginObject()
+            .Member("presented", Timing.Frames)
+            .Member("unchanged", Session.UnchangedFrames)
+            .Member("partial_presents", Session.PartialPresents)
+            .Member("dropped", Session.DroppedFrames)
+            .Member("duplicate", Session.DuplicateFrames)
+            .Member("timing_samples_lost", Timing.Dropped)
+            .EndObject();
+
+        Json.Key("stages").BeginObject();
+        for (size_t Index = 0; Index < Core::FRAME_STAGE_COUNT; ++Index) {
+            const auto  Stage = static_cast<Core::FrameStage>(Index);
+            const auto& Item  = Timing[Stage];
+            if (Item.Count == 0) {
+                continue;
+            }
+
+            Json.Key(Core::GetFrameStageName(Stage)).BeginObject()
+                .Member("count", Item.Count)
+                .Member("mean_ms", ToMilliseconds(Item.Mean))
+                .Member("p50_ms", ToMilliseconds(Item.P50))
+                .Member("p95_ms", ToMilliseconds(Item.P95))
+                .Member("p99_ms", ToMilliseconds(Item.P99))
+                .Member("max_ms", ToMilliseconds(Item.Max))
+                .EndObject();
+        }
+        Json.EndObject();
+
+        Json.Key("render").BeginObject()
+            .Member("resource_cache_hits", Session.Render.ResourceCacheHits)
+            .Member("resource_cache_misses", Session.Render.ResourceCacheMisses)
+            .Member("vertex_buffer_updates", Session.Render.VertexBufferUpdates)
+            .EndObject();
+
+        // Counts what the session logged up to here
+        Core::Logger::Flush();
+        const auto Log = Core::Logger::GetStatistics();
+
+        Json.Key("log").BeginObject()
+            .Member("written", Log.Written)
+            .Member("dropped", Log.Dropped)
+            .EndObject();
+
+        if (mOptions.KeyedMutex) {
+            const auto KeyedMutex = mApp->GetKeyedMutexStatistics();
+
+            Json.Key("keyed_mutex").BeginObject()
+                .Member("acquired", KeyedMutex.Acquired)
+                .Member("contended", KeyedMutex.Contended)
+                .Member("repeated", KeyedMutex.Repeated)
+                .Member("skipped", KeyedMutex.Skipped)
+                .Member("total_wait_ms", ToMilliseconds(KeyedMutex.TotalWait))
+                .Member("maximum_wait_ms", ToMilliseconds(KeyedMutex.MaximumWait))
+                .EndObject();
+        }
+
+        if (mOptions.Source == HeadlessSource::Pattern) {
+            Json.Key("pattern").BeginObject()
+                .Member("name", Core::GetTestPatternName(mOptions.Pattern))
+                .Member("width", mOptions.PatternWidth)
+                .Member("height", mOptions.PatternHeight)
+                .Member("rate", mOptions.PatternRate)
+                .EndObject();
+        }
+
+        if (mOptions.LatencyProbe) {
+            const auto Probe = mApp->GetLatencyProbeStatistics();
+
+            Json.Key("latency_probe").BeginObject()
+                .Member("decoded", Probe.Decoded)
+                .Member("undecodable", Probe.Undecodable)
+                .Member("skipped", Probe.Skipped)
+                .Member("repeated", Probe.Repeated)
+                .Member("unobserved", Probe.Unobserved);
+
+            Json.Key("generation_to_present").BeginObject()
+                .Member("count", Probe.GenerationToPresent.Count)
+                .Member("mean_ms", ToMilliseconds(Probe.GenerationToPresent.Mean))
+                .Member("p50_ms", ToMilliseconds(Probe.GenerationToPresent.P50))
+                .Member("p95_ms", ToMilliseconds(Probe.GenerationToPresent.P95))
+                .Member("p99_ms", ToMilliseconds(Probe.GenerationToPresent.P99))
+                .Member("max_ms", ToMilliseconds(Probe.GenerationToPresent.Max))
+                .EndObject();
+
+            Json.EndObject();
+        }
+
+        if (!mOptions.Record.empty()) {
+            const auto Recording = mApp->GetRecordingStatistics();
+
+            Json.Key("recording").BeginObject()
+                .Member("path", ToUtf8(mOptions.Record.native()))
+                .Member("recorded", Recording.Recorded)
+                .Member("dropped", Recording.Dropped)
+                .Member("failed", Recording.Failed)
+                .Member("bytes", Recording.Bytes)
+                .EndObject();
+        }
+
+        if (!mOptions.Trace.empty()) {
+            const auto Trace = Core::Trace::GetStatistics();
+
+            Json.Key("trace").BeginObject()
+                .Member("path", ToUtf8(mOptions.Trace.native()))
+                .Member("spans", Trace.Recorded)
+                .Member("overwritten", Trace.Overwritten)
+                .Member("threads", Trace.Threads)
+                .EndObject();
+        }
+
+        if (!mOptions.Snapshot.empty()) {
+            Json.Key("snapshot").BeginObject()
+                .Member("path", ToUtf8(mOptions.Snapshot.native()))
+                .Member("result", FormatHResult(SnapshotResult))
+                .EndObject();
+        }
+
+        Json.EndObject();
+
+        fprintf(Output, "%s\n", Json.GetString().c_str());
+        fflush(Output);
+    }
+}
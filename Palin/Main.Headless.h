@@ -0,0 +1,88 @@
+#pragma once
+#include "Main.App.h"
+
+
+namespace Mi::Palin
+{
+    enum class HeadlessSource
+    {
+        Window,         // Windows.Graphics.Capture of --window
+        SharedName,
+        SharedHandle,
+        SharedMemory,
+        File,
+        Pattern,
+    };
+
+    struct HeadlessOptions
+    {
+        HeadlessSource Source = HeadlessSource::Window;
+
+        std::wstring Window;            // title, or the handle in hex
+        std::wstring SharedName;        // also the mapping name of SharedMemory
+        HANDLE       SharedHandle = nullptr;
+        HANDLE       SharedFence  = nullptr;
+        bool         NtHandle     = false;
+
+        std::filesystem::path Replay;
+        Core::ReplayTiming    ReplayTiming = Core::ReplayTiming::Original;
+        bool                  Loop = false;
+
+        Core::TestPattern Pattern       = Core::TestPattern::Gradient;
+        uint32_t          PatternWidth  = 1920;
+        uint32_t          PatternHeight = 1080;
+        double            PatternRate   = 60.0;
+        bool              LatencyProbe  = false;
+
+        bool   KeyedMutex = false;
+        UINT32 AcquireKey = 1;
+        UINT32 ReleaseKey = 0;
+        UINT32 Timeout    = INFINITE;
+
+        DXGI_MODE_ROTATION       Rotation   = DXGI_MODE_ROTATION_IDENTITY;
+        Core::FramePacingPolicy  Pacing     = Core::FramePacingPolicy::VSync;
+        double                   TargetRate = 0.0;
+        bool                     LowLatency = false;
+
+        std::chrono::milliseconds Duration{ 10'000 };
+
+        std::filesystem::path Record;
+        std::filesystem::path Snapshot;
+        std::filesystem::path Trace;    // Chrome trace of the session, no tracing if empty
+        std::filesystem::path Output;   // stdout if empty
+        std::filesystem::path LogFile;  // console only if empty
+    };
+
+    // Runs App from the command line without any window or composition visuals and writes a JSON summary
+    // of the session, for automated performance runs and soak tests.
+    class Headless final
+    {
+        std::shared_ptr<App> mApp;
+        HeadlessOptions      mOptions;
+
+    public:
+        explicit Headless(const std::shared_ptr<App>& App);
+        Headless(      Headless&&) = delete;
+        Headless(const Headless& ) = delete;
+        Headless& operator=(      Headless&&) = delete;
+        Headless& operator=(const Headless& ) = delete;
+
+        // True if the command line asks for headless mode.
+        static bool IsRequested(_In_ int Argc, _In_reads_(Argc) wchar_t** Argv);
+
+        static void PrintUsage();
+
+        // Prints what is wrong to stderr and returns E_INVALIDARG for a bad command line.
+        winrt::hresult Parse(_In_ int Argc, _In_reads_(Argc) wchar_t** Argv);
+
+        // Returns the process exit code, 0 or the HRESULT that ended the session.
+        int Run();
+
+    private:
+        winrt::hresult Configure() const;
+        winrt::hresult StartPlay() const;
+
+        void WriteSummary(_In_ FILE* Output, _In_ winrt::hresult Result, _In_ bool ClosedEarly,
+            _In_ winrt::hresult SnapshotResult) const;
+    };
+}
@@ -85,15 +85,24 @@ namespace Mi::Palin
             mApp->RegisterClosedRevoker(nullptr);
         }
 
+        // Stops the enumeration worker before the combo box goes away
+        mWindowList = nullptr;
+
         if (mCboWindows) {
             DestroyWindow(mCboWindows);
         }
+        if (mTxtWindowFilter) {
+            DestroyWindow(mTxtWindowFilter);
+        }
         if (mTxtSharedName) {
             DestroyWindow(mTxtSharedName);
         }
         if (mTxtSharedHandle) {
             DestroyWindow(mTxtSharedHandle);
         }
+        if (mTxtSharedFence) {
+            DestroyWindow(mTxtSharedFence);
+        }
         if (mBtnSwitch) {
             DestroyWindow(mBtnSwitch);
         }
@@ -115,13 +124,24 @@ namespace Mi::Palin
         if (mTxtTimeout) {
             DestroyWindow(mTxtTimeout);
         }
+        if (mChkLowLatency) {
+            DestroyWindow(mChkLowLatency);
+        }
+        if (mChkSharedMemory) {
+            DestroyWindow(mChkSharedMemory);
+        }
         if (mBtnLogging) {
             DestroyWindow(mCboWindows);
         }
+        if (mBtnRecord) {
+            DestroyWindow(mBtnRecord);
+        }
 
         mCboWindows      = nullptr;
+        mTxtWindowFilter = nullptr;
         mTxtSharedName   = nullptr;
         mTxtSharedHandle = nullptr;
+        mTxtSharedFence  = nullptr;
         mBtnSwitch       = nullptr;
         mCboRotationMode = nullptr;
         mChkNtHandle     = nullptr;
@@ -129,7 +149,10 @@ namespace Mi::Palin
         mTxtAcquireKey   = nullptr;
         mTxtReleaseKey   = nullptr;
         mTxtTimeout      = nullptr;
+        mChkLowLatency   = nullptr;
+        mChkSharedMemory = nullptr;
         mBtnLogging      = nullptr;
+        mBtnRecord       = nullptr;
 
         mBrush           = nullptr;
         mContent         = nullptr;
@@ -154,16 +177,22 @@ namespace Mi::Palin
         mCboWindows = winrt::check_pointer(Controls.CreateControl(Window::ControlType::ComboBox, L""));
 
         // Populate window combo box and register for updates
-        mWindowList = std::make_unique<Core::WindowList>();
+        mWindowList = std::make_unique<Core::WindowList>(mDispatcherQueueController.DispatcherQueue());
         winrt::check_pointer(mWindowList.get());
         mWindowList->RegisterComboBoxForUpdates(mCboWindows);
 
+        winrt::check_pointer(Controls.CreateControl(Window::ControlType::Label, L"Find Window:"));
+        mTxtWindowFilter = winrt::check_pointer(Controls.CreateControl(Window::ControlType::Edit, L""));
+
         winrt::check_pointer(Controls.CreateControl(Window::ControlType::Label, L"Shared Name:"));
         mTxtSharedName = winrt::check_pointer(Controls.CreateControl(Window::ControlType::Edit, L""));
 
         winrt::check_pointer(Controls.CreateControl(Window::ControlType::Label, L"Shared Handle (Hex):"));
         mTxtSharedHandle = winrt::check_pointer(Controls.CreateControl(Window::ControlType::Edit, L""));
 
+        winrt::check_pointer(Controls.CreateControl(Window::ControlType::Label, L"Shared Fence (Hex, Optional):"));
+        mTxtSharedFence = winrt::check_pointer(Controls.CreateControl(Window::ControlType::Edit, L""));
+
         mBtnSwitch = winrt::check_pointer(Controls.CreateControl(Window::ControlType::Button, L"Start", 0,
             -1, -1, -1, 48));
         
@@ -211,8 +240,15 @@ namespace Mi::Palin
         winrt::check_pointer(Controls.CreateControl(Window::ControlType::Label, L"Timeout:"));
         mTxtTimeout = winrt::check_pointer(Controls.CreateControl(Window::ControlType::Edit, L"-1", WS_DISABLED));
 
+        mChkLowLatency   = winrt::check_pointer(Controls.CreateControl(Window::ControlType::CheckBox, L"Low Latency",
+            0, -1, -1, Width / 2 - MarginX - 10));
+        mChkSharedMemory = winrt::check_pointer(Controls.CreateControl(Window::ControlType::CheckBox, L"Shared Memory",
+            0, Width / 2, -StepAmount, Width / 2 - 4));
+
         mBtnLogging = winrt::check_pointer(Controls.CreateControl(Window::ControlType::Button, L"Turn on logging", 0,
-            -1, -1, -1, 48));
+            -1, -1, Width / 2 - MarginX - 10, 48));
+        mBtnRecord  = winrt::check_pointer(Controls.CreateControl(Window::ControlType::Button, L"Start recording", 0,
+            Width / 2, -(StepAmount + 48 / 2), Width / 2 - 4, 48));
     }
 
     LRESULT MainWindow::MessageHandler(
@@ -287,12 +323,25 @@ namespace Mi::Palin
 
     LRESULT MainWindow::Edit_Changed(HWND Sender)
     {
+        if (Sender == mTxtWindowFilter) {
+            // The best match for title, class or process name is selected as the user types
+            wchar_t Query[Core::TrigramIndex::MAXIMUM_QUERY_LENGTH + 1]{};
+            (void)Edit_GetText(Sender, Query, _countof(Query));
+
+            const auto Results = mWindowList->Search(Query, 1);
+            if (!Results.empty()) {
+                ComboBox_SetCurSel(mCboWindows, static_cast<int>(Results.front().Index));
+            }
+        }
         if (Sender == mTxtSharedName) {
+            // Shared fences can only be opened by handle
             if (Edit_GetTextLength(Sender) > 0) {
                 Edit_Enable(mTxtSharedHandle, FALSE);
+                Edit_Enable(mTxtSharedFence, FALSE);
             }
             else {
                 Edit_Enable(mTxtSharedHandle, TRUE);
+                Edit_Enable(mTxtSharedFence, TRUE);
             }
         }
         if (Sender == mTxtSharedHandle) {
@@ -330,6 +379,30 @@ namespace Mi::Palin
             return 0;
         }
 
+        if (Sender == mBtnRecord) {
+            if (mRecording) {
+                (void)mApp->StopRecording();
+
+                mRecording = false;
+                Button_SetText(Sender, L"Start recording");
+            }
+            else {
+                SYSTEMTIME Time{};
+                GetLocalTime(&Time);
+
+                wchar_t Path[MAX_PATH]{};
+                swprintf_s(Path, L"Palin-%04u%02u%02u-%02u%02u%02u.plrc",
+                    Time.wYear, Time.wMonth, Time.wDay, Time.wHour, Time.wMinute, Time.wSecond);
+
+                if (SUCCEEDED(mApp->StartRecording(Path))) {
+                    mRecording = true;
+                    Button_SetText(Sender, L"Stop recording");
+                }
+            }
+
+            return 0;
+        }
+
         if (Sender == mBtnSwitch) {
             if (mStarted) {
                 if (SUCCEEDED(mApp->StopPlay())) {
@@ -393,6 +466,12 @@ namespace Mi::Palin
                         mApp->SetKeyedMutex(true, AcquireKey, ReleaseKey, Timeout);
                     }
 
+                    // Low Latency
+                    if (FAILED(mApp->SetLowLatencyMode(Button_GetCheck(mChkLowLatency) == BST_CHECKED))) {
+                        MessageBox(mMainWindow, L"Failed: Low latency mode.", TITLE_NAME, MB_OK | MB_ICONERROR);
+                        break;
+                    }
+
                     if (IsWindowEnabled(mTxtSharedName) && (Edit_GetTextLength(mTxtSharedName) > 0)) {
                         wchar_t SharedName[256]{};
                         if (Edit_GetText(mTxtSharedName, SharedName, _countof(SharedName)) == 0) {
@@ -400,7 +479,11 @@ namespace Mi::Palin
                             break;
                         }
 
-                        if (FAILED(mApp->StartPlay(TargetWindow, SharedName))) {
+                        // With Shared Memory the name is the file mapping of a CPU frame ring
+                        const auto Result = (Button_GetCheck(mChkSharedMemory) == BST_CHECKED)
+                            ? mApp->StartPlayFromMemory(TargetWindow, SharedName)
+                            : mApp->StartPlay(TargetWindow, SharedName);
+                        if (FAILED(Result)) {
                             MessageBox(mMainWindow, L"Failed: Start failed. (1)", TITLE_NAME, MB_OK | MB_ICONERROR);
                             break;
                         }
@@ -412,21 +495,35 @@ namespace Mi::Palin
                     }
                     else {
                         if (Edit_GetTextLength(mTxtSharedHandle) > 0) {
-                            wchar_t Buffer[64]{};
-                            if (Edit_GetText(mTxtSharedHandle, Buffer, _countof(Buffer)) == 0) {
+                            const auto GetHandle = [](HWND Edit, HANDLE& Handle)
+                            {
+                                wchar_t Buffer[64]{};
+                                if (Edit_GetText(Edit, Buffer, _countof(Buffer)) == 0) {
+                                    return false;
+                                }
+
+                                if (Buffer[0] == L'0' && (Buffer[1] == L'x' || Buffer[1] == L'X')) {
+                                    Handle = reinterpret_cast<HANDLE>(static_cast<size_t>(std::stoull(&Buffer[2], nullptr, 16)));
+                                }
+                                else {
+                                    Handle = reinterpret_cast<HANDLE>(static_cast<size_t>(std::stoull(&Buffer[0], nullptr, 16)));
+                                }
+                                return true;
+                            };
+
+                            HANDLE SharedHandle = nullptr;
+                            if (!GetHandle(mTxtSharedHandle, SharedHandle)) {
                                 MessageBox(mMainWindow, L"Invalid: Shared Handle.", TITLE_NAME, MB_OK | MB_ICONERROR);
                                 break;
                             }
 
-                            HANDLE SharedHandle;
-                            if (Buffer[0] == L'0' && (Buffer[1] == L'x' || Buffer[1] == L'X')) {
-                                SharedHandle = reinterpret_cast<HANDLE>(static_cast<size_t>(std::stoull(&Buffer[2], nullptr, 16)));
-                            }
-                            else {
-                                SharedHandle = reinterpret_cast<HANDLE>(static_cast<size_t>(std::stoull(&Buffer[0], nullptr, 16)));
+                            HANDLE SharedFence = nullptr;
+                            if (Edit_GetTextLength(mTxtSharedFence) > 0 && !GetHandle(mTxtSharedFence, SharedFence)) {
+                                MessageBox(mMainWindow, L"Invalid: Shared Fence.", TITLE_NAME, MB_OK | MB_ICONERROR);
+                                break;
                             }
 
-                            if (FAILED(mApp->StartPlay(TargetWindow, SharedHandle, Button_GetCheck(mChkNtHandle)))) {
+                            if (FAILED(mApp->StartPlay(TargetWindow, SharedHandle, Button_GetCheck(mChkNtHandle), SharedFence))) {
                                 MessageBox(mMainWindow, L"Failed: Start failed. (2)", TITLE_NAME, MB_OK | MB_ICONERROR);
                                 break;
                             }
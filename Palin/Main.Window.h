@@ -15,8 +15,10 @@ namespace Mi::Palin
 
         // Controls
         HWND mCboWindows        = nullptr;
+        HWND mTxtWindowFilter   = nullptr;
         HWND mTxtSharedName     = nullptr;
         HWND mTxtSharedHandle   = nullptr;
+        HWND mTxtSharedFence    = nullptr;
         HWND mBtnSwitch         = nullptr;
         HWND mCboRotationMode   = nullptr;
         HWND mChkNtHandle       = nullptr;
@@ -24,10 +26,14 @@ namespace Mi::Palin
         HWND mTxtAcquireKey     = nullptr;
         HWND mTxtReleaseKey     = nullptr;
         HWND mTxtTimeout        = nullptr;
+        HWND mChkLowLatency     = nullptr;
+        HWND mChkSharedMemory   = nullptr;
         HWND mBtnLogging        = nullptr;
+        HWND mBtnRecord         = nullptr;
 
         bool mStarted           = false;
         bool mLogging           = false;
+        bool mRecording         = false;
         std::unique_ptr<Core::WindowList> mWindowList;
 
         // Compositions
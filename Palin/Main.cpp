@@ -1,5 +1,9 @@
 #include "Main.App.h"
 #include "Main.Window.h"
+#include "Main.Headless.h"
+#include "Main.Benchmark.h"
+#include "Core.Console.h"
+#include "Core.Trace.h"
 
 
 namespace Mi::Palin
@@ -13,6 +17,79 @@ namespace Mi::Palin
     {
         winrt::init_apartment(winrt::apartment_type::single_threaded);
 
+        int   Argc = 0;
+        const auto Argv = CommandLineToArgvW(GetCommandLineW(), &Argc);
+
+        if (Argv && Benchmark::IsRequested(Argc, Argv)) {
+            if (!Core::AttachParentConsole()) {
+                Core::RedirectIOToConsole(5000);
+            }
+
+            int ExitCode = 0;
+            try {
+                auto Runner = Benchmark();
+
+                const auto Result = Runner.Parse(Argc, Argv);
+                if (Result == S_OK) {
+                    ExitCode = Runner.Run();
+                }
+                else if (FAILED(Result)) {
+                    Benchmark::PrintUsage();
+                    ExitCode = Result;
+                }
+            }
+            catch (const winrt::hresult_error& Result) {
+                ExitCode = Result.code();
+            }
+
+            LocalFree(Argv);
+            return ExitCode;
+        }
+
+        if (Argv && Headless::IsRequested(Argc, Argv)) {
+            if (!Core::AttachParentConsole()) {
+                Core::RedirectIOToConsole(5000);
+            }
+
+            int ExitCode = 0;
+            try {
+                const auto App    = std::make_shared<Palin::App>();
+                auto       Runner = Headless(App);
+
+                const auto Result = Runner.Parse(Argc, Argv);
+                if (Result == S_OK) {
+                    ExitCode = Runner.Run();
+                }
+                else if (FAILED(Result)) {
+                    Headless::PrintUsage();
+                    ExitCode = Result;
+                }
+
+                App->Close();
+            }
+            catch (const winrt::hresult_error& Result) {
+                ExitCode = Result.code();
+            }
+
+            LocalFree(Argv);
+            return ExitCode;
+        }
+
+        // Traces the whole run, the spans are written when the window closes
+        std::filesystem::path TracePath;
+        for (int Index = 1; Argv && Index + 1 < Argc; ++Index) {
+            if (_wcsicmp(Argv[Index], L"--trace") == 0) {
+                TracePath = Argv[Index + 1];
+            }
+        }
+        LocalFree(Argv);
+
+        const auto TraceStart = std::chrono::steady_clock::now();
+        if (!TracePath.empty()) {
+            Core::Trace::SetThreadName("MainWindow");
+            Core::Trace::SetEnabled(true);
+        }
+
         const auto App    = std::make_shared<Palin::App>();
         auto       Window = MainWindow(App);
 
@@ -26,6 +103,10 @@ namespace Mi::Palin
 
         App->Close();
 
+        if (!TracePath.empty() && !Core::Trace::SaveChromeTrace(TracePath, TraceStart, std::chrono::steady_clock::now())) {
+            LOG(ERROR, "wWinMain(), can not write the trace to %ls.", TracePath.c_str());
+        }
+
         return S_OK;
     }
 
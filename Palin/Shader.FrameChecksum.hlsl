@@ -0,0 +1,49 @@
+// Tile checksums, must stay bit-exact with Mi::Core::ComputeTileChecksums (Core.FrameChecksum.cpp).
+
+#define TILE_SIZE 32
+
+Texture2D<float4> Source : register( t0 );
+RWStructuredBuffer<uint> Checksums : register( u0 );
+
+cbuffer Constants : register( b0 )
+{
+    uint Width;
+    uint Height;
+    uint TilesX;
+    uint Reserved;
+};
+
+groupshared uint TileSum;
+
+uint MixPixel(uint Pixel, uint Index)
+{
+    uint Hash = Pixel ^ (Index * 0x9E3779B1u);
+    Hash ^= Hash >> 16;
+    Hash *= 0x85EBCA6Bu;
+    Hash ^= Hash >> 13;
+    Hash *= 0xC2B2AE35u;
+    Hash ^= Hash >> 16;
+    return Hash;
+}
+
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void CS(uint3 GroupId : SV_GroupID, uint3 ThreadId : SV_DispatchThreadID, uint GroupIndex : SV_GroupIndex)
+{
+    if (GroupIndex == 0) {
+        TileSum = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (ThreadId.x < Width && ThreadId.y < Height) {
+        // UNORM8 -> float -> UNORM8 is exact, repack in B8G8R8A8 memory order
+        const uint4 Color = uint4(round(saturate(Source.Load(int3(ThreadId.xy, 0))) * 255.0f));
+        const uint  Pixel = Color.b | (Color.g << 8) | (Color.r << 16) | (Color.a << 24);
+
+        InterlockedAdd(TileSum, MixPixel(Pixel, ThreadId.y * Width + ThreadId.x));
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (GroupIndex == 0) {
+        Checksums[GroupId.y * TilesX + GroupId.x] = TileSum;
+    }
+}
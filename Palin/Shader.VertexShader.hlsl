@@ -0,0 +1,16 @@
+struct VS_INPUT
+{
+    float4 Pos : POSITION;
+    float2 Tex : TEXCOORD;
+};
+
+struct VS_OUTPUT
+{
+    float4 Pos : SV_POSITION;
+    float2 Tex : TEXCOORD;
+};
+
+VS_OUTPUT VS(VS_INPUT input)
+{
+    return input;
+}
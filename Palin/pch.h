@@ -32,6 +32,9 @@
 #include <optional>
 #include <future>
 #include <mutex>
+#include <chrono>
+#include <filesystem>
+#include <string_view>
 
 // D3D
 #include <d3d11_4.h>
@@ -48,12 +51,10 @@
 EXTERN_C IMAGE_DOS_HEADER __ImageBase;
 #define HINST_THISCOMPONENT ((HINSTANCE)&__ImageBase)
 
+// Logging, records are formatted and written by the background thread of Core::Logger
+#include "Core.Logger.h"
+
 #define LOG_ERROR 0
 #define LOG_INFO  1
 #define LOG(Tag, fmt, ...) \
-    if constexpr (LOG_##Tag == LOG_ERROR){ \
-        fprintf(stderr, "[Mi.Palin][!] " fmt "\n", ## __VA_ARGS__); \
-    } \
-    else if constexpr(LOG_##Tag == LOG_INFO) { \
-        fprintf(stdout, "[Mi.Palin][+] " fmt "\n", ## __VA_ARGS__); \
-    }
+    ::Mi::Core::Logger::Write(static_cast<::Mi::Core::LogLevel>(LOG_##Tag), fmt, ## __VA_ARGS__)
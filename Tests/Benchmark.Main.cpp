@@ -0,0 +1,109 @@
+#include "Core.Benchmark.h"
+
+
+// The CPU half of Mi.Palin.exe --benchmark, for machines without Windows. The JSON is the same, the adapter is
+// empty, so Tools/Compare-Benchmark.ps1 compares the results of either.
+int main(int Argc, char** Argv)
+{
+    using namespace Mi::Core;
+
+    BenchmarkOptions      Options;
+    std::filesystem::path OutputPath;
+
+    for (int Index = 1; Index < Argc; ++Index) {
+        const std::string_view Name = Argv[Index];
+
+        if (Name == "--help" || Name == "-?") {
+            fprintf(stderr,
+                "Usage: Palin.Benchmark [options]\n"
+                "\n"
+                "  --filter <text>                only benchmarks whose name contains the text\n"
+                "  --sample-time <ms>             default 50, the time one sample is calibrated to\n"
+                "  --samples <count>              default 15\n"
+                "  --output <path>                JSON results, stdout if omitted\n");
+            return 0;
+        }
+
+        if (Index + 1 >= Argc) {
+            fprintf(stderr, "Invalid: %s needs a value.\n", Argv[Index]);
+            return 1;
+        }
+        const char* Value = Argv[++Index];
+
+        char* End = nullptr;
+        if (Name == "--filter") {
+            Options.Filter = Value;
+        }
+        else if (Name == "--sample-time") {
+            const unsigned long Milliseconds = strtoul(Value, &End, 10);
+            if (End == Value || *End != '\0' || Milliseconds == 0 || Milliseconds > 60'000) {
+                fprintf(stderr, "Invalid: %s %s\n", Argv[Index - 1], Value);
+                return 1;
+            }
+            Options.SampleTime = std::chrono::milliseconds(Milliseconds);
+        }
+        else if (Name == "--samples") {
+            const unsigned long Samples = strtoul(Value, &End, 10);
+            if (End == Value || *End != '\0' || Samples == 0 || Samples > 1'000) {
+                fprintf(stderr, "Invalid: %s %s\n", Argv[Index - 1], Value);
+                return 1;
+            }
+            Options.Samples = static_cast<uint32_t>(Samples);
+        }
+        else if (Name == "--output") {
+            OutputPath = Value;
+        }
+        else {
+            fprintf(stderr, "Invalid: unknown option %s\n", Argv[Index - 1]);
+            return 1;
+        }
+    }
+
+    // The log shares stdout with the JSON, it only goes out next to a file
+    if (OutputPath.empty()) {
+        Logger::SetConsole(false);
+    }
+
+    BenchmarkSuite Suite;
+    AddKernelBenchmarks(Suite);
+
+    const auto Results = Suite.Run(Options);
+
+    JsonWriter Json(true);
+    Json.BeginObject();
+    Json.Member("version", 1);
+
+    Json.Key("machine").BeginObject()
+        .Member("processors", std::thread::hardware_concurrency())
+        .Member("adapter", "")
+        .EndObject();
+
+    Json.Member("sample_time_ms", static_cast<int64_t>(Options.SampleTime.count()));
+    Json.Key("benchmarks");
+    BenchmarkSuite::WriteResults(Json, Results);
+    Json.EndObject();
+
+    Logger::Flush();
+
+    FILE* Output = stdout;
+    if (!OutputPath.empty()) {
+        Output = fopen(OutputPath.string().c_str(), "w");
+        if (Output == nullptr) {
+            fprintf(stderr, "Failed: can not create %s.\n", OutputPath.string().c_str());
+            return 1;
+        }
+    }
+
+    fprintf(Output, "%s\n", Json.GetString().c_str());
+    fflush(Output);
+    if (Output != stdout) {
+        fclose(Output);
+    }
+
+    // Every kernel runs on any CPU, one that skips is broken
+    const auto Skipped = std::count_if(Results.begin(), Results.end(), [](const BenchmarkResult& Result)
+    {
+        return Result.Skipped;
+    });
+    return static_cast<int>(Skipped);
+}
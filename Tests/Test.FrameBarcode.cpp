@@ -0,0 +1,148 @@
+#include "Test.h"
+#include "Core.FrameBarcode.h"
+#include "Core.TestPattern.h"
+
+
+namespace Mi::Core
+{
+    // A B8G8R8A8 frame with a few bytes of row padding, like a mapped texture
+    struct BarcodeFrame
+    {
+        uint32_t             Width  = 0;
+        uint32_t             Height = 0;
+        uint32_t             Pitch  = 0;
+        std::vector<uint8_t> Pixels;
+
+        BarcodeFrame(_In_ uint32_t FrameWidth, _In_ uint32_t FrameHeight)
+            : Width(FrameWidth)
+            , Height(FrameHeight)
+            , Pitch(FrameWidth * 4 + 64)
+            , Pixels(static_cast<size_t>(Pitch) * FrameHeight, 0x40)
+        {
+        }
+
+        bool Write(_In_ const FrameBarcode& Barcode)
+        {
+            return WriteFrameBarcode(Barcode, Pixels.data(), Pitch, Width, Height);
+        }
+
+        [[nodiscard]] std::optional<FrameBarcode> Read() const
+        {
+            return ReadFrameBarcode(Pixels.data(), Pitch, Width, Height);
+        }
+
+        // Inverts column X on every row of the strip
+        void InvertColumn(_In_ uint32_t X)
+        {
+            for (uint32_t Row = 0; Row < GetFrameBarcodeHeight(Width); ++Row) {
+                uint8_t* Pixel = Pixels.data() + static_cast<size_t>(Row) * Pitch + static_cast<size_t>(X) * 4;
+                for (int Channel = 0; Channel < 3; ++Channel) {
+                    Pixel[Channel] = static_cast<uint8_t>(~Pixel[Channel]);
+                }
+            }
+        }
+    };
+
+    static bool operator==(_In_ const FrameBarcode& Left, _In_ const FrameBarcode& Right)
+    {
+        return Left.Sequence == Right.Sequence && Left.Timestamp == Right.Timestamp;
+    }
+
+    TEST_CASE(FrameBarcode_Height)
+    {
+        CHECK_EQUAL(GetFrameBarcodeHeight(0), 0u);
+        CHECK_EQUAL(GetFrameBarcodeHeight(FRAME_BARCODE_MINIMUM_WIDTH - 1), 0u);
+        CHECK_EQUAL(GetFrameBarcodeHeight(FRAME_BARCODE_MINIMUM_WIDTH), 4u);
+        CHECK_EQUAL(GetFrameBarcodeHeight(1920), 1920u / FRAME_BARCODE_BITS);
+    }
+
+    TEST_CASE(FrameBarcode_RoundTrip)
+    {
+        const FrameBarcode Barcodes[] = {
+            { 0, 0 },
+            { 1, 16'666'667 },
+            { 0x0123456789ABCDEF, 0xFEDCBA9876543210 },
+            { UINT64_MAX, UINT64_MAX },
+        };
+
+        for (const uint32_t Width : { FRAME_BARCODE_MINIMUM_WIDTH, 333u, 1280u, 1920u, 3840u }) {
+            for (const auto& Barcode : Barcodes) {
+                BarcodeFrame Frame(Width, 64);
+                CHECK(Frame.Write(Barcode));
+
+                const auto Decoded = Frame.Read();
+                CHECK(Decoded.has_value());
+                CHECK(Decoded.value_or(FrameBarcode{ 1, 1 }) == Barcode);
+            }
+        }
+    }
+
+    TEST_CASE(FrameBarcode_OverTestPatterns)
+    {
+        for (const auto Pattern : { TestPattern::Gradient, TestPattern::Checkerboard, TestPattern::ScrollingText, TestPattern::Noise }) {
+            BarcodeFrame Frame(640, 360);
+            DrawTestPattern(Pattern, 42, Frame.Pixels.data(), Frame.Pitch, Frame.Width, Frame.Height);
+
+            // The pattern alone is not a barcode
+            CHECK(!Frame.Read().has_value());
+
+            const FrameBarcode Barcode{ 43, 123'456'789 };
+            CHECK(Frame.Write(Barcode));
+            CHECK(Frame.Read().value_or(FrameBarcode{}) == Barcode);
+        }
+    }
+
+    TEST_CASE(FrameBarcode_ScaledHorizontally)
+    {
+        BarcodeFrame Source(1920, 32);
+        const FrameBarcode Barcode{ 7, 1'000'000'007 };
+        CHECK(Source.Write(Barcode));
+
+        // Nearest neighbour down to two thirds, the strip keeps the height it has for the source width
+        BarcodeFrame Scaled(1280, 32);
+        for (uint32_t Row = 0; Row < Scaled.Height; ++Row) {
+            for (uint32_t X = 0; X < Scaled.Width; ++X) {
+                const uint32_t SourceX = X * Source.Width / Scaled.Width;
+                std::memcpy(Scaled.Pixels.data() + static_cast<size_t>(Row) * Scaled.Pitch + X * 4,
+                    Source.Pixels.data() + static_cast<size_t>(Row) * Source.Pitch + SourceX * 4, 4);
+            }
+        }
+
+        CHECK(Scaled.Read().value_or(FrameBarcode{}) == Barcode);
+    }
+
+    TEST_CASE(FrameBarcode_EveryFlippedCellIsRejected)
+    {
+        constexpr uint32_t WIDTH = FRAME_BARCODE_BITS * 4;
+
+        BarcodeFrame Frame(WIDTH, 16);
+        CHECK(Frame.Write({ 0x5555AAAA5555AAAA, 0x0F0F0F0F0F0F0F0F }));
+
+        // Sync, payload and checksum, a single wrong cell anywhere must not decode to another frame
+        uint32_t Accepted = 0;
+        for (uint32_t Cell = 0; Cell < FRAME_BARCODE_BITS; ++Cell) {
+            BarcodeFrame Damaged = Frame;
+            Damaged.InvertColumn(Cell * 4 + 2);
+            if (Damaged.Read().has_value()) {
+                ++Accepted;
+            }
+        }
+        CHECK_EQUAL(Accepted, 0u);
+    }
+
+    TEST_CASE(FrameBarcode_TooSmall)
+    {
+        BarcodeFrame Narrow(FRAME_BARCODE_MINIMUM_WIDTH - 1, 64);
+        CHECK(!Narrow.Write({ 1, 1 }));
+        CHECK(!Narrow.Read().has_value());
+
+        // Shorter than the strip
+        BarcodeFrame Flat(1920, 4);
+        CHECK(!Flat.Write({ 1, 1 }));
+
+        // Rows shorter than the width
+        BarcodeFrame Frame(640, 64);
+        CHECK(!WriteFrameBarcode({ 1, 1 }, Frame.Pixels.data(), 640 * 4 - 4, 640, 64));
+        CHECK(!ReadFrameBarcode(Frame.Pixels.data(), 640 * 4 - 4, 640, 64).has_value());
+    }
+}
@@ -0,0 +1,88 @@
+#include "Test.h"
+#include "Core.FrameChecksum.h"
+
+
+namespace Mi::Core
+{
+    // The expected values come from a separate implementation of the hash in Shader.FrameChecksum.hlsl, the CPU
+    // reference and the shader must both keep producing them
+    TEST_CASE(FrameChecksum_MixPixelVectors)
+    {
+        CHECK_EQUAL(MixChecksumPixel(0x00000000u, 0),                 0x00000000u);
+        CHECK_EQUAL(MixChecksumPixel(0xFF0000FFu, 0),                 0xB047A41Bu);
+        CHECK_EQUAL(MixChecksumPixel(0x12345678u, 1),                 0xFE578E5Fu);
+        CHECK_EQUAL(MixChecksumPixel(0xFFFFFFFFu, 1920 * 1080 - 1),   0x0C1CA177u);
+    }
+
+    // 40 x 33 crosses a tile boundary in both directions, the edge tiles are partial
+    TEST_CASE(FrameChecksum_TileVectors)
+    {
+        static constexpr uint32_t WIDTH  = 40;
+        static constexpr uint32_t HEIGHT = 33;
+        static constexpr uint32_t PITCH  = WIDTH * 4 + 8;       // padding that must not be read
+
+        std::vector<uint8_t> Pixels(static_cast<size_t>(PITCH) * HEIGHT, 0xCD);
+        for (uint32_t Y = 0; Y < HEIGHT; ++Y) {
+            for (uint32_t X = 0; X < WIDTH; ++X) {
+                const uint32_t Pixel = (X * 0x01020304u) ^ (Y * 0x10203041u) ^ 0xA5000000u;
+                memcpy(Pixels.data() + static_cast<size_t>(Y) * PITCH + X * 4, &Pixel, sizeof(Pixel));
+            }
+        }
+
+        CHECK_EQUAL(GetChecksumTilesX(WIDTH),  2u);
+        CHECK_EQUAL(GetChecksumTilesY(HEIGHT), 2u);
+
+        uint32_t Checksums[4]{};
+        ComputeTileChecksums(Pixels.data(), WIDTH, HEIGHT, PITCH, Checksums);
+
+        CHECK_EQUAL(Checksums[0], 0x51597B5Cu);
+        CHECK_EQUAL(Checksums[1], 0x4C539901u);
+        CHECK_EQUAL(Checksums[2], 0xFEA771F2u);
+        CHECK_EQUAL(Checksums[3], 0x0132F2EEu);
+    }
+
+    TEST_CASE(FrameChecksum_ChangeTouchesOneTile)
+    {
+        static constexpr uint32_t WIDTH  = 96;
+        static constexpr uint32_t HEIGHT = 64;
+        static constexpr uint32_t PITCH  = WIDTH * 4;
+        static constexpr size_t   TILES  = 3 * 2;
+
+        std::vector<uint8_t> Pixels(static_cast<size_t>(PITCH) * HEIGHT);
+        for (size_t Index = 0; Index < Pixels.size(); ++Index) {
+            Pixels[Index] = static_cast<uint8_t>(Index * 31);
+        }
+
+        uint32_t Before[TILES]{};
+        ComputeTileChecksums(Pixels.data(), WIDTH, HEIGHT, PITCH, Before);
+
+        // One channel of one pixel in the middle tile of the bottom row
+        Pixels[static_cast<size_t>(40) * PITCH + 50 * 4 + 2] ^= 0x01;
+
+        uint32_t After[TILES]{};
+        ComputeTileChecksums(Pixels.data(), WIDTH, HEIGHT, PITCH, After);
+
+        CHECK_EQUAL(CompareTileChecksums(Before, After, TILES), 1u);
+        CHECK(Before[4] != After[4]);
+        CHECK_EQUAL(CompareTileChecksums(Before, Before, TILES), 0u);
+    }
+
+    // Swapping two pixels keeps a plain sum, the index mixed into every pixel catches it
+    TEST_CASE(FrameChecksum_SwappedPixelsDiffer)
+    {
+        static constexpr uint32_t WIDTH = 32;
+
+        std::vector<uint8_t> Pixels(static_cast<size_t>(WIDTH) * 4);
+        Pixels[0] = 0xFF;
+
+        uint32_t Before = 0;
+        ComputeTileChecksums(Pixels.data(), WIDTH, 1, WIDTH * 4, &Before);
+
+        std::swap(Pixels[0], Pixels[4]);
+
+        uint32_t After = 0;
+        ComputeTileChecksums(Pixels.data(), WIDTH, 1, WIDTH * 4, &After);
+
+        CHECK(Before != After);
+    }
+}
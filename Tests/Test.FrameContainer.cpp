@@ -0,0 +1,214 @@
+#include "Test.h"
+#include "Core.FrameContainer.h"
+
+
+namespace Mi::Core
+{
+    static constexpr uint32_t TEST_WIDTH  = 5;
+    static constexpr uint32_t TEST_HEIGHT = 3;
+    static constexpr uint32_t TEST_STRIDE = TEST_WIDTH * 4 + 4;
+
+    // The whole file, 8 byte aligned like a mapping would be
+    struct ContainerFile
+    {
+        std::vector<uint64_t> Words;
+        size_t                Size = 0;
+
+        [[nodiscard]] uint8_t* GetData() noexcept { return reinterpret_cast<uint8_t*>(Words.data()); }
+
+        [[nodiscard]] FrameContainerHeader& GetHeader() noexcept
+        {
+            return *reinterpret_cast<FrameContainerHeader*>(GetData());
+        }
+    };
+
+    static std::filesystem::path GetTestPath()
+    {
+        return std::filesystem::temp_directory_path() / "Palin.Test.FrameContainer.plrc";
+    }
+
+    static std::vector<uint8_t> MakePixels(_In_ uint8_t Seed)
+    {
+        std::vector<uint8_t> Pixels(TEST_STRIDE * TEST_HEIGHT);
+        for (size_t Index = 0; Index < Pixels.size(); ++Index) {
+            Pixels[Index] = static_cast<uint8_t>(Seed + Index * 7);
+        }
+        return Pixels;
+    }
+
+    // Frames at 0, 16 and 33 ms, the second with two dirty rects
+    static ContainerFile WriteTestContainer()
+    {
+        const auto Path = GetTestPath();
+        {
+            FrameContainerWriter Writer;
+            CHECK(Writer.Open(Path));
+
+            const FrameRect Rects[] = { { 0, 0, 2, 1 }, { 3, 1, 5, 3 } };
+            const uint64_t  Timestamps[] = { 0, 16'000'000, 33'000'000 };
+
+            for (uint32_t Index = 0; Index < 3; ++Index) {
+                FrameRecordHeader Header{};
+                Header.Timestamp      = Timestamps[Index];
+                Header.Sequence       = Index + 1;
+                Header.Width          = TEST_WIDTH;
+                Header.Height         = TEST_HEIGHT;
+                Header.Stride         = TEST_STRIDE;
+                Header.Format         = 87;     // DXGI_FORMAT_B8G8R8A8_UNORM
+                Header.DirtyRectCount = Index == 1 ? 2 : 0;
+
+                const auto Pixels = MakePixels(static_cast<uint8_t>(Index * 50));
+                CHECK(Writer.Append(Header, Index == 1 ? Rects : nullptr, Pixels.data()));
+            }
+            CHECK_EQUAL(Writer.GetFrameCount(), uint64_t{ 3 });
+            CHECK(Writer.Finish());
+            CHECK(!Writer.IsOpen());
+        }
+
+        ContainerFile File;
+        File.Size = static_cast<size_t>(std::filesystem::file_size(Path));
+        File.Words.resize((File.Size + 7) / 8);
+
+        std::ifstream Stream(Path, std::ios::binary);
+        Stream.read(reinterpret_cast<char*>(File.GetData()), static_cast<std::streamsize>(File.Size));
+        CHECK(!!Stream);
+        Stream.close();
+
+        std::filesystem::remove(Path);
+        return File;
+    }
+
+    // What a recording that stopped without Finish() leaves behind: the records, no index
+    static void StripIndex(_Inout_ ContainerFile& File)
+    {
+        File.Size = static_cast<size_t>(File.GetHeader().IndexOffset);
+        File.GetHeader().IndexOffset = 0;
+        File.GetHeader().FrameCount  = 0;
+    }
+
+    static bool CheckFrame(_In_ const FrameContainerReader& Reader, _In_ uint64_t Index)
+    {
+        const auto Frame = Reader.GetFrame(Index);
+        if (!Frame) {
+            return false;
+        }
+
+        const auto Pixels = MakePixels(static_cast<uint8_t>(Index * 50));
+        return Frame->Header->Sequence == Index + 1
+            && Frame->Header->Width    == TEST_WIDTH
+            && Frame->Header->Height   == TEST_HEIGHT
+            && Frame->Header->Stride   == TEST_STRIDE
+            && Frame->Header->PayloadSize == Pixels.size()
+            && Frame->Header->RecordSize % FRAME_CONTAINER_ALIGNMENT == 0
+            && std::memcmp(Frame->Pixels, Pixels.data(), Pixels.size()) == 0;
+    }
+
+    TEST_CASE(FrameContainer_FinishedRoundTrip)
+    {
+        auto File = WriteTestContainer();
+        CHECK(File.GetHeader().IndexOffset % FRAME_CONTAINER_ALIGNMENT == 0);
+        CHECK_EQUAL(File.GetHeader().IndexOffset + 3 * sizeof(FrameIndexEntry), File.Size);
+
+        FrameContainerReader Reader;
+        CHECK(Reader.Open(File.GetData(), File.Size));
+        CHECK(Reader.IsFinished());
+        CHECK_EQUAL(Reader.GetFrameCount(), uint64_t{ 3 });
+
+        for (uint64_t Index = 0; Index < 3; ++Index) {
+            CHECK(CheckFrame(Reader, Index));
+        }
+
+        const auto Frame = Reader.GetFrame(1);
+        CHECK(Frame.has_value());
+        CHECK_EQUAL(Frame->Header->DirtyRectCount, 2u);
+        CHECK(Frame->DirtyRects != nullptr);
+        CHECK_EQUAL(Frame->DirtyRects[1].Left,   3);
+        CHECK_EQUAL(Frame->DirtyRects[1].Bottom, 3);
+        CHECK(Reader.GetFrame(0)->DirtyRects == nullptr);
+
+        CHECK(!Reader.GetFrame(3).has_value());
+    }
+
+    TEST_CASE(FrameContainer_RecoversUnfinished)
+    {
+        auto File = WriteTestContainer();
+        StripIndex(File);
+
+        FrameContainerReader Reader;
+        CHECK(Reader.Open(File.GetData(), File.Size));
+        CHECK(!Reader.IsFinished());
+        CHECK_EQUAL(Reader.GetFrameCount(), uint64_t{ 3 });
+
+        for (uint64_t Index = 0; Index < 3; ++Index) {
+            CHECK(CheckFrame(Reader, Index));
+        }
+        CHECK_EQUAL(Reader.FindFrame(20'000'000).value_or(UINT64_MAX), uint64_t{ 1 });
+    }
+
+    TEST_CASE(FrameContainer_TruncatedRecord)
+    {
+        auto File = WriteTestContainer();
+        StripIndex(File);
+
+        // The last record cut short, down to part of its header. It has no dirty rects, the same size as the first.
+        const size_t LastRecord = File.Size - static_cast<size_t>(
+            reinterpret_cast<const FrameRecordHeader*>(File.GetData() + sizeof(FrameContainerHeader))->RecordSize);
+
+        FrameContainerReader Reader;
+        for (const size_t Size : { File.Size - 1, File.Size - 64, LastRecord + sizeof(FrameRecordHeader), LastRecord + 8 }) {
+            CHECK(Reader.Open(File.GetData(), Size));
+            CHECK_EQUAL(Reader.GetFrameCount(), uint64_t{ 2 });
+            CHECK(CheckFrame(Reader, 1));
+            CHECK(!Reader.GetFrame(2).has_value());
+        }
+
+        // Nothing but the container header
+        CHECK(Reader.Open(File.GetData(), sizeof(FrameContainerHeader)));
+        CHECK_EQUAL(Reader.GetFrameCount(), uint64_t{ 0 });
+        CHECK(!Reader.FindFrame(0).has_value());
+    }
+
+    TEST_CASE(FrameContainer_DamagedFile)
+    {
+        auto File = WriteTestContainer();
+
+        FrameContainerReader Reader;
+        CHECK(!Reader.Open(File.GetData(), sizeof(FrameContainerHeader) - 1));
+
+        // An index that ends past the data
+        CHECK(!Reader.Open(File.GetData(), File.Size - 1));
+
+        // A record header that does not add up, the frame is dropped but the others stay readable
+        auto& Header = *reinterpret_cast<FrameRecordHeader*>(File.GetData() + sizeof(FrameContainerHeader));
+        Header.PayloadSize += 1;
+        CHECK(Reader.Open(File.GetData(), File.Size));
+        CHECK(!Reader.GetFrame(0).has_value());
+        CHECK(CheckFrame(Reader, 2));
+        Header.PayloadSize -= 1;
+
+        File.GetHeader().Magic ^= 1;
+        CHECK(!Reader.Open(File.GetData(), File.Size));
+    }
+
+    TEST_CASE(FrameContainer_FindFrameBounds)
+    {
+        auto File = WriteTestContainer();
+
+        FrameContainerReader Reader;
+        CHECK(Reader.Open(File.GetData(), File.Size));
+
+        // Last frame at or before the time
+        const auto Find = [&](uint64_t Timestamp) { return Reader.FindFrame(Timestamp).value_or(UINT64_MAX); };
+        CHECK_EQUAL(Find(0),          uint64_t{ 0 });
+        CHECK_EQUAL(Find(15'999'999), uint64_t{ 0 });
+        CHECK_EQUAL(Find(16'000'000), uint64_t{ 1 });
+        CHECK_EQUAL(Find(33'000'000), uint64_t{ 2 });
+        CHECK_EQUAL(Find(UINT64_MAX), uint64_t{ 2 });
+
+        // Nothing before the first frame
+        reinterpret_cast<FrameIndexEntry*>(File.GetData() + File.GetHeader().IndexOffset)[0].Timestamp = 5;
+        CHECK(Reader.Open(File.GetData(), File.Size));
+        CHECK(!Reader.FindFrame(4).has_value());
+        CHECK_EQUAL(Find(5), uint64_t{ 0 });
+    }
+}
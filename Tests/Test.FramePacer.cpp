@@ -0,0 +1,178 @@
+#include "Test.h"
+#include "Core.FramePacer.h"
+
+
+namespace Mi::Core
+{
+    using namespace std::chrono_literals;
+
+    // A pacer on a clock the test moves by hand
+    struct PacerFixture
+    {
+        std::chrono::nanoseconds Now{ 1s };
+        FramePacer               Pacer{ [this] { return Now; } };
+    };
+
+    TEST_CASE(FramePacer_VSyncPresentsEveryPass)
+    {
+        PacerFixture Fixture;
+        Fixture.Pacer.SetPolicy(FramePacingPolicy::VSync);
+
+        const auto Decision = Fixture.Pacer.Decide();
+        CHECK(Decision.Present);
+        CHECK_EQUAL(Decision.SyncInterval, 1u);
+        CHECK(!Decision.AllowTearing);
+        CHECK(Decision.Delay.count() == 0);
+    }
+
+    TEST_CASE(FramePacer_UncappedTears)
+    {
+        PacerFixture Fixture;
+        Fixture.Pacer.SetPolicy(FramePacingPolicy::Uncapped);
+
+        const auto Decision = Fixture.Pacer.Decide();
+        CHECK(Decision.Present);
+        CHECK_EQUAL(Decision.SyncInterval, 0u);
+        CHECK(Decision.AllowTearing);
+    }
+
+    TEST_CASE(FramePacer_FixedRateKeepsCadence)
+    {
+        PacerFixture Fixture;
+        Fixture.Pacer.SetPolicy(FramePacingPolicy::FixedRate, 50.0);
+
+        // Nothing presented yet, no reason to wait
+        CHECK(Fixture.Pacer.Decide().Delay.count() == 0);
+        Fixture.Pacer.OnPresented();
+
+        Fixture.Now += 5ms;
+        auto Decision = Fixture.Pacer.Decide();
+        CHECK_EQUAL(Decision.SyncInterval, 0u);
+        CHECK(!Decision.AllowTearing);
+        CHECK(Decision.Delay == 15ms);
+
+        // Presented 2 ms late, the next deadline stays on the 20 ms grid
+        Fixture.Now += 17ms;
+        Fixture.Pacer.OnPresented();
+        Fixture.Now += 10ms;
+        CHECK(Fixture.Pacer.Decide().Delay == 8ms);
+    }
+
+    TEST_CASE(FramePacer_FixedRateDoesNotCatchUp)
+    {
+        PacerFixture Fixture;
+        Fixture.Pacer.SetPolicy(FramePacingPolicy::FixedRate, 50.0);
+        Fixture.Pacer.OnPresented();
+
+        // After a stall of many intervals the cadence restarts from the late present
+        Fixture.Now += 500ms;
+        CHECK(Fixture.Pacer.Decide().Delay.count() == 0);
+        Fixture.Pacer.OnPresented();
+
+        Fixture.Now += 1ms;
+        CHECK(Fixture.Pacer.Decide().Delay == 19ms);
+    }
+
+    TEST_CASE(FramePacer_MatchSourceWaitsForSourceFrame)
+    {
+        PacerFixture Fixture;
+        Fixture.Pacer.SetPolicy(FramePacingPolicy::MatchSource);
+
+        // Source at 25 fps
+        for (int Index = 0; Index < 4; ++Index) {
+            Fixture.Pacer.OnSourceFrame();
+            CHECK(Fixture.Pacer.Decide().Present);
+            Fixture.Pacer.OnPresented();
+            Fixture.Now += 40ms;
+        }
+        CHECK(Fixture.Pacer.GetSourceInterval() == 40ms);
+
+        // Presented, and no new source frame since: skip, and sleep until the next one is due
+        Fixture.Now -= 30ms;
+        const auto Decision = Fixture.Pacer.Decide();
+        CHECK(!Decision.Present);
+        CHECK(Decision.Delay == 30ms);
+
+        Fixture.Now += 30ms;
+        Fixture.Pacer.OnSourceFrame();
+        CHECK(Fixture.Pacer.Decide().Present);
+    }
+
+    TEST_CASE(FramePacer_SourceIntervalAverage)
+    {
+        PacerFixture Fixture;
+
+        // The first interval is taken as is, later ones move the average by 1/8 of the difference
+        Fixture.Pacer.OnSourceFrame();
+        Fixture.Now += 16ms;
+        Fixture.Pacer.OnSourceFrame();
+        CHECK(Fixture.Pacer.GetSourceInterval() == 16ms);
+
+        Fixture.Now += 32ms;
+        Fixture.Pacer.OnSourceFrame();
+        CHECK(Fixture.Pacer.GetSourceInterval() == 18ms);
+    }
+
+    TEST_CASE(FramePacer_AdaptiveVSyncSlowSourceStaysSynced)
+    {
+        PacerFixture Fixture;
+        Fixture.Pacer.SetPolicy(FramePacingPolicy::AdaptiveVSync);
+        Fixture.Pacer.SetRefreshRate(60.0);
+
+        // A 30 fps source on a 60 Hz display: a present every other vblank, every frame drawn in 3 ms
+        const auto SourceInterval = std::chrono::nanoseconds(1'000'000'000 / 30);
+
+        for (int Index = 0; Index < 30; ++Index) {
+            Fixture.Pacer.OnSourceFrame();
+
+            const auto Decision = Fixture.Pacer.Decide();
+            CHECK_EQUAL(Decision.SyncInterval, 1u);
+            CHECK(!Decision.AllowTearing);
+
+            Fixture.Pacer.OnFrameStart();
+            Fixture.Now += 3ms;
+            Fixture.Pacer.OnPresented();
+
+            Fixture.Now += SourceInterval - 3ms;
+        }
+    }
+
+    TEST_CASE(FramePacer_AdaptiveVSyncTearsAfterLateFrame)
+    {
+        PacerFixture Fixture;
+        Fixture.Pacer.SetPolicy(FramePacingPolicy::AdaptiveVSync);
+        Fixture.Pacer.SetRefreshRate(60.0);
+
+        // 20 ms of work misses the 16.7 ms vblank, beyond the 1/8 slack
+        Fixture.Pacer.OnFrameStart();
+        Fixture.Now += 20ms;
+        Fixture.Pacer.OnPresented();
+
+        auto Decision = Fixture.Pacer.Decide();
+        CHECK_EQUAL(Decision.SyncInterval, 0u);
+        CHECK(Decision.AllowTearing);
+
+        // 17 ms is within the slack
+        Fixture.Pacer.OnFrameStart();
+        Fixture.Now += 17ms;
+        Fixture.Pacer.OnPresented();
+
+        Decision = Fixture.Pacer.Decide();
+        CHECK_EQUAL(Decision.SyncInterval, 1u);
+        CHECK(!Decision.AllowTearing);
+    }
+
+    TEST_CASE(FramePacer_ResetForgetsLateFrame)
+    {
+        PacerFixture Fixture;
+        Fixture.Pacer.SetPolicy(FramePacingPolicy::AdaptiveVSync);
+        Fixture.Pacer.SetRefreshRate(60.0);
+
+        Fixture.Pacer.OnFrameStart();
+        Fixture.Now += 50ms;
+        Fixture.Pacer.OnPresented();
+        Fixture.Pacer.Reset();
+
+        CHECK(!Fixture.Pacer.Decide().AllowTearing);
+    }
+}
@@ -0,0 +1,64 @@
+#include "Test.h"
+#include "Core.FrameSignal.h"
+
+
+namespace Mi::Core
+{
+    using namespace std::chrono_literals;
+
+    TEST_CASE(FrameSignal_NotifyBeforeWaitIsKept)
+    {
+        FrameSignal Signal;
+        Signal.Notify();
+
+        // The render thread may still be drawing when the frame arrives, the wait after that must not block
+        const auto Start = std::chrono::steady_clock::now();
+        CHECK(Signal.WaitFor(1s));
+        CHECK(std::chrono::steady_clock::now() - Start < 500ms);
+    }
+
+    TEST_CASE(FrameSignal_AutoReset)
+    {
+        FrameSignal Signal;
+        Signal.Notify();
+        Signal.Notify();
+
+        // Two notifies before one wait wake it once
+        CHECK(Signal.WaitFor(0ms));
+        CHECK(!Signal.WaitFor(0ms));
+    }
+
+    TEST_CASE(FrameSignal_Reset)
+    {
+        FrameSignal Signal;
+        Signal.Notify();
+        Signal.Reset();
+
+        CHECK(!Signal.WaitFor(0ms));
+    }
+
+    TEST_CASE(FrameSignal_Timeout)
+    {
+        FrameSignal Signal;
+
+        const auto Start = std::chrono::steady_clock::now();
+        CHECK(!Signal.WaitFor(20ms));
+        CHECK(std::chrono::steady_clock::now() - Start >= 20ms);
+    }
+
+    TEST_CASE(FrameSignal_NotifyFromAnotherThread)
+    {
+        FrameSignal Signal;
+
+        std::thread Producer([&Signal]
+        {
+            std::this_thread::sleep_for(10ms);
+            Signal.Notify();
+        });
+
+        CHECK(Signal.WaitFor(5s));
+        Producer.join();
+
+        CHECK(!Signal.WaitFor(0ms));
+    }
+}
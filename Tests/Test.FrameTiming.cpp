@@ -0,0 +1,207 @@
+#include "Test.h"
+#include "Core.FrameTiming.h"
+
+
+namespace Mi::Core
+{
+    using namespace std::chrono_literals;
+
+    TEST_CASE(SpscRing_FullAndEmpty)
+    {
+        SpscRing<uint32_t, 4> Ring;
+        uint32_t Item = 0;
+
+        CHECK(!Ring.Pop(Item));
+        for (uint32_t Index = 0; Index < 4; ++Index) {
+            CHECK(Ring.Push(Index));
+        }
+        CHECK(!Ring.Push(4));
+        CHECK(Ring.BeginPush() == nullptr);
+        CHECK_EQUAL(Ring.Size(), size_t{ 4 });
+
+        for (uint32_t Index = 0; Index < 4; ++Index) {
+            CHECK(Ring.Pop(Item));
+            CHECK_EQUAL(Item, Index);
+        }
+        CHECK(!Ring.Pop(Item));
+        CHECK_EQUAL(Ring.Size(), size_t{ 0 });
+    }
+
+    TEST_CASE(SpscRing_WrapsAround)
+    {
+        SpscRing<uint32_t, 4> Ring;
+        uint32_t Item = 0;
+
+        // Many times the capacity, with the ring never empty for long
+        for (uint32_t Index = 0; Index < 100; ++Index) {
+            CHECK(Ring.Push(Index));
+            if (Index >= 2) {
+                CHECK(Ring.Pop(Item));
+                CHECK_EQUAL(Item, Index - 2);
+            }
+        }
+        CHECK_EQUAL(Ring.Size(), size_t{ 2 });
+    }
+
+    TEST_CASE(SpscRing_TwoStepPush)
+    {
+        SpscRing<FrameTimingSample, 2> Ring;
+
+        FrameTimingSample* Slot = Ring.BeginPush();
+        CHECK(Slot != nullptr);
+        Slot->FrameNumber = 7;
+
+        // Not visible before the commit
+        FrameTimingSample Sample;
+        CHECK(!Ring.Pop(Sample));
+
+        Ring.CommitPush();
+        CHECK(Ring.Pop(Sample));
+        CHECK_EQUAL(Sample.FrameNumber, uint64_t{ 7 });
+    }
+
+    TEST_CASE(SpscRing_TwoThreads)
+    {
+        constexpr uint64_t COUNT = 200'000;
+
+        SpscRing<uint64_t, 64> Ring;
+        std::thread Producer([&]
+        {
+            for (uint64_t Value = 1; Value <= COUNT;) {
+                if (Ring.Push(Value)) {
+                    ++Value;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        // Every value once, in order
+        uint64_t Expected = 1;
+        bool     InOrder  = true;
+        while (Expected <= COUNT) {
+            uint64_t Value = 0;
+            if (Ring.Pop(Value)) {
+                InOrder = InOrder && Value == Expected;
+                ++Expected;
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+        Producer.join();
+
+        CHECK(InOrder);
+        CHECK_EQUAL(Ring.Size(), size_t{ 0 });
+    }
+
+    TEST_CASE(LatencyHistogram_SmallValuesAreExact)
+    {
+        for (uint32_t Value = 0; Value < 16; ++Value) {
+            CHECK_EQUAL(LatencyHistogram::GetBucketIndex(Value), Value);
+            CHECK_EQUAL(LatencyHistogram::GetBucketUpperBound(Value), uint64_t{ Value });
+        }
+
+        // 16 to 31 still one value per bucket, 32 to 63 two
+        CHECK_EQUAL(LatencyHistogram::GetBucketUpperBound(LatencyHistogram::GetBucketIndex(31)), uint64_t{ 31 });
+        CHECK_EQUAL(LatencyHistogram::GetBucketUpperBound(LatencyHistogram::GetBucketIndex(32)), uint64_t{ 33 });
+    }
+
+    TEST_CASE(LatencyHistogram_BucketBounds)
+    {
+        const uint32_t Top = LatencyHistogram::GetBucketIndex(UINT64_MAX);
+
+        // Every bucket ends where the next one starts
+        bool Contiguous = true;
+        for (uint32_t Index = 0; Index < Top; ++Index) {
+            const uint64_t Upper = LatencyHistogram::GetBucketUpperBound(Index);
+            Contiguous = Contiguous
+                && LatencyHistogram::GetBucketIndex(Upper)     == Index
+                && LatencyHistogram::GetBucketIndex(Upper + 1) == Index + 1;
+        }
+        CHECK(Contiguous);
+
+        // Within 1/16 of the value
+        for (uint64_t Value = 16; Value < (1ull << 40); Value = Value * 3 + 1) {
+            const uint64_t Upper = LatencyHistogram::GetBucketUpperBound(LatencyHistogram::GetBucketIndex(Value));
+            CHECK(Upper >= Value);
+            CHECK(Upper - Value <= Value / 16);
+        }
+    }
+
+    TEST_CASE(LatencyHistogram_TopBucketUpperBound)
+    {
+        const uint32_t Top = LatencyHistogram::GetBucketIndex(UINT64_MAX);
+        CHECK_EQUAL(LatencyHistogram::GetBucketUpperBound(Top), UINT64_MAX);
+        CHECK_EQUAL(LatencyHistogram::GetBucketIndex(1ull << 63), Top - 15);
+        CHECK(LatencyHistogram::GetBucketUpperBound(Top - 1) < UINT64_MAX);
+
+        LatencyHistogram Histogram;
+        Histogram.Record(UINT64_MAX);
+        CHECK_EQUAL(Histogram.GetPercentile(50.0), UINT64_MAX);
+        CHECK_EQUAL(Histogram.GetPercentile(100.0), UINT64_MAX);
+    }
+
+    TEST_CASE(LatencyHistogram_Percentiles)
+    {
+        LatencyHistogram Histogram;
+        CHECK_EQUAL(Histogram.GetPercentile(50.0), uint64_t{ 0 });
+        CHECK_EQUAL(Histogram.GetMin(), uint64_t{ 0 });
+
+        for (uint64_t Value = 1; Value <= 1000; ++Value) {
+            Histogram.Record(Value * 1000);
+        }
+
+        CHECK_EQUAL(Histogram.GetCount(), uint64_t{ 1000 });
+        CHECK_EQUAL(Histogram.GetMin(),   uint64_t{ 1000 });
+        CHECK_EQUAL(Histogram.GetMax(),   uint64_t{ 1'000'000 });
+        CHECK_EQUAL(Histogram.GetMean(),  uint64_t{ 500'500 });
+
+        // The bucket's upper bound, at most 1/16 above the exact rank
+        const auto Near = [&](double Percentile, uint64_t Exact)
+        {
+            const uint64_t Value = Histogram.GetPercentile(Percentile);
+            return Value >= Exact && Value - Exact <= Exact / 16;
+        };
+        CHECK(Near(50.0, 500'000));
+        CHECK(Near(95.0, 950'000));
+        CHECK(Near(99.0, 990'000));
+
+        // Clamped to what was recorded
+        CHECK(Near(0.0, 1000));
+        CHECK_EQUAL(Histogram.GetPercentile(100.0), uint64_t{ 1'000'000 });
+        CHECK_EQUAL(Histogram.GetPercentile(150.0), uint64_t{ 1'000'000 });
+
+        Histogram.Reset();
+        CHECK_EQUAL(Histogram.GetCount(), uint64_t{ 0 });
+        CHECK_EQUAL(Histogram.GetPercentile(50.0), uint64_t{ 0 });
+    }
+
+    TEST_CASE(FrameTimingCollector_Summary)
+    {
+        FrameTimingCollector Collector;
+
+        // More than the ring holds, the producer drains it itself
+        for (uint64_t Index = 0; Index < 3000; ++Index) {
+            FrameTimingSample Sample;
+            Sample.FrameNumber = Index;
+            Sample.Set(FrameStage::Draw, 2ms);
+            if (Index % 2 == 0) {
+                Sample.Set(FrameStage::Frame, 10ms);
+            }
+            Collector.Push(Sample);
+        }
+
+        const auto Summary = Collector.GetSummary();
+        CHECK_EQUAL(Summary.Frames,  uint64_t{ 1500 });
+        CHECK_EQUAL(Summary.Dropped, uint64_t{ 0 });
+        CHECK_EQUAL(Summary[FrameStage::Draw].Count, uint64_t{ 3000 });
+        CHECK(Summary[FrameStage::Draw].P50 == 2ms);
+        CHECK(Summary[FrameStage::Frame].Max == 10ms);
+        CHECK_EQUAL(Summary[FrameStage::Gpu].Count, uint64_t{ 0 });
+
+        Collector.Reset();
+        CHECK_EQUAL(Collector.GetSummary().Frames, uint64_t{ 0 });
+    }
+}
@@ -0,0 +1,153 @@
+#include "Test.h"
+#include "Core.JsonWriter.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+namespace Mi::Core
+{
+    static std::string WriteString(_In_ std::string_view Text)
+    {
+        JsonWriter Json;
+        Json.Value(Text);
+        return Json.GetString();
+    }
+
+    static std::string WriteDouble(_In_ double Number)
+    {
+        JsonWriter Json;
+        Json.Value(Number);
+        return Json.GetString();
+    }
+
+    TEST_CASE(JsonWriter_EscapesStrings)
+    {
+        CHECK(WriteString("plain") == "\"plain\"");
+        CHECK(WriteString("") == "\"\"");
+        CHECK(WriteString("say \"hi\"") == "\"say \\\"hi\\\"\"");
+        CHECK(WriteString("C:\\Temp\\a.txt") == "\"C:\\\\Temp\\\\a.txt\"");
+        CHECK(WriteString("\b\f\n\r\t") == "\"\\b\\f\\n\\r\\t\"");
+
+        // The rest below 0x20 as \u00XX in lowercase, the NUL in the middle included
+        CHECK(WriteString(std::string_view("a\0b", 3)) == "\"a\\u0000b\"");
+        CHECK(WriteString("\x01\x1B\x1F") == "\"\\u0001\\u001b\\u001f\"");
+
+        // DEL and UTF-8 are left alone
+        CHECK(WriteString("\x7F") == "\"\x7F\"");
+        CHECK(WriteString("Caf\xC3\xA9") == "\"Caf\xC3\xA9\"");
+
+        // Keys go through the same escaping
+        JsonWriter Json;
+        Json.BeginObject().Member("a\"\n", 1).EndObject();
+        CHECK(Json.GetString() == "{\"a\\\"\\n\":1}");
+    }
+
+    TEST_CASE(JsonWriter_CompactNesting)
+    {
+        JsonWriter Json;
+        Json.BeginObject()
+            .Member("name", "frame")
+            .Key("sizes").BeginArray().Value(1).Value(2u).Value(int64_t{ -3 }).EndArray()
+            .Key("empty").BeginObject().EndObject()
+            .Key("none").BeginArray().EndArray()
+            .Key("nested").BeginArray().BeginObject().Member("ok", true).EndObject().BeginArray().EndArray().EndArray()
+            .Key("missing").Null()
+            .EndObject();
+
+        CHECK(Json.GetString() ==
+            "{\"name\":\"frame\",\"sizes\":[1,2,-3],\"empty\":{},\"none\":[],"
+            "\"nested\":[{\"ok\":true},[]],\"missing\":null}");
+    }
+
+    TEST_CASE(JsonWriter_IndentedNesting)
+    {
+        JsonWriter Json(true);
+        Json.BeginObject()
+            .Member("id", uint64_t{ 7 })
+            .Key("items").BeginArray()
+                .BeginObject().Member("on", false).EndObject()
+                .BeginArray().EndArray()
+            .EndArray()
+            .Key("empty").BeginObject().EndObject()
+            .EndObject();
+
+        CHECK(Json.GetString() ==
+            "{\n"
+            "  \"id\": 7,\n"
+            "  \"items\": [\n"
+            "    {\n"
+            "      \"on\": false\n"
+            "    },\n"
+            "    []\n"
+            "  ],\n"
+            "  \"empty\": {}\n"
+            "}");
+
+        JsonWriter Empty(true);
+        Empty.BeginArray().EndArray();
+        CHECK(Empty.GetString() == "[]");
+    }
+
+    TEST_CASE(JsonWriter_KeyThenValue)
+    {
+        // The value after a key is no item of its own, neither a comma nor a new line comes between them
+        JsonWriter Compact;
+        Compact.BeginObject().Key("a").Value(1).Key("b").BeginArray().Value("x").EndArray().EndObject();
+        CHECK(Compact.GetString() == "{\"a\":1,\"b\":[\"x\"]}");
+
+        JsonWriter Indented(true);
+        Indented.BeginObject().Key("a").Value(1).Key("b").BeginObject().EndObject().EndObject();
+        CHECK(Indented.GetString() == "{\n  \"a\": 1,\n  \"b\": {}\n}");
+
+        // Clear forgets a pending key as well
+        Compact.Clear();
+        Compact.BeginObject().Key("dangling");
+        Compact.Clear();
+        Compact.BeginArray().Value(1).Value(2).EndArray();
+        CHECK(Compact.GetString() == "[1,2]");
+    }
+
+    TEST_CASE(JsonWriter_NonFiniteDoubles)
+    {
+        CHECK(WriteDouble(std::numeric_limits<double>::quiet_NaN()) == "null");
+        CHECK(WriteDouble(std::numeric_limits<double>::infinity()) == "null");
+        CHECK(WriteDouble(-std::numeric_limits<double>::infinity()) == "null");
+
+        // Still an item of its own, separated like any other value
+        JsonWriter Json;
+        Json.BeginArray().Value(1.5).Value(std::nan("")).Value(2.5).EndArray();
+        CHECK(Json.GetString() == "[1.5,null,2.5]");
+    }
+
+    TEST_CASE(JsonWriter_DoublesRoundTrip)
+    {
+        CHECK(WriteDouble(0.1) == "0.1");
+        CHECK(WriteDouble(1.0) == "1");
+        CHECK(WriteDouble(-2.5) == "-2.5");
+        CHECK(WriteDouble(1e21) == "1e+21");
+
+        static constexpr double VALUES[] = {
+            0.1, 1.0 / 3.0, 2.0 / 3.0, 123456789.125, 16.666666666666668, -0.0, 1e-7, 6.02214076e23,
+            std::numeric_limits<double>::min(),
+            std::numeric_limits<double>::denorm_min(),
+            std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::lowest(),
+            std::numeric_limits<double>::epsilon(),
+        };
+
+        for (const double Number : VALUES) {
+            const std::string Text = WriteDouble(Number);
+
+            double Parsed = 0.0;
+            const auto Result = std::from_chars(Text.data(), Text.data() + Text.size(), Parsed);
+            CHECK(Result.ec == std::errc());
+            CHECK(Result.ptr == Text.data() + Text.size());
+
+            // Bit for bit, so -0.0 is told apart from 0.0
+            CHECK(std::memcmp(&Parsed, &Number, sizeof(Number)) == 0);
+        }
+    }
+}
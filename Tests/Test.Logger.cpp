@@ -0,0 +1,142 @@
+#include "Test.h"
+
+
+namespace Mi::Core
+{
+    // Fills a record the way Logger::Write() does, without a ring
+    template <typename... Args>
+    static std::string Format(_In_z_ const char* Text, _In_ const Args&... Arguments)
+    {
+        LogRecord Record;
+        Record.Format = Text;
+        (LogDetail::AppendArgument(Record, Arguments), ...);
+        return Logger::FormatRecord(Record);
+    }
+
+    TEST_CASE(Logger_PlainText)
+    {
+        CHECK(Format("Started") == "Started");
+        CHECK(Format("100%% done") == "100% done");
+        CHECK(Format("") == "");
+
+        LogRecord Empty;
+        CHECK(Logger::FormatRecord(Empty) == "");
+    }
+
+    TEST_CASE(Logger_ResultWithStarWidth)
+    {
+        // The way every failed call is logged, an HRESULT arrives as a negative 32-bit value
+        const int32_t Result = static_cast<int32_t>(0x80070005);
+        CHECK(Format("Result=0x%0*X", 8, Result) == "Result=0x80070005");
+        CHECK(Format("Result=0x%0*X", 8, 0x1F) == "Result=0x0000001F");
+        CHECK(Format("[%*d|%-*d]", 5, 42, 4, 7) == "[   42|7   ]");
+        CHECK(Format("%.*f", 2, 3.14159) == "3.14");
+    }
+
+    TEST_CASE(Logger_Integers)
+    {
+        CHECK(Format("%d %u", -5, 5u) == "-5 5");
+        CHECK(Format("%llu", UINT64_MAX) == "18446744073709551615");
+        CHECK(Format("%lld", INT64_MIN) == "-9223372036854775808");
+        CHECK(Format("%llX", 0x0123456789ABCDEFull) == "123456789ABCDEF");
+
+        // The length modifier of the format does not have to match the argument
+        CHECK(Format("%d", int64_t{ 1 } << 40) == "1099511627776");
+        CHECK(Format("%lld", 7) == "7");
+        CHECK(Format("%c%c", 'o', 'k') == "ok");
+
+        enum class Color : uint8_t { Red = 3 };
+        CHECK(Format("%u", Color::Red) == "3");
+    }
+
+    TEST_CASE(Logger_Strings)
+    {
+        CHECK(Format("[%s]", "text") == "[text]");
+        CHECK(Format("[%-6s]", "ab") == "[ab    ]");
+        CHECK(Format("[%s]", static_cast<const char*>(nullptr)) == "[(null)]");
+
+        // Wide strings come out as UTF-8
+        CHECK(Format("Title=%ls", L"Caf\u00E9 \u4E2D") == "Title=Caf\xC3\xA9 \xE4\xB8\xAD");
+        CHECK(Format("Title=%ls", static_cast<const wchar_t*>(nullptr)) == "Title=(null)");
+        CHECK(Format("%s and %ls", "narrow", L"wide") == "narrow and wide");
+    }
+
+    TEST_CASE(Logger_MissingArguments)
+    {
+        CHECK(Format("%d and %d", 1) == "1 and <?>");
+        CHECK(Format("Result=0x%0*X") == "Result=0x<?>");
+        CHECK(Format("Result=0x%0*X", 8) == "Result=0x<?>");
+        CHECK(Format("%s", nullptr) == "<?>");
+
+        // Extra arguments are ignored, a dangling % at the end is dropped
+        CHECK(Format("%d", 1, 2, 3) == "1");
+        CHECK(Format("Done %", 1) == "Done ");
+    }
+
+    TEST_CASE(Logger_MismatchedArguments)
+    {
+        // A wrong argument prints <?> and the next conversion still gets its own argument
+        CHECK(Format("%f %d", 1, 2) == "<?> 2");
+        CHECK(Format("%s %d", 1, 2) == "<?> 2");
+        CHECK(Format("%d %d", "text", 2) == "<?> 2");
+        CHECK(Format("%d %s", 1.5, "text") == "<?> text");
+        CHECK(Format("%k %d", 1, 2) == "<?> 2");
+    }
+
+    TEST_CASE(Logger_Truncation)
+    {
+        // The string fills the payload, what is cut is marked and the value after it does not fit at all
+        const std::string Long(LOG_RECORD_SIZE * 2, 'x');
+        const std::string Text = Format("%s|%d", Long.c_str(), 42);
+
+        CHECK(Text.size() > LOG_RECORD_SIZE / 2);
+        CHECK(Text.size() < LOG_RECORD_SIZE);
+        CHECK(Text.find_first_not_of('x') == Text.size() - std::string("|<?> <truncated>").size());
+        CHECK(Text.ends_with("|<?> <truncated>"));
+
+        const std::wstring Wide(LOG_RECORD_SIZE, L'w');
+        const std::string WideText = Format("%ls", Wide.c_str());
+        CHECK(WideText.ends_with("w <truncated>"));
+        CHECK(WideText.size() < LOG_RECORD_SIZE);
+
+        // Values only, every one is either stored whole or dropped
+        LogRecord Record;
+        Record.Format = "%llu";
+        for (uint64_t Index = 0; Index < LOG_RECORD_SIZE; ++Index) {
+            LogDetail::AppendArgument(Record, Index);
+        }
+        CHECK(Record.Truncated);
+        CHECK(Record.Size % 9 == 0);
+        CHECK(Logger::FormatRecord(Record) == "0 <truncated>");
+    }
+
+    TEST_CASE(Logger_FormatCheckedAtCompileTime)
+    {
+        using LogDetail::CheckFormat;
+        using LogDetail::FormatError;
+
+        // What every LOG call site is held to, the failing ones would not compile through Write()
+        static_assert(CheckFormat<>("Started, 100%% done") == FormatError::None);
+        static_assert(CheckFormat<int, int32_t>("Result=0x%0*X") == FormatError::None);
+        static_assert(CheckFormat<uint64_t, const wchar_t*, double>("%llu %ls %.2f") == FormatError::None);
+        static_assert(CheckFormat<char[5], void*, std::nullptr_t>("%s %p %p") == FormatError::None);
+
+        static_assert(CheckFormat<int>("%d and %d") == FormatError::TooFewArguments);
+        static_assert(CheckFormat<int>("Result=0x%0*X") == FormatError::TooFewArguments);
+        static_assert(CheckFormat<int, int, int>("%d") == FormatError::TooManyArguments);
+        static_assert(CheckFormat<int>("100%%") == FormatError::TooManyArguments);
+        static_assert(CheckFormat<int, int>("%f %d") == FormatError::WrongArgument);
+        static_assert(CheckFormat<int, int>("%s %d") == FormatError::WrongArgument);
+        static_assert(CheckFormat<const char*, int>("%d %d") == FormatError::WrongArgument);
+        static_assert(CheckFormat<double, int>("%.*f") == FormatError::WrongArgument);
+        static_assert(CheckFormat<int, int>("%k %d") == FormatError::BadConversion);
+        static_assert(CheckFormat<int>("Done %") == FormatError::BadConversion);
+
+        // The length modifier does not have to match, the formatter takes it from the argument
+        static_assert(CheckFormat<int64_t, int>("%d %lld") == FormatError::None);
+        static_assert(CheckFormat<const char*, const wchar_t*>("%ls %s") == FormatError::None);
+
+        constexpr LogDetail::FormatString<int> Checked("Index=%d");
+        CHECK(std::string_view(Checked.Get()) == "Index=%d");
+    }
+}
@@ -0,0 +1,65 @@
+#include "Test.h"
+
+
+namespace Mi::Test
+{
+    struct TestEntry
+    {
+        const char* Name;
+        TestBody    Body;
+    };
+
+    static std::vector<TestEntry>& GetTests()
+    {
+        static std::vector<TestEntry> Tests;
+        return Tests;
+    }
+
+    static uint32_t RunningFailures = 0;
+
+    TestRegistration::TestRegistration(_In_z_ const char* Name, _In_ TestBody Body)
+    {
+        GetTests().push_back({ Name, Body });
+    }
+
+    void ReportFailure(_In_z_ const char* Expression, _In_z_ const char* File, _In_ int Line, _In_ const std::string& Detail)
+    {
+        ++RunningFailures;
+        fprintf(stderr, "%s(%d): CHECK(%s) failed%s%s\n", File, Line, Expression,
+            Detail.empty() ? "" : ", ", Detail.c_str());
+    }
+}
+
+// Runs every test, or the ones whose name contains the first argument. The exit code is the number of failed tests.
+int main(int Argc, char** Argv)
+{
+    using namespace Mi::Test;
+
+    const std::string_view Filter = Argc > 1 ? Argv[1] : "";
+
+    uint32_t Ran    = 0;
+    uint32_t Failed = 0;
+    for (const auto& Test : GetTests()) {
+        if (!Filter.empty() && std::string_view(Test.Name).find(Filter) == std::string_view::npos) {
+            continue;
+        }
+
+        RunningFailures = 0;
+        Test.Body();
+        ++Ran;
+
+        if (RunningFailures != 0) {
+            ++Failed;
+            fprintf(stderr, "[FAILED] %s\n", Test.Name);
+        }
+        else {
+            fprintf(stdout, "[  OK  ] %s\n", Test.Name);
+        }
+    }
+
+    // Lines the tests logged go out before the summary
+    Mi::Core::Logger::Flush();
+
+    fprintf(stdout, "%u test(s), %u failed.\n", Ran, Failed);
+    return static_cast<int>(Failed);
+}
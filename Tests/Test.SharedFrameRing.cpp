@@ -0,0 +1,214 @@
+#include "Test.h"
+#include "Core.SharedFrameRing.h"
+
+
+namespace Mi::Core
+{
+    using namespace std::chrono_literals;
+
+    // Stands in for the file mapping, aligned like one
+    class SharedBlock
+    {
+        struct alignas(SHARED_FRAME_RING_ALIGNMENT) Line
+        {
+            uint8_t Bytes[SHARED_FRAME_RING_ALIGNMENT];
+        };
+
+        std::vector<Line> mLines;
+
+    public:
+        explicit SharedBlock(_In_ size_t Size)
+            : mLines((Size + sizeof(Line) - 1) / sizeof(Line))
+        {
+        }
+
+        [[nodiscard]] void*  GetData() noexcept       { return mLines.data(); }
+        [[nodiscard]] size_t GetSize() const noexcept { return mLines.size() * sizeof(Line); }
+    };
+
+    // Every word depends on the frame and its position, a copy mixed from two frames can not pass
+    static uint32_t GetPatternWord(_In_ uint64_t Sequence, _In_ size_t Index) noexcept
+    {
+        return static_cast<uint32_t>(Sequence) * 0x9E3779B1u + static_cast<uint32_t>(Index);
+    }
+
+    static void FillPattern(_Out_ uint8_t* Pixels, _In_ uint32_t Width, _In_ uint32_t Height, _In_ uint32_t Stride,
+        _In_ uint64_t Sequence) noexcept
+    {
+        for (uint32_t Row = 0; Row < Height; ++Row) {
+            const auto Words = reinterpret_cast<uint32_t*>(Pixels + static_cast<size_t>(Row) * Stride);
+            for (uint32_t Column = 0; Column < Width; ++Column) {
+                Words[Column] = GetPatternWord(Sequence, static_cast<size_t>(Row) * Width + Column);
+            }
+        }
+    }
+
+    static bool CheckPattern(_In_ const std::vector<uint32_t>& Words, _In_ uint64_t Sequence) noexcept
+    {
+        for (size_t Index = 0; Index < Words.size(); ++Index) {
+            if (Words[Index] != GetPatternWord(Sequence, Index)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    TEST_CASE(SharedFrameRing_RoundTrip)
+    {
+        constexpr uint32_t WIDTH  = 16;
+        constexpr uint32_t HEIGHT = 8;
+        constexpr uint32_t STRIDE = WIDTH * 4 + 32;
+
+        SharedBlock Block(GetSharedFrameRingSize(3, STRIDE * HEIGHT));
+        CHECK(SharedFrameRingWriter::Initialize(Block.GetData(), Block.GetSize(), 3, STRIDE * HEIGHT));
+
+        SharedFrameRingWriter Writer(Block.GetData(), Block.GetSize());
+        SharedFrameRingReader Reader(Block.GetData(), Block.GetSize());
+        CHECK(Writer.IsValid());
+        CHECK(Reader.IsValid());
+        CHECK(!Reader.Peek().has_value());
+
+        std::vector<uint8_t> Pixels(STRIDE * HEIGHT);
+        FillPattern(Pixels.data(), WIDTH, HEIGHT, STRIDE, 1);
+        CHECK_EQUAL(Writer.Write(Pixels.data(), WIDTH, HEIGHT, STRIDE, SharedFrameFormat::B8G8R8A8), uint64_t{ 1 });
+
+        const auto Info = Reader.Peek();
+        CHECK(Info.has_value());
+        CHECK_EQUAL(Info->Sequence, uint64_t{ 1 });
+        CHECK_EQUAL(Info->Width,    WIDTH);
+        CHECK_EQUAL(Info->Height,   HEIGHT);
+        CHECK(Info->Format == SharedFrameFormat::B8G8R8A8);
+
+        // Read packs the rows
+        std::vector<uint32_t> Words(WIDTH * HEIGHT);
+        CHECK(Reader.Read(*Info, Words.data(), WIDTH * 4));
+        CHECK(CheckPattern(Words, 1));
+
+        // Larger than a slot, or rows shorter than the width
+        CHECK_EQUAL(Writer.Write(Pixels.data(), WIDTH, HEIGHT * 2, STRIDE, SharedFrameFormat::B8G8R8A8), uint64_t{ 0 });
+        CHECK_EQUAL(Writer.Write(Pixels.data(), WIDTH, HEIGHT, WIDTH * 2, SharedFrameFormat::B8G8R8A8), uint64_t{ 0 });
+        CHECK_EQUAL(Reader.GetLatestSequence(), uint64_t{ 1 });
+    }
+
+    TEST_CASE(SharedFrameRing_RejectsForeignBlock)
+    {
+        SharedBlock Block(4096);
+        std::memset(Block.GetData(), 0x5A, Block.GetSize());
+
+        CHECK(!SharedFrameRingReader(Block.GetData(), Block.GetSize()).IsValid());
+        CHECK(!SharedFrameRingWriter(Block.GetData(), Block.GetSize()).IsValid());
+
+        // Slots that do not fit the block
+        CHECK(!SharedFrameRingWriter::Initialize(Block.GetData(), Block.GetSize(), 4, 4096));
+    }
+
+    TEST_CASE(SharedFrameRing_DetectsReuse)
+    {
+        constexpr uint32_t WIDTH = 8;
+
+        SharedBlock Block(GetSharedFrameRingSize(2, WIDTH * 4));
+        CHECK(SharedFrameRingWriter::Initialize(Block.GetData(), Block.GetSize(), 2, WIDTH * 4));
+
+        SharedFrameRingWriter Writer(Block.GetData(), Block.GetSize());
+        SharedFrameRingReader Reader(Block.GetData(), Block.GetSize());
+
+        std::vector<uint8_t> Pixels(WIDTH * 4);
+        FillPattern(Pixels.data(), WIDTH, 1, WIDTH * 4, 1);
+        (void)Writer.Write(Pixels.data(), WIDTH, 1, WIDTH * 4, SharedFrameFormat::R8G8B8A8);
+
+        const auto Info = Reader.Peek();
+        CHECK(Info.has_value());
+
+        // The writer is back in the slot of frame 1, while writing and after
+        std::vector<uint32_t> Words(WIDTH);
+        (void)Writer.Write(Pixels.data(), WIDTH, 1, WIDTH * 4, SharedFrameFormat::R8G8B8A8);
+        CHECK(Writer.BeginWrite(WIDTH, 1, WIDTH * 4, SharedFrameFormat::R8G8B8A8) != nullptr);
+        CHECK(!Reader.Read(*Info, Words.data(), WIDTH * 4));
+        CHECK_EQUAL(Writer.EndWrite(), uint64_t{ 3 });
+        CHECK(!Reader.Read(*Info, Words.data(), WIDTH * 4));
+    }
+
+    TEST_CASE(SharedFrameRing_ProducerConsumerStress)
+    {
+        constexpr uint32_t WIDTH     = 128;
+        constexpr uint32_t HEIGHT    = 64;
+        constexpr uint32_t STRIDE    = WIDTH * 4;
+        constexpr uint32_t SLOTS     = 3;
+        constexpr int      CONSUMERS = 2;
+
+        SharedBlock Block(GetSharedFrameRingSize(SLOTS, STRIDE * HEIGHT));
+        CHECK(SharedFrameRingWriter::Initialize(Block.GetData(), Block.GetSize(), SLOTS, STRIDE * HEIGHT));
+
+        // The writer never waits, the readers race it for every slot
+        std::atomic_bool Done = false;
+        std::thread Producer([&]
+        {
+            SharedFrameRingWriter Writer(Block.GetData(), Block.GetSize());
+
+            const auto Stop = std::chrono::steady_clock::now() + 500ms;
+            uint64_t Frames = 0;
+            while (std::chrono::steady_clock::now() < Stop || Frames < 1000) {
+                const auto Pixels = Writer.BeginWrite(WIDTH, HEIGHT, STRIDE, SharedFrameFormat::B8G8R8A8);
+                if (Pixels == nullptr) {
+                    break;
+                }
+                FillPattern(Pixels, WIDTH, HEIGHT, STRIDE, ++Frames);
+                (void)Writer.EndWrite();
+            }
+            Done = true;
+        });
+
+        struct Counters
+        {
+            uint64_t Good    = 0;
+            uint64_t Torn    = 0;   // dropped by the seqlock
+            uint64_t Corrupt = 0;   // accepted, but not the frame it claims to be
+            bool     Ordered = true;
+        };
+        std::array<Counters, CONSUMERS> Results{};
+
+        std::vector<std::thread> Consumers;
+        for (int Index = 0; Index < CONSUMERS; ++Index) {
+            Consumers.emplace_back([&, Index]
+            {
+                SharedFrameRingReader Reader(Block.GetData(), Block.GetSize());
+                std::vector<uint32_t> Words(WIDTH * HEIGHT);
+                auto& Result = Results[Index];
+                uint64_t Last = 0;
+
+                while (!Done) {
+                    const auto Info = Reader.Peek();
+                    if (!Info) {
+                        continue;
+                    }
+
+                    if (!Reader.Read(*Info, Words.data(), STRIDE)) {
+                        ++Result.Torn;
+                        continue;
+                    }
+
+                    if (!CheckPattern(Words, Info->Sequence)) {
+                        ++Result.Corrupt;
+                    }
+                    else {
+                        ++Result.Good;
+                    }
+
+                    Result.Ordered = Result.Ordered && Info->Sequence >= Last;
+                    Last = Info->Sequence;
+                }
+            });
+        }
+
+        Producer.join();
+        for (auto& Consumer : Consumers) {
+            Consumer.join();
+        }
+
+        for (const auto& Result : Results) {
+            CHECK_EQUAL(Result.Corrupt, uint64_t{ 0 });
+            CHECK(Result.Good > 0);
+            CHECK(Result.Ordered);
+        }
+    }
+}
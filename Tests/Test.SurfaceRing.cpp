@@ -0,0 +1,90 @@
+#include "Test.h"
+#include "Core.SurfaceRing.h"
+
+
+namespace Mi::Core
+{
+    TEST_CASE(SurfaceRing_NothingBeforePublish)
+    {
+        SurfaceRing Ring;
+        CHECK(!Ring.Acquire().has_value());
+    }
+
+    TEST_CASE(SurfaceRing_NewestFrameWins)
+    {
+        SurfaceRing Ring;
+
+        const uint32_t First = Ring.GetWriteSlot();
+        CHECK_EQUAL(Ring.Publish(), uint64_t{ 1 });
+
+        auto Slot = Ring.Acquire();
+        CHECK(Slot.has_value());
+        CHECK_EQUAL(Slot->Index, First);
+        CHECK_EQUAL(Slot->Generation, uint64_t{ 1 });
+
+        // Three publishes while the consumer holds its slot, the producer never writes into it
+        for (int Index = 0; Index < 3; ++Index) {
+            CHECK(Ring.GetWriteSlot() != First);
+            (void)Ring.Publish();
+        }
+
+        Slot = Ring.Acquire();
+        CHECK(Slot.has_value());
+        CHECK_EQUAL(Slot->Generation, uint64_t{ 4 });
+
+        // Nothing new, the same slot again
+        const auto Again = Ring.Acquire();
+        CHECK(Again.has_value());
+        CHECK_EQUAL(Again->Index, Slot->Index);
+        CHECK_EQUAL(Again->Generation, uint64_t{ 4 });
+    }
+
+    TEST_CASE(SurfaceRing_TwoThreads)
+    {
+        constexpr uint64_t FRAMES = 200'000;
+        constexpr size_t   WORDS  = 64;
+
+        // Stands in for the surfaces, every word of a slot holds the generation written into it
+        SurfaceRing Ring;
+        std::array<std::array<uint64_t, WORDS>, SURFACE_RING_SLOTS> Surfaces{};
+
+        std::atomic_bool Done       = false;
+        bool             Sequential = true;
+        std::thread Producer([&]
+        {
+            for (uint64_t Generation = 1; Generation <= FRAMES; ++Generation) {
+                Surfaces[Ring.GetWriteSlot()].fill(Generation);
+                Sequential = Sequential && Ring.Publish() == Generation;
+            }
+            Done = true;
+        });
+
+        uint64_t Last     = 0;
+        uint64_t Acquired = 0;
+        bool     Torn     = false;
+        bool     Ordered  = true;
+
+        while (!Done || Last < FRAMES) {
+            const auto Slot = Ring.Acquire();
+            if (!Slot) {
+                continue;
+            }
+
+            const auto& Surface = Surfaces[Slot->Index];
+            Torn    = Torn    || std::any_of(Surface.begin(), Surface.end(), [&](uint64_t Word) { return Word != Slot->Generation; });
+            Ordered = Ordered && Slot->Generation >= Last;
+
+            if (Slot->Generation != Last) {
+                Last = Slot->Generation;
+                ++Acquired;
+            }
+        }
+        Producer.join();
+
+        CHECK(Sequential);
+        CHECK(!Torn);
+        CHECK(Ordered);
+        CHECK_EQUAL(Last, FRAMES);
+        CHECK(Acquired > 0);
+    }
+}
@@ -0,0 +1,84 @@
+#include "Test.h"
+#include "Core.TestPattern.h"
+
+
+namespace Mi::Core
+{
+    static constexpr TestPattern TEST_PATTERNS[] = {
+        TestPattern::Gradient, TestPattern::Checkerboard, TestPattern::ScrollingText, TestPattern::Noise,
+    };
+
+    static std::vector<uint8_t> DrawFrame(_In_ TestPattern Pattern, _In_ uint64_t Frame,
+        _In_ uint32_t Width, _In_ uint32_t Height, _In_ uint32_t Pitch)
+    {
+        std::vector<uint8_t> Pixels(static_cast<size_t>(Pitch) * Height, 0xCD);
+        DrawTestPattern(Pattern, Frame, Pixels.data(), Pitch, Width, Height);
+        return Pixels;
+    }
+
+    TEST_CASE(TestPattern_Names)
+    {
+        for (const auto Pattern : TEST_PATTERNS) {
+            const auto Parsed = ParseTestPatternName(GetTestPatternName(Pattern));
+            CHECK(Parsed.has_value());
+            CHECK(Parsed.value_or(TestPattern::Gradient) == Pattern);
+        }
+
+        CHECK(!ParseTestPatternName("unknown").has_value());
+        CHECK(!ParseTestPatternName("").has_value());
+        CHECK(!ParseTestPatternName("Noise").has_value());
+    }
+
+    TEST_CASE(TestPattern_Deterministic)
+    {
+        for (const auto Pattern : TEST_PATTERNS) {
+            CHECK(DrawFrame(Pattern, 1234, 320, 180, 1280) == DrawFrame(Pattern, 1234, 320, 180, 1280));
+        }
+    }
+
+    TEST_CASE(TestPattern_MovesEveryFrame)
+    {
+        for (const auto Pattern : TEST_PATTERNS) {
+            const auto First = DrawFrame(Pattern, 10, 320, 180, 1280);
+            CHECK(First != DrawFrame(Pattern, 11, 320, 180, 1280));
+        }
+    }
+
+    TEST_CASE(TestPattern_KeepsRowPadding)
+    {
+        constexpr uint32_t WIDTH  = 97;
+        constexpr uint32_t HEIGHT = 31;
+        constexpr uint32_t PITCH  = WIDTH * 4 + 12;
+
+        for (const auto Pattern : TEST_PATTERNS) {
+            const auto Pixels = DrawFrame(Pattern, 3, WIDTH, HEIGHT, PITCH);
+
+            // Opaque inside the image, untouched after the end of every row
+            bool Opaque    = true;
+            bool Untouched = true;
+            for (uint32_t Y = 0; Y < HEIGHT; ++Y) {
+                const uint8_t* Row = Pixels.data() + static_cast<size_t>(Y) * PITCH;
+                for (uint32_t X = 0; X < WIDTH; ++X) {
+                    Opaque = Opaque && Row[X * 4 + 3] == 0xFF;
+                }
+                for (uint32_t Byte = WIDTH * 4; Byte < PITCH; ++Byte) {
+                    Untouched = Untouched && Row[Byte] == 0xCD;
+                }
+            }
+            CHECK(Opaque);
+            CHECK(Untouched);
+        }
+    }
+
+    TEST_CASE(TestPattern_TinyAndInvalidSizes)
+    {
+        for (const auto Pattern : TEST_PATTERNS) {
+            CHECK(DrawFrame(Pattern, 0, 1, 1, 4)[3] == 0xFF);
+            CHECK(DrawFrame(Pattern, 5, 3, 2, 12)[3] == 0xFF);
+
+            // A pitch shorter than a row draws nothing
+            const auto Skipped = DrawFrame(Pattern, 0, 8, 2, 28);
+            CHECK(std::all_of(Skipped.begin(), Skipped.end(), [](uint8_t Byte) { return Byte == 0xCD; }));
+        }
+    }
+}
@@ -0,0 +1,232 @@
+#include "Test.h"
+#include "Core.Trace.h"
+
+#include <string>
+
+
+namespace Mi::Core
+{
+    // TRACE_RING_CAPACITY and TRACE_RETIRED_RINGS of Core.Trace.cpp
+    static constexpr uint64_t RING_CAPACITY = 16384;
+    static constexpr size_t   RETIRED_RINGS = 16;
+
+    // Far past the steady clock of any running machine, so the spans of one test are alone in their window
+    static constexpr uint64_t WINDOW_BASE          = 1'000'000'000'000'000'000;
+    static constexpr uint64_t WINDOW_BASE_WRAP     = 2'000'000'000'000'000'000;
+    static constexpr uint64_t WINDOW_BASE_RETIRED  = 3'000'000'000'000'000'000;
+    static constexpr uint64_t WINDOW_BASE_EXPORTED = 4'000'000'000'000'000'000;
+
+    static std::chrono::steady_clock::time_point ToTimePoint(_In_ uint64_t Nanoseconds)
+    {
+        return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(static_cast<int64_t>(Nanoseconds)));
+    }
+
+    static std::string ExportTrace(_In_ uint64_t From, _In_ uint64_t To)
+    {
+        JsonWriter Json;
+        Trace::WriteChromeTrace(Json, ToTimePoint(From), ToTimePoint(To));
+        return Json.GetString();
+    }
+
+    static size_t CountOf(_In_ std::string_view Text, _In_ std::string_view Part)
+    {
+        size_t Count = 0;
+        for (size_t Offset = Text.find(Part); Offset != std::string_view::npos; Offset = Text.find(Part, Offset + 1)) {
+            ++Count;
+        }
+        return Count;
+    }
+
+    // The tid of the first thread_name event
+    static std::string FirstThreadId(_In_ const std::string& Trace)
+    {
+        const size_t Offset = Trace.find("\"tid\":");
+        if (Offset == std::string::npos) {
+            return {};
+        }
+        const size_t Begin = Offset + 6;
+        return Trace.substr(Begin, Trace.find(',', Begin) - Begin);
+    }
+
+    TEST_CASE(Trace_DisabledRecordsNothing)
+    {
+        Trace::SetEnabled(false);
+        CHECK(!Trace::IsEnabled());
+
+        const auto From = std::chrono::steady_clock::now();
+        const auto Before = Trace::GetStatistics();
+
+        // A thread of its own, a disabled span must not even create its buffer
+        std::thread([]
+        {
+            const TraceSpan Span("Trace.Test.Disabled");
+        }).join();
+
+        const auto After = Trace::GetStatistics();
+        CHECK_EQUAL(After.Recorded, Before.Recorded);
+        CHECK_EQUAL(After.Threads, Before.Threads);
+
+        Trace::SetEnabled(true);
+        std::thread([]
+        {
+            const TraceSpan Span("Trace.Test.Enabled");
+        }).join();
+        Trace::SetEnabled(false);
+
+        // Kept after tracing is turned off
+        JsonWriter Json;
+        Trace::WriteChromeTrace(Json, From, std::chrono::steady_clock::now());
+        CHECK(Json.GetString().find("\"Trace.Test.Enabled\"") != std::string::npos);
+        CHECK(Json.GetString().find("\"Trace.Test.Disabled\"") == std::string::npos);
+    }
+
+    TEST_CASE(Trace_ChromeTraceClipsToWindow)
+    {
+        std::thread([]
+        {
+            Trace::SetThreadName("Trace.Test.Window");
+
+            // In microseconds from the base, the window is 100..200
+            TraceDetail::Record("Before", WINDOW_BASE +  10'000, WINDOW_BASE +  50'000);
+            TraceDetail::Record("Inside", WINDOW_BASE + 150'500, WINDOW_BASE + 160'500);
+            TraceDetail::Record("Left",   WINDOW_BASE +  90'000, WINDOW_BASE + 120'000);
+            TraceDetail::Record("After",  WINDOW_BASE + 210'000, WINDOW_BASE + 220'000);
+            TraceDetail::Record("Right",  WINDOW_BASE + 190'000, WINDOW_BASE + 250'000);
+            TraceDetail::Record("Around", WINDOW_BASE +  50'000, WINDOW_BASE + 300'000);
+        }).join();
+
+        const std::string Trace = ExportTrace(WINDOW_BASE + 100'000, WINDOW_BASE + 200'000);
+        const std::string Tid   = FirstThreadId(Trace);
+        CHECK(!Tid.empty());
+
+        // Sorted by start, cut to the window and relative to its start
+        const std::string Expected =
+            "{\"traceEvents\":["
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + Tid + ",\"args\":{\"name\":\"Trace.Test.Window\"}},"
+            "{\"name\":\"Around\",\"cat\":\"palin\",\"ph\":\"X\",\"pid\":1,\"tid\":" + Tid + ",\"ts\":0,\"dur\":100},"
+            "{\"name\":\"Left\",\"cat\":\"palin\",\"ph\":\"X\",\"pid\":1,\"tid\":" + Tid + ",\"ts\":0,\"dur\":20},"
+            "{\"name\":\"Inside\",\"cat\":\"palin\",\"ph\":\"X\",\"pid\":1,\"tid\":" + Tid + ",\"ts\":50.5,\"dur\":10},"
+            "{\"name\":\"Right\",\"cat\":\"palin\",\"ph\":\"X\",\"pid\":1,\"tid\":" + Tid + ",\"ts\":90,\"dur\":10}"
+            "],\"displayTimeUnit\":\"ms\"}";
+        CHECK(Trace == Expected);
+
+        // Nothing recorded in the window
+        CHECK(ExportTrace(WINDOW_BASE + 400'000, WINDOW_BASE + 500'000) == "{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}");
+    }
+
+    TEST_CASE(Trace_RingWrapCountsOverwritten)
+    {
+        static constexpr uint64_t COUNT = RING_CAPACITY + 100;
+
+        TraceStatistics Before{};
+        TraceStatistics After{};
+        std::thread([&]
+        {
+            // The buffer is created, and older ones pruned, before the first figures are taken
+            Trace::SetThreadName("Trace.Test.Wrap");
+            Before = Trace::GetStatistics();
+
+            for (uint64_t Index = 0; Index < COUNT; ++Index) {
+                TraceDetail::Record("Wrap", WINDOW_BASE_WRAP + Index * 1000, WINDOW_BASE_WRAP + Index * 1000 + 500);
+            }
+            After = Trace::GetStatistics();
+        }).join();
+
+        CHECK_EQUAL(After.Recorded - Before.Recorded, COUNT);
+        CHECK_EQUAL(After.Overwritten - Before.Overwritten, COUNT - RING_CAPACITY);
+
+        // The newest spans are the ones kept
+        const std::string Trace = ExportTrace(WINDOW_BASE_WRAP, WINDOW_BASE_WRAP + COUNT * 1000);
+        CHECK_EQUAL(CountOf(Trace, "\"ph\":\"X\""), static_cast<size_t>(RING_CAPACITY));
+        CHECK(Trace.find("\"ts\":99,") == std::string::npos);
+        CHECK(Trace.find("\"ts\":100,") != std::string::npos);
+        CHECK(Trace.find("\"ts\":" + std::to_string(COUNT - 1) + ",") != std::string::npos);
+    }
+
+    TEST_CASE(Trace_PrunesRetiredRings)
+    {
+        static constexpr uint64_t THREADS = RETIRED_RINGS + 4;
+
+        for (uint64_t Index = 0; Index < THREADS; ++Index) {
+            std::thread([Index]
+            {
+                TraceDetail::Record("Retired", WINDOW_BASE_RETIRED + Index * 1000, WINDOW_BASE_RETIRED + Index * 1000 + 1);
+            }).join();
+        }
+
+        // Exited threads are dropped, oldest first, when the next thread starts to record
+        std::thread([]
+        {
+            Trace::SetThreadName("Trace.Test.Pruner");
+        }).join();
+
+        const std::string Trace = ExportTrace(WINDOW_BASE_RETIRED, WINDOW_BASE_RETIRED + THREADS * 1000);
+        CHECK_EQUAL(CountOf(Trace, "\"ph\":\"X\""), RETIRED_RINGS);
+        CHECK_EQUAL(CountOf(Trace, "\"thread_name\""), RETIRED_RINGS);
+
+        const uint64_t FirstKept = THREADS - RETIRED_RINGS;
+        CHECK(Trace.find("\"ts\":" + std::to_string(FirstKept - 1) + ",") == std::string::npos);
+        CHECK(Trace.find("\"ts\":" + std::to_string(FirstKept) + ",") != std::string::npos);
+        CHECK(Trace.find("\"ts\":" + std::to_string(THREADS - 1) + ",") != std::string::npos);
+    }
+
+    TEST_CASE(Trace_ExportWhileRingWraps)
+    {
+        // Name, start and duration of span Index all follow from Index. 5 and 997 do not divide the capacity,
+        // so a slot read while it is rewritten mixes values that do not belong together.
+        static constexpr const char* NAMES[] = { "Span0", "Span1", "Span2", "Span3", "Span4" };
+        static constexpr uint64_t    SPACING = 1'000'000;
+
+        std::atomic_bool     Stop     = false;
+        std::atomic_uint64_t Recorded = 0;
+
+        std::thread Recorder([&]
+        {
+            Trace::SetThreadName("Trace.Test.Recorder");
+            for (uint64_t Index = 0; !Stop.load(std::memory_order_relaxed); ++Index) {
+                const uint64_t Begin = WINDOW_BASE_EXPORTED + Index * SPACING;
+                TraceDetail::Record(NAMES[Index % 5], Begin, Begin + (Index % 997) * 1000);
+                Recorded.store(Index + 1, std::memory_order_relaxed);
+            }
+        });
+
+        uint64_t Exports = 0;
+        uint64_t Spans   = 0;
+        uint64_t Torn    = 0;
+        bool     Bounded = true;
+
+        const auto Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+        while (std::chrono::steady_clock::now() < Deadline || Recorded.load() < RING_CAPACITY * 4) {
+            const std::string Trace = ExportTrace(WINDOW_BASE_EXPORTED, UINT64_MAX / 2);
+            ++Exports;
+
+            uint64_t Count = 0;
+            for (size_t Offset = Trace.find("{\"name\":\"Span"); Offset != std::string::npos;
+                Offset = Trace.find("{\"name\":\"Span", Offset + 1)) {
+                const char     Name     = Trace[Offset + 13];
+                const double   Start    = std::strtod(Trace.c_str() + Trace.find("\"ts\":",  Offset) + 5, nullptr);
+                const double   Duration = std::strtod(Trace.c_str() + Trace.find("\"dur\":", Offset) + 6, nullptr);
+                const uint64_t Index    = static_cast<uint64_t>(Start) / (SPACING / 1000);
+
+                if (static_cast<double>(Index * (SPACING / 1000)) != Start
+                    || Name != static_cast<char>('0' + Index % 5)
+                    || Duration != static_cast<double>(Index % 997)) {
+                    ++Torn;
+                }
+                ++Count;
+            }
+
+            Spans  += Count;
+            Bounded = Bounded && Count <= RING_CAPACITY;
+        }
+
+        Stop = true;
+        Recorder.join();
+
+        CHECK(Exports > 0);
+        CHECK(Spans > 0);
+        CHECK(Bounded);
+        CHECK_EQUAL(Torn, 0u);
+        CHECK(Recorded.load() >= RING_CAPACITY * 4);
+    }
+}
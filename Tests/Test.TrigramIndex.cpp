@@ -0,0 +1,176 @@
+#include "Test.h"
+#include "Core.TrigramIndex.h"
+
+
+namespace Mi::Core
+{
+    static std::vector<uint64_t> SearchIds(_Inout_ TrigramIndex& Index, _In_ std::wstring_view Query,
+        _In_opt_ size_t MaxResults = 10)
+    {
+        std::vector<TrigramMatch> Matches;
+        Index.Search(Query, MaxResults, Matches);
+
+        std::vector<uint64_t> Ids;
+        for (const auto& Match : Matches) {
+            Ids.push_back(Match.Id);
+        }
+        return Ids;
+    }
+
+    static bool Near(_In_ float Value, _In_ float Expected)
+    {
+        return std::abs(Value - Expected) < 1e-4f;
+    }
+
+    TEST_CASE(TrigramIndex_Ranking)
+    {
+        TrigramIndex Index;
+        Index.Insert(1, L"Untitled",            L"Notepad",            L"notepad.exe");
+        Index.Insert(2, L"notes.txt - Notepad", L"Notepad",            L"notepad.exe");
+        Index.Insert(3, L"Notepad",             L"Notepad",            L"notepad.exe");
+        Index.Insert(4, L"Inbox - Mail",        L"Chrome_WidgetWin_1", L"chrome.exe");
+
+        // Title prefix, then anywhere in the title, then class or process name, each with every trigram found
+        std::vector<TrigramMatch> Matches;
+        Index.Search(L"NotePad", 10, Matches);
+        CHECK_EQUAL(Matches.size(), 3u);
+        CHECK(Matches.size() == 3 && Matches[0].Id == 3 && Matches[1].Id == 2 && Matches[2].Id == 1);
+        CHECK(Matches.size() == 3 && Near(Matches[0].Score, 2.25f));
+        CHECK(Matches.size() == 3 && Near(Matches[1].Score, 2.0f));
+        CHECK(Matches.size() == 3 && Near(Matches[2].Score, 1.5f));
+
+        // MaxResults keeps the best ones
+        CHECK(SearchIds(Index, L"notepad", 2) == std::vector<uint64_t>({ 3, 2 }));
+        CHECK(SearchIds(Index, L"notepad", 0).empty());
+    }
+
+    TEST_CASE(TrigramIndex_RankingTies)
+    {
+        TrigramIndex Index;
+        Index.Insert(5, L"Render Preview", L"", L"");
+        Index.Insert(6, L"Render",         L"", L"");
+        Index.Insert(9, L"Scene B",        L"", L"");
+        Index.Insert(8, L"Scene A",        L"", L"");
+
+        // Equal scores go to the shorter title, then the lower id
+        CHECK(SearchIds(Index, L"render") == std::vector<uint64_t>({ 6, 5 }));
+        CHECK(SearchIds(Index, L"scene") == std::vector<uint64_t>({ 8, 9 }));
+    }
+
+    TEST_CASE(TrigramIndex_HalfOfTheTrigrams)
+    {
+        TrigramIndex Index;
+        Index.Insert(1, L"Capture",   L"", L"");
+        Index.Insert(2, L"Captain",   L"", L"");     // cap apt
+        Index.Insert(3, L"Picture",   L"", L"");     // tur ure
+        Index.Insert(4, L"Cape",      L"", L"");     // cap
+        Index.Insert(5, L"Unrelated", L"", L"");
+
+        // Five trigrams in the query, two are enough
+        const auto Ids = SearchIds(Index, L"capture");
+        CHECK_EQUAL(Ids.size(), 3u);
+        CHECK(!Ids.empty() && Ids.front() == 1);
+        CHECK(std::find(Ids.begin(), Ids.end(), 2) != Ids.end());
+        CHECK(std::find(Ids.begin(), Ids.end(), 3) != Ids.end());
+        CHECK(std::find(Ids.begin(), Ids.end(), 4) == Ids.end());
+
+        // A typo keeps the trigrams before it
+        CHECK(!SearchIds(Index, L"captrue").empty() && SearchIds(Index, L"captrue").front() == 1);
+
+        std::vector<TrigramMatch> Matches;
+        Index.Search(L"captain", 10, Matches);
+        CHECK(!Matches.empty() && Matches.front().Id == 2);
+        CHECK(Matches.size() >= 2 && Near(Matches[1].Score, 0.4f));
+    }
+
+    TEST_CASE(TrigramIndex_ShortQueries)
+    {
+        TrigramIndex Index;
+        Index.Insert(1, L"Render Settings", L"",             L"");
+        Index.Insert(2, L"Frame Report",    L"",             L"");
+        Index.Insert(3, L"Three",           L"",             L"");
+        Index.Insert(4, L"notes.txt",       L"",             L"");
+        Index.Insert(5, L"Untitled",        L"RenderWindow", L"");
+
+        // The start of a word in any field, not a letter inside one
+        auto Ids = SearchIds(Index, L"r");
+        std::sort(Ids.begin(), Ids.end());
+        CHECK(Ids == std::vector<uint64_t>({ 1, 2, 5 }));
+
+        Ids = SearchIds(Index, L"RE");
+        CHECK_EQUAL(Ids.size(), 3u);
+        CHECK(!Ids.empty() && Ids.front() == 1);
+
+        CHECK(SearchIds(Index, L"tx") == std::vector<uint64_t>({ 4 }));
+        CHECK(SearchIds(Index, L"hr").empty());
+        CHECK(SearchIds(Index, L"").empty());
+    }
+
+    TEST_CASE(TrigramIndex_LongQueries)
+    {
+        std::wstring Title;
+        for (int Word = 0; Title.size() < TrigramIndex::MAXIMUM_QUERY_LENGTH; ++Word) {
+            Title += L"word" + std::to_wstring(Word) + L' ';
+        }
+        Title.resize(TrigramIndex::MAXIMUM_QUERY_LENGTH);
+
+        TrigramIndex Index;
+        Index.Insert(1, Title, L"", L"");
+        Index.Insert(2, L"Other", L"", L"");
+
+        // Only the first MAXIMUM_QUERY_LENGTH characters count, so the whole query is the title
+        std::vector<TrigramMatch> Matches;
+        Index.Search(Title + std::wstring(100, L'z'), 10, Matches);
+        CHECK_EQUAL(Matches.size(), 1u);
+        CHECK(!Matches.empty() && Matches.front().Id == 1 && Near(Matches.front().Score, 2.25f));
+
+        // Far beyond the limit
+        Index.Search(std::wstring(1 << 20, L'x'), 10, Matches);
+        CHECK(Matches.empty());
+    }
+
+    TEST_CASE(TrigramIndex_InsertReplaces)
+    {
+        TrigramIndex Index;
+        Index.Insert(7, L"Alpha Document", L"Xylophone", L"quartz.exe");
+        Index.Insert(8, L"Unrelated",      L"Other",      L"other.exe");
+
+        // A rename: the old postings are gone, nothing is listed twice
+        Index.Insert(7, L"Beta Document", L"Zebra", L"mango.exe");
+        CHECK_EQUAL(Index.GetSize(), 2u);
+        CHECK(SearchIds(Index, L"alpha").empty());
+        CHECK(SearchIds(Index, L"xylophone").empty());
+        CHECK(SearchIds(Index, L"quartz").empty());
+        CHECK(SearchIds(Index, L"x").empty());
+        CHECK(SearchIds(Index, L"beta") == std::vector<uint64_t>({ 7 }));
+        CHECK(SearchIds(Index, L"zebra") == std::vector<uint64_t>({ 7 }));
+        CHECK(SearchIds(Index, L"mango") == std::vector<uint64_t>({ 7 }));
+        CHECK(SearchIds(Index, L"document") == std::vector<uint64_t>({ 7 }));
+    }
+
+    TEST_CASE(TrigramIndex_EraseAndReuse)
+    {
+        TrigramIndex Index;
+        Index.Insert(1, L"Game Window", L"UnrealWindow", L"game.exe");
+        Index.Insert(2, L"Game Launcher", L"Launcher", L"launcher.exe");
+
+        CHECK(Index.Erase(1));
+        CHECK(!Index.Erase(1));
+        CHECK(!Index.Erase(3));
+        CHECK_EQUAL(Index.GetSize(), 1u);
+        CHECK(SearchIds(Index, L"game") == std::vector<uint64_t>({ 2 }));
+        CHECK(SearchIds(Index, L"unreal").empty());
+
+        // The freed slot is taken again, by the same id and then another one
+        Index.Insert(1, L"Editor", L"", L"");
+        Index.Insert(3, L"Game Server", L"", L"");
+        CHECK_EQUAL(Index.GetSize(), 3u);
+        CHECK(SearchIds(Index, L"editor") == std::vector<uint64_t>({ 1 }));
+        CHECK(SearchIds(Index, L"window").empty());
+        CHECK(SearchIds(Index, L"game") == std::vector<uint64_t>({ 3, 2 }));
+
+        Index.Clear();
+        CHECK_EQUAL(Index.GetSize(), 0u);
+        CHECK(SearchIds(Index, L"game").empty());
+    }
+}
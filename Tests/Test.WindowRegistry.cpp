@@ -0,0 +1,262 @@
+#include "Test.h"
+#include "Core.WindowRegistry.h"
+
+
+namespace Mi::Core
+{
+    // A desktop the test edits by hand, a window without a title is not listed
+    class FakeWindowProvider final : public IWindowProvider
+    {
+    public:
+        struct Window
+        {
+            std::wstring Title;
+            bool         Visible = true;
+        };
+
+        std::map<WindowId, Window> Windows;
+        uint32_t                   Described = 0;
+
+        void EnumerateWindows(_Inout_ std::vector<WindowId>& Enumerated) override
+        {
+            for (const auto& [Id, Item] : Windows) {
+                Enumerated.push_back(Id);
+            }
+        }
+
+        bool DescribeWindow(_In_ WindowId Id, _Out_ std::wstring& Title, _Out_ std::wstring& ClassName,
+            _Out_ std::wstring& ProcessName) override
+        {
+            ++Described;
+            Title.clear();
+            ClassName.clear();
+            ProcessName.clear();
+
+            const auto Item = Windows.find(Id);
+            if (Item == Windows.end() || !Item->second.Visible || Item->second.Title.empty()) {
+                return false;
+            }
+
+            Title       = Item->second.Title;
+            ClassName   = L"Class" + std::to_wstring(Id);
+            ProcessName = L"process.exe";
+            return true;
+        }
+    };
+
+    // A registry with an observer that mirrors its array the way the picker does
+    struct RegistryFixture
+    {
+        FakeWindowProvider    Provider;
+        WindowRegistry        Registry{ Provider };
+        std::vector<WindowId> Mirror;
+        uint32_t              Renamed = 0;
+
+        RegistryFixture()
+        {
+            Registry.SetObserver([this](WindowRegistryAction Action, uint32_t Index)
+            {
+                const auto& Entries = Registry.GetEntries();
+                switch (Action) {
+                    case WindowRegistryAction::Added:
+                        Mirror.push_back(Entries[Index].Window);
+                        break;
+                    case WindowRegistryAction::Removed:
+                        Mirror[Index] = Mirror.back();
+                        Mirror.pop_back();
+                        break;
+                    case WindowRegistryAction::Renamed:
+                        ++Renamed;
+                        break;
+                }
+            });
+        }
+
+        void Open(_In_ WindowId Id, _In_ const wchar_t* Title)
+        {
+            Provider.Windows[Id] = { Title, true };
+            Registry.OnEvent(WindowEvent::Created, Id);
+        }
+
+        void Close(_In_ WindowId Id)
+        {
+            Provider.Windows.erase(Id);
+            Registry.OnEvent(WindowEvent::Destroyed, Id);
+        }
+
+        // The mirror matches the array and every entry is found through the index
+        [[nodiscard]] bool IsConsistent() const
+        {
+            const auto& Entries = Registry.GetEntries();
+            if (Entries.size() != Mirror.size()) {
+                return false;
+            }
+            for (size_t Index = 0; Index < Entries.size(); ++Index) {
+                if (Entries[Index].Window != Mirror[Index] || Registry.Find(Entries[Index].Window) != &Entries[Index]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    TEST_CASE(WindowRegistry_RebuildListsTitledWindows)
+    {
+        RegistryFixture Fixture;
+        Fixture.Provider.Windows[1] = { L"Editor", true };
+        Fixture.Provider.Windows[2] = { L"",       true };
+        Fixture.Provider.Windows[3] = { L"Hidden", false };
+        Fixture.Provider.Windows[4] = { L"Game",   true };
+
+        Fixture.Registry.Rebuild();
+        CHECK_EQUAL(Fixture.Registry.GetEntries().size(), 2u);
+        CHECK(Fixture.Registry.Find(1) != nullptr);
+        CHECK(Fixture.Registry.Find(2) == nullptr);
+        CHECK(Fixture.Registry.Find(3) == nullptr);
+        CHECK(Fixture.Registry.Find(4)->ClassName == L"Class4");
+        CHECK(Fixture.IsConsistent());
+
+        // Known windows are not described again, closed ones are dropped
+        Fixture.Provider.Windows.erase(1);
+        Fixture.Provider.Described = 0;
+        Fixture.Registry.Rebuild();
+        CHECK_EQUAL(Fixture.Provider.Described, 2u);
+        CHECK(Fixture.Registry.Find(1) == nullptr);
+        CHECK(Fixture.Registry.Find(4) != nullptr);
+        CHECK(Fixture.IsConsistent());
+    }
+
+    TEST_CASE(WindowRegistry_RemoveMovesLastEntry)
+    {
+        RegistryFixture Fixture;
+        for (WindowId Id = 1; Id <= 5; ++Id) {
+            Fixture.Open(Id, (L"Window " + std::to_wstring(Id)).c_str());
+        }
+
+        // The last entry takes the slot of the removed one, and the index follows it
+        Fixture.Close(2);
+        const auto& Entries = Fixture.Registry.GetEntries();
+        CHECK_EQUAL(Entries.size(), 4u);
+        CHECK_EQUAL(Entries[1].Window, WindowId{ 5 });
+        CHECK(Fixture.Registry.Find(5) == &Entries[1]);
+        CHECK(Fixture.Registry.Find(5)->Title == L"Window 5");
+        CHECK(Fixture.Registry.Find(2) == nullptr);
+        CHECK(Fixture.IsConsistent());
+
+        // The last entry itself, nothing moves
+        Fixture.Close(4);
+        CHECK_EQUAL(Entries.size(), 3u);
+        CHECK_EQUAL(Entries[2].Window, WindowId{ 3 });
+        CHECK(Fixture.IsConsistent());
+
+        Fixture.Close(1);
+        Fixture.Close(3);
+        Fixture.Close(5);
+        CHECK(Entries.empty());
+        CHECK(Fixture.IsConsistent());
+    }
+
+    TEST_CASE(WindowRegistry_Rename)
+    {
+        RegistryFixture Fixture;
+        Fixture.Open(1, L"Untitled - Notepad");
+        Fixture.Open(2, L"Browser");
+
+        Fixture.Provider.Windows[1].Title = L"notes.txt - Notepad";
+        Fixture.Registry.OnEvent(WindowEvent::NameChanged, 1);
+        CHECK_EQUAL(Fixture.Renamed, 1u);
+        CHECK(Fixture.Registry.Find(1)->Title == L"notes.txt - Notepad");
+        CHECK(Fixture.Registry.Find(1) == &Fixture.Registry.GetEntries()[0]);
+
+        // The same title again is not a change
+        Fixture.Registry.OnEvent(WindowEvent::NameChanged, 1);
+        CHECK_EQUAL(Fixture.Renamed, 1u);
+
+        // Losing the title takes the window off the list, getting one puts it back
+        Fixture.Provider.Windows[1].Title.clear();
+        Fixture.Registry.OnEvent(WindowEvent::NameChanged, 1);
+        CHECK(Fixture.Registry.Find(1) == nullptr);
+        CHECK(Fixture.IsConsistent());
+
+        Fixture.Provider.Windows[1].Title = L"Notepad";
+        Fixture.Registry.OnEvent(WindowEvent::NameChanged, 1);
+        CHECK(Fixture.Registry.Find(1)->Title == L"Notepad");
+        CHECK_EQUAL(Fixture.Renamed, 1u);
+        CHECK(Fixture.IsConsistent());
+    }
+
+    TEST_CASE(WindowRegistry_UnknownWindowEvents)
+    {
+        RegistryFixture Fixture;
+        Fixture.Open(1, L"Editor");
+        Fixture.Open(2, L"Game");
+
+        // Windows the registry never listed, nothing changes and the observer is not called
+        Fixture.Registry.OnEvent(WindowEvent::Destroyed, 99);
+        Fixture.Registry.OnEvent(WindowEvent::Hidden, 99);
+        Fixture.Registry.OnEvent(WindowEvent::NameChanged, 99);
+        Fixture.Registry.OnEvent(WindowEvent::Destroyed, 0);
+        CHECK_EQUAL(Fixture.Registry.GetEntries().size(), 2u);
+        CHECK_EQUAL(Fixture.Renamed, 0u);
+        CHECK(Fixture.IsConsistent());
+
+        // A window destroyed twice is removed once
+        Fixture.Close(1);
+        Fixture.Close(1);
+        CHECK_EQUAL(Fixture.Registry.GetEntries().size(), 1u);
+        CHECK(Fixture.Registry.Find(2) != nullptr);
+        CHECK(Fixture.IsConsistent());
+
+        // A second Created of a listed window does not add it again
+        Fixture.Registry.OnEvent(WindowEvent::Created, 2);
+        Fixture.Registry.OnEvent(WindowEvent::Shown, 2);
+        CHECK_EQUAL(Fixture.Registry.GetEntries().size(), 1u);
+    }
+
+    TEST_CASE(WindowRegistry_HiddenUntilShown)
+    {
+        RegistryFixture Fixture;
+        Fixture.Provider.Windows[7] = { L"Splash", false };
+        Fixture.Registry.OnEvent(WindowEvent::Created, 7);
+        CHECK(Fixture.Registry.Find(7) == nullptr);
+
+        Fixture.Provider.Windows[7].Visible = true;
+        Fixture.Registry.OnEvent(WindowEvent::Shown, 7);
+        CHECK(Fixture.Registry.Find(7) != nullptr);
+
+        Fixture.Provider.Windows[7].Visible = false;
+        Fixture.Registry.OnEvent(WindowEvent::Hidden, 7);
+        CHECK(Fixture.Registry.Find(7) == nullptr);
+        CHECK(Fixture.IsConsistent());
+    }
+
+    TEST_CASE(WindowRegistry_RandomEventsStayConsistent)
+    {
+        RegistryFixture Fixture;
+
+        // A fixed xorshift sequence of opens, closes and renames over a few ids, so slots get reused often
+        uint64_t State     = 0x2545F4914F6CDD1D;
+        bool     Consistent = true;
+        for (int Step = 0; Step < 5000; ++Step) {
+            State ^= State << 13;
+            State ^= State >> 7;
+            State ^= State << 17;
+
+            const WindowId Id = 1 + State % 24;
+            switch ((State >> 8) % 3) {
+                case 0: Fixture.Open(Id, (L"Window " + std::to_wstring(Step)).c_str()); break;
+                case 1: Fixture.Close(Id); break;
+                case 2:
+                    if (const auto Item = Fixture.Provider.Windows.find(Id); Item != Fixture.Provider.Windows.end()) {
+                        Item->second.Title = L"Renamed " + std::to_wstring(Step);
+                    }
+                    Fixture.Registry.OnEvent(WindowEvent::NameChanged, Id);
+                    break;
+            }
+
+            Consistent = Consistent && Fixture.IsConsistent()
+                && Fixture.Registry.GetEntries().size() == Fixture.Provider.Windows.size();
+        }
+        CHECK(Consistent);
+    }
+}
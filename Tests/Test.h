@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+
+
+namespace Mi::Test
+{
+    using TestBody = void(*)();
+
+    // Adds a test to the list Test.Main.cpp runs, through TEST_CASE.
+    struct TestRegistration
+    {
+        TestRegistration(_In_z_ const char* Name, _In_ TestBody Body);
+    };
+
+    // Records a failed check of the running test, the test goes on.
+    void ReportFailure(_In_z_ const char* Expression, _In_z_ const char* File, _In_ int Line, _In_ const std::string& Detail);
+
+    template<typename Left, typename Right>
+    void CheckEqual(_In_ const Left& Actual, _In_ const Right& Expected, _In_z_ const char* Expression,
+        _In_z_ const char* File, _In_ int Line)
+    {
+        if (!(Actual == Expected)) {
+            if constexpr (requires { std::to_string(Actual); std::to_string(Expected); }) {
+                ReportFailure(Expression, File, Line, std::to_string(Actual) + " != " + std::to_string(Expected));
+            }
+            else {
+                ReportFailure(Expression, File, Line, {});
+            }
+        }
+    }
+}
+
+#define TEST_CASE(Name)                                                                         \
+    static void Name();                                                                         \
+    static const ::Mi::Test::TestRegistration Name##Registration(#Name, &Name);                  \
+    static void Name()
+
+#define CHECK(Expression)                                                                       \
+    do {                                                                                        \
+        if (!(Expression)) {                                                                    \
+            ::Mi::Test::ReportFailure(#Expression, __FILE__, __LINE__, {});                     \
+        }                                                                                       \
+    } while (false)
+
+#define CHECK_EQUAL(Actual, Expected) \
+    ::Mi::Test::CheckEqual((Actual), (Expected), #Actual " == " #Expected, __FILE__, __LINE__)
@@ -0,0 +1,46 @@
+#pragma once
+
+// The prefix header of the portable CMake targets, what pch.h is to Mi.Palin.exe minus Windows and D3D
+
+// SAL annotations are documentation outside of the Windows SDK
+#if defined(_MSC_VER)
+#include <sal.h>
+#else
+#define _In_
+#define _In_opt_
+#define _In_z_
+#define _In_reads_(Count)
+#define _In_reads_bytes_(Count)
+#define _Inout_
+#define _Out_
+#define _Out_writes_(Count)
+#define _Out_writes_bytes_(Count)
+#endif
+
+// STL
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+#include <optional>
+#include <future>
+#include <mutex>
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+#include <functional>
+#include <thread>
+#include <array>
+#include <map>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Logging, records are formatted and written by the background thread of Core::Logger
+#include "Core.Logger.h"
+
+#define LOG_ERROR 0
+#define LOG_INFO  1
+#define LOG(Tag, fmt, ...) \
+    ::Mi::Core::Logger::Write(static_cast<::Mi::Core::LogLevel>(LOG_##Tag), fmt, ## __VA_ARGS__)
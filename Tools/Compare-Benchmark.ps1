@@ -0,0 +1,101 @@
+<#
+.SYNOPSIS
+    Compares two result files of Mi.Palin.exe --benchmark and flags regressions.
+
+.DESCRIPTION
+    Benchmarks are matched by name. A benchmark regressed when its median time grew by more than Threshold
+    percent over the baseline. A benchmark in the baseline but not in the current results is reported as missing,
+    a renamed or dropped benchmark would otherwise stop being checked unnoticed. The exit code is the number of
+    regressions and missing benchmarks, so the script can gate a build.
+
+.EXAMPLE
+    .\Mi.Palin.exe --benchmark --output baseline.json
+    .\Mi.Palin.exe --benchmark --output current.json
+    .\Tools\Compare-Benchmark.ps1 -Baseline baseline.json -Current current.json -Threshold 10
+#>
+param(
+    [Parameter(Mandatory = $true)] [string] $Baseline,
+    [Parameter(Mandatory = $true)] [string] $Current,
+    [double] $Threshold = 10.0
+)
+
+$ErrorActionPreference = 'Stop'
+
+$Old = Get-Content -Raw -Path $Baseline | ConvertFrom-Json
+$New = Get-Content -Raw -Path $Current  | ConvertFrom-Json
+
+if ($Old.machine.adapter -ne $New.machine.adapter) {
+    Write-Warning "The adapters differ ('$($Old.machine.adapter)' and '$($New.machine.adapter)'), GPU results are not comparable."
+}
+
+$OldByName = @{}
+foreach ($Item in $Old.benchmarks) {
+    $OldByName[$Item.name] = $Item
+}
+
+$NewByName = @{}
+foreach ($Item in $New.benchmarks) {
+    $NewByName[$Item.name] = $Item
+}
+
+$Regressions = 0
+$Missing     = 0
+$Rows = @(foreach ($Item in $New.benchmarks) {
+    $Before = $OldByName[$Item.name]
+
+    if ($null -eq $Before -or $Before.skipped -or $Item.skipped) {
+        [pscustomobject]@{
+            Name     = $Item.name
+            Baseline = if ($Before -and -not $Before.skipped) { '{0:N1}' -f $Before.median_ns } else { '-' }
+            Current  = if (-not $Item.skipped) { '{0:N1}' -f $Item.median_ns } else { '-' }
+            Change   = '-'
+            Status   = if ($null -eq $Before) { 'new' } else { 'skipped' }
+        }
+        continue
+    }
+
+    $Change = ($Item.median_ns - $Before.median_ns) / $Before.median_ns * 100.0
+
+    # Within the noise of the baseline run, a slower median alone is not enough
+    $Status = 'ok'
+    if ($Change -gt $Threshold -and $Item.median_ns -gt $Before.max_ns) {
+        $Status = 'REGRESSED'
+        $Regressions++
+    }
+    elseif ($Change -lt -$Threshold -and $Item.median_ns -lt $Before.min_ns) {
+        $Status = 'improved'
+    }
+
+    [pscustomobject]@{
+        Name     = $Item.name
+        Baseline = '{0:N1}' -f $Before.median_ns
+        Current  = '{0:N1}' -f $Item.median_ns
+        Change   = '{0:+0.0;-0.0}%' -f $Change
+        Status   = $Status
+    }
+})
+
+foreach ($Item in $Old.benchmarks) {
+    if ($NewByName.ContainsKey($Item.name)) {
+        continue
+    }
+
+    $Missing++
+    $Rows += [pscustomobject]@{
+        Name     = $Item.name
+        Baseline = if (-not $Item.skipped) { '{0:N1}' -f $Item.median_ns } else { '-' }
+        Current  = '-'
+        Change   = '-'
+        Status   = 'MISSING'
+    }
+}
+
+$Rows | Format-Table -AutoSize | Out-String -Width 200 | Write-Host
+
+if ($Regressions) {
+    Write-Host "$Regressions benchmark(s) regressed by more than $Threshold%."
+}
+if ($Missing) {
+    Write-Host "$Missing benchmark(s) of the baseline are missing from the current results."
+}
+exit ($Regressions + $Missing)